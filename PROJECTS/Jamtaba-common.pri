@@ -47,10 +47,15 @@ PRECOMPILED_HEADER += PreCompiledHeaders.h
 
 HEADERS += midi/MidiDriver.h
 HEADERS += midi/MidiMessage.h
+HEADERS += midi/MidiClockScheduler.h
 HEADERS += looper/Looper.h
 HEADERS += looper/LooperLayer.h
+HEADERS += looper/CompactLayerStorage.h
 HEADERS += looper/LooperStates.h
+HEADERS += looper/LoopInfo.h
+HEADERS += looper/LoopInfoIndex.h
 HEADERS += looper/LooperPersistence.h
+HEADERS += looper/LoopIOService.h
 HEADERS += audio/core/AudioDriver.h
 HEADERS += audio/core/AudioNode.h
 HEADERS += audio/core/LocalInputNode.h
@@ -59,14 +64,22 @@ HEADERS += audio/core/AudioNodeProcessor.h
 HEADERS += audio/core/AudioMixer.h
 HEADERS += audio/core/SamplesBuffer.h
 HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/core/MeteringSlot.h
+HEADERS += audio/core/AudioBus.h
+HEADERS += audio/core/DelayLine.h
+HEADERS += audio/core/PeaksPyramid.h
+HEADERS += audio/core/RingBuffer.h
 HEADERS += audio/core/Plugins.h
 HEADERS += audio/core/Filters.h
+HEADERS += audio/core/LoudnessMeter.h
 HEADERS += audio/core/PluginDescriptor.h
 HEADERS += audio/Encoder.h
 HEADERS += audio/vorbis/VorbisDecoder.h
 HEADERS += audio/vorbis/VorbisEncoder.h
 HEADERS += audio/RoomStreamerNode.h
 HEADERS += audio/NinjamTrackNode.h
+HEADERS += audio/LoudnessAnalyzer.h
+HEADERS += audio/BuiltInPlugins.h
 HEADERS += audio/MetronomeTrackNode.h
 HEADERS += audio/MidiSyncTrackNode.h
 HEADERS += audio/SamplesBufferResampler.h
@@ -76,6 +89,7 @@ HEADERS += audio/Resampler.h
 HEADERS += video/FFMpegMuxer.h
 HEADERS += video/FFMpegDemuxer.h
 HEADERS += video/VideoFrameGrabber.h
+HEADERS += video/RgbToYuvConverter.h
 HEADERS += video/VideoWidget.h
 HEADERS += file/FileReader.h
 HEADERS += file/FileReaderFactory.h
@@ -87,6 +101,7 @@ HEADERS += file/FileUtils.h
 HEADERS += recorder/JamRecorder.h
 HEADERS += recorder/ReaperProjectGenerator.h
 HEADERS += recorder/ClipSortLogGenerator.h
+HEADERS += recorder/JamRenderer.h
 HEADERS += loginserver/LoginService.h
 HEADERS += loginserver/Version.h
 HEADERS += loginserver/MainChat.h
@@ -135,6 +150,7 @@ HEADERS += gui/IconFactory.h
 HEADERS += gui/widgets/IntervalChunksDisplay.h
 HEADERS += gui/widgets/MarqueeLabel.h
 HEADERS += gui/widgets/PeakMeter.h
+HEADERS += gui/widgets/MeterStrip.h
 HEADERS += gui/widgets/WavePeakPanel.h
 HEADERS += gui/widgets/UserNameLineEdit.h
 HEADERS += gui/widgets/MapWidget.h
@@ -164,6 +180,9 @@ HEADERS += Configurator.h
 HEADERS += persistence/Settings.h
 HEADERS += persistence/UsersDataCache.h
 HEADERS += persistence/CacheHeader.h
+HEADERS += persistence/SoundCache.h
+HEADERS += persistence/PluginScanDatabase.h
+HEADERS += bridge/BridgeTransport.h
 HEADERS += log/Logging.h
 HEADERS += UploadIntervalData.h
 HEADERS += performance/PerformanceMonitor.h
@@ -174,11 +193,16 @@ SOURCES += NinjamController.cpp
 SOURCES += MetronomeUtils.cpp
 SOURCES += midi/MidiDriver.cpp
 SOURCES += midi/MidiMessage.cpp
+SOURCES += midi/MidiClockScheduler.cpp
 SOURCES += looper/Looper.cpp
 SOURCES += looper/LooperLayer.cpp
+SOURCES += looper/CompactLayerStorage.cpp
 SOURCES += looper/LooperStates.cpp
 SOURCES += file/WaveFileWriter.cpp
+SOURCES += looper/LoopInfo.cpp
+SOURCES += looper/LoopInfoIndex.cpp
 SOURCES += looper/LooperPersistence.cpp
+SOURCES += looper/LoopIOService.cpp
 SOURCES += audio/core/AudioDriver.cpp
 SOURCES += audio/core/AudioNode.cpp
 SOURCES += audio/core/LocalInputNode.cpp
@@ -186,10 +210,13 @@ SOURCES += audio/core/LocalInputGroup.cpp
 SOURCES += audio/core/AudioNodeProcessor.cpp
 SOURCES += audio/core/AudioMixer.cpp
 SOURCES += audio/core/Filters.cpp
+SOURCES += audio/core/LoudnessMeter.cpp
 SOURCES += audio/RoomStreamerNode.cpp
 SOURCES += audio/core/Plugins.cpp
 SOURCES += audio/Mp3Decoder.cpp
 SOURCES += audio/NinjamTrackNode.cpp
+SOURCES += audio/LoudnessAnalyzer.cpp
+SOURCES += audio/BuiltInPlugins.cpp
 SOURCES += audio/MetronomeTrackNode.cpp
 SOURCES += audio/MidiSyncTrackNode.cpp
 SOURCES += audio/core/SamplesBuffer.cpp
@@ -198,11 +225,17 @@ SOURCES += audio/SamplesBufferResampler.cpp
 SOURCES += audio/vorbis/VorbisDecoder.cpp
 SOURCES += audio/vorbis/VorbisEncoder.cpp
 SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/core/MeteringSlot.cpp
+SOURCES += audio/core/AudioBus.cpp
+SOURCES += audio/core/DelayLine.cpp
+SOURCES += audio/core/PeaksPyramid.cpp
 SOURCES += audio/Resampler.cpp
 SOURCES += video/FFMpegMuxer.cpp
 SOURCES += video/FFMpegDemuxer.cpp
 SOURCES += video/VideoFrameGrabber.cpp
+SOURCES += video/RgbToYuvConverter.cpp
 SOURCES += video/VideoWidget.cpp
+SOURCES += file/FileReader.cpp
 SOURCES += file/FileReaderFactory.cpp
 SOURCES += file/WaveFileReader.cpp
 SOURCES += file/OggFileReader.cpp
@@ -211,6 +244,7 @@ SOURCES += file/FileUtils.cpp
 SOURCES += recorder/JamRecorder.cpp
 SOURCES += recorder/ReaperProjectGenerator.cpp
 SOURCES += recorder/ClipSortLogGenerator.cpp
+SOURCES += recorder/JamRenderer.cpp
 SOURCES += ninjam/Ninjam.cpp
 SOURCES += ninjam/client/ServerInfo.cpp
 SOURCES += ninjam/client/Service.cpp
@@ -221,6 +255,7 @@ SOURCES += ninjam/client/ServerMessagesHandler.cpp
 SOURCES += ninjam/client/UserChannel.cpp
 SOURCES += ninjam/server/Server.cpp
 SOURCES += gui/widgets/PeakMeter.cpp
+SOURCES += gui/widgets/MeterStrip.cpp
 SOURCES += gui/widgets/WavePeakPanel.cpp
 SOURCES += gui/widgets/ChatTabWidget.cpp
 SOURCES += gui/LocalTrackView.cpp
@@ -292,6 +327,9 @@ SOURCES += Configurator.cpp
 SOURCES += persistence/UsersDataCache.cpp
 SOURCES += persistence/Settings.cpp
 SOURCES += persistence/CacheHeader.cpp
+SOURCES += persistence/SoundCache.cpp
+SOURCES += persistence/PluginScanDatabase.cpp
+SOURCES += bridge/BridgeTransport.cpp
 SOURCES += UploadIntervalData.cpp
 SOURCES += upnp/UPnPManager.cpp
 
@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 
 SUBDIRS += VstScanner
+SUBDIRS += PluginBridge
 
 mac {
     SUBDIRS += AUScanner
@@ -0,0 +1,82 @@
+QT += core gui widgets
+
+TARGET = PluginBridge
+CONFIG -= app_bundle #in MAC create just a binary, not a complete bundle
+CONFIG += c++11
+DEFINES += VST_FORCE_DEPRECATED=0 #enable VST 2.3 features
+
+linux{
+    DEFINES += __cdecl="" #avoid tons of errors in VST_SDK in linux
+}
+
+# the PluginBridge executable is generated in the Standalone folder, like the VstScanner
+macx:DESTDIR = $$OUT_PWD/../Standalone/Jamtaba2.app/Contents/MacOS
+linux:DESTDIR = $$OUT_PWD/../Standalone
+win32{
+    CONFIG(debug, debug|release) {
+        DESTDIR = $$OUT_PWD/../Standalone/debug
+    } else {
+        DESTDIR = $$OUT_PWD/../Standalone/release
+    }
+}
+
+TEMPLATE = app
+
+ROOT_PATH = "../.."
+SOURCE_PATH = $$ROOT_PATH/src
+
+INCLUDEPATH += $$SOURCE_PATH/Common
+INCLUDEPATH += $$SOURCE_PATH/PluginBridge
+INCLUDEPATH += $$SOURCE_PATH/Standalone/vst
+INCLUDEPATH += $$ROOT_PATH/VST_SDK/VST2_SDK/pluginterfaces/vst2.x
+
+VPATH       += $$SOURCE_PATH/Common
+VPATH       += $$SOURCE_PATH/PluginBridge
+VPATH       += $$SOURCE_PATH/Standalone
+
+HEADERS += PluginBridgeHost.h
+HEADERS += bridge/BridgeTransport.h
+HEADERS += vst/VstHost.h
+HEADERS += vst/VstPlugin.h
+HEADERS += vst/VstMidiEvents.h
+HEADERS += vst/Utils.h
+HEADERS += audio/core/Plugins.h
+HEADERS += audio/core/AudioNodeProcessor.h
+
+SOURCES += main.cpp
+SOURCES += PluginBridgeHost.cpp
+SOURCES += bridge/BridgeTransport.cpp
+SOURCES += vst/VstHost.cpp
+SOURCES += vst/VstLoader.cpp
+SOURCES += vst/VstPlugin.cpp
+SOURCES += vst/VstMidiEvents.cpp
+SOURCES += vst/Utils.cpp
+SOURCES += audio/core/Plugins.cpp
+SOURCES += audio/core/AudioNodeProcessor.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/core/PluginDescriptor.cpp
+SOURCES += midi/MidiMessage.cpp
+SOURCES += log/logging.cpp
+
+win32{
+
+    win32-msvc*{#all msvc compilers
+        #windows XP support
+        QMAKE_LFLAGS_WINDOWS = /SUBSYSTEM:WINDOWS,5.01 /SUBSYSTEM:CONSOLE,5.01
+
+        CONFIG(release, debug|release) {
+            QMAKE_CXXFLAGS_RELEASE +=  -GL -Gy -Gw
+            QMAKE_LFLAGS_RELEASE += /LTCG
+        }
+    }
+
+    LIBS +=  -lwinmm -lole32 -lws2_32 -lAdvapi32 -lUser32
+    RC_FILE = ../Jamtaba2.rc #windows icon
+}
+
+macx{
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-reorder
+    LIBS+= -dead_strip
+    LIBS += -framework Cocoa
+}
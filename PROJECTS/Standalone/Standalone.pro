@@ -33,9 +33,12 @@ HEADERS += audio/PortAudioDriver.h
 HEADERS += audio/Host.h
 HEADERS += midi/RtMidiDriver.h
 HEADERS += vst/VstPlugin.h
+HEADERS += vst/VstMidiEvents.h
+HEADERS += vst/BridgedVstPlugin.h
 HEADERS += vst/VstHost.h
 HEADERS += vst/VstLoader.h
 HEADERS += PluginFinder.h
+HEADERS += PluginLoader.h
 HEADERS += vst/VstPluginFinder.h
 HEADERS += vst/Utils.h
 HEADERS += Libs/SingleApplication/singleapplication.h
@@ -57,8 +60,11 @@ SOURCES += gui/FxPanelItem.cpp
 SOURCES += gui/MidiToolsDialog.cpp
 SOURCES += midi/RtMidiDriver.cpp
 SOURCES += vst/VstPlugin.cpp
+SOURCES += vst/VstMidiEvents.cpp
+SOURCES += vst/BridgedVstPlugin.cpp
 SOURCES += vst/VstHost.cpp
 SOURCES += PluginFinder.cpp
+SOURCES += PluginLoader.cpp
 SOURCES += vst/VstPluginFinder.cpp
 SOURCES += vst/Utils.cpp
 SOURCES += vst/VstLoader.cpp
@@ -12,6 +12,7 @@
 #include "audio/core/LocalInputNode.h"
 #include "audio/core/LocalInputGroup.h"
 #include "audio/RoomStreamerNode.h"
+#include "audio/NinjamTrackNode.h"
 #include "ninjam/client/Service.h"
 #include "recorder/JamRecorder.h"
 #include "recorder/ReaperProjectGenerator.h"
@@ -20,6 +21,7 @@
 #include "gui/ThemeLoader.h"
 #include "log/Logging.h"
 #include "ninjam/client/Types.h"
+#include "persistence/SoundCache.h"
 
 #include <QBuffer>
 #include <QByteArray>
@@ -37,6 +39,10 @@ const QSize MainController::MAX_VIDEO_SIZE(320, 240); // max video resolution in
 
 const QString MainController::CRASH_FLAG_STRING = "JamTaba closed without crash :)";
 
+const int MainController::LOOPERS_STORAGE_UPDATE_PERIOD = 500;
+
+const int MainController::MAX_TRANSMIT_LATENCY = 16384;
+
 // ++++++++++++++++++++++++++++++++++++++++++++++
 
 MainController::MainController(const Settings &settings) :
@@ -50,19 +56,30 @@ MainController::MainController(const Settings &settings) :
     currentStreamingRoomID(-1000),
     started(false),
     masterGain(1),
+    sampleClock(0),
+    midiBlockStart(0),
+    audioBlockPosition(0),
+    transmitLatency(0),
     usersDataCache(Configurator::getInstance()->getCacheDir()),
     lastInputTrackID(0),
-    lastFrameTimeStamp(0),
+    lastCapturedFrameSlot(0),
     emojiManager(":/emoji/emoji.json", ":/emoji/icons")
 {
     QDir cacheDir = Configurator::getInstance()->getCacheDir();
 
+    persistence::SoundCache::getInstance()->setCacheDir(cacheDir.absoluteFilePath("sounds"));
+
+    incommingMidi.reserve(1024); // avoid allocations in audio thread, the midi driver is not pulling more messages than this capacity
+
     // Register known JamRecorders here:
     jamRecorders.append(new recorder::JamRecorder(new recorder::ReaperProjectGenerator()));
     jamRecorders.append(new recorder::JamRecorder(new recorder::ClipSortLogGenerator()));
 
     connect(&videoEncoder, &FFMpegMuxer::dataEncoded, this, &MainController::enqueueVideoDataToUpload);
 
+    connect(&loopersStorageTimer, &QTimer::timeout, this, &MainController::updateLoopersStorage);
+    loopersStorageTimer.start(LOOPERS_STORAGE_UPDATE_PERIOD);
+
     for (auto emojiCode: settings.getRecentEmojis())
         emojiManager.addRecent(emojiCode);
 
@@ -275,8 +292,10 @@ void MainController::handleNewNinjamInterval()
             jamRecorder->newInterval();
     }
 
-    if (mainWindow->cameraIsActivated())
+    if (mainWindow->cameraIsActivated()) {
+        videoEncoder.setFramesPerInterval(getFramesPerInterval());
         videoEncoder.startNewInterval();
+    }
 }
 
 void MainController::processCapturedFrame(int frameID, const QImage &frame)
@@ -290,15 +309,29 @@ void MainController::processCapturedFrame(int frameID, const QImage &frame)
 void MainController::requestCameraFrame(int intervalPosition)
 {
     if (isPlayingInNinjamRoom() && mainWindow->cameraIsActivated()) {
+
+        // the capture is driven by the interval clock, the interval is divided in 'framesPerInterval' slots and one frame is grabbed in each slot
+        const quint64 samplesPerInterval = ninjamController->getSamplesPerInterval();
+        const uint framesPerInterval = getFramesPerInterval();
+        if (!samplesPerInterval || !framesPerInterval)
+            return;
+
+        const uint frameSlot = static_cast<uint>(static_cast<quint64>(intervalPosition) * framesPerInterval / samplesPerInterval);
+
         bool isFirstPart = intervalPosition == 0;
-        if (isFirstPart || canGrabNewFrameFromCamera()) {
+        if (isFirstPart || frameSlot != lastCapturedFrameSlot) {
             static int frameID = 0;
             processCapturedFrame(frameID++, mainWindow->pickCameraFrame());
-            lastFrameTimeStamp = QDateTime::currentMSecsSinceEpoch();
+            lastCapturedFrameSlot = frameSlot;
         }
     }
 }
 
+FFMpegMuxer::Statistics MainController::getVideoEncodingStatistics() const
+{
+    return videoEncoder.getStatistics();
+}
+
 uint MainController::getFramesPerInterval() const
 {
     auto intervalTimeInSeconds = ninjamController->getSamplesPerInterval()/getSampleRate();
@@ -453,10 +486,13 @@ login::Location MainController::getGeoLocation(const QString &ip)
     return login::Location();
 }
 
-void MainController::mixGroupedInputs(int groupIndex, audio::SamplesBuffer &out)
+const audio::SamplesBuffer *MainController::getTransmitBuffer(int groupIndex) const
 {
-    if (groupIndex >= 0 && groupIndex < trackGroups.size())
-        trackGroups[groupIndex]->mixGroupedInputs(out);
+    auto group = trackGroups.value(groupIndex);
+    if (group)
+        return &group->getTransmitBuffer();
+
+    return nullptr;
 }
 
 // this is called when a new ninjam interval is received and the 'record multi track' option is enabled
@@ -612,6 +648,16 @@ void MainController::storeMetronomeSettings(float metronomeGain, float metronome
     settings.setMetronomeSettings(metronomeGain, metronomePan, metronomeMuted);
 }
 
+void MainController::setRemoteAutoGain(bool enabled)
+{
+    settings.setRemoteAutoGain(enabled);
+
+    if (isPlayingInNinjamRoom()) {
+        for (auto trackNode : ninjamController->getTrackNodes())
+            trackNode->setAutoGainEnabled(enabled);
+    }
+}
+
 void MainController::setBuiltInMetronome(const QString &metronomeAlias)
 {
     settings.setBuiltInMetronome(metronomeAlias);
@@ -680,13 +726,56 @@ void MainController::setAllLoopersStatus(bool activated)
         inputTrack->getLooper()->setActivated(activated);
 }
 
+void MainController::storeLooperCompactLockedLayersFlag(bool compact)
+{
+    settings.setLooperCompactLockedLayersFlag(compact);
+
+    for (auto inputTrack : inputTracks.values())
+        inputTrack->getLooper()->setCompactLockedLayers(compact);
+}
+
+void MainController::updateLoopersStorage()
+{
+    for (auto inputTrack : inputTracks.values())
+        inputTrack->getLooper()->updateLayersStorage();
+}
+
+void MainController::updateLatencyCompensation()
+{
+    int maxLatency = 0;
+    for (auto inputTrack : inputTracks)
+        maxLatency = qMax(maxLatency, inputTrack->getLatency());
+
+    maxLatency = qMin(maxLatency, getMaxTransmitLatency()); // the delay lines and the transmited intervals shift are using the same limit
+
+    for (auto inputTrack : inputTracks)
+        inputTrack->setLatencyCompensation(qMax(0, maxLatency - inputTrack->getLatency()));
+
+    transmitLatency = maxLatency;
+}
+
+int MainController::getMaxTransmitLatency() const
+{
+    if (ninjamController && ninjamController->getSamplesPerInterval() > 0)
+        return qMin(MAX_TRANSMIT_LATENCY, static_cast<int>(ninjamController->getSamplesPerInterval() / 2));
+
+    return MAX_TRANSMIT_LATENCY;
+}
+
 void MainController::doAudioProcess(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate)
 {
-    auto incommingMidi = pullMidiMessagesFromDevices();
+    updateLatencyCompensation(); // plugins can change the latency at any time
+
+    for (auto group : trackGroups) // the input nodes are mixed in the group transmit bus while processed
+        group->prepareTransmitBus(out.getFrameLenght());
+
     audioMixer.process(in, out, sampleRate, incommingMidi);
+    incommingMidi.clear(); // when the audio callback is splitted (new ninjam interval) the messages are delivered only in the first part
 
     out.applyGain(masterGain, 1.0f); // using 1 as boost factor/multiplier (no boost)
     masterPeak.update(out.computePeak());
+
+    audioBlockPosition += out.getFrameLenght();
 }
 
 void MainController::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, int sampleRate)
@@ -696,6 +785,11 @@ void MainController::process(const audio::SamplesBuffer &in, audio::SamplesBuffe
     if (!started)
         return;
 
+    incommingMidi.clear();
+    pullMidiMessagesFromDevices(incommingMidi, sampleClock, sampleRate); // just one time in each audio callback
+
+    audioBlockPosition = sampleClock;
+
     try
     {
         if (!isPlayingInNinjamRoom()) {
@@ -716,6 +810,9 @@ void MainController::process(const audio::SamplesBuffer &in, audio::SamplesBuffe
 
         qFatal("Aborting in  MainController::process!");
     }
+
+    midiBlockStart = sampleClock;
+    sampleClock += out.getFrameLenght();
 }
 
 void MainController::syncWithNinjamIntervalStart(uint intervalLenght)
@@ -1159,15 +1256,6 @@ audio::LocalInputNode *MainController::getInputTrackInGroup(quint8 groupIndex, q
     return trackGroup->getInputNode(trackIndex);
 }
 
-bool MainController::canGrabNewFrameFromCamera() const
-{
-    static const quint64 timeBetweenFrames = 1000/CAMERA_FPS;
-
-    const quint64 now = QDateTime::currentMSecsSinceEpoch();
-
-    return (now - lastFrameTimeStamp) >= timeBetweenFrames;
-}
-
 QList<recorder::JamRecorder *> MainController::getActiveRecorders() const
 {
     QList<recorder::JamRecorder *> activeRecorders;
@@ -3,6 +3,7 @@
 
 #include <QScopedPointer>
 #include <QImage>
+#include <QTimer>
 
 #include "UploadIntervalData.h"
 #include "loginserver/LoginService.h"
@@ -86,6 +87,7 @@ public:
     void setVideoProperties(const QSize &resolution);
 
     QSize getVideoResolution() const;
+    FFMpegMuxer::Statistics getVideoEncodingStatistics() const;
 
     void setFullScreenView(bool fullScreen);
 
@@ -193,10 +195,17 @@ public:
     int getInputTracksCount() const;
     int getInputTrackGroupsCount() const;
 
-    void mixGroupedInputs(int groupIndex, SamplesBuffer &out);
+    const SamplesBuffer *getTransmitBuffer(int groupIndex) const; // the grouped inputs mix, or null if the group not exists
+
+    int getTransmitLatency() const; // the slowest input plugins chain latency, all transmited inputs are delayed to this latency
+
+    static const int MAX_TRANSMIT_LATENCY; // in samples, the latency compensation delay lines are sized with this limit
 
     virtual float getSampleRate() const = 0;
 
+    quint64 getMidiBlockStart() const; // the sample clock position used as zero offset for the incomming midi messages timestamps
+    quint64 getAudioBlockPosition() const; // the sample clock position of the block in processing, the audio callback can be splitted in many blocks
+
     float getEncodingQuality() const;
 
     static QByteArray newGUID();
@@ -286,14 +295,15 @@ public:
     quint8 getLooperPreferedMode() const;
     bool getLooperAudioEncodingFlag() const;
     quint8 getLooperBitDepth() const;
+    bool getLooperCompactLockedLayersFlag() const;
 
     void setAllLoopersStatus(bool activated);
 
-    // sync methods
-    virtual void startMidiClock() const = 0;
+    // sync methods, start, continue and pulse messages are scheduled to be sent at the sample position (see getAudioBlockPosition)
+    virtual void startMidiClock(quint64 samplePosition) const = 0;
     virtual void stopMidiClock() const = 0;
-    virtual void continueMidiClock() const = 0;
-    virtual void sendMidiClockPulse() const = 0;
+    virtual void continueMidiClock(quint64 samplePosition) const = 0;
+    virtual void sendMidiClockPulse(quint64 samplePosition) const = 0;
 
     // collapse settings
     void setLocalChannelsCollapsed(bool collapsed);
@@ -324,10 +334,12 @@ public slots:
     virtual void setSampleRate(int newSampleRate);
     void setEncodingQuality(float newEncodingQuality);
     void storeLooperBitDepth(quint8 bitDepth);
+    void storeLooperCompactLockedLayersFlag(bool compact);
 
     void storeRemoteUserRememberSettings(bool boost, bool level, bool pan, bool mute, bool lowCut);
     void storeCollapsibleSectionsRememberSettings(bool localChannels, bool bottomSection,
                                                   bool chatSection);
+    void setRemoteAutoGain(bool enabled);
 
     void blockUserInChat(const QString &userNameToBlock);
     void unblockUserInChat(const QString &userNameToUnblock);
@@ -370,7 +382,7 @@ protected:
 
     virtual void setCSS(const QString &css) = 0;
 
-    virtual std::vector<midi::MidiMessage> pullMidiMessagesFromDevices() = 0;     // pull midi messages generated by midi controllers. This function is called just one time in each audio processing cicle.
+    virtual void pullMidiMessagesFromDevices(std::vector<midi::MidiMessage> &buffer, quint64 sampleClock, int sampleRate) = 0;     // pull midi messages generated by midi controllers. This function is called just one time in each audio processing cicle.
 
     // audio process is here too (see MainController::process)
     virtual void doAudioProcess(const SamplesBuffer &in, SamplesBuffer &out,
@@ -383,6 +395,9 @@ protected:
 private:
     void setAllTracksActivation(bool activated);
 
+    void updateLatencyCompensation(); // called in audio thread, align all input tracks to the slowest plugins chain
+    int getMaxTransmitLatency() const; // the transmited intervals are shifted by the latency, so half interval is the limit
+
     QScopedPointer<AbstractMp3Streamer> roomStreamer;
     QString currentStreamingRoomID;
 
@@ -405,15 +420,20 @@ private:
     float masterGain;
     AudioPeak masterPeak;
 
+    std::vector<midi::MidiMessage> incommingMidi; // preallocated, reused in each audio callback
+    quint64 sampleClock; // the first sample of the current audio callback
+    quint64 midiBlockStart; // the first sample of the previous audio callback, the incomming midi messages were received after this point
+    quint64 audioBlockPosition;
+
+    int transmitLatency;
+
     UsersDataCache usersDataCache;
 
     int lastInputTrackID;     // used to generate a unique key/ID for each input track
 
     const static quint8 CAMERA_FPS;
 
-    bool canGrabNewFrameFromCamera() const;
-
-    quint64 lastFrameTimeStamp;
+    uint lastCapturedFrameSlot; // camera frames are captured in slots of the interval
 
     void recreateMetronome();
 
@@ -425,6 +445,10 @@ private:
 
     QSet<QString> chatBlockedUsers;
 
+    QTimer loopersStorageTimer; // periodic loopers storage update in the main thread (see Looper::updateLayersStorage)
+
+    static const int LOOPERS_STORAGE_UPDATE_PERIOD; // in milliseconds
+
 protected slots:
 
     // ninjam
@@ -442,8 +466,25 @@ protected slots:
 
     void requestCameraFrame(int intervalPosition);
 
+    void updateLoopersStorage();
+
 };
 
+inline quint64 MainController::getMidiBlockStart() const
+{
+    return midiBlockStart;
+}
+
+inline quint64 MainController::getAudioBlockPosition() const
+{
+    return audioBlockPosition;
+}
+
+inline int MainController::getTransmitLatency() const
+{
+    return transmitLatency;
+}
+
 inline MainWindow *MainController::getMainWindow() const
 {
     return mainWindow;
@@ -659,6 +700,11 @@ inline quint8 MainController::getLooperPreferedMode() const
     return settings.getLooperPreferredMode();
 }
 
+inline bool MainController::getLooperCompactLockedLayersFlag() const
+{
+    return settings.getLooperCompactLockedLayersFlag();
+}
+
 inline bool MainController::getLooperAudioEncodingFlag() const
 {
     return settings.getLooperAudioEncodingFlag();
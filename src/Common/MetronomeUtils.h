@@ -29,7 +29,6 @@ public:
 
 private:
     static void createBuffer(const QString &audioFilePath, SamplesBuffer &outBuffer, quint32 localSampleRate);
-    static void createResampledBuffer(const SamplesBuffer &buffer, SamplesBuffer &outBuffer, int originalSampleRate, int finalSampleRate);
 
     static QString buildMetronomeFileNameFromAlias(const QString &alias, const QString &Beat);
 
@@ -14,6 +14,7 @@
 #include "audio/NinjamTrackNode.h"
 #include "audio/MetronomeTrackNode.h"
 #include "audio/MidiSyncTrackNode.h"
+#include "audio/LoudnessAnalyzer.h"
 #include "audio/Resampler.h"
 #include "audio/SamplesBufferRecorder.h"
 #include "audio/vorbis/VorbisEncoder.h"
@@ -180,6 +181,7 @@ public:
     {
         controller->currentBpi = newBpi;
         controller->samplesInInterval = controller->computeTotalSamplesInInterval();
+        controller->metronomeTrackNode->setIntervalLength(controller->samplesInInterval, controller->currentBpi);
         emit controller->currentBpiChanged(controller->currentBpi);
     }
 
@@ -243,8 +245,12 @@ NinjamController::NinjamController(controller::MainController *mainController) :
     mutex(QMutex::Recursive),
     encodersMutex(QMutex::Recursive),
     encodingThread(nullptr),
+    loudnessAnalyzer(nullptr),
     preparedForTransmit(false),
-    waitingIntervals(0) // waiting for start transmit
+    waitingIntervals(0), // waiting for start transmit
+    transmitPosition(0),
+    transmitIntervalLength(0),
+    transmitIntervalStarted(false)
 {
     running = false;
 }
@@ -265,7 +271,7 @@ void NinjamController::setBpm(int newBpm)
 {
     currentBpm = newBpm;
     samplesInInterval = computeTotalSamplesInInterval();
-    metronomeTrackNode->setSamplesPerBeat(getSamplesPerBeat());
+    metronomeTrackNode->setIntervalLength(samplesInInterval, currentBpi);
     midiSyncTrackNode->setPulseTiming(currentBpi * 24, getSamplesPerBeat()/24.0);
 
     emit currentBpmChanged(currentBpm);
@@ -276,7 +282,7 @@ void NinjamController::setBpmBpi(int initialBpm, int initialBpi)
     currentBpi = initialBpi;
     currentBpm = initialBpm;
     samplesInInterval = computeTotalSamplesInInterval();
-    metronomeTrackNode->setSamplesPerBeat(getSamplesPerBeat());
+    metronomeTrackNode->setIntervalLength(samplesInInterval, currentBpi);
     midiSyncTrackNode->setPulseTiming(currentBpi * 24, getSamplesPerBeat()/24.0);
 
     emit currentBpmChanged(currentBpm);
@@ -321,10 +327,21 @@ void NinjamController::process(const audio::SamplesBuffer &in, audio::SamplesBuf
     {
         emit startProcessing(intervalPosition); // vst host time line is updated with this event
 
+        bool newInterval = intervalPosition == 0;
+        if (newInterval)   // starting new interval
+            handleNewInterval();
+
+        bool isFirstTransmitPart = transmitPosition == 0;
+        if (isFirstTransmitPart)
+            startTransmitInterval();
+
+        // the steps are splitted in interval end and in transmit interval end (shifted by the input plugins latency)
         int samplesToProcessInThisStep
             = (std::min)((int)(samplesInInterval - intervalPosition),
                          totalSamplesToProcess - offset);
 
+        samplesToProcessInThisStep = (std::min)(samplesToProcessInThisStep, (int)(transmitIntervalLength - transmitPosition));
+
         assert(samplesToProcessInThisStep);
 
         static audio::SamplesBuffer tempOutBuffer(out.getChannels(), samplesToProcessInThisStep);
@@ -334,10 +351,6 @@ void NinjamController::process(const audio::SamplesBuffer &in, audio::SamplesBuf
         audio::SamplesBuffer tempInBuffer(in.getChannels(), samplesToProcessInThisStep);
         tempInBuffer.set(in, offset, samplesToProcessInThisStep, 0);
 
-        bool newInterval = intervalPosition == 0;
-        if (newInterval)   // starting new interval
-            handleNewInterval();
-
         metronomeTrackNode->setIntervalPosition(this->intervalPosition);
         midiSyncTrackNode->setIntervalPosition(this->intervalPosition);
         int currentBeat = intervalPosition / getSamplesPerBeat();
@@ -348,35 +361,32 @@ void NinjamController::process(const audio::SamplesBuffer &in, audio::SamplesBuf
         }
 
         // +++++++++++ MAIN AUDIO OUTPUT PROCESS +++++++++++++++
-        bool isLastPart = intervalPosition + samplesToProcessInThisStep >= samplesInInterval;
         //for (NinjamTrackNode *track : trackNodes)
         //    track->setProcessingLastPartOfInterval(isLastPart); // TODO resampler still need a flag indicating the last part?
         mainController->doAudioProcess(tempInBuffer, tempOutBuffer, sampleRate);
         out.add(tempOutBuffer, offset); // generate audio output
         // ++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-        if (preparedForTransmit)
+        bool isLastTransmitPart = transmitPosition + samplesToProcessInThisStep >= transmitIntervalLength;
+
+        if (transmitIntervalStarted)
         {
             // 1) mix input subchannels, 2) encode and 3) send the encoded audio
-            bool isFirstPart = intervalPosition == 0;
             int groupedChannels = mainController->getInputTrackGroupsCount();
             for (int groupIndex = 0; groupIndex < groupedChannels; ++groupIndex)
             {
                 if (mainController->isTransmiting(groupIndex))
                 {
                     int channels = mainController->getMaxAudioChannelsForEncoding(groupIndex);
-                    if (channels > 0)
+                    if (channels > 0 && encoders.contains(groupIndex))
                     {
-                        audio::SamplesBuffer inputMixBuffer(channels, samplesToProcessInThisStep);
-
-                        if (encoders.contains(groupIndex))
+                        // the grouped inputs are already mixed in the group transmit bus, no copies here
+                        const audio::SamplesBuffer *inputMixBuffer = mainController->getTransmitBuffer(groupIndex);
+                        if (inputMixBuffer)
                         {
-                            inputMixBuffer.zero();
-                            mainController->mixGroupedInputs(groupIndex, inputMixBuffer);
-
                             // encoding is running in another thread to avoid slow down the audio thread
-                            encodingThread->addSamplesToEncode(inputMixBuffer, groupIndex,
-                                                               isFirstPart, isLastPart);
+                            encodingThread->addSamplesToEncode(*inputMixBuffer, groupIndex,
+                                                               isFirstTransmitPart, isLastTransmitPart);
                         }
                     }
                 }
@@ -385,17 +395,31 @@ void NinjamController::process(const audio::SamplesBuffer &in, audio::SamplesBuf
 
         samplesProcessed += samplesToProcessInThisStep;
         offset += samplesToProcessInThisStep;
+        transmitPosition = isLastTransmitPart ? 0 : transmitPosition + samplesToProcessInThisStep;
         this->intervalPosition = (this->intervalPosition + samplesToProcessInThisStep)
                                  % samplesInInterval;
     }
     while (samplesProcessed < totalSamplesToProcess);
 }
 
-audio::MetronomeTrackNode *NinjamController::createMetronomeTrackNode(int sampleRate)
+void NinjamController::startTransmitInterval()
+{
+    /**
+        The transmited samples are delayed by the input plugins latency (and aligned by the latency
+        compensation), so the transmited intervals are shifted by the same latency to land on the grid.
+        The transmit interval started here is finished in the next interval, in the new latency position.
+    */
+
+    const long newLatency = mainController->getTransmitLatency(); // limited in MainController::updateLatencyCompensation
+
+    transmitIntervalLength = samplesInInterval - intervalPosition + newLatency;
+    transmitIntervalStarted = preparedForTransmit; // the first transmited interval is always complete
+}
+
+void NinjamController::loadMetronomeSounds(int sampleRate, audio::SamplesBuffer &firstBeatBuffer,
+                                           audio::SamplesBuffer &offBeatBuffer,
+                                           audio::SamplesBuffer &accentBeatBuffer)
 {
-    audio::SamplesBuffer firstBeatBuffer(2);
-    audio::SamplesBuffer offBeatBuffer(2);
-    audio::SamplesBuffer accentBeatBuffer(2);
     if (!(mainController->isUsingCustomMetronomeSounds()))
     {
         QString builtInMetronomeAlias = mainController->getSettings().getBuiltInMetronome();
@@ -415,30 +439,30 @@ audio::MetronomeTrackNode *NinjamController::createMetronomeTrackNode(int sample
     audio::metronomeUtils::removeSilenceInBufferStart(firstBeatBuffer);
     audio::metronomeUtils::removeSilenceInBufferStart(offBeatBuffer);
     audio::metronomeUtils::removeSilenceInBufferStart(accentBeatBuffer);
+}
+
+audio::MetronomeTrackNode *NinjamController::createMetronomeTrackNode(int sampleRate)
+{
+    audio::SamplesBuffer firstBeatBuffer(2);
+    audio::SamplesBuffer offBeatBuffer(2);
+    audio::SamplesBuffer accentBeatBuffer(2);
+    loadMetronomeSounds(sampleRate, firstBeatBuffer, offBeatBuffer, accentBeatBuffer);
 
     return new audio::MetronomeTrackNode(firstBeatBuffer, offBeatBuffer, accentBeatBuffer);
 }
 
 void NinjamController::recreateMetronome(int newSampleRate)
 {
-    // remove the old metronome
-    float oldGain = metronomeTrackNode->getGain();
-    float oldPan = metronomeTrackNode->getPan();
-    bool oldMutedStatus = metronomeTrackNode->isMuted();
-    bool oldSoloStatus = metronomeTrackNode->isSoloed();
-    QList<int> oldAccentBeats = metronomeTrackNode->getAccentBeats();
+    // the metronome node is not recreated, gain, pan, mute, solo and accents are preserved
+    audio::SamplesBuffer firstBeatBuffer(2);
+    audio::SamplesBuffer offBeatBuffer(2);
+    audio::SamplesBuffer accentBeatBuffer(2);
+    loadMetronomeSounds(newSampleRate, firstBeatBuffer, offBeatBuffer, accentBeatBuffer);
 
-    mainController->removeTrack(METRONOME_TRACK_ID);
+    metronomeTrackNode->setClickSounds(firstBeatBuffer, offBeatBuffer, accentBeatBuffer);
 
-    // recreate metronome using the new sample rate
-    this->metronomeTrackNode = createMetronomeTrackNode(newSampleRate);
-    this->metronomeTrackNode->setSamplesPerBeat(getSamplesPerBeat());
-    this->metronomeTrackNode->setGain(oldGain);
-    this->metronomeTrackNode->setPan(oldPan);
-    this->metronomeTrackNode->setMute(oldMutedStatus);
-    this->metronomeTrackNode->setSolo(oldSoloStatus);
-    this->metronomeTrackNode->setAccentBeats(oldAccentBeats);
-    mainController->addTrack(METRONOME_TRACK_ID, this->metronomeTrackNode);
+    if (currentBpi > 0 && currentBpm > 0)
+        metronomeTrackNode->setIntervalLength(computeTotalSamplesInInterval(), currentBpi);
 }
 
 void NinjamController::stop(bool emitDisconnectedSignal)
@@ -479,6 +503,13 @@ void NinjamController::stop(bool emitDisconnectedSignal)
         encodingThread = nullptr;
     }
 
+    if (loudnessAnalyzer)
+    {
+        loudnessAnalyzer->stop();
+        delete loudnessAnalyzer;
+        loudnessAnalyzer = nullptr;
+    }
+
     for (AudioEncoder *encoder : encoders.values())
         delete encoder;
     encoders.clear();
@@ -559,6 +590,7 @@ void NinjamController::start(const ServerInfo &server)
     if (!running)
     {
         encodingThread = new NinjamController::EncodingThread(this);
+        loudnessAnalyzer = new audio::LoudnessAnalyzer();
 
         // add a sine wave generator as input to test audio transmission
         // mainController->addInputTrackNode(new Audio::LocalInputTestStreamer(440, mainController->getAudioDriverSampleRate()));
@@ -574,6 +606,7 @@ void NinjamController::start(const ServerInfo &server)
         mainController->addTrack(MIDI_SYNC_TRACK_ID, this->midiSyncTrackNode);
 
         this->intervalPosition = lastBeat = 0;
+        this->transmitPosition = 0;
 
         auto ninjamService = mainController->getNinjamService();
         connect(ninjamService, &Service::serverBpmChanged, this,
@@ -679,6 +712,9 @@ void NinjamController::addTrack(const User &user, const UserChannel &channel)
         return;
 
     auto trackNode = new NinjamTrackNode(generateNewTrackID());
+    trackNode->setAutoGainEnabled(mainController->getSettings().isRemoteAutoGainEnabled());
+    if (loudnessAnalyzer)
+        loudnessAnalyzer->addAnalysis(trackNode->getLoudnessAnalysis());
 
     bool trackAdded = false;
 
@@ -907,6 +943,7 @@ void NinjamController::reset()
             trackNode->discardDownloadedIntervals();
     }
     intervalPosition = lastBeat = 0;
+    transmitPosition = 0;
 }
 
 void NinjamController::scheduleEncoderChangeForChannel(int channelIndex, bool voiceChatActivated)
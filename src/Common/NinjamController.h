@@ -19,6 +19,7 @@ class UserChannel;
 namespace audio {
     class MetronomeTrackNode;
     class MidiSyncTrackNode;
+    class LoudnessAnalyzer;
     class SamplesBuffer;
 }
 
@@ -154,6 +155,7 @@ private:
     static long generateNewTrackID();
 
     MetronomeTrackNode *createMetronomeTrackNode(int sampleRate);
+    void loadMetronomeSounds(int sampleRate, audio::SamplesBuffer &firstBeatBuffer, audio::SamplesBuffer &offBeatBuffer, audio::SamplesBuffer &accentBeatBuffer);
 
     QMap<int, AudioEncoder *> encoders;
     AudioEncoder *getEncoder(quint8 channelIndex);
@@ -175,10 +177,19 @@ private:
 
     EncodingThread *encodingThread;
 
+    audio::LoudnessAnalyzer *loudnessAnalyzer; // remote channels loudness normalization
+
     bool preparedForTransmit;
     int waitingIntervals;
     static const int TOTAL_PREPARED_INTERVALS = 2;     // how many intervals Jamtaba will wait to start trasmiting?
 
+    // transmit intervals are shifted by the input plugins latency
+    long transmitPosition;
+    long transmitIntervalLength;
+    bool transmitIntervalStarted;
+
+    void startTransmitInterval();
+
 private slots:
     // ninjam events
     void scheduleBpmChangeEvent(quint16 newBpm);
@@ -0,0 +1,429 @@
+#include "BuiltInPlugins.h"
+#include "audio/core/SamplesBuffer.h"
+#include "gui/plugins/Guis.h"
+#include <QDebug>
+#include <QDialog>
+#include <QDataStream>
+#include <QVBoxLayout>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define BUILT_IN_PLUGINS_USE_SSE
+    #include <xmmintrin.h>
+#endif
+
+using audio::PluginDescriptor;
+using audio::JamtabaDelay;
+using audio::JamtabaEqualizer;
+using audio::Filter;
+using audio::SamplesBuffer;
+
+namespace {
+
+// out = in + wet * level, ring = in + wet * feedback
+void mixDelayedSamples(const float *in, const float *wet, float *out, float *ring, quint32 samples, float feedback, float level)
+{
+    quint32 s = 0;
+
+#ifdef BUILT_IN_PLUGINS_USE_SSE
+    const __m128 feedbackGain = _mm_set1_ps(feedback);
+    const __m128 levelGain = _mm_set1_ps(level);
+    for (; s + 4 <= samples; s += 4) {
+        const __m128 dry = _mm_loadu_ps(in + s);
+        const __m128 delayed = _mm_loadu_ps(wet + s);
+        _mm_storeu_ps(ring + s, _mm_add_ps(dry, _mm_mul_ps(delayed, feedbackGain)));
+        _mm_storeu_ps(out + s, _mm_add_ps(dry, _mm_mul_ps(delayed, levelGain)));
+    }
+#endif
+
+    for (; s < samples; ++s) {
+        const float dry = in[s];
+        ring[s] = dry + wet[s] * feedback;
+        out[s] = dry + wet[s] * level;
+    }
+}
+
+quint32 nextPowerOfTwo(quint32 value)
+{
+    quint32 size = 1;
+    while (size < value)
+        size <<= 1;
+
+    return size;
+}
+
+} // namespace
+
+class JamtabaDelay::Ring
+{
+public:
+    Ring(int sampleRate, quint32 minSize) :
+        sampleRate(sampleRate),
+        size(nextPowerOfTwo(minSize)),
+        mask(size - 1),
+        writeIndex(0)
+    {
+        for (auto &channel : samples)
+            channel.assign(size, 0.0f);
+    }
+
+    const int sampleRate;
+    const quint32 size;
+    const quint32 mask;
+    quint32 writeIndex;
+    std::vector<float> samples[2];
+};
+
+const int JamtabaDelay::MAX_DELAY_IN_SECONDS = 3;
+const quint32 JamtabaDelay::MAX_CHUNK_SIZE = 256;
+const double JamtabaDelay::DELAY_GLIDE = 0.25;
+
+JamtabaDelay::JamtabaDelay(int sampleRate) :
+    Plugin(PluginDescriptor("Delay", PluginDescriptor::Native_Plugin, "JamTaba")),
+    ring(new Ring(sampleRate, MAX_DELAY_IN_SECONDS * sampleRate + MAX_CHUNK_SIZE + 2)),
+    pendingRing(nullptr),
+    retiredRing(nullptr),
+    currentDelay(-1), // initialized in first processed block
+    delayTimeInMs(500), // half second
+    feedbackGain(300), // feedback start in this gain
+    level(1000),
+    tempoSync(NoSync),
+    bpm(120)
+{
+
+}
+
+JamtabaDelay::~JamtabaDelay()
+{
+    delete pendingRing.fetchAndStoreAcquire(nullptr);
+    delete retiredRing.fetchAndStoreAcquire(nullptr);
+}
+
+QByteArray JamtabaDelay::getSerializedData() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << delayTimeInMs.load() << feedbackGain.load() << level.load() << tempoSync.load();
+
+    return data;
+}
+
+void JamtabaDelay::restoreFromSerializedData(const QByteArray &data)
+{
+    if (data.isEmpty()) // sessions saved before the delay was implemented
+        return;
+
+    QDataStream stream(data);
+    int delayTime = 0, feedback = 0, delayLevel = 0, sync = 0;
+    stream >> delayTime >> feedback >> delayLevel >> sync;
+
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "Invalid delay data!";
+        return;
+    }
+
+    setDelayTime(delayTime);
+    setFeedback(feedback / 1000.0f);
+    setLevel(delayLevel / 1000.0f);
+    setTempoSync(static_cast<TempoSync>(qBound(static_cast<int>(NoSync), sync, static_cast<int>(Sixteenth))));
+}
+
+void JamtabaDelay::setSampleRate(int newSampleRate)
+{
+    delete retiredRing.fetchAndStoreAcquire(nullptr);
+
+    auto newRing = new Ring(newSampleRate, MAX_DELAY_IN_SECONDS * newSampleRate + MAX_CHUNK_SIZE + 2);
+    delete pendingRing.fetchAndStoreOrdered(newRing); // a not used pending ring is replaced
+}
+
+void JamtabaDelay::updateGui()
+{
+    delete retiredRing.fetchAndStoreAcquire(nullptr); // called periodically in GUI thread
+}
+
+void JamtabaDelay::updateRing()
+{
+    if (!pendingRing.load() || retiredRing.load()) // the GUI thread is not deleted the last retired ring yet
+        return;
+
+    auto newRing = pendingRing.fetchAndStoreAcquire(nullptr);
+    if (newRing) {
+        retiredRing.storeRelease(ring.release()); // deleted in GUI thread
+        ring.reset(newRing);
+        currentDelay = -1;
+    }
+}
+
+void JamtabaDelay::start()
+{
+    //
+}
+
+double JamtabaDelay::syncToBeats(TempoSync sync)
+{
+    switch (sync) {
+    case Half:          return 2.0;
+    case Quarter:       return 1.0;
+    case DottedEighth:  return 0.75;
+    case Eighth:        return 0.5;
+    case EighthTriplet: return 1.0 / 3.0;
+    case Sixteenth:     return 0.25;
+    case NoSync:        break;
+    }
+
+    return 0.0;
+}
+
+double JamtabaDelay::computeDelayInSamples(int sampleRate) const
+{
+    const int currentBpm = bpm.load();
+    const TempoSync sync = getTempoSync();
+
+    double delayInSeconds = delayTimeInMs.load() / 1000.0;
+    if (sync != NoSync && currentBpm > 0)
+        delayInSeconds = 60.0 / currentBpm * syncToBeats(sync);
+
+    return qBound(1.0, delayInSeconds * sampleRate, static_cast<double>(MAX_DELAY_IN_SECONDS * sampleRate));
+}
+
+void JamtabaDelay::process(const SamplesBuffer &in, SamplesBuffer &out, std::vector<midi::MidiMessage> &midiBuffer)
+{
+    Q_UNUSED(midiBuffer)
+
+    updateRing();
+
+    const quint32 frames = qMin(in.getFrameLenght(), out.getFrameLenght());
+    const int channels = qMin(out.getChannels(), 2);
+    const float feedback = getFeedback();
+    const float wetLevel = getLevel();
+
+    // the delay time is gliding to the target in the next blocks
+    const double targetDelay = computeDelayInSamples(ring->sampleRate);
+    const double startDelay = currentDelay < 0 ? targetDelay : currentDelay;
+    double endDelay = startDelay + (targetDelay - startDelay) * DELAY_GLIDE;
+    if (qAbs(targetDelay - endDelay) < 0.5)
+        endDelay = targetDelay;
+
+    currentDelay = endDelay;
+
+    const double delayIncrement = (endDelay - startDelay) / qMax(frames, 1u);
+
+    float wet[2][MAX_CHUNK_SIZE];
+
+    quint32 offset = 0;
+    while (offset < frames) {
+        // the samples read in this chunk are written before, so the chunk is not bigger than the delay
+        const double chunkStartDelay = startDelay + delayIncrement * offset;
+        const double minDelay = qMin(chunkStartDelay, endDelay); // the delay is changing linearly in the block
+        const quint32 chunkSize = qMin(qMin(frames - offset, MAX_CHUNK_SIZE), qMax(static_cast<quint32>(minDelay), 1u));
+
+        // read pass, fractional taps
+        for (int c = 0; c < channels; ++c) {
+            const float *ringSamples = ring->samples[c].data();
+            double delay = chunkStartDelay;
+            for (quint32 s = 0; s < chunkSize; ++s) {
+                const double readPosition = (ring->writeIndex + s) - delay + ring->size;
+                const quint32 index = static_cast<quint32>(readPosition);
+                const float fraction = static_cast<float>(readPosition - index);
+                const float a = ringSamples[index & ring->mask];
+                const float b = ringSamples[(index + 1) & ring->mask];
+                wet[c][s] = a + (b - a) * fraction;
+                delay += delayIncrement;
+            }
+        }
+
+        // write pass, feedback and mix
+        for (int c = 0; c < channels; ++c) {
+            const int inputChannel = qMin(c, in.getChannels() - 1); // mono input in both channels
+            const float *inputSamples = in.getSamplesArray(inputChannel) + offset;
+            float *outputSamples = out.getSamplesArray(c) + offset;
+            float *ringSamples = ring->samples[c].data();
+
+            const quint32 writeIndex = ring->writeIndex;
+            const quint32 firstPart = qMin(chunkSize, ring->size - writeIndex); // ring wrapping
+            mixDelayedSamples(inputSamples, wet[c], outputSamples, ringSamples + writeIndex, firstPart, feedback, wetLevel);
+            if (firstPart < chunkSize)
+                mixDelayedSamples(inputSamples + firstPart, wet[c] + firstPart, outputSamples + firstPart, ringSamples, chunkSize - firstPart, feedback, wetLevel);
+        }
+
+        ring->writeIndex = (ring->writeIndex + chunkSize) & ring->mask;
+        offset += chunkSize;
+    }
+}
+
+void JamtabaDelay::setDelayTime(int delayTimeInMs)
+{
+    if (delayTimeInMs > 0)
+        this->delayTimeInMs.store(qMin(delayTimeInMs, MAX_DELAY_IN_SECONDS * 1000));
+}
+
+void JamtabaDelay::setFeedback(float feedback)
+{
+    feedbackGain.store(qRound(qBound(0.0f, feedback, 0.99f) * 1000)); // feedback >= 1 is never decaying
+}
+
+void JamtabaDelay::setLevel(float level)
+{
+    if (level >= 0)
+        this->level.store(qRound(level * 1000));
+}
+
+void JamtabaDelay::setTempoSync(TempoSync sync)
+{
+    tempoSync.store(sync);
+}
+
+void JamtabaDelay::setTempo(int bpm)
+{
+    if (bpm > 0)
+        this->bpm.store(bpm);
+}
+
+void JamtabaDelay::openEditor(const QPoint &centerOfScreen)
+{
+    if (editorWindow) {
+        editorWindow->raise();
+        editorWindow->activateWindow();
+        return;
+    }
+
+    editorWindow = new QDialog(0, Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
+    editorWindow->setWindowTitle(getName());
+    QObject::connect(editorWindow, SIGNAL(finished(int)), this, SLOT(editorDialogFinished()));
+
+    auto layout = new QVBoxLayout(editorWindow);
+    layout->addWidget(new DelayGui(this));
+
+    editorWindow->adjustSize();
+    editorWindow->move(centerOfScreen - editorWindow->rect().center());
+    editorWindow->show();
+}
+
+// ++++++++++++++++++++++++++++
+
+const float JamtabaEqualizer::MAX_GAIN = 15.0f;
+const double JamtabaEqualizer::LOW_CUT_FREQUENCY = 80.0;
+const double JamtabaEqualizer::BAND_FREQUENCIES[BANDS] = {120.0, 1000.0, 6000.0};
+const double JamtabaEqualizer::MID_Q = 0.7;
+
+JamtabaEqualizer::JamtabaEqualizer(int sampleRate) :
+    Plugin(PluginDescriptor("Equalizer", PluginDescriptor::Native_Plugin, "JamTaba")),
+    filter(2, BANDS + 1), // low cut + bands
+    flat(true),
+    lowCut(0),
+    sampleRate(sampleRate),
+    parametersChanged(1)
+{
+    for (int band = 0; band < BANDS; ++band)
+        gains[band].store(0);
+}
+
+void JamtabaEqualizer::setSampleRate(int newSampleRate)
+{
+    sampleRate.store(newSampleRate);
+    parametersChanged.storeRelease(1);
+}
+
+void JamtabaEqualizer::setBandGain(Band band, float gainInDb)
+{
+    gains[band].store(qRound(qBound(-MAX_GAIN, gainInDb, MAX_GAIN) * 100));
+    parametersChanged.storeRelease(1);
+}
+
+void JamtabaEqualizer::setLowCut(bool enabled)
+{
+    lowCut.store(enabled ? 1 : 0);
+    parametersChanged.storeRelease(1);
+}
+
+void JamtabaEqualizer::updateFilter()
+{
+    const double rate = sampleRate.load();
+
+    if (isLowCutEnabled())
+        filter.setStage(0, Filter::computeCoefficients(Filter::HighPass, rate, LOW_CUT_FREQUENCY, 1.0, 1.0));
+    else
+        filter.bypassStage(0);
+
+    flat = !isLowCutEnabled();
+
+    static const Filter::FilterType types[BANDS] = {Filter::LowShelf, Filter::Peaking, Filter::HighShelf};
+    for (int band = 0; band < BANDS; ++band) {
+        const float gain = getBandGain(static_cast<Band>(band));
+        if (gain != 0.0f) {
+            const double Q = band == Mid ? MID_Q : 1.0;
+            filter.setStage(band + 1, Filter::computeCoefficients(types[band], rate, BAND_FREQUENCIES[band], Q, gain));
+            flat = false;
+        }
+        else {
+            filter.bypassStage(band + 1);
+        }
+    }
+
+    if (flat)
+        filter.reset(); // no clicks from old states when the EQ is used again
+}
+
+void JamtabaEqualizer::process(const SamplesBuffer &in, SamplesBuffer &out, std::vector<midi::MidiMessage> &midiBuffer)
+{
+    Q_UNUSED(midiBuffer)
+
+    if (parametersChanged.fetchAndStoreAcquire(0))
+        updateFilter();
+
+    out.set(in);
+
+    if (!flat)
+        filter.process(out);
+}
+
+QByteArray JamtabaEqualizer::getSerializedData() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << isLowCutEnabled();
+    for (int band = 0; band < BANDS; ++band)
+        stream << getBandGain(static_cast<Band>(band));
+
+    return data;
+}
+
+void JamtabaEqualizer::restoreFromSerializedData(const QByteArray &data)
+{
+    QDataStream stream(data);
+    bool lowCutEnabled = false;
+    stream >> lowCutEnabled;
+
+    float bandGains[BANDS] = {0.0f};
+    for (int band = 0; band < BANDS; ++band)
+        stream >> bandGains[band];
+
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "Invalid equalizer data!";
+        return;
+    }
+
+    setLowCut(lowCutEnabled);
+    for (int band = 0; band < BANDS; ++band)
+        setBandGain(static_cast<Band>(band), bandGains[band]);
+}
+
+void JamtabaEqualizer::openEditor(const QPoint &centerOfScreen)
+{
+    if (editorWindow) {
+        editorWindow->raise();
+        editorWindow->activateWindow();
+        return;
+    }
+
+    editorWindow = new QDialog(0, Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
+    editorWindow->setWindowTitle(getName());
+    QObject::connect(editorWindow, SIGNAL(finished(int)), this, SLOT(editorDialogFinished()));
+
+    auto layout = new QVBoxLayout(editorWindow);
+    layout->addWidget(new EqualizerGui(this));
+
+    editorWindow->adjustSize();
+    editorWindow->move(centerOfScreen - editorWindow->rect().center());
+    editorWindow->show();
+}
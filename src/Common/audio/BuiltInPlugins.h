@@ -0,0 +1,223 @@
+#ifndef BUILT_IN_PLUGINS_H
+#define BUILT_IN_PLUGINS_H
+
+#include "audio/core/Plugins.h"
+#include "audio/core/Filters.h"
+
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <memory>
+
+namespace audio {
+
+/** Real-time safe stereo delay. The ring is preallocated (power of two size) for the max delay
+    time and the read tap is fractional (linear interpolation), so delay time and tempo changes
+    are gliding without clicks or allocations. The parameters are changed in GUI thread, only a
+    sample rate change is allocating a new ring, which is swapped in the audio thread.
+ */
+
+class JamtabaDelay : public Plugin
+{
+public:
+    enum TempoSync // delay time in beats when synced with the ninjam BPM
+    {
+        NoSync,
+        Half,
+        Quarter,
+        DottedEighth,
+        Eighth,
+        EighthTriplet,
+        Sixteenth
+    };
+
+    static const int MAX_DELAY_IN_SECONDS;
+
+    explicit JamtabaDelay(int sampleRate);
+    ~JamtabaDelay();
+    void process(const SamplesBuffer &in, SamplesBuffer &out, std::vector<midi::MidiMessage> &midiBuffer) override;
+    void setDelayTime(int delayTimeInMs);
+    void setFeedback(float feedback);
+    void setLevel(float level);
+    void setTempoSync(TempoSync sync);
+    void setTempo(int bpm) override;
+
+    float getDelayTime() const;
+
+    float getFeedback() const;
+
+    float getLevel() const;
+
+    TempoSync getTempoSync() const;
+
+    static double syncToBeats(TempoSync sync);
+
+    void openEditor(const QPoint &centerOfScreen) override;
+    void updateGui() override;
+
+    void start() override;
+    QString getPath() const override;
+
+    QByteArray getSerializedData() const override;
+    void restoreFromSerializedData(const QByteArray &data) override;
+
+    void suspend() override;
+
+    void resume() override;
+
+    void setSampleRate(int newSampleRate) override;
+
+private:
+    class Ring;
+
+    void updateRing(); // audio thread
+    double computeDelayInSamples(int sampleRate) const;
+
+    static const quint32 MAX_CHUNK_SIZE; // samples processed between the read and write passes
+    static const double DELAY_GLIDE; // fraction of the delay time change applied in each block
+
+    std::unique_ptr<Ring> ring; // used in audio thread
+    QAtomicPointer<Ring> pendingRing; // allocated in GUI thread
+    QAtomicPointer<Ring> retiredRing; // deleted in GUI thread
+
+    double currentDelay; // in samples, audio thread
+
+    QAtomicInteger<int> delayTimeInMs;
+    QAtomicInteger<int> feedbackGain; // in thousandths
+    QAtomicInteger<int> level; // in thousandths
+    QAtomicInteger<int> tempoSync;
+    QAtomicInteger<int> bpm;
+};
+
+inline void JamtabaDelay::suspend()
+{
+
+}
+
+inline void JamtabaDelay::resume()
+{
+
+}
+
+inline QString JamtabaDelay::getPath() const
+{
+    return "";
+}
+
+inline float JamtabaDelay::getDelayTime() const
+{
+    return delayTimeInMs.load();
+}
+
+inline float JamtabaDelay::getFeedback() const
+{
+    return feedbackGain.load() / 1000.0f;
+}
+
+inline float JamtabaDelay::getLevel() const
+{
+    return level.load() / 1000.0f;
+}
+
+inline JamtabaDelay::TempoSync JamtabaDelay::getTempoSync() const
+{
+    return static_cast<TempoSync>(tempoSync.load());
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+/** Lightweight channel EQ: low cut, low shelf, mid peak and high shelf computed as a single
+    stereo MultiChannelFilter cascade. The parameters are changed in GUI thread and the
+    coefficients are recomputed in the audio thread.
+ */
+
+class JamtabaEqualizer : public Plugin
+{
+public:
+    enum Band
+    {
+        Low,
+        Mid,
+        High
+    };
+
+    static const int BANDS = 3;
+    static const float MAX_GAIN; // in dB
+
+    explicit JamtabaEqualizer(int sampleRate);
+    void process(const SamplesBuffer &in, SamplesBuffer &out, std::vector<midi::MidiMessage> &midiBuffer) override;
+
+    void setBandGain(Band band, float gainInDb);
+    float getBandGain(Band band) const;
+
+    void setLowCut(bool enabled);
+    bool isLowCutEnabled() const;
+
+    void openEditor(const QPoint &centerOfScreen) override;
+    void updateGui() override;
+
+    void start() override;
+    QString getPath() const override;
+
+    QByteArray getSerializedData() const override;
+    void restoreFromSerializedData(const QByteArray &data) override;
+
+    void suspend() override;
+
+    void resume() override;
+
+    void setSampleRate(int newSampleRate) override;
+
+private:
+    void updateFilter(); // called in audio thread when the parameters are changed
+
+    static const double LOW_CUT_FREQUENCY;
+    static const double BAND_FREQUENCIES[BANDS];
+    static const double MID_Q;
+
+    MultiChannelFilter filter;
+    bool flat; // all bands in 0 dB and no low cut, the samples are just copied
+
+    QAtomicInteger<int> gains[BANDS]; // in hundredths of dB
+    QAtomicInteger<int> lowCut;
+    QAtomicInteger<int> sampleRate;
+    QAtomicInteger<int> parametersChanged;
+};
+
+inline void JamtabaEqualizer::suspend()
+{
+
+}
+
+inline void JamtabaEqualizer::resume()
+{
+
+}
+
+inline QString JamtabaEqualizer::getPath() const
+{
+    return "";
+}
+
+inline void JamtabaEqualizer::updateGui()
+{
+
+}
+
+inline void JamtabaEqualizer::start()
+{
+
+}
+
+inline float JamtabaEqualizer::getBandGain(Band band) const
+{
+    return gains[band].load() / 100.0f;
+}
+
+inline bool JamtabaEqualizer::isLowCutEnabled() const
+{
+    return lowCut.load() != 0;
+}
+
+} // namespace
+
+#endif // BUILT_IN_PLUGINS_H
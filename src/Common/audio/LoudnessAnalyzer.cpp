@@ -0,0 +1,213 @@
+#include "LoudnessAnalyzer.h"
+
+#include "audio/core/SamplesBuffer.h"
+#include "log/Logging.h"
+
+#include <QMutexLocker>
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+using audio::LoudnessAnalysis;
+using audio::LoudnessAnalyzer;
+using audio::LoudnessMeter;
+
+const float LoudnessAnalysis::UNKNOWN_LOUDNESS = -100.0f;
+const float LoudnessAnalysis::TARGET_LOUDNESS = -20.0f;
+const float LoudnessAnalysis::MAX_AUTO_GAIN = 12.0f;
+const float LoudnessAnalysis::MIN_INTERVAL_LOUDNESS = -50.0f;
+const float LoudnessAnalysis::SMOOTHING = 0.3f; // weight of the last interval
+
+namespace {
+
+const quint32 CHUNK_SIZE = 4096;
+
+}
+
+LoudnessAnalysis::LoudnessAnalysis() :
+    left(RING_CAPACITY),
+    right(RING_CAPACITY),
+    sampleRate(0),
+    writtenSamples(0),
+    intervalBoundary(0),
+    intervals(0),
+    loudness(qRound(UNKNOWN_LOUDNESS * 100)),
+    autoGainEnabled(1),
+    analyzedIntervals(0),
+    readSamples(0),
+    leftChunk(CHUNK_SIZE),
+    rightChunk(CHUNK_SIZE)
+{
+
+}
+
+void LoudnessAnalysis::write(const SamplesBuffer &samples, int sampleRate)
+{
+    // called from the audio thread, just copying the decoded samples
+
+    const quint32 frames = samples.getFrameLenght();
+    if (!frames || left.getFree() < frames || right.getFree() < frames)
+        return; // the analyzer thread is late, dropping some samples is harmless
+
+    this->sampleRate.store(sampleRate);
+
+    const float *leftSamples = samples.getSamplesArray(0);
+    const float *rightSamples = samples.isMono() ? leftSamples : samples.getSamplesArray(1);
+
+    left.write(leftSamples, frames);
+    right.write(rightSamples, frames);
+
+    writtenSamples.storeRelease(writtenSamples.load() + frames);
+}
+
+void LoudnessAnalysis::startNewInterval()
+{
+    intervalBoundary.store(writtenSamples.load());
+    intervals.storeRelease(intervals.load() + 1);
+}
+
+quint32 LoudnessAnalysis::drain(quint32 maxSamples)
+{
+    quint32 drainedSamples = 0;
+    while (drainedSamples < maxSamples) {
+        const quint32 available = std::min(left.getAvailable(), right.getAvailable());
+        const quint32 samples = std::min(std::min(available, maxSamples - drainedSamples), CHUNK_SIZE);
+        if (!samples)
+            break;
+
+        left.read(leftChunk.data(), samples);
+        right.read(rightChunk.data(), samples);
+
+        meter.process(leftChunk.data(), rightChunk.data(), samples);
+
+        drainedSamples += samples;
+    }
+
+    readSamples += drainedSamples;
+
+    return drainedSamples;
+}
+
+void LoudnessAnalysis::finishInterval()
+{
+    const float intervalLoudness = static_cast<float>(meter.getIntegratedLoudness());
+    meter.reset();
+
+    if (intervalLoudness < MIN_INTERVAL_LOUDNESS)
+        return; // user is not playing in this interval, keeping the last loudness
+
+    const float lastLoudness = getLoudness();
+    float newLoudness = intervalLoudness;
+    if (lastLoudness != UNKNOWN_LOUDNESS)
+        newLoudness = lastLoudness + SMOOTHING * (intervalLoudness - lastLoudness);
+
+    loudness.store(qRound(newLoudness * 100));
+}
+
+void LoudnessAnalysis::analyze()
+{
+    const int rate = sampleRate.load();
+    if (rate > 0 && rate != meter.getSampleRate())
+        meter.setSampleRate(rate); // the remote user changed the sample rate
+
+    const quint32 currentIntervals = intervals.loadAcquire();
+    if (currentIntervals != analyzedIntervals) {
+        // remaining samples of the finished interval. The counters are wrapping, and the samples after the boundary
+        // can be already read when the interval started while the last analysis was draining the rings
+        const quint32 remainingSamples = intervalBoundary.load() - readSamples;
+        drain(static_cast<qint32>(remainingSamples) > 0 ? remainingSamples : 0);
+        finishInterval();
+        analyzedIntervals = currentIntervals;
+    }
+
+    drain(std::numeric_limits<quint32>::max());
+}
+
+void LoudnessAnalysis::setAutoGainEnabled(bool enabled)
+{
+    autoGainEnabled.store(enabled ? 1 : 0);
+}
+
+bool LoudnessAnalysis::isAutoGainEnabled() const
+{
+    return autoGainEnabled.load() != 0;
+}
+
+void LoudnessAnalysis::setInitialLoudness(float loudness)
+{
+    if (getLoudness() == UNKNOWN_LOUDNESS && loudness > UNKNOWN_LOUDNESS)
+        this->loudness.store(qRound(loudness * 100));
+}
+
+float LoudnessAnalysis::getLoudness() const
+{
+    return loudness.load() / 100.0f;
+}
+
+float LoudnessAnalysis::getAutoGainInDb() const
+{
+    const float currentLoudness = getLoudness();
+    if (currentLoudness == UNKNOWN_LOUDNESS)
+        return 0.0f;
+
+    return qBound(-MAX_AUTO_GAIN, TARGET_LOUDNESS - currentLoudness, MAX_AUTO_GAIN);
+}
+
+float LoudnessAnalysis::getAutoGain() const
+{
+    if (!isAutoGainEnabled())
+        return 1.0f;
+
+    return std::pow(10.0f, getAutoGainInDb() / 20.0f);
+}
+
+// ++++++++++++++++++++++++++++++++++++++++
+
+LoudnessAnalyzer::LoudnessAnalyzer() :
+    stopRequested(0)
+{
+    qCDebug(jtNinjamCore) << "Starting Loudness Analyzer Thread";
+    start(QThread::LowPriority);
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer()
+{
+    stop();
+}
+
+void LoudnessAnalyzer::addAnalysis(const std::shared_ptr<LoudnessAnalysis> &analysis)
+{
+    QMutexLocker locker(&mutex);
+    this->analysis.append(analysis);
+}
+
+void LoudnessAnalyzer::stop()
+{
+    stopRequested.store(1);
+    wait();
+}
+
+void LoudnessAnalyzer::run()
+{
+    while (!stopRequested.load()) {
+        QList<std::shared_ptr<LoudnessAnalysis>> currentAnalysis;
+        {
+            QMutexLocker locker(&mutex);
+            for (auto it = analysis.begin(); it != analysis.end();) {
+                if (it->use_count() == 1) // the track node was deleted
+                    it = analysis.erase(it);
+                else
+                    ++it;
+            }
+            currentAnalysis = analysis;
+        }
+
+        for (const auto &trackAnalysis : currentAnalysis)
+            trackAnalysis->analyze();
+
+        msleep(ANALYSIS_PERIOD);
+    }
+
+    qCDebug(jtNinjamCore) << "Loudness Analyzer Thread stopped!";
+}
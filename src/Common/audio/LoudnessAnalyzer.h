@@ -0,0 +1,105 @@
+#ifndef LOUDNESS_ANALYZER_H
+#define LOUDNESS_ANALYZER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QList>
+
+#include <memory>
+#include <vector>
+
+#include "audio/core/RingBuffer.h"
+#include "audio/core/LoudnessMeter.h"
+
+namespace audio {
+
+class SamplesBuffer;
+
+/**
+    Loudness analysis of a remote ninjam channel. The audio thread only copies the decoded
+    samples to lock free rings (write) and mark the interval boundaries (startNewInterval). The
+    integrated loudness of each interval is computed in the LoudnessAnalyzer thread, and the smoothed
+    loudness is used to compute the automatic gain applied in the track pre fader stage.
+
+    The instances are shared (std::shared_ptr) between the track node and the analyzer thread,
+    so the node can be deleted while the analyzer is running.
+ */
+
+class LoudnessAnalysis
+{
+public:
+    LoudnessAnalysis();
+
+    // audio thread
+    void write(const SamplesBuffer &samples, int sampleRate);
+    void startNewInterval();
+    float getAutoGain() const; // linear gain, 1.0 when auto gain is disabled or the loudness is unknown
+
+    // analyzer thread
+    void analyze();
+
+    // GUI thread
+    void setAutoGainEnabled(bool enabled);
+    bool isAutoGainEnabled() const;
+    void setInitialLoudness(float loudness); // remembered loudness (LUFS), used until the first interval is measured
+    float getLoudness() const; // smoothed loudness in LUFS or UNKNOWN_LOUDNESS
+    float getAutoGainInDb() const;
+
+    static const float UNKNOWN_LOUDNESS;
+    static const float TARGET_LOUDNESS; // in LUFS
+    static const float MAX_AUTO_GAIN; // in dB, applied in both directions
+
+private:
+    static const quint32 RING_CAPACITY = 65536; // more than 1 second at 48 KHz, the analyzer is draining the rings every 100 ms
+    static const float MIN_INTERVAL_LOUDNESS; // quieter intervals (silence, noise floor) are ignored
+    static const float SMOOTHING;
+
+    RingBuffer<float> left;
+    RingBuffer<float> right;
+
+    QAtomicInteger<int> sampleRate;
+    QAtomicInteger<quint32> writtenSamples;
+    QAtomicInteger<quint32> intervalBoundary; // 'writtenSamples' when the last interval started
+    QAtomicInteger<quint32> intervals;
+
+    QAtomicInteger<int> loudness; // in hundredths of LUFS
+    QAtomicInteger<int> autoGainEnabled;
+
+    // analyzer thread members
+    LoudnessMeter meter;
+    quint32 analyzedIntervals;
+    quint32 readSamples;
+    std::vector<float> leftChunk;
+    std::vector<float> rightChunk;
+
+    quint32 drain(quint32 maxSamples);
+    void finishInterval();
+};
+
+// ++++++++++++++++++++++++++++++++++++++++
+
+class LoudnessAnalyzer : public QThread
+{
+public:
+    LoudnessAnalyzer();
+    ~LoudnessAnalyzer();
+
+    void addAnalysis(const std::shared_ptr<LoudnessAnalysis> &analysis);
+
+    void stop();
+
+protected:
+    void run() override;
+
+private:
+    static const int ANALYSIS_PERIOD = 100; // in milliseconds
+
+    QList<std::shared_ptr<LoudnessAnalysis>> analysis;
+    QMutex mutex;
+    QAtomicInteger<int> stopRequested;
+};
+
+} // namespace
+
+#endif // LOUDNESS_ANALYZER_H
@@ -3,45 +3,131 @@
 #include "audio/core/AudioDriver.h"
 #include "audio/core/SamplesBuffer.h"
 
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define METRONOME_USE_SSE
+    #include <xmmintrin.h>
+#endif
+
 using audio::MetronomeTrackNode;
 using audio::SamplesBuffer;
 
+namespace {
+
+// the clicks can overlap (long click sounds in fast tempos), so the samples are added
+void mixClickSamples(const float *click, float *out, quint32 samples)
+{
+    quint32 s = 0;
+
+#ifdef METRONOME_USE_SSE
+    for (; s + 4 <= samples; s += 4)
+        _mm_storeu_ps(out + s, _mm_add_ps(_mm_loadu_ps(out + s), _mm_loadu_ps(click + s)));
+#endif
+
+    for (; s < samples; ++s)
+        out[s] += click[s];
+}
+
+} // namespace
+
+class MetronomeTrackNode::Sounds
+{
+public:
+    Sounds(const SamplesBuffer &firstBeat, const SamplesBuffer &offBeat, const SamplesBuffer &accentBeat) :
+        clicks { firstBeat, offBeat, accentBeat }
+    {
+
+    }
+
+    SamplesBuffer clicks[3]; // indexed by ClickType
+};
+
+class MetronomeTrackNode::Schedule
+{
+public:
+    Schedule() :
+        totalClicks(0),
+        firstActiveClick(0),
+        intervalLength(0),
+        renderedPosition(0)
+    {
+        std::fill(accents, accents + ACCENT_WORDS, 0);
+    }
+
+    struct Click
+    {
+        long start; // offset in interval, negative for the last click of the previous interval
+        ClickType type;
+    };
+
+    Click clicks[MAX_BEATS + 1]; // sorted by start, the first click can be the tail of the previous interval
+    int totalClicks;
+    int firstActiveClick; // the clicks before this index are already played
+
+    long intervalLength;
+    long renderedPosition; // the interval position after the last rendered block
+
+    quint32 accents[ACCENT_WORDS]; // accents used in the last consistent read
+};
+
 MetronomeTrackNode::MetronomeTrackNode(const SamplesBuffer &firstBeatSamples, const SamplesBuffer &offBeatSamples, const SamplesBuffer &accentBeatSamples) :
-    firstBeatBuffer(firstBeatSamples),
-    offBeatBuffer(offBeatSamples),
-    accentBeatBuffer(accentBeatSamples),
-    samplesPerBeat(0),
+    sounds(new Sounds(firstBeatSamples, offBeatSamples, accentBeatSamples)),
+    pendingSounds(nullptr),
+    retiredSounds(nullptr),
+    schedule(new Schedule()),
     intervalPosition(0),
-    beatPosition(0),
-    currentBeat(0),
+    intervalLayout(0),
+    accentsVersion(0),
     accentBeats(QList<int>())
 {
-    resetInterval();
+    for (int w = 0; w < ACCENT_WORDS; ++w)
+        accentMask[w].store(0);
 }
 
 MetronomeTrackNode::~MetronomeTrackNode()
 {
-
+    delete sounds;
+    delete pendingSounds.fetchAndStoreAcquire(nullptr);
+    delete retiredSounds.fetchAndStoreAcquire(nullptr);
+    delete schedule;
 }
 
-void MetronomeTrackNode::setPrimaryBeatSamples(const SamplesBuffer &firstBeatSamples)
+void MetronomeTrackNode::setClickSounds(const SamplesBuffer &firstBeatSamples, const SamplesBuffer &offBeatSamples, const SamplesBuffer &accentBeatSamples)
 {
-    firstBeatBuffer.set(firstBeatSamples);
-}
+    delete retiredSounds.fetchAndStoreAcquire(nullptr); // the audio thread is not using the replaced sounds
 
-void MetronomeTrackNode::setOffBeatSamples(const SamplesBuffer &offBeatSamples)
-{
-    offBeatBuffer.set(offBeatSamples);
+    Sounds *notUsedSounds = pendingSounds.fetchAndStoreOrdered(new Sounds(firstBeatSamples, offBeatSamples, accentBeatSamples));
+    delete notUsedSounds; // replaced before the next audio block
 }
 
-void MetronomeTrackNode::setAccentBeatSamples(const SamplesBuffer &accentBeatSamples)
+void MetronomeTrackNode::updateSounds()
 {
-    accentBeatBuffer.set(accentBeatSamples);
+    if (retiredSounds.load())
+        return; // waiting the GUI thread delete the last replaced sounds
+
+    Sounds *newSounds = pendingSounds.fetchAndStoreAcquire(nullptr);
+    if (newSounds) {
+        retiredSounds.storeRelease(sounds);
+        sounds = newSounds;
+    }
 }
 
 void MetronomeTrackNode::setAccentBeats(QList<int> accentBeats)
 {
     this->accentBeats = accentBeats;
+
+    quint32 newMask[ACCENT_WORDS] = { 0 };
+    for (int beat : accentBeats) {
+        if (beat > 0 && beat < MAX_BEATS) // the first beat is always using the first beat sound
+            newMask[beat / 32] |= quint32(1) << (beat % 32);
+    }
+
+    // the audio thread is discarding the accents read while the version is odd or changed
+    accentsVersion.fetchAndAddOrdered(1);
+    for (int w = 0; w < ACCENT_WORDS; ++w)
+        accentMask[w].storeRelease(newMask[w]);
+    accentsVersion.fetchAndAddOrdered(1);
 }
 
 QList<int> MetronomeTrackNode::getAccentBeats()
@@ -49,70 +135,127 @@ QList<int> MetronomeTrackNode::getAccentBeats()
     return accentBeats;
 }
 
-void MetronomeTrackNode::setSamplesPerBeat(long samplesPerBeat)
+void MetronomeTrackNode::setBeatsPerAccent(int beatsPerAccent, int currentBpi)
+{
+    setAccentBeats(metronomeUtils::getAccentBeats(beatsPerAccent, currentBpi));
+}
+
+void MetronomeTrackNode::setIntervalLength(long samplesInInterval, int bpi)
 {
-    if (samplesPerBeat <= 0)
-        qCritical() << "samples per beat <= 0";
+    if (samplesInInterval <= 0 || bpi <= 0) {
+        qCritical() << "Invalid metronome interval length:" << samplesInInterval << "samples and" << bpi << "beats";
+        return;
+    }
 
-    this->samplesPerBeat = samplesPerBeat;
-    resetInterval();
+    intervalLayout.storeRelease((quint64(samplesInInterval) << 32) | quint32(bpi));
 }
 
-void MetronomeTrackNode::resetInterval()
+MetronomeTrackNode::ClickType MetronomeTrackNode::getClickType(int beat, const quint32 *accents) const
 {
-    beatPosition = intervalPosition = 0;
+    if (beat == 0)
+        return FirstBeat;
+
+    if (accents[beat / 32] & (quint32(1) << (beat % 32)))
+        return AccentBeat;
+
+    return OffBeat;
 }
 
-void MetronomeTrackNode::setBeatsPerAccent(int beatsPerAccent, int currentBpi)
+void MetronomeTrackNode::updateSchedule()
 {
-    setAccentBeats(metronomeUtils::getAccentBeats(beatsPerAccent, currentBpi));
+    // the last click of the previous interval can be still playing
+    Schedule::Click tail = { 0, OffBeat };
+    bool hasTail = false;
+    if (schedule->totalClicks > 0 && schedule->renderedPosition == schedule->intervalLength) {
+        const Schedule::Click &lastClick = schedule->clicks[schedule->totalClicks - 1];
+        tail.start = lastClick.start - schedule->intervalLength;
+        tail.type = lastClick.type;
+        hasTail = tail.start + static_cast<long>(sounds->clicks[tail.type].getFrameLenght()) > 0;
+    }
+
+    const quint64 layout = intervalLayout.loadAcquire();
+    const long length = static_cast<long>(layout >> 32);
+    const int bpi = std::min(static_cast<int>(layout & 0xFFFFFFFF), static_cast<int>(MAX_BEATS));
+
+    const quint32 version = accentsVersion.loadAcquire();
+    quint32 accents[ACCENT_WORDS];
+    for (int w = 0; w < ACCENT_WORDS; ++w)
+        accents[w] = accentMask[w].loadAcquire();
+
+    if (!(version & 1) && version == accentsVersion.loadAcquire())
+        std::copy(accents, accents + ACCENT_WORDS, schedule->accents); // otherwise the accents are changing right now, the last accents are used
+
+    schedule->intervalLength = length;
+    schedule->renderedPosition = 0;
+    schedule->firstActiveClick = 0;
+    schedule->totalClicks = 0;
+
+    if (length <= 0 || bpi <= 0)
+        return; // tempo is unknown
+
+    if (hasTail)
+        schedule->clicks[schedule->totalClicks++] = tail;
+
+    for (int beat = 0; beat < bpi; ++beat) {
+        Schedule::Click &click = schedule->clicks[schedule->totalClicks++];
+        click.start = static_cast<long>(static_cast<qint64>(length) * beat / bpi); // sample accurate, no accumulated rounding
+        click.type = getClickType(beat, schedule->accents);
+    }
 }
 
 void MetronomeTrackNode::setIntervalPosition(long intervalPosition)
 {
-    if (samplesPerBeat <= 0)
-        return;
+    if (intervalPosition == 0 || schedule->intervalLength <= 0)
+        updateSchedule(); // new interval, tempo and accents changes are applied here
+    else if (intervalPosition < this->intervalPosition)
+        schedule->firstActiveClick = 0;
 
     this->intervalPosition = intervalPosition;
-    this->beatPosition = intervalPosition % samplesPerBeat;
-    this->currentBeat = (intervalPosition / samplesPerBeat);
 }
 
-SamplesBuffer *MetronomeTrackNode::getSamplesBuffer(int beat)
+void MetronomeTrackNode::renderClicks(SamplesBuffer &buffer, quint32 frames)
 {
-    if (beat == 0) {
-        return &firstBeatBuffer;
-    }
-    if (this->accentBeats.contains(beat)) {
-        return &accentBeatBuffer;
+    const long blockStart = intervalPosition;
+    const long blockEnd = blockStart + static_cast<long>(frames);
+
+    for (int i = schedule->firstActiveClick; i < schedule->totalClicks; ++i) {
+        const Schedule::Click &click = schedule->clicks[i];
+        if (click.start >= blockEnd)
+            break; // the next clicks are starting in the next blocks
+
+        const SamplesBuffer &sound = sounds->clicks[click.type];
+        const long clickEnd = click.start + static_cast<long>(sound.getFrameLenght());
+        if (clickEnd <= blockStart) {
+            if (i == schedule->firstActiveClick)
+                schedule->firstActiveClick++; // skipping the played clicks in the next blocks
+            continue;
+        }
+
+        const long from = std::max(click.start, blockStart);
+        const quint32 samples = static_cast<quint32>(std::min(clickEnd, blockEnd) - from);
+        for (int c = 0; c < buffer.getChannels(); ++c) {
+            const float *clickSamples = sound.getSamplesArray(sound.isMono() ? 0 : c) + (from - click.start);
+            mixClickSamples(clickSamples, buffer.getSamplesArray(c) + (from - blockStart), samples);
+        }
     }
-    return &offBeatBuffer;
 }
 
 void MetronomeTrackNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
                                           int SampleRate, std::vector<midi::MidiMessage> &midiBuffer)
 {
-    if (samplesPerBeat <= 0)
+    updateSounds();
+
+    if (schedule->intervalLength <= 0)
         return;
 
-    internalInputBuffer.setFrameLenght(out.getFrameLenght());
+    const quint32 frames = out.getFrameLenght();
+
+    internalInputBuffer.setFrameLenght(frames);
     internalInputBuffer.zero();
 
-    auto samplesBuffer = getSamplesBuffer(currentBeat);
-    uint samplesToCopy = qMin(static_cast<uint>(samplesBuffer->getFrameLenght() - beatPosition), out.getFrameLenght());
-    int nextBeatSample = beatPosition + out.getFrameLenght();
-    int internalOffset = 0;
-    int samplesBufferOffset = beatPosition;
-    if (nextBeatSample > samplesPerBeat) { // next beat starting in this audio buffer?
-        samplesBuffer = getSamplesBuffer(currentBeat + 1);
-        internalOffset = samplesPerBeat - beatPosition;
-        samplesToCopy = std::min(nextBeatSample - samplesPerBeat,
-                                 (long)samplesBuffer->getFrameLenght());
-        samplesBufferOffset = 0;
-    }
+    renderClicks(internalInputBuffer, frames);
+
+    schedule->renderedPosition = intervalPosition + static_cast<long>(frames);
 
-    if (samplesToCopy > 0)
-        internalInputBuffer.set(*samplesBuffer, samplesBufferOffset, samplesToCopy,
-                                internalOffset);
     AudioNode::processReplacing(in, out, SampleRate, midiBuffer);
 }
@@ -3,10 +3,20 @@
 
 #include "core/AudioNode.h"
 
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+
 namespace audio {
 
 class SamplesBuffer;
 
+/**
+    The clicks of each interval are scheduled (sample accurate beat positions and click sounds) when
+    the interval starts, and the audio blocks are rendered copying the click sounds in the scheduled
+    offsets. Tempo and accents changes are stored in atomics and used in the next interval, the click
+    sounds are replaced without recreating the node, so the audio thread is never allocating memory.
+ */
+
 class MetronomeTrackNode : public audio::AudioNode
 {
 
@@ -15,35 +25,54 @@ public:
 
     ~MetronomeTrackNode();
     void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate, std::vector<midi::MidiMessage> &midiBuffer) override;
-    void setSamplesPerBeat(long samplesPerBeat);
+    void setIntervalLength(long samplesInInterval, int bpi); // used in the next interval
     void setIntervalPosition(long intervalPosition);
-    void resetInterval();
 
     void setBeatsPerAccent(int beatsPerAccent, int currentBpi); // pass zero to turn off accents
 
     bool isPlayingAccents() const;
 
-    int getBeatsPerAccent() const; // will return zero even if isPlayingAccents() when pattern is uneven
-
     void setAccentBeats(QList<int> accents); // pass empty list to turn off accents
     QList<int> getAccentBeats(); // returns the beats with accents
 
-    void setPrimaryBeatSamples(const audio::SamplesBuffer &firstBeatSamples);
-    void setOffBeatSamples(const audio::SamplesBuffer &offBeatSamples);
-    void setAccentBeatSamples(const audio::SamplesBuffer &accentBeatSamples);
+    // the new sounds are used in the next processed block, called from the GUI thread
+    void setClickSounds(const audio::SamplesBuffer &firstBeatSamples, const audio::SamplesBuffer &offBeatSamples, const SamplesBuffer &accentBeatSamples);
+
+    static const int MAX_BEATS = 192; // the max BPI accepted by ninjam servers
 
 private:
-    SamplesBuffer firstBeatBuffer;
-    SamplesBuffer offBeatBuffer;
-    SamplesBuffer accentBeatBuffer;
+    enum ClickType
+    {
+        FirstBeat, OffBeat, AccentBeat
+    };
+
+    class Sounds;
+    class Schedule;
+
+    Sounds *sounds; // used in the audio thread
+    QAtomicPointer<Sounds> pendingSounds; // created in the GUI thread
+    QAtomicPointer<Sounds> retiredSounds; // deleted in the GUI thread
+
+    Schedule *schedule; // the clicks in the current interval
 
-    long samplesPerBeat;
     long intervalPosition;
-    long beatPosition;
-    int currentBeat;
-    QList<int> accentBeats = QList<int>();
 
-    SamplesBuffer *getSamplesBuffer(int beat); // return the correct buffer to play in each beat
+    // packed interval length (high 32 bits) and BPI (low 32 bits), changed in the same atomic store
+    QAtomicInteger<quint64> intervalLayout;
+
+    // accent beats bits in 32 bits words (lock free in 32 bits platforms), the version is odd when the accents are being written
+    static const int ACCENT_WORDS = MAX_BEATS / 32;
+    QAtomicInteger<quint32> accentMask[ACCENT_WORDS];
+    QAtomicInteger<quint32> accentsVersion;
+
+    QList<int> accentBeats; // GUI thread copy
+
+    void updateSounds();
+    void updateSchedule(); // called when the interval starts
+
+    ClickType getClickType(int beat, const quint32 *accents) const;
+
+    void renderClicks(SamplesBuffer &buffer, quint32 frames);
 };
 
 inline bool MetronomeTrackNode::isPlayingAccents() const
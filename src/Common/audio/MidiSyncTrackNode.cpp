@@ -3,6 +3,7 @@
 #include "MetronomeUtils.h"
 #include "audio/core/AudioDriver.h"
 #include <algorithm>
+#include <cmath>
 
 using audio::MidiSyncTrackNode;
 using audio::SamplesBuffer;
@@ -13,7 +14,6 @@ MidiSyncTrackNode::MidiSyncTrackNode(MainController *controller) :
     pulsesPerInterval(0),
     samplesPerPulse(0),
     intervalPosition(0),
-    currentPulse(0),
     lastPlayedPulse(-1),
     running(false),
     hasSentStart(false),
@@ -48,7 +48,6 @@ void MidiSyncTrackNode::setIntervalPosition(long intervalPosition)
         return;
 
     this->intervalPosition = intervalPosition;
-    this->currentPulse = ((double)intervalPosition / samplesPerPulse);
 }
 
 void MidiSyncTrackNode::start()
@@ -69,18 +68,28 @@ void MidiSyncTrackNode::processReplacing(const SamplesBuffer &in, SamplesBuffer
     if (pulsesPerInterval <= 0 || samplesPerPulse <= 0)
         return;
 
-    if (currentPulse == 0 && currentPulse != lastPlayedPulse) {
+    // the pulses are scheduled in their exact sample position, the MidiClockScheduler will send them in precise time
+    const quint64 blockPosition = mainController->getAudioBlockPosition();
+
+    if (intervalPosition == 0) { // new interval
         if (running && !hasSentStart) {
-            mainController->startMidiClock();
+            mainController->startMidiClock(blockPosition);
             hasSentStart = true;
         }
 //        qDebug() << "Pulses played in interval: " << lastPlayedPulse;
         lastPlayedPulse = -1;
     }
 
-    while (currentPulse < pulsesPerInterval && currentPulse - lastPlayedPulse >= 1) {
-        mainController->sendMidiClockPulse();
+    const long blockEnd = intervalPosition + out.getFrameLenght();
+    while (lastPlayedPulse + 1 < pulsesPerInterval) {
+        const long pulsePosition = static_cast<long>(std::ceil((lastPlayedPulse + 1) * samplesPerPulse));
+        if (pulsePosition >= blockEnd)
+            break; // the next pulse is in the next audio blocks
+
+        const long pulseOffset = std::max(0L, pulsePosition - intervalPosition);
+        mainController->sendMidiClockPulse(blockPosition + pulseOffset);
         lastPlayedPulse++;
     }
+
     AudioNode::processReplacing(in, out, SampleRate, midiBuffer);
 }
@@ -30,8 +30,7 @@ private:
     long pulsesPerInterval;
     double samplesPerPulse;
     long intervalPosition;
-    int currentPulse;
-    int lastPlayedPulse;
+    long lastPlayedPulse;
     bool running;
     bool hasSentStart;
 
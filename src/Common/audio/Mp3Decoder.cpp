@@ -70,7 +70,7 @@ const SamplesBuffer Mp3DecoderMiniMp3::decode(char *inputBuffer, int inputBuffer
         }
     } while (bytesDecoded > 0 && bytesLeft > 0);
 
-    array = array.right(array.size() - totalBytesDecoded); // keep just the undecoded bytes to the next call for decode
+    array.remove(0, totalBytesDecoded); // keep just the undecoded bytes to the next call for decode, the capacity is reused
     if (totalBytesDecoded <= 0)
         return SamplesBuffer::ZERO_BUFFER;
 
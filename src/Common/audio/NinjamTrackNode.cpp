@@ -10,6 +10,7 @@
 
 #include "audio/core/Filters.h"
 #include "audio/core/AudioDriver.h"
+#include "audio/LoudnessAnalyzer.h"
 #include "audio/vorbis/VorbisDecoder.h"
 
 
@@ -17,6 +18,7 @@ const double NinjamTrackNode::LOW_CUT_DRASTIC_FREQUENCY = 220.0; // in Hertz
 const double NinjamTrackNode::LOW_CUT_NORMAL_FREQUENCY = 120.0; // in Hertz
 
 using audio::Filter;
+using audio::MultiChannelFilter;
 
 class NinjamTrackNode::LowCutFilter
 {
@@ -28,16 +30,16 @@ public:
     void setState(NinjamTrackNode::LowCutState state);
 private:
     NinjamTrackNode::LowCutState state;
-    Filter leftFilter;
-    Filter rightFilter;
+    double sampleRate;
+    MultiChannelFilter filter; // left and right channels computed in the same pass
 };
 
 NinjamTrackNode::LowCutFilter::LowCutFilter(double sampleRate) :
     state(LowCutState::Off),
-    leftFilter(Filter::FilterType::HighPass, sampleRate, LOW_CUT_NORMAL_FREQUENCY, 1.0, 1.0),
-    rightFilter(Filter::FilterType::HighPass, sampleRate, LOW_CUT_NORMAL_FREQUENCY, 1.0, 1.0)
+    sampleRate(sampleRate),
+    filter(2, 1)
 {
-
+    filter.setStage(0, Filter::computeCoefficients(Filter::HighPass, sampleRate, LOW_CUT_NORMAL_FREQUENCY, 1.0, 1.0));
 }
 
 void NinjamTrackNode::LowCutFilter::setState(NinjamTrackNode::LowCutState state)
@@ -48,8 +50,7 @@ void NinjamTrackNode::LowCutFilter::setState(NinjamTrackNode::LowCutState state)
         if (state == LowCutState::Drastic)
             frequency = LOW_CUT_DRASTIC_FREQUENCY;
 
-        leftFilter.setFrequency(frequency);
-        rightFilter.setFrequency(frequency);
+        filter.setStage(0, Filter::computeCoefficients(Filter::HighPass, sampleRate, frequency, 1.0, 1.0));
     }
 }
 
@@ -58,10 +59,7 @@ void NinjamTrackNode::LowCutFilter::process(audio::SamplesBuffer &buffer)
     if (state == LowCutState::Off)
         return;
 
-    quint32 samples = buffer.getFrameLenght();
-    leftFilter.process(buffer.getSamplesArray(0), samples);
-    if (!buffer.isMono())
-        rightFilter.process(buffer.getSamplesArray(1), samples);
+    filter.process(buffer); // mono buffers are processing only the first channel
 }
 
 //--------------------------------------------------------------------------
@@ -173,7 +171,9 @@ NinjamTrackNode::NinjamTrackNode(int ID) :
     lowCut(new NinjamTrackNode::LowCutFilter(44100)),
     //processingLastPartOfInterval(false),
     currentDecoder(nullptr),
-    decodersMutex(QMutex::NonRecursive)
+    decodersMutex(QMutex::NonRecursive),
+    loudnessAnalysis(new audio::LoudnessAnalysis()),
+    autoGain(1.0f)
 {
 
 }
@@ -295,6 +295,8 @@ bool NinjamTrackNode::startNewInterval()
         decodersMutex.unlock();
     }
 
+    loudnessAnalysis->startNewInterval();
+
     return isPlaying();
 }
 
@@ -428,6 +430,8 @@ void NinjamTrackNode::processReplacing(const audio::SamplesBuffer &in, audio::Sa
     }
 
     if (!internalInputBuffer.isEmpty()) {
+        loudnessAnalysis->write(internalInputBuffer, getSampleRate()); // just copying the decoded samples, the analysis is done in another thread
+
         if (needResamplingFor(sampleRate)) {
             const auto &resampledBuffer = resampler.resample(internalInputBuffer, out.getFrameLenght());
             internalInputBuffer.setFrameLenght(resampledBuffer.getFrameLenght());
@@ -440,6 +444,39 @@ void NinjamTrackNode::processReplacing(const audio::SamplesBuffer &in, audio::Sa
     }
 }
 
+void NinjamTrackNode::preFaderProcess(audio::SamplesBuffer &out)
+{
+    const float targetGain = loudnessAnalysis->getAutoGain();
+    if (autoGain == 1.0f && targetGain == 1.0f)
+        return;
+
+    out.fade(autoGain, targetGain); // ramping to avoid clicks when the auto gain changes
+    autoGain = targetGain;
+}
+
+void NinjamTrackNode::setAutoGainEnabled(bool enabled)
+{
+    loudnessAnalysis->setAutoGainEnabled(enabled);
+}
+
+void NinjamTrackNode::setInitialLoudness(float loudness)
+{
+    loudnessAnalysis->setInitialLoudness(loudness);
+}
+
+float NinjamTrackNode::getLoudness() const
+{
+    return loudnessAnalysis->getLoudness();
+}
+
+float NinjamTrackNode::getAutoGainInDb() const
+{
+    if (!loudnessAnalysis->isAutoGainEnabled())
+        return 0.0f;
+
+    return loudnessAnalysis->getAutoGainInDb();
+}
+
 bool NinjamTrackNode::needResamplingFor(int targetSampleRate) const
 {
     if (currentDecoder)
@@ -6,9 +6,12 @@
 #include "SamplesBufferResampler.h"
 #include "readerwriterqueue.h"
 
+#include <memory>
+
 namespace audio {
 class SamplesBuffer;
 class StreamBuffer;
+class LoudnessAnalysis;
 }
 
 class NinjamTrackNode : public audio::AudioNode
@@ -58,10 +61,19 @@ public:
 
     void stopDecoding();
 
+    // loudness normalization, the loudness is measured in the LoudnessAnalyzer thread
+    std::shared_ptr<audio::LoudnessAnalysis> getLoudnessAnalysis() const;
+    void setAutoGainEnabled(bool enabled);
+    void setInitialLoudness(float loudness);
+    float getLoudness() const;
+    float getAutoGainInDb() const;
+
     //void setProcessingLastPartOfInterval(bool status);
 
 protected:
 
+    void preFaderProcess(audio::SamplesBuffer &out) override;
+
     class TrackNodeCommand {
     protected:
         TrackNodeCommand(NinjamTrackNode *node);
@@ -103,6 +115,9 @@ private:
 
     void consumePendingEvents();
 
+    std::shared_ptr<audio::LoudnessAnalysis> loudnessAnalysis;
+    float autoGain; // current linear auto gain, ramped to the analysis auto gain in each processed buffer
+
 };
 
 
@@ -111,4 +126,9 @@ inline int NinjamTrackNode::getID() const
     return ID;
 }
 
+inline std::shared_ptr<audio::LoudnessAnalysis> NinjamTrackNode::getLoudnessAnalysis() const
+{
+    return loudnessAnalysis;
+}
+
 #endif // NINJAMTRACKNODE_H
@@ -16,6 +16,7 @@
 #include <cmath>
 #include <QMutexLocker>
 #include <QFile>
+#include <QtConcurrent/QtConcurrent>
 
 namespace audio {
 class Mp3Decoder;
@@ -29,35 +30,151 @@ using audio::Mp3DecoderMiniMp3;
 using audio::SamplesBuffer;
 
 const int AbstractMp3Streamer::MAX_BYTES_PER_DECODING = 2048;
+const int AbstractMp3Streamer::MAX_FRAMES_PER_DECODING = 8192; // the decoder internal buffer size
+const int AbstractMp3Streamer::DECODE_AHEAD_MS = 500;
+const int AbstractMp3Streamer::DECODING_POLL_MS = 5;
+const quint32 AbstractMp3Streamer::INPUT_RING_SIZE = 256 * 1024;
 
 // +++++++++++++
 AbstractMp3Streamer::AbstractMp3Streamer(Mp3Decoder *decoder) :
+    stopDecodingRequested(0),
+    wakeRequested(0),
+    bytesToDecode(MAX_BYTES_PER_DECODING),
     decoder(decoder),
     device(nullptr),
     streaming(false),
-    bufferedSamples(2, 4096)
+    inputBytes(INPUT_RING_SIZE),
+    leftSamples(MAX_FRAMES_PER_DECODING * 8), // 65536 frames, more than DECODE_AHEAD_MS + one decoded chunk at 48 KHz
+    rightSamples(MAX_FRAMES_PER_DECODING * 8),
+    underflows(0),
+    receivedBytes(0),
+    decodedFrames(0)
 {
-    bufferedSamples.setFrameLenght(0);// reset internal offset
+    decodingThreadPool.setMaxThreadCount(1);
 }
 
 AbstractMp3Streamer::~AbstractMp3Streamer()
 {
+    stopDecoding();
     delete decoder;
 }
 
+void AbstractMp3Streamer::startDecoding()
+{
+    if (decodingFuture.isRunning())
+        return;
+
+    stopDecodingRequested.store(0);
+    decodingFuture = QtConcurrent::run(&decodingThreadPool, this, &AbstractMp3Streamer::decodingLoop);
+}
+
+void AbstractMp3Streamer::stopDecoding()
+{
+    stopDecodingRequested.store(1);
+    wakeDecodingThread();
+    decodingFuture.waitForFinished();
+}
+
+void AbstractMp3Streamer::wakeDecodingThread()
+{
+    wakeRequested.storeRelease(1);
+
+    // the mutex is locked by the decoding thread only while checking 'wakeRequested', in this case the decoding thread is not waiting
+    if (decodingMutex.tryLock()) {
+        decodingCondition.wakeOne();
+        decodingMutex.unlock();
+    }
+}
+
+void AbstractMp3Streamer::decodingLoop()
+{
+    while (!stopDecodingRequested.load()) {
+
+        if (inputBytes.getFree() >= static_cast<quint32>(MAX_BYTES_PER_DECODING))
+            fillInputBytes();
+
+        // stay DECODE_AHEAD_MS ahead of the audio callback, and always keep room for a complete decoded chunk
+        const quint32 framesAhead = getSampleRate() * DECODE_AHEAD_MS / 1000;
+        bool decoded = false;
+        if (getDecodedFrames() < framesAhead && leftSamples.getFree() >= static_cast<quint32>(MAX_FRAMES_PER_DECODING))
+            decoded = decodeNextChunk();
+
+        if (!decoded) {
+            QMutexLocker locker(&decodingMutex);
+            if (!stopDecodingRequested.load() && !wakeRequested.fetchAndStoreAcquire(0))
+                decodingCondition.wait(&decodingMutex, DECODING_POLL_MS);
+
+            wakeRequested.store(0);
+        }
+    }
+}
+
+bool AbstractMp3Streamer::decodeNextChunk()
+{
+    const quint32 bytesRead = inputBytes.read(&bytesToDecode[0], MAX_BYTES_PER_DECODING);
+    if (!bytesRead)
+        return false;
+
+    const auto &decodedBuffer = decoder->decode(&bytesToDecode[0], bytesRead);
+    const quint32 frames = decodedBuffer.getFrameLenght();
+    if (frames > 0) {
+        const quint32 rightChannel = decodedBuffer.isMono() ? 0 : 1;
+        rightSamples.write(decodedBuffer.getSamplesArray(rightChannel), frames);
+        leftSamples.write(decodedBuffer.getSamplesArray(0), frames); // the audio thread uses the left ring to check the available frames
+        decodedFrames.fetchAndAddRelaxed(frames);
+    }
+
+    return true;
+}
+
+void AbstractMp3Streamer::fillInputBytes()
+{
+    // nothing to do in base class
+}
+
+quint32 AbstractMp3Streamer::getDecodedFrames() const
+{
+    return std::min(leftSamples.getAvailable(), rightSamples.getAvailable());
+}
+
+AbstractMp3Streamer::Statistics AbstractMp3Streamer::getStatistics() const
+{
+    Statistics statistics;
+    statistics.bufferedBytes = inputBytes.getAvailable();
+    statistics.bufferedFrames = getDecodedFrames();
+    statistics.underflows = underflows.load();
+    statistics.receivedBytes = receivedBytes.load();
+    statistics.decodedFrames = decodedFrames.load();
+    return statistics;
+}
+
 void AbstractMp3Streamer::stopCurrentStream()
 {
     qCDebug(jtNinjamRoomStreamer) << "stopping room stream";
 
+    stopDecoding(); // the decoding thread is not touching the rings after this point
+
+    QMutexLocker locker(&mutex); // wait the audio thread
+
     if (device) {
         decoder->reset();// discard unprocessed bytes
         device->deleteLater();
         device = nullptr;
-        bufferedSamples.zero();// discard samples
         streaming = false;
+
+        const Statistics statistics = getStatistics();
+        qCDebug(jtNinjamRoomStreamer) << "stream statistics - received bytes:" << statistics.receivedBytes
+                                      << "decoded frames:" << statistics.decodedFrames
+                                      << "underflows:" << statistics.underflows;
     }
-    bytesToDecode.clear();
-    lastPeak.zero();
+
+    inputBytes.clear();
+    leftSamples.clear();
+    rightSamples.clear();
+    underflows.store(0);
+    receivedBytes.store(0);
+    decodedFrames.store(0);
+    meter.reset();
 }
 
 int AbstractMp3Streamer::getSamplesToRender(int targetSampleRate, int outLenght)
@@ -72,32 +189,43 @@ void AbstractMp3Streamer::processReplacing(const SamplesBuffer &in, SamplesBuffe
 {
     Q_UNUSED(in);
 
-    if (bufferedSamples.isEmpty() || !streaming)
+    if (!streaming)
+        return;
+
+    if (!mutex.tryLock()) // the stream is stopping in the main thread, skip this callback instead of blocking
         return;
 
-    int samplesToRender = getSamplesToRender(targetSampleRate, out.getFrameLenght());
-    if (samplesToRender <= 0)
+    const int samplesToRender = getSamplesToRender(targetSampleRate, out.getFrameLenght());
+    const quint32 availableFrames = getDecodedFrames();
+    if (samplesToRender <= 0 || !availableFrames) {
+        mutex.unlock();
         return;
+    }
+
+    if (availableFrames < static_cast<quint32>(samplesToRender)) {
+        underflows.fetchAndAddRelaxed(1);
+        qCDebug(jtNinjamRoomStreamer) << samplesToRender - availableFrames << " samples missing";
+    }
 
-    internalInputBuffer.setFrameLenght(samplesToRender);
-    internalInputBuffer.set(bufferedSamples);
+    const quint32 frames = std::min(availableFrames, static_cast<quint32>(samplesToRender));
+    internalInputBuffer.setFrameLenght(frames);
+    leftSamples.read(internalInputBuffer.getSamplesArray(0), frames);
+    rightSamples.read(internalInputBuffer.getSamplesArray(1), frames);
+
+    mutex.unlock();
+
+    wakeDecodingThread(); // space available in the PCM ring
 
     if (needResamplingFor(targetSampleRate)) {
         const auto &resampledBuffer = resampler.resample(internalInputBuffer, out.getFrameLenght());
         internalOutputBuffer.setFrameLenght(resampledBuffer.getFrameLenght());
         internalOutputBuffer.set(resampledBuffer);
     } else {
-        internalOutputBuffer.setFrameLenght(out.getFrameLenght());
+        internalOutputBuffer.setFrameLenght(frames);
         internalOutputBuffer.set(internalInputBuffer);
     }
 
-    bufferedSamples.discardFirstSamples(samplesToRender);// keep non rendered samples for next audio callback
-
-    if (internalOutputBuffer.getFrameLenght() < out.getFrameLenght())
-        qCDebug(jtNinjamRoomStreamer) << out.getFrameLenght()
-            - internalOutputBuffer.getFrameLenght() << " samples missing";
-
-    this->lastPeak.update(internalOutputBuffer.computePeak());
+    meter.publish(internalOutputBuffer.computePeak());
 
     out.add(internalOutputBuffer);
 }
@@ -119,36 +247,12 @@ bool AbstractMp3Streamer::needResamplingFor(int targetSampleRate) const
     return targetSampleRate != getSampleRate();
 }
 
-void AbstractMp3Streamer::decode(const unsigned int maxBytesToDecode)
-{
-    if (!device)
-        return;
-    qint64 totalBytesToProcess = std::min((int)maxBytesToDecode, bytesToDecode.size());
-    char *in = bytesToDecode.data();
-
-    if (totalBytesToProcess > 0) {
-        int bytesProcessed = 0;
-        while (bytesProcessed < totalBytesToProcess) {// split bytesReaded in chunks to avoid a very large decoded buffer
-            // chunks maxsize is 2048 bytes
-            int bytesToProcess = std::min((int)(totalBytesToProcess - bytesProcessed),
-                                          MAX_BYTES_PER_DECODING);
-            const auto &decodedBuffer = decoder->decode(in, bytesToProcess);
-
-            // prepare in for the next decoding
-            in += bytesToProcess;
-            bytesProcessed += bytesToProcess;
-            // +++++++++++++++++  PROCESS DECODED SAMPLES ++++++++++++++++
-            bufferedSamples.append(decodedBuffer);
-        }
-
-        bytesToDecode = bytesToDecode.right(bytesToDecode.size() - bytesProcessed);
-    }
-}
-
 void AbstractMp3Streamer::setStreamPath(const QString &streamPath)
 {
     stopCurrentStream();
     initialize(streamPath);
+    if (streaming)
+        startDecoding();
 }
 
 // +++++++++++++++++++++++++++++++++++++++
@@ -158,7 +262,10 @@ const int NinjamRoomStreamerNode::BUFFER_SIZE = 128000;
 NinjamRoomStreamerNode::NinjamRoomStreamerNode(const QUrl &streamPath) :
     AbstractMp3Streamer(new Mp3DecoderMiniMp3()),
     httpClient(nullptr),
-    buffering(false)
+    buffering(0),
+    deviceReadRequested(0),
+    deviceBytesPending(0),
+    deviceReadChunk(16384)
 {
     setStreamPath(streamPath.toString());
 }
@@ -174,9 +281,9 @@ void NinjamRoomStreamerNode::initialize(const QString &streamPath)
 {
     AbstractMp3Streamer::initialize(streamPath);
 
-    buffering = true;
-    bufferedSamples.zero();
-    bytesToDecode.clear();
+    buffering.store(1);
+    deviceReadRequested.store(0);
+    deviceBytesPending.store(0);
 
     if (!streamPath.isEmpty()) {
 
@@ -196,18 +303,39 @@ void NinjamRoomStreamerNode::on_reply_error(QNetworkReply::NetworkError /*error*
     emit error(msg);
 }
 
+void NinjamRoomStreamerNode::fillInputBytes()
+{
+    // called in the decoding thread, the network reply is read in the main thread. The new bytes are read
+    // in the 'readyRead' signal, so the main thread is called only when some bytes are waiting in the reply
+    if (deviceBytesPending.load() && deviceReadRequested.testAndSetOrdered(0, 1))
+        QMetaObject::invokeMethod(this, "on_reply_read", Qt::QueuedConnection);
+}
+
 void NinjamRoomStreamerNode::on_reply_read()
 {
+    deviceReadRequested.store(0);
+
     if (!device) {
         qCDebug(jtNinjamRoomStreamer) << "device is null!";
         return;
     }
     if (device->isOpen() && device->isReadable()) {
-        QMutexLocker locker(&mutex);
-        bytesToDecode.append(device->readAll());
-        if (buffering) {
-            qCDebug(jtNinjamRoomStreamer) << "bytes downloaded  bytesToDecode:"<<bytesToDecode.size()
-                                      << " bufferedSamples: " << bufferedSamples.getFrameLenght();
+        // read in fixed chunks, the bytes not fitting in the ring stay in the reply until the decoding thread ask for more
+        while (device->bytesAvailable() > 0 && inputBytes.getFree() > 0) {
+            const qint64 maxBytes = std::min(static_cast<qint64>(inputBytes.getFree()), static_cast<qint64>(deviceReadChunk.size()));
+            const qint64 bytesRead = device->read(&deviceReadChunk[0], maxBytes);
+            if (bytesRead <= 0)
+                break;
+
+            inputBytes.write(&deviceReadChunk[0], bytesRead);
+            receivedBytes.fetchAndAddRelaxed(bytesRead);
+        }
+
+        deviceBytesPending.store(device->bytesAvailable() > 0 ? 1 : 0);
+
+        if (buffering.load()) {
+            qCDebug(jtNinjamRoomStreamer) << "bytes downloaded  bytesToDecode:" << inputBytes.getAvailable()
+                                      << " bufferedSamples: " << getDecodedFrames();
         }
     } else {
         qCritical() << "problem in device!";
@@ -216,36 +344,36 @@ void NinjamRoomStreamerNode::on_reply_read()
 
 NinjamRoomStreamerNode::~NinjamRoomStreamerNode()
 {
+    stopDecoding(); // avoid calls to fillInputBytes while this instance is destroyed
 }
 
 void NinjamRoomStreamerNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
                                               int sampleRate, std::vector<midi::MidiMessage> &midiBuffer)
 {
     Q_UNUSED(in)
-    QMutexLocker locker(&mutex);
-    if (buffering && bytesToDecode.size() >= BUFFER_SIZE)
-        buffering = false;
-    if (!buffering && bytesToDecode.isEmpty())
-        buffering = true;
-    if (buffering)
+
+    const quint32 bufferedBytes = inputBytes.getAvailable();
+    if (buffering.load() && (bufferedBytes >= static_cast<quint32>(BUFFER_SIZE) || inputBytes.getFree() == 0))
+        buffering.store(0);
+
+    if (buffering.load())
+        return;
+
+    const uint samplesToRender = getSamplesToRender(sampleRate, out.getFrameLenght());
+    if (getDecodedFrames() < samplesToRender && bufferedBytes == 0) { // no more bytes to decode
+        qCritical() << "no more bytes to decode and not enough buffered samples. Buffering ...";
+        underflows.fetchAndAddRelaxed(1);
+        buffering.store(1);
         return;
-    uint samplesToRender = getSamplesToRender(sampleRate, out.getFrameLenght());
-    while (bufferedSamples.getFrameLenght() < samplesToRender) {// need decoding?
-        decode(256);
-        if (bytesToDecode.isEmpty()) {// no more bytes to decode
-            qCritical() << "no more bytes to decode and not enough buffered samples. Buffering ...";
-            buffering = true;
-            break;
-        }
     }
-    if (!bufferedSamples.isEmpty())
-        AbstractMp3Streamer::processReplacing(in, out, sampleRate, midiBuffer);
+
+    AbstractMp3Streamer::processReplacing(in, out, sampleRate, midiBuffer);
 }
 
 int NinjamRoomStreamerNode::getBufferingPercentage() const
 {
-    if (buffering)
-        return bytesToDecode.size()/(float)BUFFER_SIZE * 100;
+    if (buffering.load())
+        return inputBytes.getAvailable()/(float)BUFFER_SIZE * 100;
 
     if (!streaming)
         return 0;
@@ -254,7 +382,8 @@ int NinjamRoomStreamerNode::getBufferingPercentage() const
 
 // ++++++++++++++++++
 AudioFileStreamerNode::AudioFileStreamerNode(const QString &file) :
-    AbstractMp3Streamer(new Mp3DecoderMiniMp3())
+    AbstractMp3Streamer(new Mp3DecoderMiniMp3()),
+    fileReadChunk(16384)
 {
     setStreamPath(file);
 }
@@ -266,20 +395,35 @@ void AudioFileStreamerNode::initialize(const QString &streamPath)
     if (!f->open(QIODevice::ReadOnly))
         qCritical() << "error opening the file " << streamPath;
     this->device = f;
-    bytesToDecode.append(f->readAll());
+}
+
+void AudioFileStreamerNode::fillInputBytes()
+{
+    // the file is read in chunks in the decoding thread
+    if (!device || !device->isOpen())
+        return;
+
+    const qint64 maxBytes = std::min(static_cast<qint64>(inputBytes.getFree()), static_cast<qint64>(fileReadChunk.size()));
+    const qint64 bytesRead = device->read(&fileReadChunk[0], maxBytes);
+    if (bytesRead > 0) {
+        inputBytes.write(&fileReadChunk[0], bytesRead);
+        receivedBytes.fetchAndAddRelaxed(bytesRead);
+    }
 }
 
 AudioFileStreamerNode::~AudioFileStreamerNode()
 {
+    stopDecoding();
 }
 
-void AudioFileStreamerNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out,
-                                             int sampleRate, std::vector<midi::MidiMessage> &midiBuffer)
+bool AudioFileStreamerNode::isBuffering() const
 {
-    while (bufferedSamples.getFrameLenght() < out.getFrameLenght())
-        decode(1024 + 1024);
+    return false;
+}
 
-    AbstractMp3Streamer::processReplacing(in, out, sampleRate, midiBuffer);
+int AudioFileStreamerNode::getBufferingPercentage() const
+{
+    return 100;
 }
 
-// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++/*
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -2,8 +2,13 @@
 #define ROOM_STREAMER_NODE_H
 
 #include "core/AudioNode.h"
+#include "core/RingBuffer.h"
 #include <QNetworkReply>
 #include <QNetworkAccessManager>
+#include <QThreadPool>
+#include <QFuture>
+#include <QWaitCondition>
+#include <QAtomicInt>
 #include "SamplesBufferResampler.h"
 
 class QIODevice;
@@ -12,6 +17,11 @@ namespace audio {
 
 class Mp3Decoder;
 
+/**
+    The compressed bytes are stored in a fixed size ring, a worker thread decodes these bytes to a preallocated
+    PCM ring, staying DECODE_AHEAD_MS ahead of the audio callback. The audio thread just read the decoded samples.
+ */
+
 class AbstractMp3Streamer : public AudioNode
 {
     Q_OBJECT
@@ -31,23 +41,63 @@ public:
     virtual bool isBuffering() const  = 0;
     virtual int getBufferingPercentage() const = 0;
 
+    struct Statistics
+    {
+        quint32 bufferedBytes;  // compressed bytes waiting to be decoded
+        quint32 bufferedFrames; // decoded frames ready to play
+        quint32 underflows;     // audio callbacks without enough decoded frames
+        quint64 receivedBytes;
+        quint64 decodedFrames;
+    };
+
+    Statistics getStatistics() const;
+
 signals:
     void error(const QString &errorMsg);
 
 private:
     static const int MAX_BYTES_PER_DECODING;
+    static const int MAX_FRAMES_PER_DECODING;
+    static const int DECODE_AHEAD_MS;
+    static const int DECODING_POLL_MS;
+
+    QThreadPool decodingThreadPool; // just one thread
+    QFuture<void> decodingFuture;
+    QAtomicInt stopDecodingRequested;
+    QAtomicInt wakeRequested; // checked by the decoding thread before waiting, so a wake up is never lost
+    QMutex decodingMutex;
+    QWaitCondition decodingCondition;
+    std::vector<char> bytesToDecode; // a chunk read from the input ring
+
+    void decodingLoop();
+    bool decodeNextChunk();
 
 protected:
     audio::Mp3Decoder *decoder;
 
     QIODevice *device;
-    void decode(const unsigned int maxBytesToDecode);
-    QByteArray bytesToDecode;
-    virtual void initialize(const QString &streamPath);
     bool streaming;
-    SamplesBuffer bufferedSamples;
+
+    static const quint32 INPUT_RING_SIZE;
+
+    RingBuffer<char> inputBytes;   // compressed stream, written by the main thread (network) or by the decoding thread (file)
+    RingBuffer<float> leftSamples; // decoded stream, read in the audio thread
+    RingBuffer<float> rightSamples;
+
+    QAtomicInt underflows;
+    QAtomicInteger<quint64> receivedBytes;
+    QAtomicInteger<quint64> decodedFrames;
+
     SamplesBufferResampler resampler;
 
+    virtual void initialize(const QString &streamPath);
+    virtual void fillInputBytes(); // called from the decoding thread when the input ring has free space
+
+    void startDecoding();
+    void stopDecoding();
+    void wakeDecodingThread(); // never blocking, can be called from the audio thread
+
+    quint32 getDecodedFrames() const;
     int getSamplesToRender(int targetSampleRate, int outLenght);
 };
 
@@ -75,10 +125,14 @@ public:
 
 protected:
     void initialize(const QString &streamPath) override;
+    void fillInputBytes() override;
 
 private:
     QNetworkAccessManager httpClient;
-    bool buffering;
+    QAtomicInt buffering;
+    QAtomicInt deviceReadRequested;
+    QAtomicInt deviceBytesPending; // the last read stopped with bytes in the reply because the input ring was full
+    std::vector<char> deviceReadChunk;
 
     static const int BUFFER_SIZE;
 
@@ -89,7 +143,7 @@ private slots:
 
 inline bool NinjamRoomStreamerNode::isBuffering() const
 {
-    return buffering;
+    return buffering.load() != 0;
 }
 
 // ++++++++++++++++++++++++++++
@@ -99,12 +153,17 @@ class AudioFileStreamerNode : public AbstractMp3Streamer
 {
 protected:
     void initialize(const QString &streamPath) override;
+    void fillInputBytes() override;
 
 public:
     explicit AudioFileStreamerNode(const QString &file);
     ~AudioFileStreamerNode();
-    void processReplacing(const SamplesBuffer &in, SamplesBuffer &out, int sampleRate,
-                                  std::vector<midi::MidiMessage> &midiBuffer) override;
+
+    bool isBuffering() const override;
+    int getBufferingPercentage() const override;
+
+private:
+    std::vector<char> fileReadChunk;
 };
 
 } // namespace end
@@ -0,0 +1,37 @@
+#include "AudioBus.h"
+
+using audio::AudioBus;
+using audio::SamplesBuffer;
+
+AudioBus::AudioBus(quint32 maxFrames) :
+    buffer(2, maxFrames) // stereo and max frames are allocated here, prepare() is not allocating in the most common cases
+{
+    buffer.setFrameLenght(0);
+}
+
+void AudioBus::prepare(int channels, quint32 frames)
+{
+    if (channels > 1)
+        buffer.setToStereo();
+    else
+        buffer.setToMono();
+
+    buffer.setFrameLenght(frames);
+    buffer.zero();
+}
+
+void AudioBus::mix(const SamplesBuffer &source, float leftGain, float rightGain)
+{
+    if (buffer.isMono() && !source.isMono()) { // fused stereo to mono downmix
+        const quint32 frames = qMin(buffer.getFrameLenght(), source.getFrameLenght());
+        const float *left = source.getSamplesArray(0);
+        const float *right = source.getSamplesArray(1);
+        float *out = buffer.getSamplesArray(0);
+        for (quint32 s = 0; s < frames; ++s)
+            out[s] += left[s] * leftGain + right[s] * rightGain;
+
+        return;
+    }
+
+    buffer.add(source); // same channels, or mono source in a stereo bus
+}
@@ -0,0 +1,49 @@
+#ifndef AUDIO_BUS_H
+#define AUDIO_BUS_H
+
+#include "SamplesBuffer.h"
+
+namespace audio {
+
+/**
+    A preallocated mix bus. Sources are mixed directly into the bus while they are processed in the
+    audio thread, so no intermediate buffers are copied or allocated. Stereo sources mixed in a mono
+    bus are downmixed and panned in the same pass.
+
+    Used as the transmit bus of each channel group (the encoder feed), and can be used by any other
+    consumer needing a per group mix (recording, monitoring, etc.).
+ */
+
+class AudioBus
+{
+public:
+    explicit AudioBus(quint32 maxFrames = 4096);
+
+    void prepare(int channels, quint32 frames); // called in the audio thread before the sources are processed, the bus is cleared
+
+    void mix(const SamplesBuffer &source, float leftGain = 1.0f, float rightGain = 1.0f); // gains are used only when downmixing a stereo source in a mono bus
+
+    const SamplesBuffer &getBuffer() const;
+
+    int getChannels() const;
+
+private:
+    AudioBus(const AudioBus &other);
+    AudioBus &operator=(const AudioBus &other);
+
+    SamplesBuffer buffer;
+};
+
+inline const SamplesBuffer &AudioBus::getBuffer() const
+{
+    return buffer;
+}
+
+inline int AudioBus::getChannels() const
+{
+    return buffer.getChannels();
+}
+
+} // namespace
+
+#endif // AUDIO_BUS_H
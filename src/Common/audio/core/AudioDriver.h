@@ -105,6 +105,8 @@ public:
 
     virtual int getBufferSize() const;
 
+    virtual double getOutputLatency() const; // in seconds, the time between the audio callback and the moment the first processed sample is heard
+
     virtual QList<int> getValidSampleRates(int deviceIndex) const = 0;
     virtual QList<int> getValidBufferSizes(int deviceIndex) const = 0;
 
@@ -189,6 +191,14 @@ inline int AudioDriver::getBufferSize() const
     return bufferSize;
 }
 
+inline double AudioDriver::getOutputLatency() const
+{
+    if (sampleRate <= 0)
+        return 0.0;
+
+    return static_cast<double>(bufferSize) / sampleRate; // just one buffer, some drivers can report a more precise value
+}
+
 
 
 class NullAudioDriver : public AudioDriver
@@ -13,7 +13,7 @@ using audio::SamplesBuffer;
 AudioMixer::AudioMixer(int sampleRate) :
     sampleRate(sampleRate)
 {
-
+    nodeMidiBuffer.reserve(1024);
 }
 
 void AudioMixer::addNode(AudioNode *node)
@@ -49,11 +49,10 @@ void AudioMixer::process(const SamplesBuffer &in, SamplesBuffer &out, int sample
         bool canProcess = (!hasSoloedBuffers && !node->isMuted()) || (hasSoloedBuffers && node->isSoloed());
         if (canProcess) {
 
-            // each channel (not subchannel) will receive a full copy of incomming midi messages
-            std::vector<midi::MidiMessage> midiMessages(midiBuffer.size());
-            midiMessages.insert(midiMessages.begin(), midiBuffer.begin(), midiBuffer.end());
+            // each channel (not subchannel) will receive a full copy of incomming midi messages. The preallocated buffer capacity is reused, no allocations here
+            nodeMidiBuffer.assign(midiBuffer.begin(), midiBuffer.end());
 
-            node->processReplacing(in, out, sampleRate, midiMessages);
+            node->processReplacing(in, out, sampleRate, nodeMidiBuffer);
         }
         else { // just discard the samples if node is muted, the internalBuffer is not copyed to out buffer
             static audio::SamplesBuffer internalBuffer(2);
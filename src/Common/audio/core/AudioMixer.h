@@ -6,10 +6,7 @@
 #include <QMap>
 #include <QScopedPointer>
 #include "audio/SamplesBufferResampler.h"
-
-namespace midi {
-class MidiMessage;
-}
+#include "midi/MidiMessage.h"
 
 namespace audio {
 
@@ -36,6 +33,7 @@ private:
     QList<AudioNode *> nodes;
     int sampleRate;
     QMap<AudioNode *, SamplesBufferResampler> resamplers;
+    std::vector<midi::MidiMessage> nodeMidiBuffer; // reused for each node, avoiding allocations in audio thread
 
 };
 
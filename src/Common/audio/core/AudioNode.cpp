@@ -63,7 +63,7 @@ void AudioNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &out, in
 
     internalOutputBuffer.applyGain(gain, leftGain, rightGain, boost);
 
-    lastPeak.update(internalOutputBuffer.computePeak());
+    meter.publish(internalOutputBuffer.computePeak());
 
     postFaderProcess(internalOutputBuffer);
 
@@ -78,7 +78,6 @@ void AudioNode::setRmsWindowSize(int samples)
 AudioNode::AudioNode() :
     internalInputBuffer(2),
     internalOutputBuffer(2),
-    lastPeak(),
     pan(0),
     leftGain(1.0),
     rightGain(1.0),
@@ -118,12 +117,17 @@ int AudioNode::getInputResamplingLength(int sourceSampleRate, int targetSampleRa
 
 AudioPeak AudioNode::getLastPeak() const
 {
-    return this->lastPeak;
+    return meter.getLastPeak();
+}
+
+MeteringSlot::Snapshot AudioNode::getMeterSnapshot() const
+{
+    return meter.getSnapshot();
 }
 
 void AudioNode::resetLastPeak()
 {
-    lastPeak.zero();
+    meter.reset();
 }
 
 void AudioNode::setPan(float pan)
@@ -181,6 +185,11 @@ void AudioNode::reset()
 }
 
 void AudioNode::updateGains()
+{
+    computePanGains(pan, leftGain, rightGain);
+}
+
+void AudioNode::computePanGains(float pan, float &leftGain, float &rightGain)
 {
     double angle = pan * PI_OVER_2 * 0.5;
     leftGain = (float)(ROOT_2_OVER_2 * (cos(angle) - sin(angle)));
@@ -241,6 +250,16 @@ void AudioNode::suspendProcessors()
     }
 }
 
+int AudioNode::getLatency() const
+{
+    int latency = 0;
+    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
+        if (processors[i] && !processors[i]->isBypassed())
+            latency += processors[i]->getLatency();
+    }
+    return latency;
+}
+
 void AudioNode::updateProcessorsGui()
 {
     QMutexLocker locker(&mutex);
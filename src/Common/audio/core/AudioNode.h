@@ -4,6 +4,7 @@
 #include <QSet>
 #include <QMutex>
 #include "SamplesBuffer.h"
+#include "MeteringSlot.h"
 #include "AudioDriver.h"
 #include "midi/MidiMessage.h"
 #include <QDebug>
@@ -41,6 +42,8 @@ public:
     void resumeProcessors();
     virtual void updateProcessorsGui();
 
+    int getLatency() const; // the sum of the plugins latency (in samples), bypassed plugins are ignored
+
     void setGain(float gainValue);
     void setBoost(float boostValue);
 
@@ -51,6 +54,7 @@ public:
     float getPan() const;
 
     AudioPeak getLastPeak() const;
+    MeteringSlot::Snapshot getMeterSnapshot() const;
 
     void resetLastPeak();
 
@@ -64,6 +68,8 @@ public:
 
     virtual void reset(); // reset pan, gain, boost, etc
 
+    static void computePanGains(float pan, float &leftGain, float &rightGain); // constant power pan law, pan in [-1, 1]
+
     static const quint8 MAX_PROCESSORS_PER_TRACK = 4;
 
 protected:
@@ -78,7 +84,7 @@ protected:
     SamplesBuffer internalInputBuffer;
     SamplesBuffer internalOutputBuffer;
 
-    mutable audio::AudioPeak lastPeak;
+    MeteringSlot meter; // peaks published in the audio thread and read in the GUI thread
     QMutex mutex; // used to protected connections manipulation because nodes can be added or removed by different threads
 
     // pan
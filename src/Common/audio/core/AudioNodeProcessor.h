@@ -24,6 +24,7 @@ public:
     virtual void openEditor(const QPoint &centerOfScreen) = 0;
     virtual void closeEditor() = 0;
     virtual void setSampleRate(int newSampleRate);
+    virtual void setTempo(int bpm); // ninjam BPM, used by tempo synced processors
 
     virtual void setBypass(bool state);
     bool isBypassed() const;
@@ -32,6 +33,8 @@ public:
 
     virtual bool canGenerateMidiMessages() const;
 
+    virtual int getLatency() const; // processing latency in samples (lookahead, linear phase filters, etc.)
+
 protected:
     bool bypassed;
 
@@ -53,6 +56,11 @@ inline bool AudioNodeProcessor::canGenerateMidiMessages() const
     return false;
 }
 
+inline int AudioNodeProcessor::getLatency() const
+{
+    return 0;
+}
+
 inline AudioNodeProcessor::~AudioNodeProcessor()
 {
     //
@@ -63,6 +71,11 @@ inline void AudioNodeProcessor::setSampleRate(int newSampleRate)
     Q_UNUSED(newSampleRate);
 }
 
+inline void AudioNodeProcessor::setTempo(int bpm)
+{
+    Q_UNUSED(bpm);
+}
+
 
 }//namespace
 
@@ -0,0 +1,53 @@
+#include "DelayLine.h"
+
+#include <algorithm>
+
+using audio::DelayLine;
+using audio::SamplesBuffer;
+
+DelayLine::DelayLine(quint32 maxDelay, int channels) :
+    mask(0),
+    writeIndex(0),
+    delay(0)
+{
+    quint32 size = 1;
+    while (size <= maxDelay)
+        size <<= 1;
+
+    mask = size - 1;
+    ring.assign(channels, std::vector<float>(size, 0.0f));
+}
+
+void DelayLine::setDelay(quint32 delayInSamples)
+{
+    delay = qMin(delayInSamples, getMaxDelay());
+}
+
+void DelayLine::clear()
+{
+    for (auto &channel : ring)
+        std::fill(channel.begin(), channel.end(), 0.0f);
+}
+
+void DelayLine::process(const SamplesBuffer &in, SamplesBuffer &out)
+{
+    const quint32 frames = qMin(in.getFrameLenght(), out.getFrameLenght());
+    const int channels = qMin(out.getChannels(), static_cast<int>(ring.size()));
+
+    for (int c = 0; c < channels; ++c) {
+        const float *input = in.getSamplesArray(qMin(c, in.getChannels() - 1)); // mono inputs are duplicated
+        float *output = out.getSamplesArray(c);
+        float *samples = ring[c].data();
+
+        quint32 write = writeIndex;
+        quint32 read = writeIndex - delay;
+        for (quint32 s = 0; s < frames; ++s) {
+            samples[write & mask] = input[s];
+            output[s] = samples[read & mask];
+            ++write;
+            ++read;
+        }
+    }
+
+    writeIndex += frames;
+}
@@ -0,0 +1,49 @@
+#ifndef DELAY_LINE_H
+#define DELAY_LINE_H
+
+#include "SamplesBuffer.h"
+
+#include <vector>
+
+namespace audio {
+
+/**
+    A preallocated multichannel delay line with integer delay, used to compensate the latency of
+    plugin chains. The ring size is a power of two, so the read/write indexes are just masked.
+    Changing the delay is not allocating, the delay is clamped in the max delay.
+ */
+
+class DelayLine
+{
+public:
+    explicit DelayLine(quint32 maxDelay = 16384, int channels = 2);
+
+    void setDelay(quint32 delayInSamples);
+    quint32 getDelay() const;
+
+    quint32 getMaxDelay() const;
+
+    void process(const SamplesBuffer &in, SamplesBuffer &out); // 'out' is replaced by the delayed samples
+
+    void clear();
+
+private:
+    std::vector<std::vector<float>> ring;
+    quint32 mask;
+    quint32 writeIndex;
+    quint32 delay;
+};
+
+inline quint32 DelayLine::getDelay() const
+{
+    return delay;
+}
+
+inline quint32 DelayLine::getMaxDelay() const
+{
+    return mask; // the write position is always preserved in the ring
+}
+
+} // namespace
+
+#endif // DELAY_LINE_H
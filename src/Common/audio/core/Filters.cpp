@@ -1,9 +1,17 @@
 #include "Filters.h"
+#include "SamplesBuffer.h"
 #include <cfloat>
 #include <cmath>
 #include <cstdint>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define FILTERS_USE_SSE
+    #include <xmmintrin.h>
+#endif
 
 using audio::Filter;
+using audio::MultiChannelFilter;
 
 #define SQUARE(x) ((x) * (x))
 
@@ -47,6 +55,16 @@ void Filter::setFrequency(double newFrequency)
 }
 
 void Filter::initialize(FilterType type, double freq, double Q, double gain)
+{
+    const Coefficients coefficients = computeCoefficients(type, sampleRate, freq, Q, gain);
+    b0 = coefficients.b0;
+    b1 = coefficients.b1;
+    b2 = coefficients.b2;
+    a1 = coefficients.a1;
+    a2 = coefficients.a2;
+}
+
+Filter::Coefficients Filter::computeCoefficients(FilterType type, double sampleRate, double freq, double Q, double gain)
 {
     if (Q <= .001)
         Q = 0.001;
@@ -68,7 +86,9 @@ void Filter::initialize(FilterType type, double freq, double Q, double gain)
     const double alpha = sinW0 / (2.0 * Q);
     const double beta = sqrt(A) / Q;
 
-    double a0 = 0;
+    double a0 = 1.0;
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    double a1 = 0.0, a2 = 0.0;
 
     switch (type) {
     case LowPass:
@@ -153,11 +173,13 @@ void Filter::initialize(FilterType type, double freq, double Q, double gain)
         break;
     }
 
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
+    Coefficients coefficients;
+    coefficients.b0 = b0 / a0;
+    coefficients.b1 = b1 / a0;
+    coefficients.b2 = b2 / a0;
+    coefficients.a1 = a1 / a0;
+    coefficients.a2 = a2 / a0;
+    return coefficients;
 }
 
 float Filter::dBAtFrequency(float freq) const
@@ -184,3 +206,212 @@ float Filter::dBAtFrequency(float freq) const
 
     return std::min(120.f, std::max(-120.f, rv));
 }
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+namespace {
+
+// added in every stage input, small enough to be inaudible and big enough to keep the states normalized
+const float DENORMAL_GUARD = 1e-20f;
+
+}
+
+MultiChannelFilter::MultiChannelFilter(int channels, int stages) :
+    channels(qBound(1, channels, MAX_CHANNELS)),
+    stages(qBound(1, stages, MAX_STAGES))
+{
+    for (int stage = 0; stage < MAX_STAGES; ++stage)
+        bypassStage(stage);
+
+    reset();
+}
+
+void MultiChannelFilter::setStage(int stage, const Filter::Coefficients &coefficients)
+{
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel)
+        setStage(stage, channel, coefficients);
+}
+
+void MultiChannelFilter::setStage(int stage, int channel, const Filter::Coefficients &coefficients)
+{
+    if (stage < 0 || stage >= MAX_STAGES || channel < 0 || channel >= MAX_CHANNELS)
+        return;
+
+    b0[stage][channel] = static_cast<float>(coefficients.b0);
+    b1[stage][channel] = static_cast<float>(coefficients.b1);
+    b2[stage][channel] = static_cast<float>(coefficients.b2);
+    a1[stage][channel] = static_cast<float>(coefficients.a1);
+    a2[stage][channel] = static_cast<float>(coefficients.a2);
+
+    activeStages[stage] = true;
+}
+
+void MultiChannelFilter::bypassStage(int stage)
+{
+    if (stage < 0 || stage >= MAX_STAGES)
+        return;
+
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel) { // identity, z states are preserved
+        b0[stage][channel] = 1.0f;
+        b1[stage][channel] = b2[stage][channel] = 0.0f;
+        a1[stage][channel] = a2[stage][channel] = 0.0f;
+    }
+
+    activeStages[stage] = false;
+}
+
+void MultiChannelFilter::reset()
+{
+    std::fill(&z1[0][0], &z1[0][0] + MAX_STAGES * MAX_CHANNELS, 0.0f);
+    std::fill(&z2[0][0], &z2[0][0] + MAX_STAGES * MAX_CHANNELS, 0.0f);
+}
+
+void MultiChannelFilter::process(SamplesBuffer &buffer)
+{
+    float *pointers[MAX_CHANNELS] = {nullptr};
+    const int channelsToProcess = std::min(buffer.getChannels(), channels);
+    for (int c = 0; c < channelsToProcess; ++c)
+        pointers[c] = buffer.getSamplesArray(c);
+
+    process(pointers, buffer.getFrameLenght());
+}
+
+void MultiChannelFilter::process(float * const *data, quint32 samples)
+{
+    for (int firstChannel = 0; firstChannel < channels; firstChannel += LANES) {
+        float *lanes[LANES] = {nullptr};
+        bool hasData = false;
+        for (int lane = 0; lane < LANES && firstChannel + lane < channels; ++lane) {
+            lanes[lane] = data[firstChannel + lane];
+            hasData = hasData || lanes[lane];
+        }
+
+        if (hasData)
+            processLanes(lanes, firstChannel, samples);
+    }
+
+    // same protection used in Filter::process
+    for (int stage = 0; stage < stages; ++stage) {
+        for (int c = 0; c < channels; ++c) {
+            if (!std::isfinite(z1[stage][c]) || !std::isfinite(z2[stage][c]))
+                z1[stage][c] = z2[stage][c] = 0.0f;
+        }
+    }
+}
+
+#ifdef FILTERS_USE_SSE
+
+void MultiChannelFilter::processLanes(float * const *lanes, int firstChannel, quint32 samples)
+{
+    int stagesToProcess[MAX_STAGES];
+    int totalStages = 0;
+    for (int stage = 0; stage < stages; ++stage) {
+        if (activeStages[stage])
+            stagesToProcess[totalStages++] = stage;
+    }
+
+    if (totalStages == 0)
+        return;
+
+    __m128 s1[MAX_STAGES];
+    __m128 s2[MAX_STAGES];
+    for (int i = 0; i < totalStages; ++i) {
+        s1[i] = _mm_loadu_ps(&z1[stagesToProcess[i]][firstChannel]);
+        s2[i] = _mm_loadu_ps(&z2[stagesToProcess[i]][firstChannel]);
+    }
+
+    const __m128 guard = _mm_set1_ps(DENORMAL_GUARD);
+
+    // one sample from each lane, all cascaded stages
+    auto processFrame = [&](__m128 x) -> __m128 {
+        for (int i = 0; i < totalStages; ++i) {
+            const int stage = stagesToProcess[i];
+            x = _mm_add_ps(x, guard);
+            const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&b0[stage][firstChannel]), x), s1[i]);
+            s1[i] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&b1[stage][firstChannel]), x),
+                                          _mm_mul_ps(_mm_loadu_ps(&a1[stage][firstChannel]), y)), s2[i]);
+            s2[i] = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(&b2[stage][firstChannel]), x),
+                               _mm_mul_ps(_mm_loadu_ps(&a2[stage][firstChannel]), y));
+            x = y;
+        }
+        return x;
+    };
+
+    const __m128 zero = _mm_setzero_ps();
+    quint32 s = 0;
+
+    // 4 samples of 4 lanes are transposed, so each vector holds the same sample in all lanes
+    for (; s + 4 <= samples; s += 4) {
+        __m128 r0 = lanes[0] ? _mm_loadu_ps(lanes[0] + s) : zero;
+        __m128 r1 = lanes[1] ? _mm_loadu_ps(lanes[1] + s) : zero;
+        __m128 r2 = lanes[2] ? _mm_loadu_ps(lanes[2] + s) : zero;
+        __m128 r3 = lanes[3] ? _mm_loadu_ps(lanes[3] + s) : zero;
+
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        r0 = processFrame(r0);
+        r1 = processFrame(r1);
+        r2 = processFrame(r2);
+        r3 = processFrame(r3);
+
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        if (lanes[0])
+            _mm_storeu_ps(lanes[0] + s, r0);
+        if (lanes[1])
+            _mm_storeu_ps(lanes[1] + s, r1);
+        if (lanes[2])
+            _mm_storeu_ps(lanes[2] + s, r2);
+        if (lanes[3])
+            _mm_storeu_ps(lanes[3] + s, r3);
+    }
+
+    for (; s < samples; ++s) {
+        float frame[LANES];
+        for (int lane = 0; lane < LANES; ++lane)
+            frame[lane] = lanes[lane] ? lanes[lane][s] : 0.0f;
+
+        _mm_storeu_ps(frame, processFrame(_mm_loadu_ps(frame)));
+
+        for (int lane = 0; lane < LANES; ++lane) {
+            if (lanes[lane])
+                lanes[lane][s] = frame[lane];
+        }
+    }
+
+    for (int i = 0; i < totalStages; ++i) {
+        _mm_storeu_ps(&z1[stagesToProcess[i]][firstChannel], s1[i]);
+        _mm_storeu_ps(&z2[stagesToProcess[i]][firstChannel], s2[i]);
+    }
+}
+
+#else
+
+void MultiChannelFilter::processLanes(float * const *lanes, int firstChannel, quint32 samples)
+{
+    for (int lane = 0; lane < LANES; ++lane) {
+        float *data = lanes[lane];
+        if (!data)
+            continue;
+
+        const int c = firstChannel + lane;
+        for (int stage = 0; stage < stages; ++stage) {
+            if (!activeStages[stage])
+                continue;
+
+            float s1 = z1[stage][c];
+            float s2 = z2[stage][c];
+            for (quint32 s = 0; s < samples; ++s) {
+                const float x = data[s] + DENORMAL_GUARD;
+                const float y = b0[stage][c] * x + s1;
+                s1 = b1[stage][c] * x - a1[stage][c] * y + s2;
+                s2 = b2[stage][c] * x - a2[stage][c] * y;
+                data[s] = y;
+            }
+            z1[stage][c] = s1;
+            z2[stage][c] = s2;
+        }
+    }
+}
+
+#endif
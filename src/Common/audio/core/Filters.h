@@ -6,6 +6,8 @@
 namespace audio
 {
 
+class SamplesBuffer;
+
 /** Biquad Filter - Adapted from Ardour code: http://ardour.org/ */
 
 class Filter
@@ -24,6 +26,22 @@ public:
         HighShelf
     };
 
+    struct Coefficients // normalized by a0
+    {
+        double b0, b1, b2;
+        double a1, a2;
+    };
+
+    /*** Compute biquad coefficients
+     *
+     * @param type filter type (LowPass, HighPass, etc)
+     * @param sampleRate sample rate
+     * @param frequency filter frequency
+     * @param Q filter quality
+     * @param gain filter gain in dB (used by Peaking and shelving filters)
+     */
+    static Coefficients computeCoefficients(FilterType type, double sampleRate, double frequency, double Q, double gain);
+
     Filter (FilterType type, double samplerate, double frequency, double Q = 1.0, double gain = 1.0);
 
     void process(float *data, const quint32 samples);
@@ -59,6 +77,65 @@ private:
     FilterType type;
 };
 
+/** Cascade of biquads (transposed direct form II) processing up to MAX_CHANNELS independent
+ *  channels in the same pass. Coefficients and states are stored per channel (structure of arrays)
+ *  and 4 channels are computed together with SSE, so a stereo track, or 4/8 tracks, cost the same
+ *  as a single channel. Bypassed stages are skipped, and a tiny offset is injected in every stage
+ *  input to keep the states out of the denormal range.
+ */
+
+class MultiChannelFilter
+{
+
+public:
+    static const int MAX_CHANNELS = 8;
+    static const int MAX_STAGES = 8;
+
+    explicit MultiChannelFilter(int channels = 2, int stages = 1);
+
+    void setStage(int stage, const Filter::Coefficients &coefficients); // same response in all channels
+    void setStage(int stage, int channel, const Filter::Coefficients &coefficients);
+    void bypassStage(int stage);
+
+    /*** Process the samples in place
+     * @param channels array with getChannels() pointers, null pointers are skipped
+     * @param samples samples in each channel
+     */
+    void process(float * const *channels, quint32 samples);
+
+    void process(SamplesBuffer &buffer);
+
+    void reset();
+
+    inline int getChannels() const
+    {
+        return channels;
+    }
+
+    inline int getStages() const
+    {
+        return stages;
+    }
+
+private:
+    static const int LANES = 4; // channels computed in each SIMD pass
+
+    void processLanes(float * const *lanes, int firstChannel, quint32 samples);
+
+    int channels;
+    int stages;
+    bool activeStages[MAX_STAGES];
+
+    // [stage][channel], the lanes computed together are contiguous
+    float b0[MAX_STAGES][MAX_CHANNELS];
+    float b1[MAX_STAGES][MAX_CHANNELS];
+    float b2[MAX_STAGES][MAX_CHANNELS];
+    float a1[MAX_STAGES][MAX_CHANNELS];
+    float a2[MAX_STAGES][MAX_CHANNELS];
+    float z1[MAX_STAGES][MAX_CHANNELS];
+    float z2[MAX_STAGES][MAX_CHANNELS];
+};
+
 } // namespace
 
 #endif
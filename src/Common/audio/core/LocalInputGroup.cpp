@@ -21,6 +21,7 @@ LocalInputGroup::~LocalInputGroup()
 void LocalInputGroup::addInputNode(LocalInputNode *input)
 {
     groupedInputs.append(input);
+    input->setTransmitBus(&transmitBus);
 }
 
 LocalInputNode *LocalInputGroup::getInputNode(quint8 index) const
@@ -32,22 +33,16 @@ LocalInputNode *LocalInputGroup::getInputNode(quint8 index) const
     return nullptr;
 }
 
-void LocalInputGroup::mixGroupedInputs(SamplesBuffer &out)
+void LocalInputGroup::prepareTransmitBus(quint32 frames)
 {
-    for (auto inputTrack : groupedInputs) {
-        auto lastBuffer = inputTrack->getLastBuffer();
-        if (lastBuffer.getChannels() == out.getChannels()) {
-            out.add(lastBuffer);
-        }
-        else {
-            out.add(inputTrack->getLastBufferMixedToMono());
-        }
-    }
+    transmitBus.prepare(getMaxInputChannelsForEncoding(), frames);
 }
 
 void LocalInputGroup::removeInput(LocalInputNode *input)
 {
-    if (!groupedInputs.removeOne(input))
+    if (groupedInputs.removeOne(input))
+        input->setTransmitBus(nullptr);
+    else
         qCritical() << "the input track was not removed!";
 }
 
@@ -1,12 +1,13 @@
 #ifndef _LOCAL_INPUT_GROUP_H_
 #define _LOCAL_INPUT_GROUP_H_
 
+#include "AudioBus.h"
+
 #include <QList>
 
 namespace audio {
 
 class LocalInputNode;
-class SamplesBuffer;
 
 class LocalInputGroup
 {
@@ -21,7 +22,8 @@ public:
 
     int getIndex() const;
 
-    void mixGroupedInputs(audio::SamplesBuffer &out);
+    void prepareTransmitBus(quint32 frames); // called before the grouped inputs are processed
+    const audio::SamplesBuffer &getTransmitBuffer() const; // the grouped inputs mix, ready to encode
 
     void removeInput(audio::LocalInputNode *input);
 
@@ -42,8 +44,14 @@ private:
     QList<audio::LocalInputNode *> groupedInputs;
     bool transmiting;
     bool voiceChatActivated;
+    audio::AudioBus transmitBus;
 };
 
+inline const audio::SamplesBuffer &LocalInputGroup::getTransmitBuffer() const
+{
+    return transmitBus.getBuffer();
+}
+
 inline bool LocalInputGroup::isTransmiting() const
 {
     return transmiting;
@@ -1,5 +1,6 @@
 #include "LocalInputNode.h"
 #include "audio/core/AudioNodeProcessor.h"
+#include "audio/core/AudioBus.h"
 #include "midi/MidiMessage.h"
 #include "MainController.h"
 #include "NinjamController.h"
@@ -86,10 +87,16 @@ LocalInputNode::LocalInputNode(controller::MainController *controller, int paren
     receivingRoutedMidiInput(false),
     routingMidiInput(false),
     mainController(controller),
-    looper(LocalInputNode::createLooper(controller))
+    looper(LocalInputNode::createLooper(controller)),
+    transmitBus(nullptr),
+    latencyCompensation(controller::MainController::MAX_TRANSMIT_LATENCY),
+    compensatedBuffer(2, 4096),
+    looperBuffer(2, 4096)
 {
     Q_UNUSED(isMono)
     setToNoInput();
+
+    filteredMidiBuffer.reserve(1024);
 }
 
 LocalInputNode::~LocalInputNode()
@@ -108,7 +115,10 @@ Looper *LocalInputNode::createLooper(controller::MainController *controller)
     if (preferredLayersCount > MAX_LOOP_LAYERS)
         preferredLayersCount = MAX_LOOP_LAYERS;
 
-    return new audio::Looper(static_cast<Looper::Mode>(preferrredMode), preferredLayersCount);
+    auto looper = new audio::Looper(static_cast<Looper::Mode>(preferrredMode), preferredLayersCount);
+    looper->setCompactLockedLayers(controller->getLooperCompactLockedLayersFlag());
+
+    return looper;
 }
 
 void LocalInputNode::stopLooper()
@@ -154,6 +164,14 @@ void LocalInputNode::setProcessorsSampleRate(int newSampleRate)
     }
 }
 
+void LocalInputNode::setProcessorsTempo(int bpm)
+{
+    for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
+        if (processors[i])
+            processors[i]->setTempo(bpm);
+    }
+}
+
 void LocalInputNode::closeProcessorsWindows()
 {
     for (int i = 0; i < MAX_PROCESSORS_PER_TRACK; ++i) {
@@ -162,20 +180,20 @@ void LocalInputNode::closeProcessorsWindows()
     }
 }
 
-SamplesBuffer LocalInputNode::getLastBufferMixedToMono() const
+void LocalInputNode::setTransmitBus(AudioBus *bus)
 {
-    if (internalOutputBuffer.isMono())
-        return internalOutputBuffer;
+    transmitBus = bus;
+}
 
-    const uint samples = internalOutputBuffer.getFrameLenght();
-    SamplesBuffer lastBuffer(1, samples);
-    float *samplesArray = lastBuffer.getSamplesArray(0);
-    float *internalArrays[2] = {internalOutputBuffer.getSamplesArray(0), internalOutputBuffer.getSamplesArray(1)};
-    for (uint s = 0; s < samples; ++s) {
-        samplesArray[s] = internalArrays[0][s] * leftGain + internalArrays[1][s] * rightGain;
-    }
+void LocalInputNode::setLatencyCompensation(quint32 samples)
+{
+    if (samples == latencyCompensation.getDelay())
+        return;
 
-    return lastBuffer;
+    if (latencyCompensation.getDelay() == 0)
+        latencyCompensation.clear(); // the delay line is not fed when the delay is zero, discarding old samples
+
+    latencyCompensation.setDelay(samples);
 }
 
 void LocalInputNode::setAudioInputSelection(int firstChannelIndex, int channelCount)
@@ -238,7 +256,8 @@ void LocalInputNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &ou
     *
     */
 
-    std::vector<midi::MidiMessage> filteredMidiBuffer(midiBuffer.size());
+    filteredMidiBuffer.clear();
+    const quint32 blockFrames = out.getFrameLenght();
     internalInputBuffer.setFrameLenght(out.getFrameLenght());
     internalOutputBuffer.setFrameLenght(out.getFrameLenght());
     internalInputBuffer.zero();
@@ -252,7 +271,7 @@ void LocalInputNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &ou
             internalInputBuffer.set(in, audioInputRange.getFirstChannel(), audioInputRange.getChannels());
         }
         else if (isMidi() && !midiBuffer.empty()) {
-            processIncommingMidi(midiBuffer, filteredMidiBuffer);
+            processIncommingMidi(midiBuffer, filteredMidiBuffer, blockFrames);
         }
     }
 
@@ -260,12 +279,14 @@ void LocalInputNode::processReplacing(const SamplesBuffer &in, SamplesBuffer &ou
         quint8 subchannelIndex = 1; // second subchannel
         auto secondSubchannel = mainController->getInputTrackInGroup(channelGroupIndex, subchannelIndex);
         if (secondSubchannel && secondSubchannel->isMidi()) {
-            secondSubchannel->processIncommingMidi(midiBuffer, filteredMidiBuffer);
+            secondSubchannel->processIncommingMidi(midiBuffer, filteredMidiBuffer, blockFrames);
         }
     }
 
+    sortMidiMessagesByOffset(filteredMidiBuffer); // messages from different devices (or routed from second subchannel) are mixed
+
     if (isRoutingMidiInput()) {
-        lastPeak.update(AudioPeak()); // ensure the audio meters will be ZERO
+        meter.publish(AudioPeak()); // ensure the audio meters will be ZERO
 
         return; // when routing midi this track will not render midi data, this data will be rendered by first subchannel. But the midi data is processed above to update MIDI activity meter
     }
@@ -302,14 +323,21 @@ void LocalInputNode::setReceivingRoutedMidiInput(bool receiveRoutedMidiInput)
         routingMidiInput = false;
 }
 
-void LocalInputNode::processIncommingMidi(std::vector<midi::MidiMessage> &inBuffer, std::vector<midi::MidiMessage> &outBuffer)
+void LocalInputNode::processIncommingMidi(std::vector<midi::MidiMessage> &inBuffer, std::vector<midi::MidiMessage> &outBuffer, quint32 blockFrames)
 {
+    const quint64 blockStart = mainController->getMidiBlockStart();
     auto iterator = inBuffer.begin();
     while(iterator != inBuffer.end()) {
         auto message(*iterator);
         if (canProcessMidiMessage(message)) {
             message.transpose(getTranspose());
 
+            // the messages received in the previous audio callback are rendered in this callback preserving the original time distance
+            quint32 offset = 0;
+            if (message.getTimestamp() > blockStart && blockFrames > 0)
+                offset = static_cast<quint32>(qMin(message.getTimestamp() - blockStart, static_cast<quint64>(blockFrames - 1)));
+            message.setSampleOffset(offset);
+
             outBuffer.push_back(message);
 
             // save the midi activity peak value for notes or controls
@@ -323,6 +351,20 @@ void LocalInputNode::processIncommingMidi(std::vector<midi::MidiMessage> &inBuff
     }
 }
 
+void LocalInputNode::sortMidiMessagesByOffset(std::vector<midi::MidiMessage> &messages)
+{
+    // insertion sort, stable and allocation free. The messages are almost sorted, and just a few messages are received in each audio callback
+    for (size_t i = 1; i < messages.size(); ++i) {
+        const midi::MidiMessage message = messages[i];
+        size_t j = i;
+        while (j > 0 && messages[j - 1].getSampleOffset() > message.getSampleOffset()) {
+            messages[j] = messages[j - 1];
+            --j;
+        }
+        messages[j] = message;
+    }
+}
+
 qint8 LocalInputNode::getTranspose() const
 {
     if (!receivingRoutedMidiInput) {
@@ -349,7 +391,33 @@ void LocalInputNode::preFaderProcess(SamplesBuffer &out) // this function is cal
 
 void LocalInputNode::postFaderProcess(SamplesBuffer &out)
 {
-    looper->mixToBuffer(out);
+    if (!transmitBus || latencyCompensation.getDelay() == 0) {
+        looper->mixToBuffer(out);
+        if (transmitBus)
+            transmitBus->mix(out, leftGain, rightGain); // the stereo samples are panned again when transmiting in mono
+        return;
+    }
+
+    if (out.isMono()) {
+        compensatedBuffer.setToMono();
+        looperBuffer.setToMono();
+    }
+    else {
+        compensatedBuffer.setToStereo();
+        looperBuffer.setToStereo();
+    }
+
+    compensatedBuffer.setFrameLenght(out.getFrameLenght());
+    latencyCompensation.process(out, compensatedBuffer);
+
+    // the looper is playing in the interval grid, so the loops are mixed after the latency compensation and are not delayed
+    looperBuffer.setFrameLenght(out.getFrameLenght());
+    looperBuffer.zero();
+    looper->mixToBuffer(looperBuffer);
+    out.add(looperBuffer);
+    compensatedBuffer.add(looperBuffer);
+
+    transmitBus->mix(compensatedBuffer, leftGain, rightGain);
 }
 
 void LocalInputNode::setStereoInversion(bool inverted)
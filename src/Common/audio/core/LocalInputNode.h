@@ -2,6 +2,7 @@
 #define _LOCAL_INPUT_NODE_H_
 
 #include "AudioNode.h"
+#include "DelayLine.h"
 #include "looper/Looper.h"
 
 namespace midi {
@@ -14,6 +15,8 @@ class MainController;
 
 namespace audio {
 
+class AudioBus;
+
 class LocalInputNode : public AudioNode
 {
     Q_OBJECT
@@ -59,9 +62,13 @@ public:
     int getChanneGroupIndex() const;
 
     const audio::SamplesBuffer &getLastBuffer() const;
-    SamplesBuffer getLastBufferMixedToMono() const;
+
+    void setTransmitBus(audio::AudioBus *bus); // the processed samples are mixed in the group transmit bus
+
+    void setLatencyCompensation(quint32 samples); // delay added in transmited samples to align with the slowest plugins chain
 
     void setProcessorsSampleRate(int newSampleRate);
+    void setProcessorsTempo(int bpm);
 
     void closeProcessorsWindows();
 
@@ -162,10 +169,20 @@ private:
 
     bool canProcessMidiMessage(const midi::MidiMessage &msg) const;
 
-    void processIncommingMidi(std::vector<midi::MidiMessage> &inBuffer, std::vector<midi::MidiMessage> &outBuffer);
+    void processIncommingMidi(std::vector<midi::MidiMessage> &inBuffer, std::vector<midi::MidiMessage> &outBuffer, quint32 blockFrames);
+
+    std::vector<midi::MidiMessage> filteredMidiBuffer; // preallocated, reused in each audio callback
+
+    static void sortMidiMessagesByOffset(std::vector<midi::MidiMessage> &messages);
 
     audio::Looper* looper;
 
+    audio::AudioBus *transmitBus;
+
+    audio::DelayLine latencyCompensation; // transmited samples only, the local monitoring is not delayed
+    audio::SamplesBuffer compensatedBuffer;
+    audio::SamplesBuffer looperBuffer; // the looper output when the transmited samples are delayed
+
     static audio::Looper *createLooper(controller::MainController *controller);
 
 };
@@ -0,0 +1,163 @@
+#include "LoudnessMeter.h"
+
+#include <cmath>
+#include <algorithm>
+
+using audio::LoudnessMeter;
+using audio::Filter;
+
+const double LoudnessMeter::SILENCE = -70.0; // the absolute gate
+
+namespace {
+
+const quint32 MAX_CHUNK_SIZE = 1024;
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+double powerToLoudness(double power)
+{
+    return -0.691 + 10.0 * std::log10(power);
+}
+
+/* The K-weighting filters are specified for 48 KHz, the coefficients for other sample rates
+ * are computed with the bilinear transform of the analog prototypes (same approach used in libebur128).
+ * The cookbook shelf used in Filter is ~0.25 dB off at 1 KHz.
+ */
+Filter::Coefficients computeKWeightingShelf(int sampleRate)
+{
+    const double f0 = 1681.974450955533;
+    const double G = 3.999843853973347;
+    const double Q = 0.7071752369554196;
+
+    const double K = std::tan(M_PI * f0 / sampleRate);
+    const double Vh = std::pow(10.0, G / 20.0);
+    const double Vb = std::pow(Vh, 0.4996667741545416);
+    const double a0 = 1.0 + K / Q + K * K;
+
+    Filter::Coefficients coefficients;
+    coefficients.b0 = (Vh + Vb * K / Q + K * K) / a0;
+    coefficients.b1 = 2.0 * (K * K - Vh) / a0;
+    coefficients.b2 = (Vh - Vb * K / Q + K * K) / a0;
+    coefficients.a1 = 2.0 * (K * K - 1.0) / a0;
+    coefficients.a2 = (1.0 - K / Q + K * K) / a0;
+    return coefficients;
+}
+
+Filter::Coefficients computeKWeightingHighPass(int sampleRate)
+{
+    const double f0 = 38.13547087602444;
+    const double Q = 0.5003270373238773;
+
+    const double K = std::tan(M_PI * f0 / sampleRate);
+    const double a0 = 1.0 + K / Q + K * K;
+
+    Filter::Coefficients coefficients;
+    coefficients.b0 = 1.0;
+    coefficients.b1 = -2.0;
+    coefficients.b2 = 1.0;
+    coefficients.a1 = 2.0 * (K * K - 1.0) / a0;
+    coefficients.a2 = (1.0 - K / Q + K * K) / a0;
+    return coefficients;
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter(int sampleRate) :
+    kWeighting(2, 2)
+{
+    for (auto &channel : weighted)
+        channel.resize(MAX_CHUNK_SIZE);
+
+    setSampleRate(sampleRate);
+}
+
+void LoudnessMeter::setSampleRate(int sampleRate)
+{
+    this->sampleRate = sampleRate;
+    hopSize = qMax(1, sampleRate / 10);
+
+    // K-weighting, the BS.1770 pre-filter (head acoustic) and RLB high pass
+    kWeighting.setStage(0, computeKWeightingShelf(sampleRate));
+    kWeighting.setStage(1, computeKWeightingHighPass(sampleRate));
+
+    reset();
+}
+
+void LoudnessMeter::reset()
+{
+    kWeighting.reset();
+    hopPosition = 0;
+    hopPower = 0.0;
+    completedHops = 0;
+    std::fill(hops, hops + HOPS_PER_BLOCK, 0.0);
+    blocksPower.clear();
+}
+
+void LoudnessMeter::process(const float *left, const float *right, quint32 samples)
+{
+    if (!right)
+        right = left; // dual mono
+
+    quint32 offset = 0;
+    while (offset < samples) {
+        const quint32 chunkSize = std::min(samples - offset, MAX_CHUNK_SIZE);
+        std::copy(left + offset, left + offset + chunkSize, weighted[0].begin());
+        std::copy(right + offset, right + offset + chunkSize, weighted[1].begin());
+
+        float *channels[] = { weighted[0].data(), weighted[1].data() };
+        kWeighting.process(channels, chunkSize);
+
+        for (quint32 s = 0; s < chunkSize; ++s) {
+            hopPower += weighted[0][s] * weighted[0][s] + weighted[1][s] * weighted[1][s];
+
+            if (++hopPosition == hopSize) {
+                hops[completedHops % HOPS_PER_BLOCK] = hopPower;
+                completedHops++;
+                hopPower = 0.0;
+                hopPosition = 0;
+
+                if (completedHops >= HOPS_PER_BLOCK) {
+                    double blockPower = 0.0;
+                    for (double hop : hops)
+                        blockPower += hop;
+
+                    blocksPower.push_back(blockPower / (hopSize * HOPS_PER_BLOCK));
+                }
+            }
+        }
+
+        offset += chunkSize;
+    }
+}
+
+double LoudnessMeter::getIntegratedLoudness() const
+{
+    const double absoluteGate = std::pow(10.0, (SILENCE + 0.691) / 10.0);
+
+    double sum = 0.0;
+    int count = 0;
+    for (double power : blocksPower) {
+        if (power > absoluteGate) {
+            sum += power;
+            count++;
+        }
+    }
+
+    if (!count)
+        return SILENCE;
+
+    const double relativeGate = sum / count * std::pow(10.0, -10.0 / 10.0); // 10 LU below
+
+    sum = 0.0;
+    count = 0;
+    for (double power : blocksPower) {
+        if (power > absoluteGate && power > relativeGate) {
+            sum += power;
+            count++;
+        }
+    }
+
+    return powerToLoudness(sum / count);
+}
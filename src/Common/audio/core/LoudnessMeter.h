@@ -0,0 +1,57 @@
+#ifndef LOUDNESS_METER_H
+#define LOUDNESS_METER_H
+
+#include "Filters.h"
+
+#include <vector>
+
+namespace audio {
+
+/**
+    Integrated loudness (LUFS) as described in ITU-R BS.1770: the samples are K-weighted (high shelf
+    + high pass biquads), the mean square is computed in 400 ms blocks overlapped by 75%, and the
+    blocks are gated (absolute gate in -70 LUFS and relative gate 10 LU below the ungated loudness).
+    Mono samples are measured as dual mono, the same way they are played.
+ */
+
+class LoudnessMeter
+{
+public:
+    explicit LoudnessMeter(int sampleRate = 44100);
+
+    void setSampleRate(int sampleRate); // reset the measurement
+    int getSampleRate() const;
+
+    void process(const float *left, const float *right, quint32 samples); // 'right' can be null (mono)
+
+    double getIntegratedLoudness() const; // SILENCE when no block is above the absolute gate
+
+    void reset();
+
+    static const double SILENCE;
+
+private:
+    static const int HOPS_PER_BLOCK = 4; // 400 ms blocks, 100 ms hops
+
+    int sampleRate;
+    quint32 hopSize;
+    quint32 hopPosition;
+    double hopPower;
+
+    double hops[HOPS_PER_BLOCK];
+    int completedHops;
+
+    std::vector<double> blocksPower; // mean square of each 400 ms block
+
+    MultiChannelFilter kWeighting;
+    std::vector<float> weighted[2];
+};
+
+inline int LoudnessMeter::getSampleRate() const
+{
+    return sampleRate;
+}
+
+} // namespace
+
+#endif // LOUDNESS_METER_H
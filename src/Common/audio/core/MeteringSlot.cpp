@@ -0,0 +1,89 @@
+#include "MeteringSlot.h"
+
+#include <atomic>
+#include <cstring>
+
+using audio::MeteringSlot;
+using audio::AudioPeak;
+
+MeteringSlot::MeteringSlot() :
+    sequence(0),
+    resetSequence(0),
+    clips(0)
+{
+    for (auto &value : values)
+        value.store(0);
+}
+
+quint32 MeteringSlot::toBits(float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float MeteringSlot::fromBits(quint32 bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void MeteringSlot::publish(const AudioPeak &peak)
+{
+    const quint32 currentSequence = sequence.load();
+
+    sequence.store(currentSequence + 1); // odd, writing
+    std::atomic_thread_fence(std::memory_order_release);
+
+    values[0].store(toBits(peak.getLeftPeak()));
+    values[1].store(toBits(peak.getRightPeak()));
+    values[2].store(toBits(peak.getLeftRMS()));
+    values[3].store(toBits(peak.getRightRMS()));
+
+    if (peak.getMaxPeak() >= 1.0f)
+        clips.fetchAndAddRelaxed(1);
+
+    sequence.storeRelease(currentSequence + 2); // even, done
+}
+
+MeteringSlot::Snapshot MeteringSlot::getSnapshot() const
+{
+    Snapshot snapshot;
+
+    quint32 firstSequence;
+    quint32 lastSequence;
+    do {
+        firstSequence = sequence.loadAcquire();
+        if (firstSequence & 1) // the writer is storing a new block
+            continue;
+
+        snapshot.peak = AudioPeak(fromBits(values[0].load()), fromBits(values[1].load()),
+                                  fromBits(values[2].load()), fromBits(values[3].load()));
+        snapshot.clips = clips.load();
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        lastSequence = sequence.load();
+    }
+    while ((firstSequence & 1) || firstSequence != lastSequence);
+
+    snapshot.sequence = firstSequence;
+
+    if (firstSequence == resetSequence.loadAcquire())
+        snapshot.peak.zero(); // reset and no new block published after the reset
+
+    return snapshot;
+}
+
+AudioPeak MeteringSlot::getLastPeak() const
+{
+    return getSnapshot().peak;
+}
+
+void MeteringSlot::reset()
+{
+    const quint32 currentSequence = sequence.loadAcquire();
+
+    // when the writer is storing a block (odd sequence) this block is ignored too
+    resetSequence.storeRelease(currentSequence + (currentSequence & 1));
+}
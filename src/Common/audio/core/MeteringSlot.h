@@ -0,0 +1,53 @@
+#ifndef METERING_SLOT_H
+#define METERING_SLOT_H
+
+#include "AudioPeak.h"
+
+#include <QAtomicInteger>
+
+namespace audio {
+
+/**
+    Peak/RMS values published by the audio thread after each processed block and read by the GUI
+    thread without locks. A sequence lock is used: the writer makes the sequence odd while storing
+    the values, and the readers retry when the sequence is odd or changed during the read, so a
+    snapshot is never torn (left peak from one block and right peak from another).
+
+    Only raw block values are published. Peak hold and decay are computed in the GUI meters.
+ */
+
+class MeteringSlot
+{
+public:
+    struct Snapshot
+    {
+        AudioPeak peak;
+        quint32 clips;    // published blocks with some sample >= 0 dBFS
+        quint32 sequence; // changed when a new block is published
+    };
+
+    MeteringSlot();
+
+    void publish(const AudioPeak &peak); // audio thread (just one writer)
+
+    Snapshot getSnapshot() const; // any thread
+    AudioPeak getLastPeak() const;
+
+    void reset(); // any thread, the current values are ignored until the next publication
+
+private:
+    MeteringSlot(const MeteringSlot &other);
+    MeteringSlot &operator=(const MeteringSlot &other);
+
+    static quint32 toBits(float value);
+    static float fromBits(quint32 bits);
+
+    QAtomicInteger<quint32> sequence; // odd while the writer is storing the values
+    QAtomicInteger<quint32> resetSequence;
+    QAtomicInteger<quint32> values[4]; // left/right peaks and left/right rms, stored as float bits
+    QAtomicInteger<quint32> clips;
+};
+
+} // namespace
+
+#endif // METERING_SLOT_H
@@ -0,0 +1,238 @@
+#include "PeaksPyramid.h"
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define PEAKS_PYRAMID_USE_SSE
+    #include <xmmintrin.h>
+#endif
+
+using audio::PeaksPyramid;
+
+const uint PeaksPyramid::BASE_BLOCK;
+
+PeaksPyramid::PeaksPyramid() :
+    maxSamples(0)
+{
+
+}
+
+void PeaksPyramid::resize(uint maxSamples)
+{
+    if (maxSamples <= this->maxSamples)
+        return;
+
+    this->maxSamples = maxSamples;
+
+    uint buckets = (maxSamples + BASE_BLOCK - 1) / BASE_BLOCK;
+    uint level = 0;
+    while (true) {
+        if (level >= levels.size())
+            levels.push_back(Level());
+
+        levels[level].mins.resize(buckets, 0.0f);
+        levels[level].maxs.resize(buckets, 0.0f);
+
+        if (buckets <= 1)
+            break;
+
+        buckets = (buckets + 1) / 2;
+        level++;
+    }
+}
+
+void PeaksPyramid::clear()
+{
+    for (Level &level : levels) {
+        std::fill(level.mins.begin(), level.mins.end(), 0.0f);
+        std::fill(level.maxs.begin(), level.maxs.end(), 0.0f);
+    }
+}
+
+void PeaksPyramid::updateBaseBucket(const float *left, const float *right, uint availableSamples, uint bucket)
+{
+    const uint start = bucket * BASE_BLOCK;
+    const uint count = std::min(BASE_BLOCK, availableSamples - start);
+
+    float leftMin, leftMax, rightMin, rightMax;
+    computeMinMax(left + start, count, leftMin, leftMax);
+    computeMinMax(right + start, count, rightMin, rightMax);
+
+    levels[0].mins[bucket] = std::min(leftMin, rightMin);
+    levels[0].maxs[bucket] = std::max(leftMax, rightMax);
+}
+
+void PeaksPyramid::update(const float *left, const float *right, uint availableSamples, uint from, uint count)
+{
+    availableSamples = std::min(availableSamples, maxSamples);
+    if (!count || levels.empty() || from >= availableSamples)
+        return;
+
+    const uint end = std::min(from + count, availableSamples);
+    uint firstBucket = from / BASE_BLOCK;
+    uint lastBucket = (end - 1) / BASE_BLOCK;
+
+    for (uint bucket = firstBucket; bucket <= lastBucket; ++bucket)
+        updateBaseBucket(left, right, availableSamples, bucket);
+
+    // propagate to upper levels, only the touched buckets are recomputed
+    for (size_t l = 1; l < levels.size(); ++l) {
+        const Level &lower = levels[l - 1];
+        Level &level = levels[l];
+
+        firstBucket /= 2;
+        lastBucket /= 2;
+
+        for (uint bucket = firstBucket; bucket <= lastBucket; ++bucket) {
+            const uint child = bucket * 2;
+            float min = lower.mins[child];
+            float max = lower.maxs[child];
+            if (child + 1 < lower.mins.size()) {
+                min = std::min(min, lower.mins[child + 1]);
+                max = std::max(max, lower.maxs[child + 1]);
+            }
+            level.mins[bucket] = min;
+            level.maxs[bucket] = max;
+        }
+    }
+}
+
+void PeaksPyramid::getMaxPeaks(const float *left, const float *right, uint availableSamples, uint samplesPerPeak, std::vector<float> &peaks) const
+{
+    peaks.clear();
+
+    availableSamples = std::min(availableSamples, maxSamples);
+    if (!samplesPerPeak || !availableSamples)
+        return;
+
+    const uint totalPeaks = (availableSamples + samplesPerPeak - 1) / samplesPerPeak;
+    peaks.reserve(totalPeaks);
+
+    const bool hasSamples = left && right; // compacted looper layers have only the pyramid levels
+    if ((samplesPerPeak < BASE_BLOCK && hasSamples) || levels.empty()) { // zoomed in, the buckets are bigger than a peak
+        if (!hasSamples)
+            return;
+
+        for (uint start = 0; start < availableSamples; start += samplesPerPeak) {
+            const uint count = std::min(samplesPerPeak, availableSamples - start);
+            peaks.push_back(std::max(computeMaxAbs(left + start, count), computeMaxAbs(right + start, count)));
+        }
+        return;
+    }
+
+    for (uint start = 0; start < availableSamples; start += samplesPerPeak) {
+        const uint end = std::min(start + samplesPerPeak, availableSamples);
+        peaks.push_back(getMaxPeak(hasSamples ? left : nullptr, hasSamples ? right : nullptr, availableSamples, start, end));
+    }
+}
+
+float PeaksPyramid::getMaxPeak(const float *left, const float *right, uint availableSamples, uint start, uint end) const
+{
+    // the last bucket is not full when the available samples are not a multiple of BASE_BLOCK
+    const uint lastBucketEnd = end == availableSamples ? end + BASE_BLOCK - 1 : end;
+
+    uint firstBucket = start / BASE_BLOCK;
+    uint endBucket = (end + BASE_BLOCK - 1) / BASE_BLOCK; // exclusive
+    float maxAbs = 0.0f;
+
+    if (left && right) {
+        // the partial buckets in the edges are computed using the samples, so the peak is exact
+        firstBucket = (start + BASE_BLOCK - 1) / BASE_BLOCK;
+        endBucket = std::max(lastBucketEnd / BASE_BLOCK, firstBucket);
+
+        const uint headEnd = std::min(firstBucket * BASE_BLOCK, end);
+        if (start < headEnd)
+            maxAbs = std::max(computeMaxAbs(left + start, headEnd - start), computeMaxAbs(right + start, headEnd - start));
+
+        const uint tailStart = std::max(endBucket * BASE_BLOCK, headEnd);
+        if (tailStart < end)
+            maxAbs = std::max(maxAbs, std::max(computeMaxAbs(left + tailStart, end - tailStart), computeMaxAbs(right + tailStart, end - tailStart)));
+    }
+
+    // the whole buckets are read in the biggest levels, just a few buckets per level
+    float min = 0.0f;
+    float max = 0.0f;
+    for (size_t l = 0; l < levels.size() && firstBucket < endBucket; ++l) {
+        const Level &level = levels[l];
+        if (firstBucket & 1) {
+            min = std::min(min, level.mins[firstBucket]);
+            max = std::max(max, level.maxs[firstBucket]);
+            firstBucket++;
+        }
+        if (endBucket & 1) {
+            endBucket--;
+            min = std::min(min, level.mins[endBucket]);
+            max = std::max(max, level.maxs[endBucket]);
+        }
+        firstBucket /= 2;
+        endBucket /= 2;
+    }
+
+    return std::max(maxAbs, std::max(max, -min));
+}
+
+float PeaksPyramid::computeMaxAbs(const float *samples, uint count)
+{
+    uint i = 0;
+    float maxAbs = 0.0f;
+
+#ifdef PEAKS_PYRAMID_USE_SSE
+    if (count >= 4) {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 maxValues = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4)
+            maxValues = _mm_max_ps(maxValues, _mm_andnot_ps(signMask, _mm_loadu_ps(samples + i))); // clear the sign bits
+
+        // horizontal max
+        maxValues = _mm_max_ps(maxValues, _mm_movehl_ps(maxValues, maxValues));
+        maxValues = _mm_max_ss(maxValues, _mm_shuffle_ps(maxValues, maxValues, 1));
+        maxAbs = _mm_cvtss_f32(maxValues);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        float value = samples[i];
+        if (value < 0)
+            value = -value; // std::fabs is slow, just negate if needed
+
+        if (value > maxAbs)
+            maxAbs = value;
+    }
+
+    return maxAbs;
+}
+
+void PeaksPyramid::computeMinMax(const float *samples, uint count, float &min, float &max)
+{
+    uint i = 0;
+    min = 0.0f;
+    max = 0.0f;
+
+#ifdef PEAKS_PYRAMID_USE_SSE
+    if (count >= 4) {
+        __m128 minValues = _mm_setzero_ps();
+        __m128 maxValues = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            const __m128 values = _mm_loadu_ps(samples + i);
+            minValues = _mm_min_ps(minValues, values);
+            maxValues = _mm_max_ps(maxValues, values);
+        }
+
+        minValues = _mm_min_ps(minValues, _mm_movehl_ps(minValues, minValues));
+        minValues = _mm_min_ss(minValues, _mm_shuffle_ps(minValues, minValues, 1));
+        maxValues = _mm_max_ps(maxValues, _mm_movehl_ps(maxValues, maxValues));
+        maxValues = _mm_max_ss(maxValues, _mm_shuffle_ps(maxValues, maxValues, 1));
+        min = _mm_cvtss_f32(minValues);
+        max = _mm_cvtss_f32(maxValues);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float value = samples[i];
+        if (value < min)
+            min = value;
+
+        if (value > max)
+            max = value;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef _AUDIO_PEAKS_PYRAMID_
+#define _AUDIO_PEAKS_PYRAMID_
+
+#include <vector>
+#include <QtGlobal>
+
+namespace audio {
+
+/**
+    Multi resolution min/max peaks cache. The first level stores min and max values for
+    every BASE_BLOCK samples, each next level combines two buckets of the previous level
+    (power of two levels). The levels are updated incrementally when samples are recorded
+    or overdubbed, and any zoom (samples per peak) is computed reading only a few buckets per pixel.
+ */
+
+class PeaksPyramid
+{
+public:
+    PeaksPyramid();
+
+    void resize(uint maxSamples); // allocate all levels, call this outside the audio callback when possible
+    void clear();
+
+    // recompute the buckets touching the range [from, from + count) and propagate the changes to the upper levels
+    void update(const float *left, const float *right, uint availableSamples, uint from, uint count);
+
+    // fill 'peaks' with the max absolute values, one value per 'samplesPerPeak' samples. 'left' and 'right' can be null, only the
+    // levels are used and the buckets in the peaks edges can include some neighbour samples
+    void getMaxPeaks(const float *left, const float *right, uint availableSamples, uint samplesPerPeak, std::vector<float> &peaks) const;
+
+    inline uint getLevels() const { return static_cast<uint>(levels.size()); }
+
+    static float computeMaxAbs(const float *samples, uint count); // SIMD max(abs(sample)) reduction
+    static void computeMinMax(const float *samples, uint count, float &min, float &max); // SIMD min/max reduction
+
+    static const uint BASE_BLOCK = 64; // samples in each bucket of the first level
+
+private:
+    struct Level
+    {
+        std::vector<float> mins;
+        std::vector<float> maxs;
+    };
+
+    std::vector<Level> levels;
+    uint maxSamples;
+
+    void updateBaseBucket(const float *left, const float *right, uint availableSamples, uint bucket);
+    float getMaxPeak(const float *left, const float *right, uint availableSamples, uint start, uint end) const;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef _AUDIO_RING_BUFFER_
+#define _AUDIO_RING_BUFFER_
+
+#include <QtGlobal>
+#include <QAtomicInteger>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+namespace audio {
+
+/**
+    Fixed size, lock free, single producer / single consumer ring buffer. The memory is allocated
+    only in the constructor (or in 'resize'), so 'write' and 'read' can be used in the audio thread.
+    The capacity is rounded to the next power of two.
+ */
+
+template <typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(quint32 capacity = 0)
+        : writePosition(0),
+          readPosition(0)
+    {
+        resize(capacity);
+    }
+
+    void resize(quint32 capacity) // not thread safe, call before producer and consumer start
+    {
+        quint32 size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        data.assign(size, T());
+        mask = size - 1;
+        clear();
+    }
+
+    void clear() // not thread safe
+    {
+        writePosition.store(0);
+        readPosition.store(0);
+    }
+
+    inline quint32 getCapacity() const { return static_cast<quint32>(data.size()); }
+
+    inline quint32 getAvailable() const // items ready to read
+    {
+        return writePosition.loadAcquire() - readPosition.loadAcquire();
+    }
+
+    inline quint32 getFree() const // items that can be written
+    {
+        return getCapacity() - getAvailable();
+    }
+
+    quint32 write(const T *items, quint32 count) // producer thread, return the written items
+    {
+        const quint32 write = writePosition.load();
+        count = std::min(count, getCapacity() - (write - readPosition.loadAcquire()));
+        if (!count)
+            return 0;
+
+        const quint32 start = write & mask;
+        const quint32 firstPart = std::min(count, getCapacity() - start); // split in two copies when wrapping
+        std::copy(items, items + firstPart, &data[start]);
+        std::copy(items + firstPart, items + count, &data[0]);
+
+        writePosition.storeRelease(write + count);
+        return count;
+    }
+
+    quint32 read(T *items, quint32 count) // consumer thread, return the read items
+    {
+        const quint32 read = readPosition.load();
+        count = std::min(count, writePosition.loadAcquire() - read);
+        if (!count)
+            return 0;
+
+        const quint32 start = read & mask;
+        const quint32 firstPart = std::min(count, getCapacity() - start);
+        std::copy(&data[start], &data[start] + firstPart, items);
+        std::copy(&data[0], &data[0] + (count - firstPart), items + firstPart);
+
+        readPosition.storeRelease(read + count);
+        return count;
+    }
+
+private:
+    std::vector<T> data;
+    quint32 mask;
+    QAtomicInteger<quint32> writePosition; // only incremented, the unsigned overflow is fine
+    QAtomicInteger<quint32> readPosition;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,436 @@
+#include "BridgeTransport.h"
+#include "audio/core/SamplesBuffer.h"
+#include "midi/MidiMessage.h"
+#include "log/Logging.h"
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QThread>
+#include <cstring>
+#include <new>
+
+#if defined(Q_OS_LINUX)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <ctime>
+    #include <cerrno>
+#elif defined(Q_OS_WIN)
+    #include <windows.h>
+#endif
+
+using bridge::BridgeTransport;
+using audio::SamplesBuffer;
+using midi::MidiMessage;
+
+namespace {
+
+const quint32 FRAMES = 4096;
+const quint32 CHANNELS = 2;
+const quint32 MIDI_MESSAGES = 128;
+const quint32 SLOTS = 4; // blocks in each ring
+const quint32 MAGIC = 0x4A544252; // 'JTBR'
+const quint32 VERSION = 2; // responses are carrying midi messages since version 2
+
+const qint64 SPIN_TIME = 20000; // nanoseconds spinning before sleep
+
+} // namespace
+
+const quint32 BridgeTransport::MAX_FRAMES = FRAMES;
+const quint32 BridgeTransport::MAX_CHANNELS = CHANNELS;
+const quint32 BridgeTransport::MAX_MIDI_MESSAGES = MIDI_MESSAGES;
+
+struct BridgeTransport::Ring
+{
+    QAtomicInteger<quint32> writeCount; // the futex word, incremented for each published block
+    QAtomicInteger<quint32> readCount;
+    QAtomicInteger<quint32> consumerSleeping;
+};
+
+struct BridgeTransport::Block
+{
+    struct MidiData
+    {
+        qint32 data;
+        quint32 sampleOffset;
+    };
+
+    quint32 sequence;
+    quint32 frames;
+    quint32 channels;
+    TimeInfo timeInfo;
+    quint32 midiMessages;
+    quint32 latency; // responses only, the plugin processing latency in samples
+    MidiData midi[MIDI_MESSAGES];
+    float samples[CHANNELS][FRAMES];
+};
+
+struct BridgeTransport::Layout
+{
+    quint32 magic;
+    quint32 version;
+    Ring requests;
+    Ring responses;
+    Block requestBlocks[SLOTS];
+    Block responseBlocks[SLOTS];
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class BridgeTransport::Signal
+{
+public:
+    explicit Signal(const QString &name);
+    ~Signal();
+
+    void wait(QAtomicInteger<quint32> *word, quint32 expectedValue, qint64 timeoutInNanoseconds);
+    void wake(QAtomicInteger<quint32> *word);
+
+private:
+#ifdef Q_OS_WIN
+    HANDLE event;
+#endif
+};
+
+#if defined(Q_OS_LINUX)
+
+BridgeTransport::Signal::Signal(const QString &name)
+{
+    Q_UNUSED(name) // the futex word lives in shared memory, no names are necessary
+}
+
+BridgeTransport::Signal::~Signal()
+{
+
+}
+
+void BridgeTransport::Signal::wait(QAtomicInteger<quint32> *word, quint32 expectedValue, qint64 timeoutInNanoseconds)
+{
+    timespec timeout;
+    timeout.tv_sec = timeoutInNanoseconds / 1000000000;
+    timeout.tv_nsec = timeoutInNanoseconds % 1000000000;
+
+    // not using FUTEX_PRIVATE_FLAG, the word is shared between processes
+    syscall(SYS_futex, reinterpret_cast<int *>(word), FUTEX_WAIT, expectedValue, &timeout, nullptr, 0);
+}
+
+void BridgeTransport::Signal::wake(QAtomicInteger<quint32> *word)
+{
+    syscall(SYS_futex, reinterpret_cast<int *>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+#elif defined(Q_OS_WIN)
+
+BridgeTransport::Signal::Signal(const QString &name)
+{
+    const QString eventName = "Local\\" + name;
+    event = CreateEventW(nullptr, FALSE, FALSE, reinterpret_cast<LPCWSTR>(eventName.utf16())); // auto reset, opened if already created by the other process
+}
+
+BridgeTransport::Signal::~Signal()
+{
+    if (event)
+        CloseHandle(event);
+}
+
+void BridgeTransport::Signal::wait(QAtomicInteger<quint32> *word, quint32 expectedValue, qint64 timeoutInNanoseconds)
+{
+    Q_UNUSED(word)
+    Q_UNUSED(expectedValue)
+
+    if (event)
+        WaitForSingleObject(event, static_cast<DWORD>((timeoutInNanoseconds + 999999) / 1000000));
+}
+
+void BridgeTransport::Signal::wake(QAtomicInteger<quint32> *word)
+{
+    Q_UNUSED(word)
+
+    if (event)
+        SetEvent(event);
+}
+
+#else
+
+BridgeTransport::Signal::Signal(const QString &name)
+{
+    Q_UNUSED(name)
+}
+
+BridgeTransport::Signal::~Signal()
+{
+
+}
+
+void BridgeTransport::Signal::wait(QAtomicInteger<quint32> *word, quint32 expectedValue, qint64 timeoutInNanoseconds)
+{
+    Q_UNUSED(word)
+    Q_UNUSED(expectedValue)
+
+    QThread::usleep(qBound<qint64>(1, timeoutInNanoseconds / 1000, 50)); // polling, there is no futex in Mac
+}
+
+void BridgeTransport::Signal::wake(QAtomicInteger<quint32> *word)
+{
+    Q_UNUSED(word)
+}
+
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+BridgeTransport::BridgeTransport(const QString &key) :
+    sharedMemory(key),
+    lastSequence(0),
+    currentSequence(0),
+    responseLatency(0)
+{
+
+}
+
+BridgeTransport::~BridgeTransport()
+{
+    close();
+}
+
+QString BridgeTransport::getKey() const
+{
+    return sharedMemory.key();
+}
+
+bool BridgeTransport::isOpen() const
+{
+    return sharedMemory.isAttached();
+}
+
+BridgeTransport::Layout *BridgeTransport::getLayout() const
+{
+    return static_cast<Layout *>(const_cast<void *>(sharedMemory.constData()));
+}
+
+bool BridgeTransport::create()
+{
+    if (!sharedMemory.create(sizeof(Layout))) {
+        qCritical() << "Can't create the plugin bridge shared memory" << sharedMemory.errorString();
+        return false;
+    }
+
+    Layout *layout = new (sharedMemory.data()) Layout();
+    layout->magic = MAGIC;
+    layout->version = VERSION;
+
+    requestsSignal.reset(new Signal(getKey() + "-requests"));
+    responsesSignal.reset(new Signal(getKey() + "-responses"));
+
+    lastSequence = 0;
+
+    return true;
+}
+
+bool BridgeTransport::attach()
+{
+    if (!sharedMemory.attach()) {
+        qCritical() << "Can't attach the plugin bridge shared memory" << sharedMemory.errorString();
+        return false;
+    }
+
+    const Layout *layout = getLayout();
+    if (sharedMemory.size() < static_cast<int>(sizeof(Layout)) || layout->magic != MAGIC || layout->version != VERSION) {
+        qCritical() << "Invalid plugin bridge shared memory, JamTaba and plugin bridge versions are different?";
+        sharedMemory.detach();
+        return false;
+    }
+
+    requestsSignal.reset(new Signal(getKey() + "-requests"));
+    responsesSignal.reset(new Signal(getKey() + "-responses"));
+
+    currentSequence = 0;
+
+    return true;
+}
+
+void BridgeTransport::close()
+{
+    if (sharedMemory.isAttached())
+        sharedMemory.detach();
+
+    requestsSignal.reset();
+    responsesSignal.reset();
+}
+
+BridgeTransport::Block *BridgeTransport::getWritableBlock(Ring &ring, Block *blocks)
+{
+    const quint32 write = ring.writeCount.load();
+    if (write - ring.readCount.loadAcquire() >= SLOTS)
+        return nullptr; // the consumer is late
+
+    return &blocks[write % SLOTS];
+}
+
+void BridgeTransport::publish(Ring &ring, Signal &signal)
+{
+    ring.writeCount.fetchAndAddOrdered(1);
+
+    if (ring.consumerSleeping.loadAcquire()) // avoid a system call when the consumer is spinning
+        signal.wake(&ring.writeCount);
+}
+
+const BridgeTransport::Block *BridgeTransport::waitBlock(Ring &ring, const Block *blocks, Signal &signal, int timeoutInMicroseconds)
+{
+    const quint32 read = ring.readCount.load();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const qint64 timeout = static_cast<qint64>(timeoutInMicroseconds) * 1000;
+
+    while (ring.writeCount.loadAcquire() == read) {
+        const qint64 elapsed = timer.nsecsElapsed();
+        if (elapsed >= timeout)
+            return nullptr;
+
+        if (elapsed < SPIN_TIME)
+            continue;
+
+        ring.consumerSleeping.fetchAndStoreOrdered(1);
+        if (ring.writeCount.loadAcquire() == read) // published after the last check?
+            signal.wait(&ring.writeCount, read, timeout - elapsed);
+
+        ring.consumerSleeping.fetchAndStoreOrdered(0);
+    }
+
+    return &blocks[read % SLOTS];
+}
+
+void BridgeTransport::release(Ring &ring)
+{
+    ring.readCount.fetchAndAddOrdered(1);
+}
+
+void BridgeTransport::writeMidiMessages(Block *block, const std::vector<MidiMessage> &midiMessages)
+{
+    block->midiMessages = qMin(static_cast<quint32>(midiMessages.size()), MAX_MIDI_MESSAGES);
+    for (quint32 m = 0; m < block->midiMessages; ++m) {
+        const MidiMessage &message = midiMessages[m];
+        block->midi[m].data = message.getStatus() | (message.getData1() << 8) | (message.getData2() << 16);
+        block->midi[m].sampleOffset = message.getSampleOffset();
+    }
+}
+
+void BridgeTransport::readMidiMessages(const Block *block, std::vector<MidiMessage> &midiMessages)
+{
+    midiMessages.clear(); // the capacity is kept, no allocations when 'MAX_MIDI_MESSAGES' are reserved
+    for (quint32 m = 0; m < block->midiMessages; ++m) {
+        MidiMessage message(block->midi[m].data, -1);
+        message.setSampleOffset(block->midi[m].sampleOffset);
+        midiMessages.push_back(message);
+    }
+}
+
+quint32 BridgeTransport::sendRequest(const SamplesBuffer &in, const std::vector<MidiMessage> &midiMessages, const TimeInfo &timeInfo)
+{
+    Layout *layout = getLayout();
+    Block *block = getWritableBlock(layout->requests, layout->requestBlocks);
+    if (!block)
+        return 0;
+
+    block->sequence = ++lastSequence;
+    if (!block->sequence) // zero is used to report full rings
+        block->sequence = ++lastSequence;
+
+    block->frames = qMin(in.getFrameLenght(), MAX_FRAMES);
+    block->channels = qMin(static_cast<quint32>(in.getChannels()), MAX_CHANNELS);
+    block->timeInfo = timeInfo;
+    block->latency = 0;
+
+    for (quint32 c = 0; c < block->channels; ++c)
+        std::memcpy(block->samples[c], in.getSamplesArray(c), block->frames * sizeof(float));
+
+    writeMidiMessages(block, midiMessages);
+
+    publish(layout->requests, *requestsSignal);
+
+    return block->sequence;
+}
+
+bool BridgeTransport::waitResponse(quint32 sequence, SamplesBuffer &out, std::vector<MidiMessage> &midiMessages, int timeoutInMicroseconds)
+{
+    Layout *layout = getLayout();
+
+    forever {
+        const Block *block = waitBlock(layout->responses, layout->responseBlocks, *responsesSignal, timeoutInMicroseconds);
+        if (!block)
+            return false;
+
+        const bool isExpectedBlock = block->sequence == sequence;
+        const bool isOldBlock = static_cast<qint32>(block->sequence - sequence) < 0;
+
+        if (isExpectedBlock) {
+            const quint32 frames = qMin(block->frames, out.getFrameLenght());
+            const quint32 channels = qMin(block->channels, static_cast<quint32>(out.getChannels()));
+            for (quint32 c = 0; c < channels; ++c)
+                std::memcpy(out.getSamplesArray(c), block->samples[c], frames * sizeof(float));
+
+            readMidiMessages(block, midiMessages);
+
+            responseLatency.storeRelease(block->latency);
+        }
+
+        if (isExpectedBlock || isOldBlock)
+            release(layout->responses); // late responses for previous requests are discarded
+
+        if (isExpectedBlock)
+            return true;
+
+        if (!isOldBlock)
+            return false; // response for a future request? Not possible, but avoid spinning
+    }
+}
+
+bool BridgeTransport::waitRequest(SamplesBuffer &in, std::vector<MidiMessage> &midiMessages, TimeInfo &timeInfo, int timeoutInMicroseconds)
+{
+    Layout *layout = getLayout();
+    const Block *block = waitBlock(layout->requests, layout->requestBlocks, *requestsSignal, timeoutInMicroseconds);
+    if (!block)
+        return false;
+
+    currentSequence = block->sequence;
+    timeInfo = block->timeInfo;
+
+    if (block->channels > 1)
+        in.setToStereo();
+    else
+        in.setToMono();
+
+    in.setFrameLenght(block->frames);
+    for (quint32 c = 0; c < block->channels; ++c)
+        std::memcpy(in.getSamplesArray(c), block->samples[c], block->frames * sizeof(float));
+
+    readMidiMessages(block, midiMessages);
+
+    release(layout->requests);
+
+    return true;
+}
+
+bool BridgeTransport::sendResponse(const SamplesBuffer &out, const std::vector<MidiMessage> &midiMessages, quint32 latency)
+{
+    Layout *layout = getLayout();
+    Block *block = getWritableBlock(layout->responses, layout->responseBlocks);
+    if (!block)
+        return false;
+
+    block->sequence = currentSequence;
+    block->frames = qMin(out.getFrameLenght(), MAX_FRAMES);
+    block->channels = qMin(static_cast<quint32>(out.getChannels()), MAX_CHANNELS);
+    block->latency = latency;
+
+    for (quint32 c = 0; c < block->channels; ++c)
+        std::memcpy(block->samples[c], out.getSamplesArray(c), block->frames * sizeof(float));
+
+    writeMidiMessages(block, midiMessages);
+
+    publish(layout->responses, *responsesSignal);
+
+    return true;
+}
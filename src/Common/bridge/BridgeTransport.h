@@ -0,0 +1,102 @@
+#ifndef BRIDGE_TRANSPORT_H
+#define BRIDGE_TRANSPORT_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QSharedMemory>
+#include <QScopedPointer>
+#include <QAtomicInteger>
+#include <vector>
+
+namespace audio {
+class SamplesBuffer;
+}
+
+namespace midi {
+class MidiMessage;
+}
+
+namespace bridge {
+
+/**
+    Audio and MIDI transport between JamTaba and a plugin host process (PluginBridge). Two lock-free
+    single producer/single consumer rings live in a shared memory segment: JamTaba writes the blocks
+    to process in the requests ring and the host process writes the processed blocks in the responses
+    ring. The consumer spins for a few microseconds before sleeping in a futex (Linux) or in a named
+    event (Windows), the producer wakes the consumer only when it is sleeping. In Mac the consumer is
+    polling with short sleeps.
+
+    'sendRequest'/'waitResponse' are used in the JamTaba audio thread and 'waitRequest'/'sendResponse'
+    in the host process audio thread. No memory is allocated after 'create' or 'attach'.
+ */
+
+class BridgeTransport
+{
+public:
+    struct TimeInfo // host time line, forwarded to the bridged plugins
+    {
+        quint32 sampleRate;
+        quint32 bpm;
+        qint32 positionInSamples;
+        bool playing;
+    };
+
+    explicit BridgeTransport(const QString &key);
+    ~BridgeTransport();
+
+    bool create(); // JamTaba side, create the shared memory segment
+    bool attach(); // host process side
+    void close();
+
+    bool isOpen() const;
+
+    QString getKey() const;
+
+    // JamTaba side. 'sendRequest' return the request sequence, zero when the requests ring is full
+    quint32 sendRequest(const audio::SamplesBuffer &in, const std::vector<midi::MidiMessage> &midiMessages, const TimeInfo &timeInfo);
+    bool waitResponse(quint32 sequence, audio::SamplesBuffer &out, std::vector<midi::MidiMessage> &midiMessages, int timeoutInMicroseconds); // late responses for old requests are discarded
+    quint32 getResponseLatency() const; // the plugin latency reported in the last response
+
+    // host process side
+    bool waitRequest(audio::SamplesBuffer &in, std::vector<midi::MidiMessage> &midiMessages, TimeInfo &timeInfo, int timeoutInMicroseconds);
+    bool sendResponse(const audio::SamplesBuffer &out, const std::vector<midi::MidiMessage> &midiMessages, quint32 latency = 0); // midi messages generated by the plugin
+
+    static const quint32 MAX_FRAMES;
+    static const quint32 MAX_CHANNELS;
+    static const quint32 MAX_MIDI_MESSAGES;
+
+private:
+    struct Ring;
+    struct Block;
+    struct Layout;
+
+    class Signal; // futex or named event used to wake up the consumer
+
+    Layout *getLayout() const;
+
+    static Block *getWritableBlock(Ring &ring, Block *blocks); // nullptr when the ring is full
+    static void publish(Ring &ring, Signal &signal);
+    static const Block *waitBlock(Ring &ring, const Block *blocks, Signal &signal, int timeoutInMicroseconds);
+    static void release(Ring &ring);
+
+    static void writeMidiMessages(Block *block, const std::vector<midi::MidiMessage> &midiMessages);
+    static void readMidiMessages(const Block *block, std::vector<midi::MidiMessage> &midiMessages);
+
+    QSharedMemory sharedMemory;
+    QScopedPointer<Signal> requestsSignal;
+    QScopedPointer<Signal> responsesSignal;
+
+    quint32 lastSequence; // JamTaba side
+    quint32 currentSequence; // host process side, the sequence of the last received request
+
+    QAtomicInteger<quint32> responseLatency; // JamTaba side, read in GUI thread
+};
+
+inline quint32 BridgeTransport::getResponseLatency() const
+{
+    return responseLatency.loadAcquire();
+}
+
+} // namespace
+
+#endif // BRIDGE_TRANSPORT_H
@@ -0,0 +1,173 @@
+#include "FileReader.h"
+
+#include <QFile>
+#include <QDebug>
+
+using audio::FileReader;
+using audio::CompressedFileReader;
+using audio::SamplesBuffer;
+
+bool FileReader::read(const QString &filePath, SamplesBuffer &outBuffer, quint32 &sampleRate)
+{
+    if (!open(filePath))
+        return false;
+
+    sampleRate = getSampleRate();
+
+    if (getChannels() == 1)
+        outBuffer.setToMono();
+    else
+        outBuffer.setToStereo();
+
+    const quint32 maxFrames = outBuffer.getFrameLenght(); // zero = entire file
+    const quint64 totalFrames = getTotalFrames();
+
+    if (totalFrames > 0) { // decoding directly in 'outBuffer', no intermediate copies
+        quint64 frames = maxFrames > 0 ? qMin(static_cast<quint64>(maxFrames), totalFrames) : totalFrames;
+        readFrames(outBuffer, static_cast<quint32>(frames));
+    }
+    else { // unknown lenght, decoding and appending chunks
+        SamplesBuffer chunk(outBuffer.getChannels());
+        outBuffer.setFrameLenght(0);
+        forever {
+            quint32 framesToRead = CHUNK_FRAMES;
+            if (maxFrames > 0)
+                framesToRead = qMin(framesToRead, maxFrames - outBuffer.getFrameLenght());
+
+            if (!framesToRead || !readFrames(chunk, framesToRead))
+                break;
+
+            outBuffer.append(chunk);
+        }
+    }
+
+    close();
+
+    return true;
+}
+
+// ----------------------------------------------------------------------
+
+CompressedFileReader::CompressedFileReader() :
+    decodedSamples(2),
+    decodedOffset(0),
+    channels(2),
+    opened(false)
+{
+
+}
+
+bool CompressedFileReader::open(const QString &filePath)
+{
+    close();
+
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly)) {
+        qCritical() << "Failed to open audio file ..." << filePath << file.errorString();
+        return false;
+    }
+
+    encodedData = file.readAll(); // just the compressed data, the samples are decoded on demand
+
+    opened = restart();
+    if (!opened)
+        close();
+
+    return opened;
+}
+
+bool CompressedFileReader::restart()
+{
+    releaseDecoder();
+
+    decodedSamples.setFrameLenght(0);
+    decodedOffset = 0;
+
+    if (!initializeDecoder(encodedData))
+        return false;
+
+    // decoding the first chunk, sample rate and channels are available after this
+    if (fillDecodedSamples())
+        channels = decodedSamples.isMono() ? 1 : 2;
+
+    return true;
+}
+
+void CompressedFileReader::close()
+{
+    releaseDecoder();
+
+    encodedData.clear();
+    decodedSamples.setFrameLenght(0);
+    decodedOffset = 0;
+    opened = false;
+}
+
+bool CompressedFileReader::fillDecodedSamples()
+{
+    if (decodedOffset < decodedSamples.getFrameLenght())
+        return true; // still have decoded samples
+
+    const SamplesBuffer &chunk = decodeNextChunk();
+    if (chunk.isEmpty())
+        return false;
+
+    if (chunk.isMono())
+        decodedSamples.setToMono();
+    else
+        decodedSamples.setToStereo();
+
+    decodedSamples.setFrameLenght(chunk.getFrameLenght());
+    decodedSamples.set(chunk);
+    decodedOffset = 0;
+
+    return true;
+}
+
+quint32 CompressedFileReader::readFrames(SamplesBuffer &outBuffer, quint32 frames)
+{
+    if (!opened) {
+        outBuffer.setFrameLenght(0);
+        return 0;
+    }
+
+    outBuffer.setFrameLenght(frames);
+
+    quint32 framesRead = 0;
+    while (framesRead < frames && fillDecodedSamples()) {
+        const quint32 framesToCopy = qMin(frames - framesRead, decodedSamples.getFrameLenght() - decodedOffset);
+        outBuffer.set(decodedSamples, decodedOffset, framesToCopy, framesRead);
+        decodedOffset += framesToCopy;
+        framesRead += framesToCopy;
+    }
+
+    outBuffer.setFrameLenght(framesRead);
+
+    return framesRead;
+}
+
+bool CompressedFileReader::seek(quint64 frame)
+{
+    if (!opened || !restart())
+        return false;
+
+    // skipping the decoded frames until the seek position
+    quint64 skippedFrames = 0;
+    while (skippedFrames < frame && fillDecodedSamples()) {
+        const quint64 framesToSkip = qMin(frame - skippedFrames, static_cast<quint64>(decodedSamples.getFrameLenght() - decodedOffset));
+        decodedOffset += framesToSkip;
+        skippedFrames += framesToSkip;
+    }
+
+    return skippedFrames == frame;
+}
+
+quint16 CompressedFileReader::getChannels() const
+{
+    return channels;
+}
+
+quint64 CompressedFileReader::getTotalFrames() const
+{
+    return 0; // unknown until the end of decoding
+}
@@ -3,15 +3,74 @@
 
 #include "audio/core/SamplesBuffer.h"
 #include <QString>
+#include <QByteArray>
 
 namespace audio {
 
+/**
+    Audio file reader. Files can be decoded in chunks (open, readFrames, seek, close) to avoid
+    holding the entire decoded file in memory, or at once using read().
+ */
+
 class FileReader
 {
 
 public:
-    virtual bool read(const QString &filePath, SamplesBuffer& outBuffer, quint32 &sampleRate) = 0;
     virtual ~FileReader(){}
+
+    virtual bool open(const QString &filePath) = 0;
+    virtual void close() = 0;
+
+    // decode the next 'frames' in the start of 'outBuffer' and set the 'outBuffer' frame lenght. Return the decoded frames, zero in the end of file.
+    virtual quint32 readFrames(SamplesBuffer &outBuffer, quint32 frames) = 0;
+    virtual bool seek(quint64 frame) = 0;
+
+    virtual quint32 getSampleRate() const = 0;
+    virtual quint16 getChannels() const = 0;
+    virtual quint64 getTotalFrames() const = 0; // zero when the lenght is unknown before decoding (compressed files)
+
+    // decode the entire file, or just 'outBuffer.getFrameLenght()' frames when 'outBuffer' is not empty
+    bool read(const QString &filePath, SamplesBuffer &outBuffer, quint32 &sampleRate);
+
+protected:
+    static const quint32 CHUNK_FRAMES = 8192;
+};
+
+/**
+    Base class for compressed files (ogg, mp3). The encoded file is small and is loaded in open(),
+    the samples are decoded on demand in readFrames(). Seek is linear, the stream is decoded
+    again from the start until the seek position.
+ */
+
+class CompressedFileReader : public FileReader
+{
+
+public:
+    CompressedFileReader();
+
+    bool open(const QString &filePath) override;
+    void close() override;
+
+    quint32 readFrames(SamplesBuffer &outBuffer, quint32 frames) override;
+    bool seek(quint64 frame) override;
+
+    quint16 getChannels() const override;
+    quint64 getTotalFrames() const override;
+
+protected:
+    virtual bool initializeDecoder(const QByteArray &encodedData) = 0;
+    virtual void releaseDecoder() = 0;
+    virtual const SamplesBuffer &decodeNextChunk() = 0; // return an empty buffer in the end of the stream
+
+private:
+    bool restart();
+    bool fillDecodedSamples();
+
+    QByteArray encodedData;
+    SamplesBuffer decodedSamples; // last decoded chunk, partially consumed
+    quint32 decodedOffset;
+    quint16 channels;
+    bool opened;
 };
 
 } // namespace
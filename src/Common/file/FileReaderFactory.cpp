@@ -12,14 +12,36 @@ class NullFileReader : public FileReader
 {
 
 public:
-    inline bool read(const QString &filePath, audio::SamplesBuffer &outBuffer, quint32 &sampleRate) override
+    inline bool open(const QString &filePath) override
     {
         Q_UNUSED(filePath)
-        Q_UNUSED(outBuffer)
-        Q_UNUSED(sampleRate)
 
         return false;
     }
+
+    inline void close() override
+    {
+
+    }
+
+    inline quint32 readFrames(audio::SamplesBuffer &outBuffer, quint32 frames) override
+    {
+        Q_UNUSED(frames)
+
+        outBuffer.setFrameLenght(0);
+        return 0;
+    }
+
+    inline bool seek(quint64 frame) override
+    {
+        Q_UNUSED(frame)
+
+        return false;
+    }
+
+    inline quint32 getSampleRate() const override { return 0; }
+    inline quint16 getChannels() const override { return 0; }
+    inline quint64 getTotalFrames() const override { return 0; }
 };
 
 std::unique_ptr<FileReader> FileReaderFactory::createFileReader(const QString &filePath)
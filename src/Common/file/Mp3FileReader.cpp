@@ -1,41 +1,60 @@
 #include "Mp3FileReader.h"
 #include "audio/Mp3Decoder.h"
 
-#include <QFile>
 #include <QDebug>
 
 using audio::Mp3FileReader;
 using audio::SamplesBuffer;
 
-bool Mp3FileReader::read(const QString &filePath, SamplesBuffer &outBuffer, quint32 &sampleRate)
+Mp3FileReader::Mp3FileReader() :
+    bytesProcessed(0),
+    decodedChunk(2)
 {
-    // Open the mp3 file
-    QFile audioFile(filePath);
-    if (!audioFile.open(QFile::ReadOnly)) {
-        qCritical() << "Failed to open mp3 file ..." << filePath;
-        return false;
-    }
 
-    audio::Mp3DecoderMiniMp3 decoder;
-    QByteArray encodedData = audioFile.readAll();
+}
+
+Mp3FileReader::~Mp3FileReader()
+{
+    close();
+}
+
+bool Mp3FileReader::initializeDecoder(const QByteArray &encodedData)
+{
+    decoder.reset(new audio::Mp3DecoderMiniMp3());
+    this->encodedData = encodedData; // implicitly shared, no copy
+    bytesProcessed = 0;
+
+    return true;
+}
+
+void Mp3FileReader::releaseDecoder()
+{
+    decoder.reset();
+    encodedData.clear();
+    bytesProcessed = 0;
+}
 
-    const quint64 totalBytesToProcess = encodedData.size();
-    uint bytesProcessed = 0;
-    const static int MAX_BYTES_PER_DECODING = 2048;         // chunks maxsize is 2048 bytes
+const SamplesBuffer &Mp3FileReader::decodeNextChunk()
+{
+    const static int MAX_BYTES_PER_DECODING = 2048; // chunks maxsize is 2048 bytes
 
-    SamplesBuffer bufferedSamples(2);
+    if (!decoder)
+        return SamplesBuffer::ZERO_BUFFER;
 
-    while (bytesProcessed < totalBytesToProcess) { // split in chunks to avoid a very large decoded buffer
-        int bytesToProcess = std::min((int)(totalBytesToProcess - bytesProcessed), MAX_BYTES_PER_DECODING);
-        const auto &decodedBuffer = decoder.decode(encodedData.data() + bytesProcessed, bytesToProcess);
-        // +++++++++++++++++  PROCESS DECODED SAMPLES ++++++++++++++++
-        bufferedSamples.append(decodedBuffer);
+    // the decoder need some chunks (the mp3 frame size) before return samples
+    while (bytesProcessed < encodedData.size()) {
+        int bytesToProcess = std::min(encodedData.size() - bytesProcessed, MAX_BYTES_PER_DECODING);
+        decodedChunk = decoder->decode(const_cast<char *>(encodedData.constData()) + bytesProcessed, bytesToProcess); // the input is copied by the decoder
         bytesProcessed += bytesToProcess;
+
+        if (!decodedChunk.isEmpty())
+            return decodedChunk;
     }
 
-    sampleRate = decoder.getSampleRate();
-    outBuffer.setFrameLenght(bufferedSamples.getFrameLenght());
-    outBuffer.set(bufferedSamples);
+    return SamplesBuffer::ZERO_BUFFER;
+}
 
-    return true;
+quint32 Mp3FileReader::getSampleRate() const
+{
+    return decoder ? decoder->getSampleRate() : 0;
 }
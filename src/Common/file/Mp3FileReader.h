@@ -3,14 +3,31 @@
 
 #include "FileReader.h"
 
+#include <memory>
+
 namespace audio {
 
-class Mp3FileReader : public FileReader
+class Mp3DecoderMiniMp3;
+
+class Mp3FileReader : public CompressedFileReader
 {
 
 public:
-    bool read(const QString &filePath, audio::SamplesBuffer &outBuffer, quint32 &sampleRate) override;
+    Mp3FileReader();
+    ~Mp3FileReader();
+
+    quint32 getSampleRate() const override;
+
+protected:
+    bool initializeDecoder(const QByteArray &encodedData) override;
+    void releaseDecoder() override;
+    const SamplesBuffer &decodeNextChunk() override;
 
+private:
+    std::unique_ptr<Mp3DecoderMiniMp3> decoder;
+    QByteArray encodedData;
+    int bytesProcessed;
+    SamplesBuffer decodedChunk;
 };
 
 } // namespace
@@ -1,52 +1,56 @@
 #include "OggFileReader.h"
 #include <QDebug>
-#include <QFile>
-#include <QFileInfo>
 #include "audio/vorbis/VorbisDecoder.h"
 
 using audio::OggFileReader;
 using audio::SamplesBuffer;
 
-bool OggFileReader::read(const QString &filePath, SamplesBuffer &outBuffer, quint32 &sampleRate)
+OggFileReader::OggFileReader()
 {
-    // Open the ogg file
-    QFile oggFile(filePath);
-    if (!oggFile.open(QFile::ReadOnly)) {
-        qWarning() << "Failed to open OGG file ..." << filePath;
+
+}
+
+OggFileReader::~OggFileReader()
+{
+    close();
+}
+
+bool OggFileReader::initializeDecoder(const QByteArray &encodedData)
+{
+    decoder.reset(new vorbis::Decoder());
+    decoder->setInputData(encodedData);
+
+    if (!decoder->initialize()) { // read the ogg headers from file
+        qWarning() << "Can't initialize the ogg decoder!";
         return false;
     }
 
-    vorbis::Decoder decoder;
-    decoder.setInputData(oggFile.readAll());
-    decoder.initialize(); // read the ogg headers from file
-    sampleRate = decoder.getSampleRate();
-    if (decoder.isMono())
-        outBuffer.setToMono();
-    else
-        outBuffer.setToStereo();
-
-    // decode and append decoded data in 'outBuffer'
-    int decodedFrames = 0;
+    return true;
+}
+
+void OggFileReader::releaseDecoder()
+{
+    decoder.reset();
+}
+
+const SamplesBuffer &OggFileReader::decodeNextChunk()
+{
+    if (!decoder)
+        return SamplesBuffer::ZERO_BUFFER;
+
     const int MAX_SAMPLES_PER_DECODE = 1024;
-    bool append = outBuffer.getFrameLenght() == 0;
-    auto remaining = outBuffer.getFrameLenght();
-    do
-    {
-        const auto &decodedBuffer = decoder.decode(MAX_SAMPLES_PER_DECODE);
-        decodedFrames = decodedBuffer.getFrameLenght();
-        if (!decodedBuffer.isEmpty()) {
-            if (append) {
-                outBuffer.append(decodedBuffer);
-            }
-            else {
-                auto samplesToCopy = std::min(decodedBuffer.getFrameLenght(), remaining);
-                auto outBufferOffset = outBuffer.getFrameLenght() - remaining;
-                outBuffer.set(decodedBuffer, 0, samplesToCopy, outBufferOffset);
-                remaining -= samplesToCopy;
-            }
-        }
-    }
-    while(decodedFrames > 0);
+    return decoder->decode(MAX_SAMPLES_PER_DECODE);
+}
 
-    return true;
+quint32 OggFileReader::getSampleRate() const
+{
+    return decoder ? decoder->getSampleRate() : 0;
+}
+
+quint16 OggFileReader::getChannels() const
+{
+    if (decoder && decoder->isMono())
+        return 1;
+
+    return 2; // decoded buffers are always stereo
 }
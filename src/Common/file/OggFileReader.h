@@ -3,14 +3,31 @@
 
 #include "FileReader.h"
 
+#include <memory>
+
+namespace vorbis {
+class Decoder;
+}
+
 namespace audio {
 
-class OggFileReader : public FileReader
+class OggFileReader : public CompressedFileReader
 {
 
 public:
-    bool read(const QString &filePath, audio::SamplesBuffer &outBuffer, quint32 &sampleRate) override;
+    OggFileReader();
+    ~OggFileReader();
+
+    quint32 getSampleRate() const override;
+    quint16 getChannels() const override;
+
+protected:
+    bool initializeDecoder(const QByteArray &encodedData) override;
+    void releaseDecoder() override;
+    const SamplesBuffer &decodeNextChunk() override;
 
+private:
+    std::unique_ptr<vorbis::Decoder> decoder;
 };
 
 } // namespace
@@ -1,222 +1,356 @@
 #include "WaveFileReader.h"
 #include <QDebug>
-#include <QFile>
-#include <QFileInfo>
-#include <cmath>
 #include <QtEndian>
-#include <QDataStream>
-#include <memory>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define WAVE_READER_USE_SSE2
+    #include <emmintrin.h>
+#endif
 
 using audio::SamplesBuffer;
 using audio::WaveFileReader;
 
-class SampleExtractor
-{
+namespace {
 
-public:
-    explicit SampleExtractor(QDataStream *stream) :
-        stream(stream)
-    {
-    }
-    
-    virtual ~SampleExtractor()
-    {
-        
-    }
+const quint16 WAVE_FORMAT_PCM = 0x0001;
+const quint16 WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+const quint16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
 
-    virtual float nextSample() = 0;
+// same scale used in WaveFileWriter, so 16 bits files are loaded exactly as they were before saving
+const float SCALE_8_BITS = 1.0f / 128.0f;
+const float SCALE_16_BITS = 1.0f / 32767.0f;
+const float SCALE_24_BITS = 1.0f / 8388607.0f;
+const float SCALE_32_BITS = 1.0f / 2147483648.0f;
 
-protected:
-    QDataStream *stream;
+struct Pcm8Bits
+{
+    static const int BYTES = 1;
+    static float decode(const uchar *sample) { return (static_cast<int>(sample[0]) - 128) * SCALE_8_BITS; } // 8 bits samples are unsigned
 };
 
-class SampleExtractor16Bits : public SampleExtractor
+struct Pcm16Bits
 {
-    public:
+    static const int BYTES = 2;
+    static float decode(const uchar *sample) { return qFromLittleEndian<qint16>(sample) * SCALE_16_BITS; }
+};
 
-        explicit SampleExtractor16Bits(QDataStream *stream)
-            :SampleExtractor(stream)
-        {
+struct Pcm24Bits
+{
+    static const int BYTES = 3;
+    static float decode(const uchar *sample)
+    {
+        const qint32 value = static_cast<qint32>((quint32(sample[0]) << 8) | (quint32(sample[1]) << 16) | (quint32(sample[2]) << 24)) >> 8; // sign extended
+        return value * SCALE_24_BITS;
+    }
+};
 
-        }
+struct Pcm32Bits
+{
+    static const int BYTES = 4;
+    static float decode(const uchar *sample) { return qFromLittleEndian<qint32>(sample) * SCALE_32_BITS; }
+};
 
-        float nextSample() override
-        {
-            qint16 sampleValue;
-            *stream >> sampleValue;
-            return sampleValue / 32767.0f;
-        }
+struct Float32Bits
+{
+    static const int BYTES = 4;
+    static float decode(const uchar *sample)
+    {
+        const quint32 bits = qFromLittleEndian<quint32>(sample);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
 };
 
-class SampleExtractor32Bits : public SampleExtractor
+template <typename Format>
+void deinterleave(const uchar *input, quint32 firstFrame, quint32 frames, quint16 channels, float *left, float *right)
 {
-    public:
-        explicit SampleExtractor32Bits(QDataStream *stream)
-            :SampleExtractor(stream)
-        {
+    const quint32 frameSize = channels * Format::BYTES;
+    const uchar *frame = input + firstFrame * frameSize;
+    for (quint32 i = firstFrame; i < frames; ++i, frame += frameSize) {
+        left[i] = Format::decode(frame);
+        if (right)
+            right[i] = channels > 1 ? Format::decode(frame + Format::BYTES) : left[i];
+    }
+}
 
+#ifdef WAVE_READER_USE_SSE2
+
+// return the converted frames, the remaining frames are converted by the scalar code
+quint32 deinterleave16BitsSimd(const uchar *input, quint32 frames, quint16 channels, float *left, float *right)
+{
+    const __m128 scale = _mm_set1_ps(SCALE_16_BITS);
+    quint32 i = 0;
+
+    if (channels == 1) {
+        for (; i + 8 <= frames; i += 8) { // 8 mono samples per iteration
+            const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i * 2));
+            const __m128 low = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16)), scale);
+            const __m128 high = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16)), scale);
+            _mm_storeu_ps(left + i, low);
+            _mm_storeu_ps(left + i + 4, high);
+            if (right) {
+                _mm_storeu_ps(right + i, low);
+                _mm_storeu_ps(right + i + 4, high);
+            }
         }
+    }
+    else if (channels == 2) {
+        for (; i + 4 <= frames; i += 4) { // 4 stereo frames per iteration, L R L R ...
+            const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i * 4));
+            const __m128i leftSamples = _mm_srai_epi32(_mm_slli_epi32(samples, 16), 16);
+            _mm_storeu_ps(left + i, _mm_mul_ps(_mm_cvtepi32_ps(leftSamples), scale));
+            if (right) {
+                const __m128i rightSamples = _mm_srai_epi32(samples, 16);
+                _mm_storeu_ps(right + i, _mm_mul_ps(_mm_cvtepi32_ps(rightSamples), scale));
+            }
+        }
+    }
 
-        float nextSample() override
-        {
-            char buffer[4];
-            stream->readRawData(buffer, 4);
+    return i;
+}
 
-            float sample = 0;
-            memcpy(&sample, &buffer, sizeof(sample));
-            return sample;
+quint32 deinterleaveFloatSimd(const uchar *input, quint32 frames, quint16 channels, float *left, float *right)
+{
+    quint32 i = 0;
+
+    if (channels == 2) {
+        const float *samples = reinterpret_cast<const float *>(input);
+        for (; i + 4 <= frames; i += 4) {
+            const __m128 first = _mm_loadu_ps(samples + i * 2);      // L0 R0 L1 R1
+            const __m128 second = _mm_loadu_ps(samples + i * 2 + 4); // L2 R2 L3 R3
+            _mm_storeu_ps(left + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+            if (right)
+                _mm_storeu_ps(right + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
         }
-};
+    }
 
-class SampleExtractor24Bits : public SampleExtractor
-{
-    public:
-        explicit SampleExtractor24Bits(QDataStream *stream)
-            :SampleExtractor(stream)
-        {
+    return i;
+}
 
-        }
+#endif
 
-        float nextSample() override
-        {
-            char buffer[3];
-            stream->readRawData(buffer, 3);
-            return ((buffer[0] & 0xFF) | ((buffer[1] & 0xFF) << 8) | (buffer[2] << 16)) / 8388606.0F;
-        }
-};
+} // namespace
 
-class SampleExtractor8Bits : public SampleExtractor
+WaveFileReader::WaveFileReader() :
+    mappedData(nullptr),
+    samplesData(nullptr),
+    totalFrames(0),
+    position(0),
+    sampleRate(0),
+    channels(0),
+    format(Pcm16Bits)
 {
-    public:
-        explicit SampleExtractor8Bits(QDataStream *stream)
-            :SampleExtractor(stream)
-        {
 
-        }
-
-        float nextSample() override
-        {
-            qint8 byte;
-            *stream >> byte;
-            return byte / 127.0;
-        }
-};
+}
 
-class NullSampleExtractor : public SampleExtractor
+WaveFileReader::~WaveFileReader()
 {
-    public:
-        NullSampleExtractor()
-            :SampleExtractor(nullptr)
-        {
-        }
+    close();
+}
 
-        float nextSample() override
-        {
-            return 0.0;
-        }
-};
+void WaveFileReader::convertSamples(const uchar *input, quint32 frames, quint16 channels, SampleFormat format, float *left, float *right)
+{
+    if (!channels || !frames)
+        return;
+
+    quint32 convertedFrames = 0;
+
+    switch (format) {
+    case Pcm8Bits:
+        deinterleave<Pcm8Bits>(input, 0, frames, channels, left, right);
+        break;
+    case Pcm16Bits:
+#ifdef WAVE_READER_USE_SSE2
+        convertedFrames = deinterleave16BitsSimd(input, frames, channels, left, right);
+#endif
+        deinterleave<Pcm16Bits>(input, convertedFrames, frames, channels, left, right);
+        break;
+    case Pcm24Bits:
+        deinterleave<Pcm24Bits>(input, 0, frames, channels, left, right);
+        break;
+    case Pcm32Bits:
+        deinterleave<Pcm32Bits>(input, 0, frames, channels, left, right);
+        break;
+    case Float32Bits:
+#ifdef WAVE_READER_USE_SSE2
+        convertedFrames = deinterleaveFloatSimd(input, frames, channels, left, right);
+#endif
+        deinterleave<Float32Bits>(input, convertedFrames, frames, channels, left, right);
+        break;
+    }
+}
 
-class SampleExtractorFactory
+quint8 WaveFileReader::getBytesPerSample(SampleFormat format)
 {
-public:
-    static std::unique_ptr<SampleExtractor> createExtractor(QDataStream *stream, quint8 bitsPerSample)
-    {
-        switch (bitsPerSample/8) {
-            case 1: return std::unique_ptr<SampleExtractor8Bits>(new SampleExtractor8Bits(stream));
-            case 2: return std::unique_ptr<SampleExtractor16Bits>(new SampleExtractor16Bits(stream));
-            case 3: return std::unique_ptr<SampleExtractor24Bits>(new SampleExtractor24Bits(stream));
-            case 4: return std::unique_ptr<SampleExtractor32Bits>(new SampleExtractor32Bits(stream));
-        }
-        qCritical() << "Can't create a SampleExtractor to handle " << bitsPerSample << " bits per sample!";
-        return std::unique_ptr<NullSampleExtractor>(new NullSampleExtractor());
+    switch (format) {
+    case Pcm8Bits:      return 1;
+    case Pcm16Bits:     return 2;
+    case Pcm24Bits:     return 3;
+    case Pcm32Bits:     return 4;
+    case Float32Bits:   return 4;
     }
-};
 
-bool WaveFileReader::read(const QString &filePath, audio::SamplesBuffer &outBuffer, quint32 &sampleRate)
+    return 2;
+}
+
+bool WaveFileReader::open(const QString &filePath)
 {
-    // Open the wave file
-    QFile wavFile(filePath);
-    if (!wavFile.open(QFile::ReadOnly)) {
+    close();
+
+    file.setFileName(filePath);
+    if (!file.open(QFile::ReadOnly)) {
         qCritical() << "Failed to open WAV file ..." << filePath;
-        return false; // Done, out buffer is not changed
+        return false;
     }
 
-    // Read in the whole thing
-    QByteArray wavFileContent = wavFile.readAll();
-
-    // Define the header components
-    char fileType[4];
-    quint32 fileSize;
-    char waveName[4];
-    char fmtName[4];
-    quint32 fmtLength;
-    quint16 fmtType;
-    quint16 channels;
-    quint32 sampleRateXBitsPerSampleXChanngelsDivEight;
-    quint16 bitsPerSampleXChannelsDivEightPointOne;
-    quint16 bitsPerSample;
-    char dataHeader[4];
-    quint32 dataSize = 0;
-
-    // Create a data stream to analyze the data
-    QDataStream stream(&wavFileContent, QIODevice::ReadOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-
-    // Now pop off the appropriate data into each header field defined above
-    stream.readRawData((char *)fileType, 4); // "RIFF"
-    if (QString::fromLocal8Bit(fileType, 4) != "RIFF") {
-        qCritical() << "Error loading " << filePath << ", 'RIFF' chunk not founded!";
+    const qint64 size = file.size();
+    mappedData = file.map(0, size);
+
+    const uchar *data = mappedData;
+    if (!data) { // some file systems can't map files
+        fileContent = file.readAll();
+        data = reinterpret_cast<const uchar *>(fileContent.constData());
+    }
+
+    if (!parseHeader(data, size, filePath)) {
+        close();
         return false;
     }
 
-    stream >> fileSize; // File Size
+    return true;
+}
 
-    stream.readRawData((char *)waveName, 4); // "WAVE"
-    if (QString::fromLocal8Bit(waveName, 4) != "WAVE") {
-        qCritical() << "Error loading " << filePath << ", 'WAVE' chunk not founded!";
+bool WaveFileReader::parseHeader(const uchar *data, qint64 size, const QString &filePath)
+{
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0) {
+        qCritical() << "Error loading " << filePath << ", 'RIFF' chunk not founded!";
         return false;
     }
 
-    stream.readRawData((char *)fmtName, 4); // "fmt"
-    if (QString::fromLocal8Bit(fmtName, 4) != "fmt ") {
-        qCritical() << "Error loading " << filePath << ", 'fmt' chunk not founded!";
+    if (std::memcmp(data + 8, "WAVE", 4) != 0) {
+        qCritical() << "Error loading " << filePath << ", 'WAVE' chunk not founded!";
         return false;
     }
 
-    stream >> fmtLength;  // Format length
-    stream >> fmtType;    // Format type
-    stream >> channels;   // Number of channels
-    stream >> sampleRate; // Sample rate
-    stream >> sampleRateXBitsPerSampleXChanngelsDivEight; // (Sample Rate * BitsPerSample * Channels) / 8
-    stream >> bitsPerSampleXChannelsDivEightPointOne; // (BitsPerSample * Channels) / 8.1
-    stream >> bitsPerSample; // Bits per sample
-    while (QString::fromLocal8Bit(dataHeader, 4) != "data" && !stream.atEnd()) {
-        stream.readRawData((char *)dataHeader, 4); // "data" header
-        stream >> dataSize; // Data Size
-        if (QString::fromLocal8Bit(dataHeader, 4) != "data")
-            stream.skipRawData(dataSize);
+    bool fmtFound = false;
+    qint64 offset = 12;
+    while (offset + 8 <= size) {
+        const uchar *chunk = data + offset;
+        const quint32 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const uchar *chunkData = chunk + 8;
+        const qint64 availableBytes = size - offset - 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || availableBytes < 16) {
+                qCritical() << "Error loading " << filePath << ", invalid 'fmt' chunk!";
+                return false;
+            }
+
+            quint16 formatTag = qFromLittleEndian<quint16>(chunkData);
+            channels = qFromLittleEndian<quint16>(chunkData + 2);
+            sampleRate = qFromLittleEndian<quint32>(chunkData + 4);
+            const quint16 bitsPerSample = qFromLittleEndian<quint16>(chunkData + 14);
+
+            if (formatTag == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 26 && availableBytes >= 26)
+                formatTag = qFromLittleEndian<quint16>(chunkData + 24); // first bytes of the sub format GUID
+
+            if (formatTag == WAVE_FORMAT_IEEE_FLOAT && bitsPerSample == 32) {
+                format = Float32Bits;
+            }
+            else if (formatTag == WAVE_FORMAT_PCM && bitsPerSample >= 8 && bitsPerSample <= 32 && bitsPerSample % 8 == 0) {
+                static const SampleFormat PCM_FORMATS[] = { Pcm8Bits, Pcm16Bits, Pcm24Bits, Pcm32Bits };
+                format = PCM_FORMATS[bitsPerSample / 8 - 1];
+            }
+            else {
+                qCritical() << "Error loading " << filePath << ", unsupported format" << formatTag << bitsPerSample << "bits per sample!";
+                return false;
+            }
+
+            if (!channels) {
+                qCritical() << "Error loading " << filePath << ", zero channels!";
+                return false;
+            }
+
+            fmtFound = true;
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!fmtFound) {
+                qCritical() << "Error loading " << filePath << ", 'fmt' chunk not founded!";
+                return false;
+            }
+
+            const quint64 dataSize = qMin(static_cast<quint64>(chunkSize), static_cast<quint64>(availableBytes)); // truncated files are loaded until the end
+            samplesData = chunkData;
+            totalFrames = dataSize / (channels * getBytesPerSample(format));
+            position = 0;
+            return true;
+        }
+
+        offset += 8 + static_cast<qint64>(chunkSize) + (chunkSize & 1); // chunks are word aligned
+    }
+
+    qCritical() << "Error loading " << filePath << ", 'data' chunk not founded!";
+    return false;
+}
+
+void WaveFileReader::close()
+{
+    if (mappedData) {
+        file.unmap(mappedData);
+        mappedData = nullptr;
     }
 
-    uint samples = dataSize / channels / (bitsPerSample/ 8);
+    if (file.isOpen())
+        file.close();
 
-    if (channels == 1)
-        outBuffer.setToMono();
-    else
-        outBuffer.setToStereo();
+    fileContent.clear();
+    samplesData = nullptr;
+    totalFrames = 0;
+    position = 0;
+}
 
-    if (outBuffer.getFrameLenght() > 0) // load only outBuffer.frameLenght samples?
-        samples = qMin(samples, outBuffer.getFrameLenght());
+quint32 WaveFileReader::readFrames(SamplesBuffer &outBuffer, quint32 frames)
+{
+    const quint32 framesToRead = samplesData ? static_cast<quint32>(qMin(static_cast<quint64>(frames), totalFrames - position)) : 0;
 
-    outBuffer.setFrameLenght(samples);
+    outBuffer.setFrameLenght(framesToRead);
+    if (!framesToRead)
+        return 0;
 
-    // Now pull out the data
-    std::unique_ptr<SampleExtractor> sampleExtractor = SampleExtractorFactory::createExtractor(&stream, bitsPerSample);
-    for (uint s = 0; s < samples; ++s) {
-        for (int c = 0; c < channels; ++c) {
-            float sample = sampleExtractor->nextSample();
-            outBuffer.set(c, s, sample);
-        }
-    }
+    const quint32 frameSize = channels * getBytesPerSample(format);
+    float *left = outBuffer.getSamplesArray(0);
+    float *right = outBuffer.getChannels() > 1 ? outBuffer.getSamplesArray(1) : nullptr;
+
+    convertSamples(samplesData + position * frameSize, framesToRead, channels, format, left, right);
+
+    position += framesToRead;
+
+    return framesToRead;
+}
+
+bool WaveFileReader::seek(quint64 frame)
+{
+    if (!samplesData || frame > totalFrames)
+        return false;
+
+    position = frame;
 
     return true;
 }
+
+quint32 WaveFileReader::getSampleRate() const
+{
+    return sampleRate;
+}
+
+quint16 WaveFileReader::getChannels() const
+{
+    return channels;
+}
+
+quint64 WaveFileReader::getTotalFrames() const
+{
+    return totalFrames;
+}
@@ -3,16 +3,61 @@
 
 #include "FileReader.h"
 
+#include <QFile>
+
 namespace audio {
 
+/**
+    The wave file is memory mapped (no copies of the entire file in memory) and the samples
+    are converted to float directly from the mapped data, chunk by chunk.
+ */
+
 class WaveFileReader : public FileReader
 {
 
 public:
-    bool read(const QString &filePath, audio::SamplesBuffer &outBuffer, quint32 &sampleRate) override;
+    enum SampleFormat
+    {
+        Pcm8Bits,
+        Pcm16Bits,
+        Pcm24Bits,
+        Pcm32Bits,
+        Float32Bits
+    };
+
+    WaveFileReader();
+    ~WaveFileReader();
+
+    bool open(const QString &filePath) override;
+    void close() override;
+
+    quint32 readFrames(SamplesBuffer &outBuffer, quint32 frames) override;
+    bool seek(quint64 frame) override;
+
+    quint32 getSampleRate() const override;
+    quint16 getChannels() const override;
+    quint64 getTotalFrames() const override;
+
+    // convert interleaved little endian samples to float. 'right' can be null, only the first 2 channels are converted
+    static void convertSamples(const uchar *input, quint32 frames, quint16 channels, SampleFormat format, float *left, float *right);
+
+private:
+    bool parseHeader(const uchar *data, qint64 size, const QString &filePath);
+
+    static quint8 getBytesPerSample(SampleFormat format);
+
+    QFile file;
+    uchar *mappedData;
+    QByteArray fileContent; // used when the file can't be mapped
+    const uchar *samplesData; // the 'data' chunk
 
+    quint64 totalFrames;
+    quint64 position;
+    quint32 sampleRate;
+    quint16 channels;
+    SampleFormat format;
 };
 
 } // namespace
 
-#endif // AUDIOFILEREADER_H
+#endif // WAVEFILEREADER_H
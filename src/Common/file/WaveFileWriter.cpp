@@ -1,32 +1,66 @@
 #include "WaveFileWriter.h"
 
-#include <QFile>
 #include <QDebug>
 #include <QDataStream>
+#include <QtEndian>
 #include <QThread>
 #include <climits>
+#include <cstring>
 
 using audio::WaveFileWriter;
 using audio::SamplesBuffer;
 
+WaveFileWriter::WaveFileWriter() :
+    channels(2),
+    bitDepth(16),
+    dataChunkSize(0)
+{
+
+}
+
+WaveFileWriter::~WaveFileWriter()
+{
+    close();
+}
+
 void WaveFileWriter::write(const QString &filePath, const SamplesBuffer &buffer, quint32 sampleRate, quint8 bitDepth)
 {
-    QFile wavFile(filePath);
+    if (!open(filePath, buffer.getChannels(), sampleRate, bitDepth))
+        return;
+
+    append(buffer);
+    close();
+}
+
+bool WaveFileWriter::open(const QString &filePath, quint8 channels, quint32 sampleRate, quint8 bitDepth)
+{
+    close();
+
+    wavFile.setFileName(filePath);
     if (!wavFile.open(QFile::WriteOnly)) {
         qCritical() << "Failed to create WAV file ..." << filePath;
-        return;
+        return false;
     }
 
-    const uint samples = buffer.getFrameLenght();
-    const uint dataChunkSize = buffer.getChannels() * buffer.getFrameLenght() * bitDepth/8;// bytes per sample
-    const uint fileSize = dataChunkSize + 44; // WAVE HEADER is 44 bytes
+    this->channels = channels;
+    this->bitDepth = bitDepth == 16 ? 16 : 32;
+    this->dataChunkSize = 0;
+
+    writeHeader(sampleRate); // the chunk sizes are placeholders, they are filled by close()
+
+    return true;
+}
+
+void WaveFileWriter::writeHeader(quint32 sampleRate)
+{
+    const uint fileSize = dataChunkSize + HEADER_SIZE;
 
     QDataStream out(&wavFile);
     out.setByteOrder(QDataStream::LittleEndian);
 
     // RIFF chunk
     out.writeRawData("RIFF", 4);
-    out << quint32(fileSize - 8); // Placeholder for the RIFF chunk size (filled by close())
+    out << quint32(fileSize - 8);
     out.writeRawData("WAVE", 4);
 
     const quint8 sampleSize = bitDepth;
@@ -34,37 +68,75 @@ void WaveFileWriter::write(const QString &filePath, const SamplesBuffer &buffer,
     out.writeRawData("fmt ", 4);
     out << quint32(16); // "fmt " chunk size (always 16 for PCM)
     out << quint16(bitDepth == 16 ? 1 : 3); // data format (1 => PCM, 3 => IEEE float) http://www-mmsp.ece.mcgill.ca/Documents/AudioFormats/WAVE/WAVE.html
-    out << quint16(buffer.getChannels());
+    out << quint16(channels);
     out << quint32(sampleRate);
-    out << quint32(sampleRate * buffer.getChannels() * sampleSize / 8 ); // bytes per second
-    out << quint16(buffer.getChannels() * sampleSize / 8); // Block align
+    out << quint32(sampleRate * channels * sampleSize / 8 ); // bytes per second
+    out << quint16(channels * sampleSize / 8); // Block align
     out << quint16(sampleSize); // Significant Bits Per Sample
 
     // Data chunk
     out.writeRawData("data", 4);
-    out << quint32(dataChunkSize); // Placeholder for the data chunk size (filled by close())
+    out << quint32(dataChunkSize);
+}
+
+void WaveFileWriter::append(const SamplesBuffer &buffer)
+{
+    if (!wavFile.isOpen() || buffer.isEmpty())
+        return;
 
-    //write interleaved samples
-    if (bitDepth == 32)
-        out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    const uint frames = buffer.getFrameLenght();
+    const uint bufferChannels = buffer.getChannels();
+    const uint bytesPerSample = bitDepth/8;
+    const uint bytes = frames * channels * bytesPerSample;
 
-    uint channels = buffer.getChannels();
-    for (uint s = 0; s < samples; ++s) {
-        for (uint c = 0; c < channels; ++c) {
-            if (bitDepth == 16) {
-                int sample = buffer.get(c, s) * SHRT_MAX;
+    if (static_cast<uint>(interleavedBytes.size()) < bytes)
+        interleavedBytes.resize(bytes);
+
+    // interleave all samples in a byte array and write everything in one call
+    uchar *dest = reinterpret_cast<uchar *>(interleavedBytes.data());
+    for (uint c = 0; c < channels; ++c) {
+        const float *samples = buffer.getSamplesArray(c < bufferChannels ? c : bufferChannels - 1); // mono buffers are duplicated
+        uchar *channelDest = dest + c * bytesPerSample;
+        const uint stride = channels * bytesPerSample;
+        if (bitDepth == 16) {
+            for (uint s = 0; s < frames; ++s) {
+                int sample = samples[s] * SHRT_MAX;
                 // hard clip
                 if (sample > SHRT_MAX)
                     sample = SHRT_MAX;
                 else if (sample < SHRT_MIN)
                     sample = SHRT_MIN;
 
-                out << quint16(sample);
+                qToLittleEndian<qint16>(static_cast<qint16>(sample), channelDest + s * stride);
             }
-            else { // 32 bits
-                out << buffer.get(c, s);
+        }
+        else { // 32 bits float
+            for (uint s = 0; s < frames; ++s) {
+                quint32 rawValue;
+                std::memcpy(&rawValue, &samples[s], sizeof(float));
+                qToLittleEndian<quint32>(rawValue, channelDest + s * stride);
             }
         }
     }
 
+    wavFile.write(interleavedBytes.constData(), bytes);
+    dataChunkSize += bytes;
+}
+
+void WaveFileWriter::close()
+{
+    if (!wavFile.isOpen())
+        return;
+
+    // fill the RIFF and data chunk sizes
+    QDataStream out(&wavFile);
+    out.setByteOrder(QDataStream::LittleEndian);
+
+    wavFile.seek(4);
+    out << quint32(dataChunkSize + HEADER_SIZE - 8);
+
+    wavFile.seek(HEADER_SIZE - 4);
+    out << quint32(dataChunkSize);
+
+    wavFile.close();
 }
@@ -3,14 +3,38 @@
 
 #include "FileReader.h"
 
+#include <QFile>
+#include <QByteArray>
+
 namespace audio {
 
 class WaveFileWriter
 {
 
 public:
+    WaveFileWriter();
+    ~WaveFileWriter();
+
+    // write the entire buffer in one shot
     void write(const QString &filePath, const SamplesBuffer &buffer, quint32 sampleRate, quint8 bitDepth);
 
+    // streaming API: open, append N buffers and close. The header sizes are filled in close()
+    bool open(const QString &filePath, quint8 channels, quint32 sampleRate, quint8 bitDepth);
+    void append(const SamplesBuffer &buffer);
+    void close();
+
+    inline bool isOpen() const { return wavFile.isOpen(); }
+
+private:
+    QFile wavFile;
+    quint8 channels;
+    quint8 bitDepth;
+    quint32 dataChunkSize;
+    QByteArray interleavedBytes; // reused between 'append' calls
+
+    void writeHeader(quint32 sampleRate);
+
+    static const int HEADER_SIZE = 44;
 };
 
 } // namespace
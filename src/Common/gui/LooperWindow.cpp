@@ -30,6 +30,7 @@ LooperWindow::LooperWindow(QWidget *parent, MainController *mainController) :
     ui(new Ui::LooperWindow),
     mainController(mainController),
     looper(nullptr),
+    loopIOService(new audio::LoopIOService(this)),
     currentBeat(-1)
 {
     setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint); // remove help/question marker
@@ -62,6 +63,13 @@ LooperWindow::LooperWindow(QWidget *parent, MainController *mainController) :
     ui->loadButton->setMenu(loadMenu);
     connect(loadMenu, &QMenu::aboutToShow, this, &LooperWindow::showLoadMenu);
 
+    connect(loopIOService, &audio::LoopIOService::progressChanged, this, &LooperWindow::showLoopIOProgress);
+    connect(loopIOService, &audio::LoopIOService::loadFinished, this, &LooperWindow::handleLoopLoaded);
+    connect(loopIOService, &audio::LoopIOService::saveFinished, this, &LooperWindow::handleLoopSaved);
+
+    ui->cancelLoopIOButton->setVisible(false); // visible only while a loop is saved or loaded
+    connect(ui->cancelLoopIOButton, &QPushButton::clicked, loopIOService, &audio::LoopIOService::cancel);
+
     ui->mainLevelSlider->setOrientation(Qt::Vertical);
 
     connect(ui->mainLevelSlider, &QSlider::valueChanged, [=](int value){
@@ -494,6 +502,9 @@ void LooperWindow::updateControls()
         ui->saveButton->setEnabled(looper->canSave());
         ui->loadButton->setEnabled(looper->isStopped());
 
+        const double memoryInMB = looper->getMemoryUsage() / (1024.0 * 1024.0);
+        ui->loopNameLabel->setToolTip(tr("Looper memory: %1 MB").arg(memoryInMB, 0, 'f', 1));
+
         ui->resetButton->setEnabled(looper->isStopped() || looper->isPlaying());
 
         // update playing and recording options
@@ -776,16 +787,37 @@ void LooperWindow::showSaveDialogs()
     uint bpi = ninjamController->getCurrentBpi();
     quint8 bitDepth = mainController->getLooperBitDepth();
 
-    LoopSaver loopSaver(savePath, looper);
+    audio::LoopIOService::SaveSettings saveSettings;
+    saveSettings.savePath = savePath;
+    saveSettings.bpm = bpm;
+    saveSettings.bpi = bpi;
+    saveSettings.encodeInOggVorbis = encodeInOggVorbis;
+    saveSettings.vorbisQuality = vorbisQuality;
+    saveSettings.sampleRate = sampleRate;
+    saveSettings.bitDepth = bitDepth;
 
     loopFileName = file::sanitizeFileName(loopFileName);
-    loopSaver.save(loopFileName, bpm, bpi, encodeInOggVorbis, vorbisQuality, sampleRate, bitDepth);
+    loopIOService->save(looper, loopFileName, saveSettings); // looper name is updated when the saving is finished
+    ui->cancelLoopIOButton->setVisible(true);
+}
+
+void LooperWindow::handleLoopSaved(const QString &loopName, bool success)
+{
+    ui->cancelLoopIOButton->setVisible(false);
+
+    if (!success && !loopIOService->isCanceled())
+        qCritical() << "Error saving the loop" << loopName;
 
-    looper->setLoopName(loopFileName);
+    ui->loopNameLabel->setText(looper ? looper->getLoopName() : QString());
 
     updateControls();
 }
 
+void LooperWindow::showLoopIOProgress(int processedLayers, int totalLayers)
+{
+    ui->loopNameLabel->setText(tr("Processing layers %1/%2 ...").arg(processedLayers).arg(totalLayers));
+}
+
 QString LooperWindow::getOptionName(Looper::RecordingOption option)
 {
     switch (option) {
@@ -915,7 +947,7 @@ void LooperWindow::showLoadMenu()
         QString loopFilePath = QFileDialog::getOpenFileName(this, fileDialogTitle, loopsDir, filter);
         if (!loopFilePath.isEmpty()) {
             QString loopDir = QFileInfo(loopFilePath).dir().absolutePath();
-            loadLoopInfo(loopDir, LoopLoader::loadLoopInfo(loopFilePath));
+            loadLoopInfo(loopDir, LoopInfo::loadFromJsonFile(loopFilePath));
         }
     });
 
@@ -1003,20 +1035,32 @@ void LooperWindow::loadLoopInfo(const QString &loopDir, const LoopInfo &loopInfo
 
         ui->loopNameLabel->setText("");
 
-        LoopLoader loader(loopDir);
         uint currentSampleRate = mainController->getSampleRate();
         quint32 samplesPerInterval = mainController->getNinjamController()->getSamplesPerInterval();
-        loader.load(loopInfo, looper, currentSampleRate, samplesPerInterval);
-
-        updateLayersControls(); // update layers pan and gain after loading a loop
-
-        updateModeComboBox();
-
-        ui->loopNameLabel->setText(loopInfo.getName());
-
-        update();
+        loopIOService->load(looper, loopDir, loopInfo, currentSampleRate, samplesPerInterval); // layers are decoded in background
+        ui->cancelLoopIOButton->setVisible(true);
     }
     else {
         qCritical() << "Can't load loop " << loopInfo.getName() << " in " << loopDir;
     }
 }
+
+void LooperWindow::handleLoopLoaded(const QString &loopName, bool success)
+{
+    ui->cancelLoopIOButton->setVisible(false);
+
+    if (!success) {
+        if (!loopIOService->isCanceled())
+            qCritical() << "Can't load loop " << loopName;
+        ui->loopNameLabel->setText("");
+        return;
+    }
+
+    updateLayersControls(); // update layers pan and gain after loading a loop
+
+    updateModeComboBox();
+
+    ui->loopNameLabel->setText(loopName);
+
+    update();
+}
@@ -12,6 +12,7 @@
 
 #include "looper/Looper.h"
 #include "looper/LooperPersistence.h"
+#include "looper/LoopIOService.h"
 #include "looper/LooperLayer.h"
 #include "widgets/BlinkableButton.h"
 #include "widgets/Slider.h"
@@ -111,6 +112,8 @@ private:
 
     controller::MainController *mainController;
 
+    audio::LoopIOService *loopIOService; // save and load loops without freezing the window
+
     void deleteWavePanels();
 
 
@@ -195,6 +198,9 @@ private:
     void setMaxLayerComboBoxValuesAvailability(int valuesToDisable);
 
     void loadLoopInfo(const QString &loopDir, const audio::LoopInfo &info);
+    void handleLoopLoaded(const QString &loopName, bool success);
+    void handleLoopSaved(const QString &loopName, bool success);
+    void showLoopIOProgress(int processedLayers, int totalLayers);
 
     void updateLayersControls();
     void updateModeComboBox();
@@ -36,6 +36,8 @@
 #include "TextEditorModifier.h"
 #include "widgets/InstrumentsMenu.h"
 #include "ninjam/client/Types.h"
+#include "recorder/JamRenderer.h"
+#include "recorder/ReaperProjectGenerator.h"
 
 // to get versions
 #include "libavutil/avutil.h"
@@ -49,6 +51,9 @@
 #include <QImage>
 #include <QCameraInfo>
 #include <QToolTip>
+#include <QFileDialog>
+#include <QProgressDialog>
+#include <QtConcurrent/QtConcurrent>
 
 const QSize MainWindow::MAIN_WINDOW_MIN_SIZE = QSize(1100, 695);
 const QString MainWindow::NIGHT_MODE_SUFFIX = "_nm";
@@ -2185,9 +2190,20 @@ void MainWindow::timerEvent(QTimerEvent *)
                    if (showBattery)
                        string += QString(" BAT: %1%").arg(performanceMonitor->getBatteryUsed());
 
+                   // video encoding latency and dropped frames
+                   bool showVideo = mainController->isPlayingInNinjamRoom() && cameraIsActivated();
+                   if (showVideo) {
+                       auto videoStatistics = mainController->getVideoEncodingStatistics();
+                       string += QString(" VIDEO: %1 ms").arg(videoStatistics.averageLatency, 0, 'f', 0);
+
+                       auto droppedFrames = videoStatistics.replacedFrames + videoStatistics.overBudgetFrames;
+                       if (droppedFrames > 0)
+                           string += QString(" (%1 dropped)").arg(droppedFrames);
+                   }
+
                    performanceMonitorLabel->setText(string);
 
-                   performanceMonitorLabel->setVisible(showMemmory || showBattery);
+                   performanceMonitorLabel->setVisible(showMemmory || showBattery || showVideo);
 
                }
 
@@ -2414,6 +2430,71 @@ void MainWindow::showPrivateServerWindow()
     privateServerWindow->activateWindow();
 }
 
+void MainWindow::exportRecordedJam()
+{
+    QString rppFile = QFileDialog::getOpenFileName(this, tr("Select the recorded jam"), mainController->getSettings().getRecordingPath(), tr("Reaper project (*.rpp)"));
+    if (rppFile.isEmpty())
+        return;
+
+    auto jam = recorder::ReaperProjectGenerator::readJam(rppFile);
+    if (!jam) {
+        showMessageBox(tr("Error!"), tr("Can't read the recorded jam in %1").arg(rppFile), QMessageBox::Critical);
+        return;
+    }
+
+    auto answer = QMessageBox::question(this, tr("Export recorded jam"), tr("Export one file per track (stems) too?"), QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel, QMessageBox::No);
+    if (answer == QMessageBox::Cancel)
+        return;
+
+    QDir jamDir = QFileInfo(rppFile).absoluteDir(); // the 'Reaper' folder
+    jamDir.cdUp();
+
+    recorder::JamRenderer::Settings renderSettings;
+    renderSettings.outputPath = jamDir.absoluteFilePath("Mixdown");
+    renderSettings.sampleRate = static_cast<quint32>(mainController->getSampleRate());
+    renderSettings.renderStems = answer == QMessageBox::Yes;
+
+    auto renderer = new recorder::JamRenderer(*jam);
+    renderer->loadTrackMixes(*mainController->getUsersDataCache());
+
+    auto progressDialog = new QProgressDialog(tr("Exporting recorded jam ..."), tr("Cancel"), 0, 100, this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setAttribute(Qt::WA_DeleteOnClose, true);
+    progressDialog->setMinimumDuration(0);
+
+    connect(progressDialog, &QProgressDialog::canceled, [renderer](){
+        renderer->cancel();
+    });
+
+    // the renderer signals are emitted in a worker thread, the connections are queued because the context objects are living in GUI thread
+    connect(renderer, &recorder::JamRenderer::progressChanged, progressDialog, [progressDialog](int renderedIntervals, int totalIntervals){
+        progressDialog->setMaximum(totalIntervals);
+        progressDialog->setValue(renderedIntervals);
+    });
+
+    connect(renderer, &recorder::JamRenderer::renderFinished, this, [=](bool success){
+        progressDialog->close();
+        if (success) {
+            QString message = tr("Jam exported to %1").arg(renderSettings.outputPath);
+            if (renderer->getUndecodedFiles() > 0)
+                message += "\n\n" + tr("%1 recorded intervals can't be decoded and were exported as silence.").arg(renderer->getUndecodedFiles());
+
+            showMessageBox(tr("Export recorded jam"), message, QMessageBox::Information);
+        }
+        else if (!renderer->getErrorString().isEmpty()) { // not cancelled by the user
+            showMessageBox(tr("Error!"), tr("Can't export the recorded jam. %1").arg(renderer->getErrorString()), QMessageBox::Critical);
+        }
+
+        renderer->deleteLater();
+    });
+
+    progressDialog->show();
+
+    QtConcurrent::run([renderer, renderSettings](){
+        renderer->render(renderSettings);
+    });
+}
+
 void MainWindow::showConnectWithPrivateServerDialog()
 {
     auto privateServerDialog = new PrivateServerDialog(ui.centralWidget, mainController);
@@ -2505,8 +2586,10 @@ void MainWindow::setupPreferencesDialogSignals(PreferencesDialog *dialog)
     connect(dialog, &PreferencesDialog::looperFolderChanged, mainController, &MainController::storeLooperFolder);
 
     connect(dialog, &PreferencesDialog::looperWaveFilesBitDepthChanged, mainController, &MainController::storeLooperBitDepth);
+    connect(dialog, &PreferencesDialog::looperCompactLockedLayersChanged, mainController, &MainController::storeLooperCompactLockedLayersFlag);
 
     connect(dialog, &PreferencesDialog::rememberRemoteUserSettingsChanged, mainController, &MainController::storeRemoteUserRememberSettings);
+    connect(dialog, &PreferencesDialog::remoteAutoGainChanged, mainController, &MainController::setRemoteAutoGain);
     connect(dialog, &PreferencesDialog::rememberCollapsibleSectionsSettingsChanged, mainController, &MainController::storeCollapsibleSectionsRememberSettings);
 }
 
@@ -2897,6 +2980,8 @@ void MainWindow::setupSignals()
 
     connect(ui.actionHostPrivateServer, &QAction::triggered, this, &MainWindow::showPrivateServerWindow);
 
+    connect(ui.actionExportRecordedJam, &QAction::triggered, this, &MainWindow::exportRecordedJam);
+
     connect(ui.actionReportBugs, &QAction::triggered, this, &MainWindow::showJamtabaIssuesWebPage);
 
     connect(ui.actionWiki, &QAction::triggered, this, &MainWindow::showJamtabaWikiWebPage);
@@ -214,6 +214,8 @@ protected slots:
     void showConnectWithPrivateServerDialog();
     void showPrivateServerWindow();
 
+    void exportRecordedJam();
+
     // view menu
     void updateMeteringMenu();
     void handleMenuMeteringAction(QAction *);
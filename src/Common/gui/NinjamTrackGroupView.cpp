@@ -7,10 +7,8 @@
 #include "MainWindow.h"
 
 #include <QMenu>
-#include <QDateTime>
 #include <QLayout>
 #include <QStackedLayout>
-#include <QtConcurrent>
 
 const uint NinjamTrackGroupView::MAX_WIDTH_IN_GRID_LAYOUT = 350;
 const uint NinjamTrackGroupView::MAX_HEIGHT_IN_GRID_LAYOUT = 210;
@@ -26,7 +24,7 @@ NinjamTrackGroupView::NinjamTrackGroupView(MainController *mainController, long
     mainController(mainController),
     userIP(initialValues.getUserIP()),
     tracksLayoutEnum(TracksLayout::VerticalLayout),
-    videoFrameRate(10),
+    videoDecoder(new FFMpegDemuxer(this)),
     intervalsWithoutReceiveVideo(0)
 {
 
@@ -136,28 +134,12 @@ void NinjamTrackGroupView::addVideoInterval(const QByteArray &encodedVideoData)
         }
     }
 
-    FFMpegDemuxer *videoDecoder = new FFMpegDemuxer(this, encodedVideoData);
-    connect(videoDecoder, &FFMpegDemuxer::imagesDecoded, this, [=](QList<QImage> images, uint frameRate){
-        if (!images.isEmpty()) {
-            videoFrameRate = frameRate;
-            decodedImages << images;
-
-            videoDecoder->deleteLater();
-        }
-    });
-
-    QtConcurrent::run(videoDecoder, &FFMpegDemuxer::decode);
+    videoDecoder->addInterval(encodedVideoData); // played when the next interval starts
 }
 
 void NinjamTrackGroupView::startVideoStream()
 {
-    lastVideoRender = 0;
-
-    if (!decodedImages.isEmpty()) {
-        while (decodedImages.size() > 1)
-            decodedImages.removeFirst(); // keep just the last decoded interval
-    }
-    else {
+    if (!videoDecoder->startNextInterval()) {
         intervalsWithoutReceiveVideo++;
         if (intervalsWithoutReceiveVideo > 1) {
             videoWidget->setVisible(false); // hide the video widget when transmition is stopped
@@ -467,23 +449,13 @@ void NinjamTrackGroupView::updateGuiElements()
     TrackGroupView::updateGuiElements();
     userNameLabel->updateMarquee();
 
-    // video
-    if (!decodedImages.isEmpty()) {
-        quint64 now = QDateTime::currentMSecsSinceEpoch();
-
-        quint64 timePerFrame = 1000 / videoFrameRate;
-        quint64 diff = now - lastVideoRender;
-        if (diff >= timePerFrame) { // time to show a new video frame?
-            lastVideoRender = now - (diff % timePerFrame);
-            auto &currentImages = decodedImages.first();
-            if (!currentImages.isEmpty()) {
-                updateVideoFrame(currentImages.takeFirst());
-            }
-            else {
-                decodedImages.removeFirst(); // avoid show the last received frame forever
-            }
-        }
-    }
+    // video, the decoder scale the frames to the video widget size
+    if (videoWidget->isVisible())
+        videoDecoder->setTargetSize(videoWidget->getTargetSize(videoDecoder->getVideoSize()));
+
+    auto frame = videoDecoder->getCurrentFrame(); // null if is not the time to show a new video frame
+    if (!frame.isNull())
+        updateVideoFrame(frame);
 }
 
 NinjamTrackGroupView::~NinjamTrackGroupView()
@@ -17,6 +17,8 @@ namespace persistence {
 class CacheEntry;
 }
 
+class FFMpegDemuxer;
+
 enum class TracksLayout
 {
     VerticalLayout,
@@ -74,10 +76,7 @@ private:
     TracksLayout tracksLayoutEnum;
 
     VideoWidget *videoWidget;
-    QByteArray encodedVideoData;
-    quint64 lastVideoRender;
-    QList<QList<QImage>> decodedImages;
-    uint videoFrameRate;
+    FFMpegDemuxer *videoDecoder; // frames are decoded on demand, just a few frames are in memory
     uint intervalsWithoutReceiveVideo;
 
     void setupHorizontalLayout();
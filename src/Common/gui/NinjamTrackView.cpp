@@ -250,6 +250,10 @@ void NinjamTrackView::setInitialValues(const persistence::CacheEntry &initialVal
     auto instrumentIconIndex = initialValues.hasValidInstrumentIndex() ? initialValues.getInstrumentIndex() : guessInstrumentIcon();
     instrumentsButton->setInstrumentIcon(instrumentIconIndex);
 
+    auto trackNode = getTrackNode();
+    if (trackNode && initialValues.hasLoudness())
+        trackNode->setInitialLoudness(initialValues.getLoudness()); // auto gain is applied before the first interval is measured
+
 }
 
 void NinjamTrackView::setChannelMode(NinjamTrackNode::ChannelMode mode)
@@ -301,6 +305,12 @@ void NinjamTrackView::updateGuiElements()
             toolTipText += QString(" (%1, %2 KHz)")
                     .arg(trackNode->isStereo() ? tr("Stereo") : tr("Mono"))
                     .arg(QString::number(trackNode->getSampleRate()/1000.0, 'f', 1));
+
+            auto autoGain = trackNode->getAutoGainInDb();
+            if (autoGain != 0.0f)
+                toolTipText += QString("\n%1 %2 dB").arg(tr("Auto level")).arg(QString::number(autoGain, 'f', 1));
+
+            updateCachedLoudness(trackNode->getLoudness());
         }
 
         networkUsageLabel->setToolTip(toolTipText);
@@ -312,6 +322,15 @@ void NinjamTrackView::updateGuiElements()
     }
 }
 
+void NinjamTrackView::updateCachedLoudness(float loudness)
+{
+    if (loudness <= persistence::CacheEntry::UNKNOWN_LOUDNESS || qAbs(loudness - cacheEntry.getLoudness()) < 0.1f)
+        return;
+
+    cacheEntry.setLoudness(loudness);
+    mainController->getUsersDataCache()->updateUserCacheEntry(cacheEntry);
+}
+
 void NinjamTrackView::setNetworkUsageUpdatePeriod(quint32 periodInMilliseconds)
 {
     NinjamTrackView::networkUsageUpdatePeriod = periodInMilliseconds;
@@ -78,6 +78,8 @@ private:
 
     void setupHorizontalLayout();
 
+    void updateCachedLoudness(float loudness); // remembering the measured loudness
+
     void updateExtraWidgetsVisibility();
 
     bool downloadingFirstInterval;
@@ -139,6 +139,7 @@ void PreferencesDialog::setupSignals()
 
     connect(ui->radioButtonLooperOggEncoding, &QCheckBox::toggled, this, &PreferencesDialog::looperAudioEncodingFlagChanged);
     connect(ui->lineEditLoopsFolder, &QLineEdit::textChanged, this,  &PreferencesDialog::looperFolderChanged);
+    connect(ui->checkBoxLooperCompactLockedLayers, &QCheckBox::toggled, this, &PreferencesDialog::looperCompactLockedLayersChanged);
     connect(ui->loopsFolderBrowseButton, &QPushButton::clicked, [=]() {
         QString currentLoopsFolder = ui->lineEditLoopsFolder->text();
         QFileDialog folderDialog(this, tr("Choosing loops folder ..."), currentLoopsFolder);
@@ -190,6 +191,9 @@ void PreferencesDialog::accept()
     bool rememberingLowCut = ui->checkBoxRememberLowCut->isChecked();
     emit rememberRemoteUserSettingsChanged(rememberingBoost, rememberingLevel, rememberingPan, rememberingMute, rememberingLowCut);
 
+    if (ui->checkBoxRemoteAutoGain->isChecked() != settings->isRemoteAutoGainEnabled())
+        emit remoteAutoGainChanged(ui->checkBoxRemoteAutoGain->isChecked());
+
     bool rememberLocalChannels = ui->checkBoxRememberLocalChannels->isChecked();
     bool rememberBottomSection = ui->checkBoxRememberBottomSection->isChecked();
     bool rememberChatSection = ui->checkBoxRememberChatSection->isChecked();
@@ -256,6 +260,7 @@ void PreferencesDialog::populateRememberTab()
     ui->checkBoxRememberPan->setChecked(settings->isRememberingPan());
     ui->checkBoxRememberMute->setChecked(settings->isRememberingMute());
     ui->checkBoxRememberLowCut->setChecked(settings->isRememberingLowCut());
+    ui->checkBoxRemoteAutoGain->setChecked(settings->isRemoteAutoGainEnabled());
 
     ui->checkBoxRememberLocalChannels->setChecked(settings->isRememberingLocalChannels());
     ui->checkBoxRememberBottomSection->setChecked(settings->isRememberingBottomSection());
@@ -267,6 +272,7 @@ void PreferencesDialog::populateLooperTab()
     QSignalBlocker lineEditSignalBlocker(ui->lineEditLoopsFolder);
     QSignalBlocker radioButtonSignalBlocker(ui->radioButtonLooperOggEncoding);
     QSignalBlocker bitDepthCheckBoxBlocker(ui->comboBoxBitRate);
+    QSignalBlocker compactLayersCheckBoxBlocker(ui->checkBoxLooperCompactLockedLayers);
 
     ui->lineEditLoopsFolder->setText(settings->getLooperFolder());
     ui->radioButtonLooperOggEncoding->setChecked(settings->getLooperAudioEncodingFlag());
@@ -281,6 +287,8 @@ void PreferencesDialog::populateLooperTab()
         comboBoxIndex = 1;
 
     ui->comboBoxBitRate->setCurrentIndex(comboBoxIndex);
+
+    ui->checkBoxLooperCompactLockedLayers->setChecked(settings->getLooperCompactLockedLayersFlag());
 }
 
 void PreferencesDialog::selectRecordingTab()
@@ -45,7 +45,9 @@ signals:
     void looperAudioEncodingFlagChanged(bool savingEncodedAudio);
     void looperWaveFilesBitDepthChanged(quint8 bitDepth);
     void looperFolderChanged(const QString &newLoopsFolder);
+    void looperCompactLockedLayersChanged(bool compact);
     void rememberRemoteUserSettingsChanged(bool boost, bool level, bool pan, bool mute, bool lowCut);
+    void remoteAutoGainChanged(bool enabled);
     void rememberCollapsibleSectionsSettingsChanged(bool localChannels, bool bottomSection, bool chatSection);
 
 public slots:
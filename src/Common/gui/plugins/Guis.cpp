@@ -3,10 +3,13 @@
 #include <QSlider>
 #include <QLabel>
 #include <QLineEdit>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QSignalMapper>
 #include <cmath>
 #include <QDebug>
 #include <QObject>
-#include "audio/core/Plugins.h"
+#include "audio/BuiltInPlugins.h"
 
 PluginGui::PluginGui(audio::Plugin *plugin) :
     QWidget(0),
@@ -28,7 +31,8 @@ audio::Plugin *PluginGui::getPlugin() const
 // ++++++++++++++++++++++++++++++++++++++++++++++
 
 DelayGui::DelayGui(audio::JamtabaDelay *delayPlugin) :
-    PluginGui(delayPlugin)
+    PluginGui(delayPlugin),
+    delay(delayPlugin)
 {
     QGridLayout *mainLayout = new QGridLayout(this);
 
@@ -37,56 +41,137 @@ DelayGui::DelayGui(audio::JamtabaDelay *delayPlugin) :
     sliderDelayTime->setMinimum(1);
     sliderDelayTime->setMaximum(2000); // 2 seconds
     lineEditDelayTime = new QLineEdit(this);
+    lineEditDelayTime->setReadOnly(true);
     mainLayout->addWidget(new QLabel(tr("Delay Time (ms):"), this), 0, 0, Qt::AlignRight);
     mainLayout->addWidget(sliderDelayTime, 0, 1);
     mainLayout->addWidget(lineEditDelayTime, 0, 2);
-    QObject::connect(sliderDelayTime, &QSlider::sliderReleased, this, &DelayGui::on_sliderDelayReleased);
+
+    // tempo sync, the delay time is computed using the ninjam BPM
+    comboSync = new QComboBox(this);
+    comboSync->addItem(tr("Off"), audio::JamtabaDelay::NoSync);
+    comboSync->addItem(tr("1/2"), audio::JamtabaDelay::Half);
+    comboSync->addItem(tr("1/4"), audio::JamtabaDelay::Quarter);
+    comboSync->addItem(tr("1/8 dotted"), audio::JamtabaDelay::DottedEighth);
+    comboSync->addItem(tr("1/8"), audio::JamtabaDelay::Eighth);
+    comboSync->addItem(tr("1/8 triplet"), audio::JamtabaDelay::EighthTriplet);
+    comboSync->addItem(tr("1/16"), audio::JamtabaDelay::Sixteenth);
+    mainLayout->addWidget(new QLabel(tr("Sync:"), this), 1, 0, Qt::AlignRight);
+    mainLayout->addWidget(comboSync, 1, 1, 1, 2, Qt::AlignLeft);
 
     // feedback
     sliderFeedback = new QSlider(Qt::Horizontal, this);
+    sliderFeedback->setRange(1, 99);
     lineEditFeedback = new QLineEdit(this);
-    mainLayout->addWidget(new QLabel(tr("Feedback (db):"), this), 1, 0, Qt::AlignRight);
-    mainLayout->addWidget(sliderFeedback, 1, 1);
-    mainLayout->addWidget(lineEditFeedback, 1, 2);
-    QObject::connect(sliderFeedback, &QSlider::sliderReleased, this, &DelayGui::on_sliderFeedbackReleased);
+    lineEditFeedback->setReadOnly(true);
+    mainLayout->addWidget(new QLabel(tr("Feedback (db):"), this), 2, 0, Qt::AlignRight);
+    mainLayout->addWidget(sliderFeedback, 2, 1);
+    mainLayout->addWidget(lineEditFeedback, 2, 2);
 
     // level
     sliderLevel = new QSlider(Qt::Horizontal, this); // wet gain
     sliderLevel->setMaximum(100);
     lineEditLevel = new QLineEdit(this);
-    mainLayout->addWidget(new QLabel(tr("Level:"), this), 2, 0, Qt::AlignRight);
-    mainLayout->addWidget(sliderLevel, 2, 1);
-    mainLayout->addWidget(lineEditLevel, 2, 2);
-    QObject::connect(sliderLevel, &QSlider::sliderReleased, this, &DelayGui::on_sliderLevelReleased);
-
-    // initial values
-    sliderDelayTime->setValue(sliderDelayTime->maximum() * 0.25);
-    sliderFeedback->setValue(sliderFeedback->maximum() * 0.25);
-    sliderLevel->setValue(sliderLevel->maximum() * 0.5);
+    lineEditLevel->setReadOnly(true);
+    mainLayout->addWidget(new QLabel(tr("Level:"), this), 3, 0, Qt::AlignRight);
+    mainLayout->addWidget(sliderLevel, 3, 1);
+    mainLayout->addWidget(lineEditLevel, 3, 2);
+
+    // initial values, the delay is processing while the sliders are moved
+    sliderDelayTime->setValue(qRound(delay->getDelayTime()));
+    sliderFeedback->setValue(qRound(delay->getFeedback() * 100));
+    sliderLevel->setValue(qRound(delay->getLevel() * 100));
+    comboSync->setCurrentIndex(comboSync->findData(delay->getTempoSync()));
+
+    on_sliderDelayChanged(sliderDelayTime->value());
+    on_sliderFeedbackChanged(sliderFeedback->value());
+    on_sliderLevelChanged(sliderLevel->value());
+    on_comboSyncChanged(comboSync->currentIndex());
+
+    connect(sliderDelayTime, &QSlider::valueChanged, this, &DelayGui::on_sliderDelayChanged);
+    connect(sliderFeedback, &QSlider::valueChanged, this, &DelayGui::on_sliderFeedbackChanged);
+    connect(sliderLevel, &QSlider::valueChanged, this, &DelayGui::on_sliderLevelChanged);
+    connect(comboSync, SIGNAL(currentIndexChanged(int)), this, SLOT(on_comboSyncChanged(int)));
 }
 
-void DelayGui::on_sliderDelayReleased()
+void DelayGui::on_sliderDelayChanged(int value)
 {
-    dynamic_cast<audio::JamtabaDelay *>(plugin)->setDelayTime(sliderDelayTime->value());
-    lineEditDelayTime->setText(QString::number(sliderDelayTime->value()));
+    delay->setDelayTime(value);
+    lineEditDelayTime->setText(QString::number(value));
 }
 
-void DelayGui::on_sliderFeedbackReleased()
+void DelayGui::on_sliderFeedbackChanged(int value)
 {
-    int value = sliderFeedback->value();
-    dynamic_cast<audio::JamtabaDelay *>(plugin)->setFeedback(value/100.0);
+    delay->setFeedback(value/100.0);
     float db = 20 * std::log10(value/100.0);
     lineEditFeedback->setText(QString::number(db, 'f', 1));
 }
 
-void DelayGui::on_sliderLevelReleased()
+void DelayGui::on_sliderLevelChanged(int value)
 {
-    int value = sliderLevel->value();
-    dynamic_cast<audio::JamtabaDelay *>(plugin)->setLevel(value/100.0);
+    delay->setLevel(value/100.0);
     lineEditLevel->setText(QString::number(value/100.0, 'f', 1));
 }
 
+void DelayGui::on_comboSyncChanged(int index)
+{
+    auto sync = static_cast<audio::JamtabaDelay::TempoSync>(comboSync->itemData(index).toInt());
+    delay->setTempoSync(sync);
+
+    const bool synced = sync != audio::JamtabaDelay::NoSync;
+    sliderDelayTime->setEnabled(!synced);
+    lineEditDelayTime->setEnabled(!synced);
+}
+
 DelayGui::~DelayGui()
 {
     qDebug() << "detrutor delay GUI";
 }
+
+// ++++++++++++++++++++++++++++++++++++++++++++++
+
+EqualizerGui::EqualizerGui(audio::JamtabaEqualizer *equalizer) :
+    PluginGui(equalizer),
+    equalizer(equalizer)
+{
+    auto mainLayout = new QGridLayout(this);
+
+    lowCutCheckBox = new QCheckBox(tr("Low cut"), this);
+    lowCutCheckBox->setChecked(equalizer->isLowCutEnabled());
+    mainLayout->addWidget(lowCutCheckBox, 0, 0, 1, BANDS, Qt::AlignLeft);
+    connect(lowCutCheckBox, &QCheckBox::toggled, this, &EqualizerGui::setLowCut);
+
+    auto mapper = new QSignalMapper(this);
+    const QString bandNames[BANDS] = { tr("Low"), tr("Mid"), tr("High") };
+    const int maxGain = static_cast<int>(audio::JamtabaEqualizer::MAX_GAIN * 10); // slider values in tenths of dB
+
+    for (int band = 0; band < BANDS; ++band) {
+        gainSliders[band] = new QSlider(Qt::Vertical, this);
+        gainSliders[band]->setRange(-maxGain, maxGain);
+        gainSliders[band]->setValue(qRound(equalizer->getBandGain(static_cast<audio::JamtabaEqualizer::Band>(band)) * 10));
+
+        gainLabels[band] = new QLabel(this);
+
+        mainLayout->addWidget(gainLabels[band], 1, band, Qt::AlignHCenter);
+        mainLayout->addWidget(gainSliders[band], 2, band, Qt::AlignHCenter);
+        mainLayout->addWidget(new QLabel(bandNames[band], this), 3, band, Qt::AlignHCenter);
+
+        connect(gainSliders[band], SIGNAL(valueChanged(int)), mapper, SLOT(map()));
+        mapper->setMapping(gainSliders[band], band);
+
+        updateBandGain(band);
+    }
+
+    connect(mapper, SIGNAL(mapped(int)), this, SLOT(updateBandGain(int)));
+}
+
+void EqualizerGui::updateBandGain(int band)
+{
+    const float gain = gainSliders[band]->value() / 10.0f;
+    equalizer->setBandGain(static_cast<audio::JamtabaEqualizer::Band>(band), gain);
+    gainLabels[band]->setText(QString::number(gain, 'f', 1) + " dB");
+}
+
+void EqualizerGui::setLowCut(bool enabled)
+{
+    equalizer->setLowCut(enabled);
+}
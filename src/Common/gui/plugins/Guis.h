@@ -5,9 +5,13 @@
 
 class QSlider;
 class QLineEdit;
+class QLabel;
+class QCheckBox;
+class QComboBox;
 
 namespace audio {
 class JamtabaDelay;
+class JamtabaEqualizer;
 class Plugin;
 }
 
@@ -37,14 +41,19 @@ public:
     ~DelayGui();
 
 private slots:
-    void on_sliderDelayReleased();
-    void on_sliderFeedbackReleased();
-    void on_sliderLevelReleased();
+    void on_sliderDelayChanged(int value);
+    void on_sliderFeedbackChanged(int value);
+    void on_sliderLevelChanged(int value);
+    void on_comboSyncChanged(int index);
 
 private:
+    audio::JamtabaDelay *delay;
+
     QSlider *sliderDelayTime;
     QLineEdit *lineEditDelayTime;
 
+    QComboBox *comboSync;
+
     QSlider *sliderFeedback;
     QLineEdit *lineEditFeedback;
 
@@ -52,4 +61,25 @@ private:
     QLineEdit *lineEditLevel;
 };
 
+class EqualizerGui : public PluginGui
+{
+    Q_OBJECT
+
+public:
+    explicit EqualizerGui(audio::JamtabaEqualizer *equalizer);
+
+private slots:
+    void updateBandGain(int band);
+    void setLowCut(bool enabled);
+
+private:
+    static const int BANDS = 3;
+
+    audio::JamtabaEqualizer *equalizer;
+
+    QSlider *gainSliders[BANDS];
+    QLabel *gainLabels[BANDS];
+    QCheckBox *lowCutCheckBox;
+};
+
 #endif // DELAY_H
@@ -91,7 +91,7 @@ void LooperWavePanel::updateDrawings()
     if (!looper)
         return;
 
-    peaksArray = looper->getLayerPeaks(layerID, samplesPerPixel);
+    looper->getLayerPeaks(layerID, samplesPerPixel, peaksArray); // reusing the peaks array, no allocations when zooming or resizing
 
     update();
 }
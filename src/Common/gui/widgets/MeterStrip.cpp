@@ -0,0 +1,87 @@
+#include "MeterStrip.h"
+
+#include <QPainter>
+#include <QPaintDevice>
+#include <cmath>
+
+MeterStrip::MeterStrip() :
+    devicePixelRatio(1.0),
+    orientation(Qt::Vertical),
+    drawSegments(true),
+    segmentSize(0),
+    valid(false)
+{
+
+}
+
+void MeterStrip::invalidate()
+{
+    valid = false;
+}
+
+void MeterStrip::rebuild(const QSizeF &size, qreal devicePixelRatio, const std::vector<QColor> &colors,
+                         Qt::Orientation orientation, bool drawSegments, quint8 segmentSize)
+{
+    this->size = size;
+    this->devicePixelRatio = devicePixelRatio;
+    this->orientation = orientation;
+    this->drawSegments = drawSegments;
+    this->segmentSize = segmentSize;
+    this->valid = true;
+
+    const int pixmapWidth = std::ceil(size.width() * devicePixelRatio);
+    const int pixmapHeight = std::ceil(size.height() * devicePixelRatio);
+
+    pixmap = QPixmap(qMax(pixmapWidth, 1), qMax(pixmapHeight, 1));
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    if (colors.empty() || !segmentSize)
+        return;
+
+    // same geometry used before the cache, the segments are painted from the bottom (vertical) or left (horizontal)
+    const bool isVertical = orientation == Qt::Vertical;
+    const qreal pad = drawSegments ? 1.0 : 0;
+    const quint32 segments = static_cast<quint32>(isVertical ? size.height() : size.width()) / segmentSize;
+
+    qreal x = 0;
+    qreal y = isVertical ? (size.height() - segmentSize) : 0;
+    const qreal w = isVertical ? size.width() - pad : segmentSize - pad;
+    const qreal h = isVertical ? (segmentSize - pad) : size.height() - pad;
+
+    QPainter painter(&pixmap);
+    for (quint32 i = 0; i < segments; ++i) {
+        const QColor &color = (i < colors.size()) ? colors[i] : colors.back(); // always use the last color (red) when painting big peak values
+        painter.fillRect(QRectF(x, y, w, h), color);
+        if (isVertical)
+            y -= segmentSize;
+        else
+            x += segmentSize;
+    }
+}
+
+void MeterStrip::paint(QPainter &painter, const QRectF &rect, qreal peakPosition, const std::vector<QColor> &colors,
+                       Qt::Orientation orientation, bool drawSegments, quint8 segmentSize)
+{
+    const quint32 segmentsToPaint = getSegmentsToPaint(peakPosition, segmentSize);
+    if (!segmentsToPaint || colors.empty())
+        return;
+
+    const qreal dpr = painter.device() ? painter.device()->devicePixelRatioF() : 1.0;
+
+    if (!valid || size != rect.size() || devicePixelRatio != dpr || this->orientation != orientation
+            || this->drawSegments != drawSegments || this->segmentSize != segmentSize) {
+        rebuild(rect.size(), dpr, colors, orientation, drawSegments, segmentSize);
+    }
+
+    const qreal litSize = segmentsToPaint * segmentSize;
+    if (orientation == Qt::Vertical) {
+        const qreal top = rect.height() - litSize;
+        QRectF source(0, top, rect.width(), litSize);
+        painter.drawPixmap(QRectF(rect.left(), top, rect.width(), litSize), pixmap, QRectF(source.topLeft() * dpr, source.size() * dpr));
+    }
+    else {
+        QRectF source(0, 0, litSize, rect.height());
+        painter.drawPixmap(QRectF(rect.left(), rect.top(), litSize, rect.height()), pixmap, QRectF(source.topLeft() * dpr, source.size() * dpr));
+    }
+}
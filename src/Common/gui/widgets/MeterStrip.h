@@ -0,0 +1,47 @@
+#ifndef _METER_STRIP_H_
+#define _METER_STRIP_H_
+
+#include <QPixmap>
+#include <QColor>
+#include <QRectF>
+#include <vector>
+
+class QPainter;
+
+/**
+    Pre-rendered meter segments. All the segments are painted once in a pixmap (rebuilt only when the
+    rectangle size, orientation, segments style or colors change) and the lit segments are blitted as
+    one clipped rectangle, instead of filling one rectangle per segment in every repaint.
+ */
+
+class MeterStrip
+{
+public:
+    MeterStrip();
+
+    void invalidate(); // call when the colors are changed
+
+    void paint(QPainter &painter, const QRectF &rect, qreal peakPosition, const std::vector<QColor> &colors,
+               Qt::Orientation orientation, bool drawSegments, quint8 segmentSize);
+
+    static inline quint32 getSegmentsToPaint(qreal peakPosition, quint8 segmentSize)
+    {
+        return peakPosition > 0 ? static_cast<quint32>(peakPosition) / segmentSize : 0;
+    }
+
+private:
+    void rebuild(const QSizeF &size, qreal devicePixelRatio, const std::vector<QColor> &colors,
+                 Qt::Orientation orientation, bool drawSegments, quint8 segmentSize);
+
+    QPixmap pixmap;
+
+    // cache key
+    QSizeF size;
+    qreal devicePixelRatio;
+    Qt::Orientation orientation;
+    bool drawSegments;
+    quint8 segmentSize;
+    bool valid;
+};
+
+#endif
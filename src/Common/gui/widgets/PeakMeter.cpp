@@ -58,29 +58,14 @@ void BaseMeter::resizeEvent(QResizeEvent * /*ev*/)
 }
 
 
-void BaseMeter::paintSegments(QPainter &painter, const QRectF &rect, float peakPosition, const std::vector<QColor> &segmentsColors, bool drawSegments)
+void BaseMeter::paintSegments(QPainter &painter, MeterStrip &strip, const QRectF &rect, float peakPosition, const std::vector<QColor> &segmentsColors, bool drawSegments)
 {
-    const quint32 segmentsToPaint = (quint32)peakPosition/SEGMENTS_SIZE;
+    const quint32 segmentsToPaint = MeterStrip::getSegmentsToPaint(peakPosition, SEGMENTS_SIZE);
 
     if (segmentsColors.size() < segmentsToPaint)
         return;
 
-    const bool isVerticalMeter = isVertical();
-
-    const qreal pad = drawSegments ? 1.0 : 0;
-
-    qreal x = rect.left();
-    qreal y = isVerticalMeter ? (rect.height() - SEGMENTS_SIZE) : rect.top();
-    const qreal w = isVerticalMeter ? rect.width() - pad : SEGMENTS_SIZE - pad;
-    const qreal h = isVerticalMeter ? (SEGMENTS_SIZE - pad) : rect.height() - pad;
-
-    for (quint32 i = 0; i < segmentsToPaint; ++i) {
-        painter.fillRect(x, y, w, h, segmentsColors[i]);
-        if (isVerticalMeter)
-            y -= SEGMENTS_SIZE;
-        else
-            x += SEGMENTS_SIZE;
-    }
+    strip.paint(painter, rect, peakPosition, segmentsColors, orientation, drawSegments, SEGMENTS_SIZE); // the lit segments are blitted in one step
 }
 
 void BaseMeter::setOrientation(Qt::Orientation orientation)
@@ -213,9 +198,12 @@ void AudioMeter::recreateInterpolatedColors()
 
         QColor newRmsColor(rmsColor);
         int newAlpha = static_cast<float>(i)/segments * rmsColor.alpha();
-        rmsColor.setAlpha(qMin(newAlpha + rmsInitialAlpha, 255));
+        newRmsColor.setAlpha(qMin(newAlpha + rmsInitialAlpha, 255));
         rmsColors.push_back(newRmsColor);
     }
+
+    peakStrip.invalidate();
+    rmsStrip.invalidate();
 }
 
 void AudioMeter::paintMaxPeakMarker(QPainter &painter, qreal maxPeakPosition, const QRectF &rect)
@@ -303,7 +291,7 @@ void AudioMeter::paintEvent(QPaintEvent *)
         for (uint i = 0; i < channels; ++i) {
             if (paintingPeaks && currentPeak[i]) {
                 qreal peakPosition = getPeakPosition(currentPeak[i], rectSize, peakValuesOffset);
-                paintSegments(painter, drawRect, peakPosition, peakColors, drawSegments);
+                paintSegments(painter, peakStrip, drawRect, peakPosition, peakColors, drawSegments);
             }
 
             if (paintingMaxPeakMarker && maxPeak[i]) {
@@ -316,7 +304,7 @@ void AudioMeter::paintEvent(QPaintEvent *)
 
                 qreal rmsXOffset = (paintingPeaks && isVertical()) ? channels * drawRect.width() : 0;
                 qreal rmsYOffset = (paintingPeaks && !isVertical()) ? channels * drawRect.height() : 0;
-                paintSegments(painter, drawRect.translated(rmsXOffset, rmsYOffset), rmsPosition, rmsColors, drawSegments);
+                paintSegments(painter, rmsStrip, drawRect.translated(rmsXOffset, rmsYOffset), rmsPosition, rmsColors, drawSegments);
             }
 
             if (isVertical())
@@ -521,7 +509,8 @@ bool AudioMeter::isPaintingRmsOnly()
 MidiActivityMeter::MidiActivityMeter(QWidget *parent) :
     BaseMeter(parent),
     midiActivityColor(Qt::red),
-    activityValue(0)
+    activityValue(0),
+    paintedSegments(0)
 {
 
 }
@@ -540,6 +529,8 @@ void MidiActivityMeter::recreateInterpolatedColors()
         newColor.setAlpha(qMin(newAlpha + initialAlpha, 255));
         colors.push_back(newColor);
     }
+
+    strip.invalidate();
 }
 
 void MidiActivityMeter::paintEvent(QPaintEvent *)
@@ -548,9 +539,27 @@ void MidiActivityMeter::paintEvent(QPaintEvent *)
 
     if (isEnabled()) {
         float value = (isVertical() ? height() : width()) * activityValue;
-        paintSegments(painter, rect(), value, colors);
-        updateInternalValues();
+        paintSegments(painter, strip, rect(), value, colors);
     }
+
+    paintedSegments = getSegmentsToPaint();
+}
+
+quint32 MidiActivityMeter::getSegmentsToPaint() const
+{
+    if (!isEnabled())
+        return 0;
+
+    const float value = (isVertical() ? height() : width()) * activityValue;
+    return MeterStrip::getSegmentsToPaint(value, SEGMENTS_SIZE);
+}
+
+void MidiActivityMeter::refresh()
+{
+    updateInternalValues();
+
+    if (getSegmentsToPaint() != paintedSegments)
+        update();
 }
 
 void MidiActivityMeter::updateInternalValues()
@@ -571,6 +580,7 @@ void MidiActivityMeter::updateInternalValues()
 void MidiActivityMeter::setSolidColor(const QColor &color)
 {
     this->midiActivityColor = color;
+    recreateInterpolatedColors();
     update();
 }
 
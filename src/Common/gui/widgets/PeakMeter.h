@@ -4,6 +4,8 @@
 #include <QFrame>
 #include <cmath>
 
+#include "MeterStrip.h"
+
 class BaseMeter : public QFrame
 {
     Q_OBJECT
@@ -21,7 +23,7 @@ protected:
 
     void resizeEvent(QResizeEvent *) override;
 
-    void paintSegments(QPainter &painter, const QRectF &rect, float rawPeakValue, const std::vector<QColor> &segmentsColors, bool drawSegments = true);
+    void paintSegments(QPainter &painter, MeterStrip &strip, const QRectF &rect, float peakPosition, const std::vector<QColor> &segmentsColors, bool drawSegments = true);
 
     bool isVertical() const;
 
@@ -115,6 +117,9 @@ private:
     std::vector<QColor> peakColors;
     std::vector<QColor> rmsColors;
 
+    MeterStrip peakStrip; // pre-rendered segments
+    MeterStrip rmsStrip;
+
     // static painting flags. Turning on/off will affect all audio meters.
     static bool paintingMaxPeakMarker;
     static bool paintingPeaks;
@@ -173,6 +178,7 @@ public:
     explicit MidiActivityMeter(QWidget *parent);
     void setSolidColor(const QColor &color);
     void setActivityValue(float value);
+    void refresh(); // compute the decay and repaint only when the lit segments are changed
 
     QSize minimumSizeHint() const override;
 
@@ -183,9 +189,12 @@ protected:
 private:
     QColor midiActivityColor;
     std::vector<QColor> colors;
+    MeterStrip strip;
     float activityValue;
+    quint32 paintedSegments;
 
     void updateInternalValues();
+    quint32 getSegmentsToPaint() const;
 
     static const int MIN_SIZE;
 };
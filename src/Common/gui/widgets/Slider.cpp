@@ -42,8 +42,14 @@ AudioSlider::AudioSlider(QWidget *parent) :
 
     connect(this, &AudioSlider::valueChanged, this, &AudioSlider::showToolTip);
 
-    currentPeak[0] = currentPeak[1] = 0;
-    currentRms[0] = currentRms[1] = 0;
+    for (int i = 0; i < 2; ++i) {
+        currentPeak[i] = 0.0f;
+        maxPeak[i] = 0.0f;
+        currentRms[i] = 0.0f;
+        lastMaxPeakTime[i] = 0;
+    }
+
+    paintedPixels = computeMeterPixels();
 }
 
 void AudioSlider::setShowMeterOnly(bool showMeterOnly)
@@ -98,6 +104,8 @@ void AudioSlider::setPeak(float peak, float rms)
     peak = limitFloatValue(peak, 0.0f, maxLinearValue);
     rms = limitFloatValue(rms, 0.0f, maxLinearValue);
 
+    updateInternalValues(); // compute decay and max peak
+
     if (peak > currentPeak[0] || peak > currentPeak[1]) {
         currentPeak[0] = currentPeak[1] = peak;
         if (peak > maxPeak[0] || peak > maxPeak[1]) {
@@ -109,7 +117,7 @@ void AudioSlider::setPeak(float peak, float rms)
     if (rms > currentRms[0] || rms > currentRms[1])
         currentRms[0] = currentRms[1] = rms;
 
-    update();
+    updateMeters();
 }
 
 
@@ -123,6 +131,8 @@ void AudioSlider::setPeak(float leftPeak, float rightPeak, float leftRms, float
     leftRms = limitFloatValue(leftRms, 0.0f, maxLinearValue);
     rightRms = limitFloatValue(rightRms, 0.0f, maxLinearValue);
 
+    updateInternalValues(); // compute decay and max peak
+
     float peaks[2] = {leftPeak, rightPeak};
     for (int i = 0; i < 2; ++i) {
         if (!stereo) // fixing #858
@@ -145,7 +155,47 @@ void AudioSlider::setPeak(float leftPeak, float rightPeak, float leftRms, float
             currentRms[i] = rms[i];
     }
 
-    update();
+    updateMeters();
+}
+
+bool AudioSlider::MeterPixels::operator==(const MeterPixels &other) const
+{
+    for (int i = 0; i < 2; ++i) {
+        if (peakSegments[i] != other.peakSegments[i] || rmsSegments[i] != other.rmsSegments[i] || maxPeakPosition[i] != other.maxPeakPosition[i])
+            return false;
+    }
+
+    return true;
+}
+
+AudioSlider::MeterPixels AudioSlider::computeMeterPixels() const
+{
+    MeterPixels pixels = { {0, 0}, {0, 0}, {0, 0} };
+
+    if (!isEnabled() || showSliderOnly)
+        return pixels;
+
+    const uint channels = stereo ? 2 : 1;
+    const qreal rectSize = isVertical() ? height() : width();
+
+    for (uint i = 0; i < channels; ++i) {
+        if (paintingPeaks && currentPeak[i])
+            pixels.peakSegments[i] = MeterStrip::getSegmentsToPaint(getPeakPosition(currentPeak[i], rectSize), SEGMENTS_SIZE);
+
+        if (paintingMaxPeakMarker && maxPeak[i])
+            pixels.maxPeakPosition[i] = qRound(getPeakPosition(maxPeak[i], rectSize));
+
+        if (paintingRMS && currentRms[i])
+            pixels.rmsSegments[i] = MeterStrip::getSegmentsToPaint(getPeakPosition(currentRms[i], rectSize), SEGMENTS_SIZE);
+    }
+
+    return pixels;
+}
+
+void AudioSlider::updateMeters()
+{
+    if (computeMeterPixels() != paintedPixels)
+        update();
 }
 
 
@@ -261,7 +311,7 @@ void AudioSlider::paintEvent(QPaintEvent *)
         for (uint i = 0; i < channels; ++i) {
             if (paintingPeaks && currentPeak[i]) {
                 qreal peakPosition = getPeakPosition(currentPeak[i], rectSize);
-                paintSegments(painter, drawRect, peakPosition, peakColors, drawSegments);
+                paintSegments(painter, peakStrip, drawRect, peakPosition, peakColors, drawSegments);
             }
 
             if (paintingMaxPeakMarker && maxPeak[i]) {
@@ -274,7 +324,7 @@ void AudioSlider::paintEvent(QPaintEvent *)
 
                 qreal rmsXOffset = (paintingPeaks && isVertical()) ? channels * drawRect.width() : 0;
                 qreal rmsYOffset = (paintingPeaks && !isVertical()) ? channels * drawRect.height() : 0;
-                paintSegments(painter, drawRect.translated(rmsXOffset, rmsYOffset), rmsPosition, rmsColors, drawSegments);
+                paintSegments(painter, rmsStrip, drawRect.translated(rmsXOffset, rmsYOffset), rmsPosition, rmsColors, drawSegments);
             }
 
             if (isVertical())
@@ -295,8 +345,7 @@ void AudioSlider::paintEvent(QPaintEvent *)
         paintSliderHandler(painter);
     }
 
-    if (!showSliderOnly)
-        updateInternalValues(); // compute decay and max peak
+    paintedPixels = computeMeterPixels();
 }
 
 void AudioSlider::paintMaxPeakMarker(QPainter &painter, qreal maxPeakPosition, const QRectF &rect)
@@ -385,9 +434,12 @@ void AudioSlider::recreateInterpolatedColors()
 
         QColor newRmsColor(rmsColor);
         int newAlpha = static_cast<float>(i)/segments * rmsColor.alpha();
-        rmsColor.setAlpha(qMin(newAlpha + rmsInitialAlpha, 255));
+        newRmsColor.setAlpha(qMin(newAlpha + rmsInitialAlpha, 255));
         rmsColors.push_back(newRmsColor);
     }
+
+    peakStrip.invalidate();
+    rmsStrip.invalidate();
 }
 
 
@@ -400,27 +452,9 @@ QColor AudioSlider::interpolateColor(const QColor &start, const QColor &end, flo
     return QColor::fromRgb(r, g, b);
 }
 
-void AudioSlider::paintSegments(QPainter &painter, const QRectF &rect, float peakPosition, const std::vector<QColor> &segmentsColors, bool drawSegments)
+void AudioSlider::paintSegments(QPainter &painter, MeterStrip &strip, const QRectF &rect, float peakPosition, const std::vector<QColor> &segmentsColors, bool drawSegments)
 {
-    const quint32 segmentsToPaint = (quint32)peakPosition/SEGMENTS_SIZE;
-
-    const bool isVerticalMeter = isVertical();
-
-    const qreal pad = drawSegments ? 1.0 : 0;
-
-    qreal x = rect.left();
-    qreal y = isVerticalMeter ? (rect.height() - SEGMENTS_SIZE) : rect.top();
-    const qreal w = isVerticalMeter ? rect.width() - pad : SEGMENTS_SIZE - pad;
-    const qreal h = isVerticalMeter ? (SEGMENTS_SIZE - pad) : rect.height() - pad;
-
-    for (quint32 i = 0; i < segmentsToPaint; ++i) {
-        auto color = (i < segmentsColors.size()) ? segmentsColors[i] : segmentsColors.back(); // always use the last color (red) when painting big peak values
-        painter.fillRect(x, y, w, h, color);
-        if (isVerticalMeter)
-            y -= SEGMENTS_SIZE;
-        else
-            x += SEGMENTS_SIZE;
-    }
+    strip.paint(painter, rect, peakPosition, segmentsColors, orientation(), drawSegments, SEGMENTS_SIZE); // the lit segments are blitted in one step
 }
 
 void AudioSlider::resizeEvent(QResizeEvent *event)
@@ -4,6 +4,7 @@
 #include <QSlider>
 
 #include "Utils.h"
+#include "MeterStrip.h"
 
 class AudioSlider : public QSlider
 {
@@ -73,7 +74,7 @@ private:
     void recreateInterpolatedColors();
     QColor interpolateColor(const QColor &start, const QColor &end, float ratio);
 
-    void paintSegments(QPainter &painter, const QRectF &rect, float rawPeakValue, const std::vector<QColor> &segmentsColors, bool drawSegments = true);
+    void paintSegments(QPainter &painter, MeterStrip &strip, const QRectF &rect, float peakPosition, const std::vector<QColor> &segmentsColors, bool drawSegments = true);
 
     bool isVertical() const;
 
@@ -85,9 +86,23 @@ private:
 
     void updateInternalValues();
 
+    // what is visible in the meters, in pixels. Repaints are skipped when the new peak values are not changing any pixel.
+    struct MeterPixels
+    {
+        quint32 peakSegments[2];
+        quint32 rmsSegments[2];
+        qint32 maxPeakPosition[2];
+
+        bool operator==(const MeterPixels &other) const;
+        bool operator!=(const MeterPixels &other) const { return !(*this == other); }
+    };
+
+    MeterPixels computeMeterPixels() const;
+    void updateMeters(); // repaint only when some meter pixel changed
+
     uint getParallelSegments() const;
 
-    qreal getPeakPosition(qreal linearPeak, qreal rectSize);
+    qreal getPeakPosition(qreal linearPeak, qreal rectSize) const;
 
     void paintMaxPeakMarker(QPainter &painter, qreal maxPeakPosition, const QRectF &rect);
 
@@ -112,6 +127,9 @@ private:
     std::vector<QColor> peakColors;
     std::vector<QColor> rmsColors;
 
+    MeterStrip peakStrip; // pre-rendered segments
+    MeterStrip rmsStrip;
+
     // static painting flags. Turning on/off will affect all audio meters.
     static bool paintingMaxPeakMarker;
     static bool paintingPeaks;
@@ -123,6 +141,8 @@ private:
 
     qint64 lastMaxPeakTime[2];
 
+    MeterPixels paintedPixels; // the meters state in the last paint
+
     bool stereo; // draw 2 meters?
 
     QPixmap dbMarkersPixmap;
@@ -149,7 +169,7 @@ private:
     static const int MIN_SIZE;
 };
 
-inline qreal AudioSlider::getPeakPosition(qreal linearPeak, qreal rectSize)
+inline qreal AudioSlider::getPeakPosition(qreal linearPeak, qreal rectSize) const
 {
     qreal db = Utils::linearToDb(linearPeak) - getMaxDbValue();
     return Utils::poweredGainToLinear(Utils::dbToLinear(db)) * rectSize;
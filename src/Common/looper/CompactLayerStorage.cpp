@@ -0,0 +1,94 @@
+#include "CompactLayerStorage.h"
+
+#include <algorithm>
+#include <cmath>
+
+using audio::CompactLayerStorage;
+
+const uint CompactLayerStorage::BLOCK_SIZE;
+const float CompactLayerStorage::SILENCE_THRESHOLD = 0.00001f; // -100 dB
+
+CompactLayerStorage::CompactLayerStorage() :
+    frames(0)
+{
+
+}
+
+void CompactLayerStorage::compress(const float *left, const float *right, uint frames)
+{
+    this->frames = frames;
+
+    const uint totalBlocks = (frames + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    blocks.clear();
+    blocks.reserve(totalBlocks);
+
+    samples.clear();
+
+    std::vector<qint16> blockSamples;
+    for (uint b = 0; b < totalBlocks; ++b) {
+        const uint start = b * BLOCK_SIZE;
+        const uint count = std::min(BLOCK_SIZE, frames - start);
+
+        float peak = 0.0f;
+        for (uint s = start; s < start + count; ++s)
+            peak = std::max(peak, std::max(std::fabs(left[s]), std::fabs(right[s])));
+
+        Block block;
+        block.offset = static_cast<uint>(samples.size());
+        block.scale = 0.0f;
+
+        if (peak >= SILENCE_THRESHOLD) {
+            block.scale = peak / 32767.0f;
+            const float toInt = 1.0f / block.scale;
+            samples.resize(samples.size() + count * 2);
+            qint16 *out = &(samples[block.offset]);
+            for (uint s = 0; s < count; ++s) {
+                *out++ = static_cast<qint16>(std::lround(left[start + s] * toInt));
+                *out++ = static_cast<qint16>(std::lround(right[start + s] * toInt));
+            }
+        }
+
+        blocks.push_back(block);
+    }
+
+    samples.shrink_to_fit(); // release the memory reserved when growing
+}
+
+void CompactLayerStorage::decode(uint from, uint frames, float *left, float *right) const
+{
+    if (!this->frames) {
+        std::fill(left, left + frames, 0.0f);
+        std::fill(right, right + frames, 0.0f);
+        return;
+    }
+
+    uint decoded = 0;
+    while (decoded < frames) {
+        const uint position = (from + decoded) % this->frames; // wrapping, a layer resized to a longer cycle repeats the stored samples
+        const uint offsetInBlock = position % BLOCK_SIZE;
+        const uint blockStart = position - offsetInBlock;
+        const uint blockFrames = std::min(BLOCK_SIZE, this->frames - blockStart);
+        const uint count = std::min(frames - decoded, blockFrames - offsetInBlock);
+
+        const Block &block = blocks[position / BLOCK_SIZE];
+        if (block.scale == 0.0f) { // silence
+            std::fill(left + decoded, left + decoded + count, 0.0f);
+            std::fill(right + decoded, right + decoded + count, 0.0f);
+        }
+        else {
+            const qint16 *in = &(samples[block.offset + offsetInBlock * 2]);
+            const float scale = block.scale;
+            for (uint s = 0; s < count; ++s) {
+                left[decoded + s] = in[s * 2] * scale;
+                right[decoded + s] = in[s * 2 + 1] * scale;
+            }
+        }
+
+        decoded += count;
+    }
+}
+
+size_t CompactLayerStorage::getMemoryUsage() const
+{
+    return blocks.capacity() * sizeof(Block) + samples.capacity() * sizeof(qint16);
+}
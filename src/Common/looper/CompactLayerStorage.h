@@ -0,0 +1,46 @@
+#ifndef _COMPACT_LAYER_STORAGE_H_
+#define _COMPACT_LAYER_STORAGE_H_
+
+#include <vector>
+#include <QtGlobal>
+
+namespace audio {
+
+/**
+    Compact (lossy) storage used by locked looper layers. The samples are stored in blocks of BLOCK_SIZE
+    stereo frames as 16 bits integers scaled by the block peak (block floating point), so quiet passages keep
+    more precision than plain 16 bits PCM. Silent blocks are not stored at all.
+    The memory used is ~1/2 of float samples, or much less in layers with silence.
+ */
+
+class CompactLayerStorage
+{
+public:
+    CompactLayerStorage();
+
+    void compress(const float *left, const float *right, uint frames);
+
+    // decode 'frames' starting in 'from', the reading position wraps to the beginning after the last stored frame
+    void decode(uint from, uint frames, float *left, float *right) const;
+
+    inline uint getFrames() const { return frames; }
+    size_t getMemoryUsage() const; // in bytes
+
+    static const uint BLOCK_SIZE = 1024; // frames in each block
+    static const float SILENCE_THRESHOLD; // blocks with peaks lower than this are stored as silence
+
+private:
+    struct Block
+    {
+        float scale; // zero in silent blocks
+        uint offset; // first (interleaved) sample in 'samples'
+    };
+
+    std::vector<Block> blocks;
+    std::vector<qint16> samples; // interleaved stereo
+    uint frames;
+};
+
+} // namespace
+
+#endif
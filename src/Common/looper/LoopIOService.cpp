@@ -0,0 +1,144 @@
+#include "LoopIOService.h"
+#include "Looper.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+
+using audio::LoopIOService;
+using audio::LoopSaver;
+using audio::LoopLoader;
+using audio::SamplesBuffer;
+
+LoopIOService::SaveSettings::SaveSettings() :
+    bpm(0),
+    bpi(0),
+    encodeInOggVorbis(true),
+    vorbisQuality(0),
+    sampleRate(44100),
+    bitDepth(16)
+{
+
+}
+
+LoopIOService::LoopIOService(QObject *parent) :
+    QObject(parent),
+    canceled(0),
+    processedLayers(0),
+    currentJob(LoadJob)
+{
+    connect(&watcher, &QFutureWatcher<bool>::finished, this, &LoopIOService::handleJobFinished);
+}
+
+LoopIOService::~LoopIOService()
+{
+    cancel();
+    watcher.waitForFinished();
+}
+
+bool LoopIOService::isBusy() const
+{
+    return watcher.isRunning();
+}
+
+void LoopIOService::cancel()
+{
+    canceled.store(1);
+}
+
+void LoopIOService::waitCurrentJob()
+{
+    if (isBusy()) {
+        cancel();
+        watcher.waitForFinished(); // the workers check the cancel flag before each layer
+    }
+
+    canceled.store(0);
+    processedLayers.store(0);
+}
+
+void LoopIOService::reportLayerFinished(int totalLayers)
+{
+    emit progressChanged(processedLayers.fetchAndAddOrdered(1) + 1, totalLayers); // queued to the main thread
+}
+
+void LoopIOService::save(Looper *looper, const QString &loopFileName, const SaveSettings &settings)
+{
+    waitCurrentJob();
+
+    currentJob = SaveJob;
+    this->looper = looper;
+    loopInfo = LoopSaver::createLoopInfo(looper, loopFileName, settings.bpm, settings.bpi, settings.encodeInOggVorbis);
+
+    // copying the layers in the main thread, the audio thread is still using the looper
+    const QList<SamplesBuffer> layersSamples = looper->getLayersSamples();
+    const uint loopLenght = looper->getIntervalLenght();
+    const LoopInfo info = loopInfo;
+
+    watcher.setFuture(QtConcurrent::run([=]() -> bool {
+        if (!LoopSaver::createLoopDir(settings.savePath, loopFileName))
+            return false;
+
+        QList<quint8> layers;
+        for (int layer = 0; layer < layersSamples.size(); ++layer)
+            layers << layer;
+
+        QtConcurrent::blockingMap(layers, [&](quint8 layer) {
+            if (canceled.load())
+                return;
+
+            LoopSaver::saveSamplesToDisk(settings.savePath, loopFileName, layersSamples.at(layer), layer,
+                                         settings.encodeInOggVorbis, settings.vorbisQuality, settings.sampleRate, settings.bitDepth);
+
+            reportLayerFinished(layers.size());
+        });
+
+        if (canceled.load()) {
+            qDebug() << "Saving loop canceled, the json file is not written for" << loopFileName;
+            return false;
+        }
+
+        return info.saveToJsonFile(settings.savePath, loopLenght); // the json is written only when all layers are saved
+    }));
+}
+
+void LoopIOService::load(Looper *looper, const QString &loadPath, const LoopInfo &loopInfo, uint currentSampleRate, quint32 samplesPerInterval)
+{
+    waitCurrentJob();
+
+    currentJob = LoadJob;
+    this->looper = looper;
+    this->loopInfo = loopInfo;
+    loadedLayers.clear();
+
+    const int totalLayers = loopInfo.getLayersCount();
+
+    watcher.setFuture(QtConcurrent::run([=]() -> bool {
+        auto isCanceled = [this]() { return canceled.load() != 0; };
+        auto layerFinished = [this, totalLayers]() { reportLayerFinished(totalLayers); };
+
+        loadedLayers = LoopLoader::loadLayers(loadPath, loopInfo, currentSampleRate, samplesPerInterval, isCanceled, layerFinished);
+
+        return !canceled.load();
+    }));
+}
+
+void LoopIOService::handleJobFinished()
+{
+    const bool success = watcher.result();
+    const QString loopName = loopInfo.getName();
+
+    if (currentJob == SaveJob) {
+        if (success && looper) {
+            looper->setChanged(false);
+            looper->setLoopName(loopName);
+        }
+        emit saveFinished(loopName, success);
+    }
+    else {
+        if (success && looper)
+            LoopLoader::setLooperLayers(loopInfo, loadedLayers, looper); // main thread
+
+        loadedLayers.clear(); // release the decoded samples
+        emit loadFinished(loopName, success && looper);
+    }
+}
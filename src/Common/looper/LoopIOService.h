@@ -0,0 +1,88 @@
+#ifndef _LOOP_IO_SERVICE_H_
+#define _LOOP_IO_SERVICE_H_
+
+#include "LooperPersistence.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+
+namespace audio {
+
+class Looper;
+
+/**
+    Save and load loops in a background thread. The layers are encoded/decoded in parallel and the looper is
+    touched only in the main thread: the layers are copied before saving and the decoded layers are set in the
+    looper when the loading is finished. Only one job runs at time, starting a new job cancels the current one.
+ */
+
+class LoopIOService : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    struct SaveSettings
+    {
+        SaveSettings();
+
+        QString savePath;
+        uint bpm;
+        uint bpi;
+        bool encodeInOggVorbis;
+        float vorbisQuality;
+        uint sampleRate;
+        quint8 bitDepth;
+    };
+
+    explicit LoopIOService(QObject *parent = nullptr);
+    ~LoopIOService();
+
+    void save(Looper *looper, const QString &loopFileName, const SaveSettings &settings);
+    void load(Looper *looper, const QString &loadPath, const LoopInfo &loopInfo, uint currentSampleRate, quint32 samplesPerInterval);
+
+    bool isBusy() const;
+    bool isCanceled() const; // the last job was canceled by the user
+
+public slots:
+    void cancel();
+
+signals:
+    void progressChanged(int processedLayers, int totalLayers);
+    void saveFinished(const QString &loopName, bool success);
+    void loadFinished(const QString &loopName, bool success);
+
+private slots:
+    void handleJobFinished();
+
+private:
+
+    enum JobType
+    {
+        SaveJob,
+        LoadJob
+    };
+
+    QFutureWatcher<bool> watcher;
+    QAtomicInt canceled;
+    QAtomicInt processedLayers;
+
+    JobType currentJob;
+    QPointer<Looper> looper;
+    LoopInfo loopInfo;
+    QList<LoopLoader::LoadedLayer> loadedLayers; // written by the worker thread, read when the job is finished
+
+    void waitCurrentJob();
+    void reportLayerFinished(int totalLayers);
+};
+
+inline bool LoopIOService::isCanceled() const
+{
+    return canceled.load() != 0;
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,132 @@
+#include "LoopInfo.h"
+
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+using audio::LoopInfo;
+using audio::LoopLayerInfo;
+
+LoopInfo::LoopInfo(quint32 bpm, quint16 bpi, const QString &name, bool audioIsEncoded, quint8 mode) :
+    bpm(bpm),
+    bpi(bpi),
+    name(name),
+    usingEncodedAudio(audioIsEncoded),
+    looperMode(mode)
+{
+    //
+}
+
+LoopInfo::LoopInfo()
+    : LoopInfo(0, 0, QString(), false, 0) // calling overloaded constructor
+{
+    //
+}
+
+bool LoopInfo::isValid() const
+{
+    return !name.isEmpty() && bpm > 0 && bpi > 0 && layers.size() > 0;
+}
+
+QString LoopInfo::toString(bool showBpm) const
+{
+    QString text = name;
+    text += " (";
+
+    if (showBpm)
+        text += QString::number(bpm) + " BPM, ";
+
+    text += QString::number(bpi) + " BPI, ";
+    text += QString::number(layers.size()) + " layers";
+
+    text += ")";
+
+    return text;
+}
+
+void LoopInfo::addLayer(bool isLocked, float gain, float pan)
+{
+    LoopLayerInfo layerInfo;
+    layerInfo.locked = isLocked;
+    layerInfo.gain = gain;
+    layerInfo.pan = pan;
+    layers.append(layerInfo);
+}
+
+LoopInfo LoopInfo::loadFromJsonFile(const QString &jsonFilePath)
+{
+    QFile file(jsonFilePath);
+    if (!file.open(QFile::ReadOnly)) {
+        qCritical() << "Error loading loop metada:" << file.errorString();
+        return LoopInfo();
+    }
+
+    if (QFileInfo(file).suffix() != "json") {
+        qCritical() << "Error loading loop metada, not a json file" << jsonFilePath;
+        return LoopInfo();
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QJsonObject root = doc.object();
+
+    quint32 bpm = (root.contains("bpm") ? (root["bpm"].toInt()) : 0);
+    quint16 bpi = (root.contains("bpi") ? (root["bpi"].toInt()) : 0);
+    bool audioIsEncoded = root.contains("audioFormat") && root["audioFormat"].toString() == "ogg";
+    QString loopName = QFileInfo(file).baseName();
+    quint8 looperMode = root.contains("looperMode") ? root["looperMode"].toInt() : 0;
+
+    LoopInfo loopInfo(bpm, bpi, loopName, audioIsEncoded, looperMode);
+
+    if (root.contains("layers")) {
+        if (root["layers"].isArray()) { // new loop file format
+            QJsonArray layers = root["layers"].toArray();
+            for (int i = 0; i < layers.size(); ++i) {
+                QJsonObject layer = layers.at(i).toObject();
+                bool isLocked = layer.contains("locked") ? layer["locked"].toBool() : false;
+                float gain = layer.contains("gain") ? layer["gain"].toDouble() : 1.0;
+                float pan = layer.contains("pan") ? layer["pan"].toDouble() : 0.0;
+                loopInfo.addLayer(isLocked, gain, pan);
+            }
+        }
+        else { // using old loop file format
+            int layers = root["layers"].toInt(0);
+            for (int l = 0; l < layers; ++l) {
+                loopInfo.addLayer(false, 1.0, 0.0);
+            }
+        }
+    }
+
+    return loopInfo;
+}
+
+bool LoopInfo::saveToJsonFile(const QString &savePath, uint loopLenght) const
+{
+    QFile jsonFile(QDir(savePath).absoluteFilePath(name) + ".json");
+    if (!jsonFile.open(QIODevice::WriteOnly)) {
+        qCritical() << jsonFile.errorString();
+        return false;
+    }
+
+    QJsonObject root;
+    root["bpm"] = static_cast<int>(bpm);
+    root["bpi"] = static_cast<int>(bpi);
+    root["loopLenght"] = static_cast<int>(loopLenght);
+    root["audioFormat"] = usingEncodedAudio ? "ogg" : "wave";
+    root["looperMode"] = static_cast<int>(looperMode);
+
+    QJsonArray jsonLayers;
+    for (const LoopLayerInfo &layerInfo : layers) {
+        QJsonObject layer;
+        layer["locked"] = layerInfo.locked;
+        layer["gain"] = layerInfo.gain;
+        layer["pan"] = layerInfo.pan;
+        jsonLayers.append(layer);
+    }
+    root["layers"] = jsonLayers;
+
+    QJsonDocument doc(root);
+    return jsonFile.write(doc.toJson()) > 0;
+}
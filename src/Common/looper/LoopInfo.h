@@ -0,0 +1,101 @@
+#ifndef _LOOP_INFO_H_
+#define _LOOP_INFO_H_
+
+#include <QString>
+#include <QList>
+
+namespace audio {
+
+struct LoopLayerInfo
+{
+    float pan;
+    float gain;
+    bool locked;
+};
+
+/**
+    Loop metadata, saved in a json file beside the loop folder containing the layers audio files.
+ */
+
+class LoopInfo
+{
+public:
+    LoopInfo(quint32 bpm, quint16 bpi, const QString &name, bool usingEncodedAudio, quint8 mode);
+    LoopInfo();
+
+    static LoopInfo loadFromJsonFile(const QString &jsonFilePath);
+    bool saveToJsonFile(const QString &savePath, uint loopLenght) const;
+
+    void addLayer(bool isLocked, float gain, float pan);
+
+    bool isValid() const;
+
+    QString toString(bool showBpm = false) const;
+
+    quint8 getLayersCount() const;
+
+    bool audioIsEncoded() const;
+
+    QString getName() const;
+
+    QList<LoopLayerInfo> getLayersInfo() const;
+
+    quint8 getLooperMode() const;
+
+    quint16 getBpi() const;
+    quint32 getBpm() const;
+
+    void setName(const QString &name);
+
+private:
+    quint32 bpm;
+    quint16 bpi;
+    QString name;
+    bool usingEncodedAudio;
+    QList<LoopLayerInfo> layers;
+    quint8 looperMode;
+};
+
+inline quint16 LoopInfo::getBpi() const
+{
+    return bpi;
+}
+
+inline quint32 LoopInfo::getBpm() const
+{
+    return bpm;
+}
+
+inline void LoopInfo::setName(const QString &name)
+{
+    this->name = name;
+}
+
+inline quint8 LoopInfo::getLooperMode() const
+{
+    return looperMode;
+}
+
+inline quint8 LoopInfo::getLayersCount() const
+{
+    return layers.size();
+}
+
+inline bool LoopInfo::audioIsEncoded() const
+{
+    return usingEncodedAudio;
+}
+
+inline QString LoopInfo::getName() const
+{
+    return name;
+}
+
+inline QList<LoopLayerInfo> LoopInfo::getLayersInfo() const
+{
+    return layers;
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,138 @@
+#include "LoopInfoIndex.h"
+
+#include <QFileInfo>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDebug>
+
+using audio::LoopInfo;
+using audio::LoopLayerInfo;
+using audio::LoopInfoIndex;
+
+const QString LoopInfoIndex::INDEX_FILE_NAME("loops.index");
+const quint32 LoopInfoIndex::INDEX_VERSION;
+
+QHash<QString, LoopInfoIndex::Entries> LoopInfoIndex::cachedFolders;
+QMutex LoopInfoIndex::mutex;
+
+QList<LoopInfo> LoopInfoIndex::getLoopsInfo(const QString &loadPath)
+{
+    QMutexLocker locker(&mutex);
+
+    QDir loadDir(loadPath);
+    const QString folderKey = loadDir.absolutePath();
+    const QString indexFilePath = loadDir.absoluteFilePath(INDEX_FILE_NAME);
+
+    if (!cachedFolders.contains(folderKey))
+        cachedFolders.insert(folderKey, readIndexFile(indexFilePath));
+
+    const Entries &cachedEntries = cachedFolders[folderKey];
+    Entries entries;
+    QList<LoopInfo> infos;
+    bool indexChanged = false;
+
+    QDir::Filters filters = QDir::NoDotAndDotDot | QDir::Files;
+    QFileInfoList fileInfoList = loadDir.entryInfoList(QStringList("*.json"), filters);
+    for (const QFileInfo &fileInfo : fileInfoList) {
+        const QString fileName = fileInfo.fileName();
+        const qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+        const qint64 fileSize = fileInfo.size();
+
+        auto cachedEntry = cachedEntries.constFind(fileName);
+        bool isUpdated = cachedEntry != cachedEntries.constEnd()
+                && cachedEntry->lastModified == lastModified
+                && cachedEntry->fileSize == fileSize;
+
+        Entry entry;
+        if (isUpdated) {
+            entry = cachedEntry.value();
+        }
+        else { // new or modified loop file
+            entry.lastModified = lastModified;
+            entry.fileSize = fileSize;
+            entry.loopInfo = LoopInfo::loadFromJsonFile(fileInfo.absoluteFilePath());
+            indexChanged = true;
+        }
+
+        entries.insert(fileName, entry);
+        infos.append(entry.loopInfo);
+    }
+
+    if (entries.size() != cachedEntries.size()) // some loops were deleted
+        indexChanged = true;
+
+    if (indexChanged) {
+        writeIndexFile(indexFilePath, entries);
+        cachedFolders.insert(folderKey, entries);
+    }
+
+    return infos;
+}
+
+LoopInfoIndex::Entries LoopInfoIndex::readIndexFile(const QString &indexFilePath)
+{
+    Entries entries;
+
+    QFile indexFile(indexFilePath);
+    if (!indexFile.open(QFile::ReadOnly))
+        return entries; // no index yet, all json files will be parsed
+
+    QDataStream stream(&indexFile);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision); // same precision used in writeIndexFile
+    quint32 version = 0;
+    quint32 entriesCount = 0;
+    stream >> version >> entriesCount;
+    if (version != INDEX_VERSION)
+        return entries;
+
+    for (quint32 i = 0; i < entriesCount && stream.status() == QDataStream::Ok; ++i) {
+        QString fileName;
+        QString loopName;
+        Entry entry;
+        quint32 bpm;
+        quint16 bpi;
+        bool encoded;
+        quint8 mode;
+        quint8 layers;
+        stream >> fileName >> entry.lastModified >> entry.fileSize >> loopName >> bpm >> bpi >> encoded >> mode >> layers;
+
+        entry.loopInfo = LoopInfo(bpm, bpi, loopName, encoded, mode);
+        for (quint8 l = 0; l < layers; ++l) {
+            bool locked;
+            float gain;
+            float pan;
+            stream >> locked >> gain >> pan;
+            entry.loopInfo.addLayer(locked, gain, pan);
+        }
+
+        entries.insert(fileName, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "Corrupted loops index file, ignoring" << indexFilePath;
+        entries.clear();
+    }
+
+    return entries;
+}
+
+void LoopInfoIndex::writeIndexFile(const QString &indexFilePath, const Entries &entries)
+{
+    QFile indexFile(indexFilePath);
+    if (!indexFile.open(QFile::WriteOnly)) {
+        qCritical() << "Can't write the loops index file" << indexFile.errorString();
+        return;
+    }
+
+    QDataStream stream(&indexFile);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << INDEX_VERSION << static_cast<quint32>(entries.size());
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        const LoopInfo &info = it->loopInfo;
+        stream << it.key() << it->lastModified << it->fileSize << info.getName() << info.getBpm() << info.getBpi();
+        stream << info.audioIsEncoded() << info.getLooperMode() << info.getLayersCount();
+        for (const LoopLayerInfo &layer : info.getLayersInfo())
+            stream << layer.locked << layer.gain << layer.pan;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef _LOOP_INFO_INDEX_H_
+#define _LOOP_INFO_INDEX_H_
+
+#include "LoopInfo.h"
+
+#include <QHash>
+#include <QMutex>
+
+class TestLoopInfoIndex;
+
+namespace audio {
+
+/**
+    Metadata of all loops saved in a folder. The index is stored in the loops folder and kept in memory,
+    only the json files modified after the last indexing (or new files) are parsed again.
+ */
+
+class LoopInfoIndex
+{
+    friend class ::TestLoopInfoIndex;
+
+public:
+    static QList<LoopInfo> getLoopsInfo(const QString &loadPath);
+
+    static const QString INDEX_FILE_NAME;
+
+private:
+    static const quint32 INDEX_VERSION = 1;
+
+    struct Entry
+    {
+        qint64 lastModified; // msecs since epoch
+        qint64 fileSize;
+        LoopInfo loopInfo;
+    };
+
+    typedef QHash<QString, Entry> Entries; // json file name is the key
+
+    static QHash<QString, Entries> cachedFolders; // loops folder path is the key
+    static QMutex mutex;
+
+    static Entries readIndexFile(const QString &indexFilePath);
+    static void writeIndexFile(const QString &indexFilePath, const Entries &entries);
+};
+
+} // namespace
+
+#endif
@@ -4,6 +4,7 @@
 #include "Utils.h"
 
 #include <QDebug>
+#include <QtConcurrent/QtConcurrent>
 
 #include <cstring>
 #include <vector>
@@ -27,6 +28,7 @@ Looper::Looper(Looper::Mode initialMode, quint8 maxLayers) :
     loading(false),
     waitingToStop(false),
     activated(true),
+    compactLockedLayers(false),
     currentLayerIndex(0),
     focusedLayerIndex(0),
     maxLayers(maxLayers),
@@ -106,7 +108,7 @@ float Looper::getLayerPan(quint8 layer) const
 
 AudioPeak Looper::getLastPeak() const
 {
-    return lastPeak;
+    return meter.getLastPeak();
 }
 
 bool Looper::isFull() const
@@ -136,14 +138,19 @@ int Looper::getLastValidLayer() const
 
 void Looper::resetLayersContent()
 {
+    for (uint l = 0; l < MAX_LOOP_LAYERS; ++l)
+        layers[l]->prepareExpandedStorage(false); // compacted layers are erased in the audio thread without allocations
+
     resetRequested = true;
     setChanged(false);
 
-    lastPeak.zero();
+    meter.reset();
 }
 
 Looper::~Looper()
 {
+    waitForCompaction(); // the workers are using the layers
+
     for (int l = 0; l < MAX_LOOP_LAYERS; ++l) {
         if (layers[l])
             delete layers[l];
@@ -256,6 +263,13 @@ void Looper::setLayerLockedState(quint8 layerIndex, bool locked)
     if (canLockLayer(layerIndex)) {
         layers[layerIndex]->setLocked(locked);
 
+        if (compactLockedLayers) {
+            if (locked)
+                compactLayer(layerIndex); // compressed in a worker and swapped in the audio thread
+            else
+                layers[layerIndex]->prepareExpandedStorage();
+        }
+
         if (locked && focusedLayerIndex == layerIndex)
             focusedLayerIndex = -1; // clear focused layer when locking
 
@@ -502,13 +516,19 @@ void Looper::mixToBuffer(SamplesBuffer &samples)
 
     processChangeRequests();
 
-    lastPeak = peakAfterMix - peakBeforeMix; // minus operator is overloaded in AudioPeak class
+    meter.publish(peakAfterMix - peakBeforeMix); // minus operator is overloaded in AudioPeak class
 }
 
 void Looper::processChangeRequests()
 {
-    // reset requested in last process cycle?
-    if (resetRequested && !isRecording()) {
+    bool storagePending = false;
+    for (uint l = 0; l < MAX_LOOP_LAYERS; ++l) {
+        if (!layers[l]->commitPendingStorage()) // compacted or expanded layers prepared in the main thread
+            storagePending = true;
+    }
+
+    // reset requested in last process cycle? Waiting the expanded storages before erasing the layers
+    if (resetRequested && !isRecording() && !storagePending) {
         for (uint l = 0; l < maxLayers; ++l) {
             layers[l]->reset();
         }
@@ -586,14 +606,65 @@ bool Looper::canRecord() const
     return !layers[currentLayerIndex]->isLocked(); // in SELECTED_LAYER_ONLY mode we can't allow recording in selected layer if this layer is locked
 }
 
-const std::vector<float> Looper::getLayerPeaks(quint8 layerIndex, uint samplesPerPeak) const
+void Looper::getLayerPeaks(quint8 layerIndex, uint samplesPerPeak, std::vector<float> &peaks) const
 {
-    if (layerIndex < maxLayers) {
-        LooperLayer *layer = layers[layerIndex];
-        return layer->getSamplesPeaks(samplesPerPeak);
+    if (layerIndex < maxLayers)
+        layers[layerIndex]->getSamplesPeaks(samplesPerPeak, peaks);
+    else
+        peaks.clear();
+}
+
+void Looper::setCompactLockedLayers(bool compact)
+{
+    if (compact == compactLockedLayers)
+        return;
+
+    compactLockedLayers = compact;
+
+    for (uint l = 0; l < MAX_LOOP_LAYERS; ++l) {
+        if (compact && layers[l]->isLocked())
+            compactLayer(l);
+        else if (!compact)
+            layers[l]->prepareExpandedStorage();
+    }
+}
+
+void Looper::compactLayer(quint8 layerIndex)
+{
+    for (int i = compactionJobs.size() - 1; i >= 0; --i) {
+        if (compactionJobs.at(i).isFinished())
+            compactionJobs.removeAt(i);
+    }
+
+    LooperLayer *layer = layers[layerIndex];
+    compactionJobs.append(QtConcurrent::run([layer]() {
+        layer->prepareCompactStorage();
+    }));
+}
+
+void Looper::waitForCompaction()
+{
+    for (QFuture<void> &job : compactionJobs)
+        job.waitForFinished();
+
+    compactionJobs.clear();
+}
+
+void Looper::updateLayersStorage()
+{
+    for (uint l = 0; l < MAX_LOOP_LAYERS; ++l) {
+        layers[l]->releaseRetiredStorage();
+        layers[l]->refreshPeaks();
     }
+}
+
+size_t Looper::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (uint l = 0; l < MAX_LOOP_LAYERS; ++l)
+        bytes += layers[l]->getMemoryUsage();
 
-    return std::vector<float>(); // empty vector
+    return bytes;
 }
 
 void Looper::setMode(Mode mode)
@@ -614,28 +685,52 @@ void Looper::mixLayer(quint8 layerIndex, SamplesBuffer &samples, uint samplesToM
     if (layerIndex >= maxLayers)
         return;
 
-    LooperLayer *loopLayer = layers[layerIndex];
-    samplesToMix = qMin(samplesToMix, loopLayer->getAvailableSamples());
-    if (samplesToMix) {
-        loopLayer->mixTo(samples, samplesToMix, intervalPosition, mainGain); // mix buffered samples
+    samplesToMix = qMin(samplesToMix, samples.getFrameLenght());
+    for (uint offset = 0; offset < samplesToMix; offset += LooperLayer::MAX_MIX_FRAMES) {
+        const uint frames = qMin(samplesToMix - offset, LooperLayer::MAX_MIX_FRAMES);
+        LooperLayer::MixSource source;
+        if (layers[layerIndex]->getMixSource(intervalPosition + offset, frames, mainGain, source))
+            mixSources(&source, 1, samples, offset, frames);
     }
 }
 
 void Looper::mixAllLayers(SamplesBuffer &samples, uint samplesToMix)
 {
-    for (uint layer = 0; layer < maxLayers; ++layer)
-        mixLayer(layer, samples, samplesToMix);
+    mixLayers(samples, samplesToMix, false);
 }
 
 void Looper::mixLockedLayers(SamplesBuffer &samples, uint samplesToMix)
 {
-    for (uint layer = 0; layer < maxLayers; ++layer) {
-        if (layerIsLocked(layer)) {
-            mixLayer(layer, samples, samplesToMix);
+    mixLayers(samples, samplesToMix, true);
+}
+
+void Looper::mixLayers(SamplesBuffer &samples, uint samplesToMix, bool lockedLayersOnly)
+{
+    // big blocks are mixed in chunks, the compacted layers are decoded in preallocated buffers
+    samplesToMix = qMin(samplesToMix, samples.getFrameLenght());
+    for (uint offset = 0; offset < samplesToMix; offset += LooperLayer::MAX_MIX_FRAMES) {
+        const uint frames = qMin(samplesToMix - offset, LooperLayer::MAX_MIX_FRAMES);
+
+        LooperLayer::MixSource sources[MAX_LOOP_LAYERS];
+        uint sourcesCount = 0;
+        for (quint8 layer = 0; layer < maxLayers; ++layer) {
+            if (lockedLayersOnly && !layers[layer]->isLocked())
+                continue;
+
+            if (layers[layer]->getMixSource(intervalPosition + offset, frames, mainGain, sources[sourcesCount]))
+                sourcesCount++;
         }
+
+        mixSources(sources, sourcesCount, samples, offset, frames);
     }
 }
 
+void Looper::mixSources(const LooperLayer::MixSource *sources, uint sourcesCount, SamplesBuffer &samples, uint offset, uint samplesToMix)
+{
+    float *right = samples.isMono() ? nullptr : samples.getSamplesArray(1) + offset;
+    LooperLayer::mixLayers(sources, sourcesCount, samples.getSamplesArray(0) + offset, right, samplesToMix); // all layers in one pass
+}
+
 void Looper::processBufferUsingCurrentLayerSettings(SamplesBuffer &buffer)
 {
     float layerGain = layers[currentLayerIndex]->getGain();
@@ -2,6 +2,7 @@
 #define _AUDIO_LOOPER_
 
 #include "audio/core/SamplesBuffer.h"
+#include "audio/core/MeteringSlot.h"
 #include "LooperLayer.h"
 #include "LooperPersistence.h"
 
@@ -11,6 +12,8 @@
 #include <QSharedPointer>
 #include <QMap>
 #include <QMutex>
+#include <QFuture>
+#include <QList>
 
 #define MAX_LOOP_LAYERS 8
 
@@ -89,7 +92,7 @@ public:
     void setMode(Mode mode);
     Mode getMode() const;
 
-    const std::vector<float> getLayerPeaks(quint8 layerIndex, uint samplesPerPeak) const;
+    void getLayerPeaks(quint8 layerIndex, uint samplesPerPeak, std::vector<float> &peaks) const;
 
     quint8 getCurrentLayerIndex() const;
     quint8 getFocusedLayerIndex() const;
@@ -149,6 +152,16 @@ public:
 
     void setActivated(bool activated);
 
+    void setCompactLockedLayers(bool compact); // store locked layers using less memory
+    bool isCompactingLockedLayers() const;
+    void waitForCompaction(); // block until the locked layers compression is finished
+
+    size_t getMemoryUsage() const; // samples memory used by all layers, in bytes
+
+    // called periodically in the main thread: release the layers storage replaced in the audio thread and
+    // rebuild the peaks of the compacted layers resized in the audio thread
+    void updateLayersStorage();
+
 public slots:
     void resetLayersContent(); // clear all
 
@@ -172,6 +185,11 @@ private:
 
     bool activated;
 
+    bool compactLockedLayers;
+    QList<QFuture<void>> compactionJobs; // locked layers are compressed in worker threads
+
+    void compactLayer(quint8 layerIndex);
+
     LooperLayer *layers[MAX_LOOP_LAYERS];
     quint8 currentLayerIndex; // current played layer
     int focusedLayerIndex; // layer clicked by user, used to choose recording layer. Sometimes focused layer will be equal to currentLayerIndex.
@@ -185,7 +203,7 @@ private:
 
     void setCurrentLayer(quint8 newLayer);
 
-    AudioPeak lastPeak;
+    audio::MeteringSlot meter; // peaks published in the audio thread and read in the GUI thread
 
     QSharedPointer<LooperState> state;
 
@@ -204,6 +222,8 @@ private:
     void mixLayer(quint8 layerIndex, SamplesBuffer &samples, uint samplesToMix);
     void mixAllLayers(SamplesBuffer &samples, uint samplesToMix);
     void mixLockedLayers(SamplesBuffer &samples, uint samplesToMix);
+    void mixLayers(SamplesBuffer &samples, uint samplesToMix, bool lockedLayersOnly);
+    void mixSources(const LooperLayer::MixSource *sources, uint sourcesCount, SamplesBuffer &samples, uint offset, uint samplesToMix);
 
     void setState(LooperState *state);
 
@@ -236,6 +256,11 @@ inline float Looper::getMainGain() const
     return mainGain;
 }
 
+inline bool Looper::isCompactingLockedLayers() const
+{
+    return compactLockedLayers;
+}
+
 inline QString Looper::getLoopName() const
 {
     return loopName;
@@ -5,22 +5,26 @@
 #include <cmath>
 #include <QDebug>
 
-#include <QDebug>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define LOOPER_LAYER_USE_SSE
+    #include <xmmintrin.h>
+#endif
 
 using audio::LooperLayer;
 using audio::SamplesBuffer;
 
+const uint LooperLayer::MAX_MIX_FRAMES;
+
 LooperLayer::LooperLayer() :
-    lastSamplesPerPeak(0),
     availableSamples(0),
-    lastCacheComputationSample(0),
     lastCycleLenght(0),
     locked(false),
     gain(1.0),
     pan(0),
     leftGain(1),
     rightGain(1),
-    muteState(MuteState::Unmuted)
+    muteState(MuteState::Unmuted),
+    hasPendingStorage(0)
 {
     setPan(0); // center
 }
@@ -43,19 +47,48 @@ void LooperLayer::reset()
 }
 
 void LooperLayer::zero()
+{
+    availableSamples = 0;
+    peaks.clear();
+    samplesRevision.ref();
+
+    // only the audio thread swaps the storage. A compacted layer (or a layer with a pending storage) is
+    // erased in the audio thread, after the expanded storage is committed
+    eraseRequested.storeRelease(1);
+    if (storageMutex.tryLock()) {
+        if (!compactStorage && !hasPendingStorage.load())
+            eraseFloatSamples();
+
+        storageMutex.unlock();
+    }
+}
+
+void LooperLayer::eraseFloatSamples()
 {
     std::fill(leftChannel.begin(), leftChannel.end(), static_cast<float>(0));
     std::fill(rightChannel.begin(), rightChannel.end(), static_cast<float>(0));
 
-    availableSamples = 0;
-    lastSamplesPerPeak = 0;
-    lastCacheComputationSample = 0;
-    peaksCache.clear();
+    eraseRequested.storeRelease(0);
 }
 
 void LooperLayer::setSamples(const SamplesBuffer &samples)
 {
-    zero();
+    QMutexLocker locker(&storageMutex); // the audio thread is not swapping the storage while the samples are replaced
+
+    if (compactStorage || hasPendingStorage.load()) {
+        setExpandedSamples(samples); // the audio thread can be using the current storage
+        return;
+    }
+
+    samplesRevision.ref();
+    availableSamples = 0;
+    peaks.clear();
+    eraseFloatSamples();
+
+    if (leftChannel.size() < lastCycleLenght) { // the layer was compacted before the last cycle resize
+        leftChannel.resize(lastCycleLenght);
+        rightChannel.resize(lastCycleLenght);
+    }
 
     uint samplesToCopy = qMin(samples.getFrameLenght(), lastCycleLenght);
     if (!samplesToCopy) {
@@ -75,18 +108,7 @@ void LooperLayer::setSamples(const SamplesBuffer &samples)
 
     availableSamples = samplesToCopy;
 
-
-    // rebuild peaks cache
-    lastCacheComputationSample = 0;
-    peaksCache.clear();
-
-    if (lastSamplesPerPeak) {
-        while (availableSamples - lastCacheComputationSample >= lastSamplesPerPeak) { // enough samples to cache a new max peak?
-            peaksCache.push_back(computeMaxPeak(lastCacheComputationSample, lastSamplesPerPeak));
-            lastCacheComputationSample += lastSamplesPerPeak;
-        }
-    }
-
+    peaks.update(&(leftChannel[0]), &(rightChannel[0]), availableSamples, 0, availableSamples); // rebuild all peaks
 }
 
 void LooperLayer::setPan(float pan)
@@ -115,76 +137,139 @@ void LooperLayer::setGain(float gain)
 
 void LooperLayer::prepareForNewCycle(uint samplesInNewCycle, bool isOverdubbing)
 {
+    Q_UNUSED(isOverdubbing)
+
     if (samplesInNewCycle > lastCycleLenght)
         resize(samplesInNewCycle);
 
-    if (isOverdubbing)
-        lastCacheComputationSample = 0; // reset max peak cache position to compute overdub peaks correctly
-
     lastCycleLenght = samplesInNewCycle;
 }
 
 void LooperLayer::overdub(const SamplesBuffer &samples, uint samplesToMix, uint startPosition)
 {
-    if (!samples.isMono()) {
-        float *internalChannels[] = {&(leftChannel[startPosition]), &(rightChannel[startPosition])};
-        float *samplesArray[] = {samples.getSamplesArray(0), samples.getSamplesArray(1)};
-        for (uint s = 0; s < samplesToMix; ++s) {
-            internalChannels[0][s] += samplesArray[0][s]; // left channel
-            internalChannels[1][s] += samplesArray[1][s]; // right channel
+    if (!ensureFloatStorage())
+        return;
+
+    addSamples(&(leftChannel[startPosition]), samples.getSamplesArray(0), samplesToMix);
+    if (!samples.isMono())
+        addSamples(&(rightChannel[startPosition]), samples.getSamplesArray(1), samplesToMix);
+
+    if (availableSamples < startPosition + samplesToMix)
+        availableSamples = startPosition + samplesToMix;
+
+    peaks.update(&(leftChannel[0]), &(rightChannel[0]), availableSamples, startPosition, samplesToMix);
+}
+
+bool LooperLayer::getMixSource(uint intervalPosition, uint samplesToMix, float looperMainGain, MixSource &source)
+{
+    bool canMix = muteState == LooperLayer::Unmuted || muteState == LooperLayer::WaitingToMute;
+    if (!canMix || intervalPosition >= availableSamples)
+        return false;
+
+    source.frames = qMin(samplesToMix, availableSamples - intervalPosition); // the layer end is handled here, once per callback
+    if (!source.frames)
+        return false;
+
+    const float mainGain = looperMainGain * gain;
+    if (compactStorage) { // decoding only the samples used in this callback
+        Q_ASSERT(source.frames <= MAX_MIX_FRAMES); // the looper is mixing bigger blocks in chunks
+        source.frames = qMin(source.frames, static_cast<uint>(decodedLeft.size()));
+        compactStorage->decode(intervalPosition, source.frames, &(decodedLeft[0]), &(decodedRight[0]));
+        source.left = &(decodedLeft[0]);
+        source.right = &(decodedRight[0]);
+    }
+    else {
+        source.left = &(leftChannel[intervalPosition]);
+        source.right = &(rightChannel[intervalPosition]);
+    }
+    source.leftGain = mainGain * leftGain;
+    source.rightGain = mainGain * rightGain;
+
+    return true;
+}
+
+void LooperLayer::mixLayers(const MixSource *sources, uint sourcesCount, float *outLeft, float *outRight, uint frames)
+{
+    if (!sourcesCount || !frames)
+        return;
+
+    // the frames shared by all layers are mixed in a single pass, the output is loaded and stored only once
+    uint commonFrames = frames;
+    for (uint i = 0; i < sourcesCount; ++i)
+        commonFrames = qMin(commonFrames, sources[i].frames);
+
+    uint s = 0;
+
+#ifdef LOOPER_LAYER_USE_SSE
+    if (outRight) {
+        for (; s + 4 <= commonFrames; s += 4) {
+            __m128 left = _mm_loadu_ps(outLeft + s);
+            __m128 right = _mm_loadu_ps(outRight + s);
+            for (uint i = 0; i < sourcesCount; ++i) {
+                const MixSource &source = sources[i];
+                left = _mm_add_ps(left, _mm_mul_ps(_mm_loadu_ps(source.left + s), _mm_set1_ps(source.leftGain)));
+                right = _mm_add_ps(right, _mm_mul_ps(_mm_loadu_ps(source.right + s), _mm_set1_ps(source.rightGain)));
+            }
+            _mm_storeu_ps(outLeft + s, left);
+            _mm_storeu_ps(outRight + s, right);
         }
     }
     else {
-        float *internalChannels[] = {&(leftChannel[startPosition]), &(rightChannel[startPosition])};
-        float *samplesArray = samples.getSamplesArray(0);
-        for (uint s = 0; s < samplesToMix; ++s) {
-            internalChannels[0][s] += samplesArray[s];
+        for (; s + 4 <= commonFrames; s += 4) {
+            __m128 left = _mm_loadu_ps(outLeft + s);
+            for (uint i = 0; i < sourcesCount; ++i)
+                left = _mm_add_ps(left, _mm_mul_ps(_mm_loadu_ps(sources[i].left + s), _mm_set1_ps(sources[i].leftGain)));
+
+            _mm_storeu_ps(outLeft + s, left);
+        }
+    }
+#endif
+
+    for (; s < commonFrames; ++s) {
+        float left = outLeft[s];
+        float right = 0.0f;
+        for (uint i = 0; i < sourcesCount; ++i) {
+            left += sources[i].left[s] * sources[i].leftGain;
+            right += sources[i].right[s] * sources[i].rightGain;
         }
+
+        outLeft[s] = left;
+        if (outRight)
+            outRight[s] += right;
     }
 
-    if (availableSamples < startPosition + samplesToMix)
-        availableSamples = startPosition + samplesToMix;
+    if (commonFrames == frames)
+        return;
 
-    // build peaks cache when overdubbing
-    if (lastSamplesPerPeak) {
-        const uint position = startPosition + samplesToMix;
-        while (position - lastCacheComputationSample >= lastSamplesPerPeak) { // enough samples to cache a new max peak?
-            const int peakIndex = (position/lastSamplesPerPeak) - 1;
-            float lastPeak = computeMaxPeak(lastCacheComputationSample, lastSamplesPerPeak);
-            if (peakIndex >= 0 && static_cast<uint>(peakIndex) < peaksCache.size())
-                peaksCache[peakIndex] = lastPeak;
-            else
-                peaksCache.push_back(lastPeak);
-
-            lastCacheComputationSample += lastSamplesPerPeak;
+    // some layers are ending inside this buffer, mixing the remaining frames layer by layer
+    for (uint i = 0; i < sourcesCount; ++i) {
+        const MixSource &source = sources[i];
+        for (uint f = commonFrames; f < source.frames; ++f) {
+            outLeft[f] += source.left[f] * source.leftGain;
+            if (outRight)
+                outRight[f] += source.right[f] * source.rightGain;
         }
     }
 }
 
-void LooperLayer::mixTo(SamplesBuffer &outBuffer, uint samplesToMix, uint intervalPosition, float looperMainGain)
+void LooperLayer::addSamples(float *destination, const float *source, uint count)
 {
-    bool canMix = samplesToMix > 0 && (muteState == LooperLayer::Unmuted || muteState == LooperLayer::WaitingToMute);
-    if (canMix) {
-        float *internalChannels[] = {&(leftChannel[0]), &(rightChannel[0])};
-        const uint secondChannelIndex = (outBuffer.isMono()) ? 0 : 1;
-        float *bufferChannels[] = {outBuffer.getSamplesArray(0), outBuffer.getSamplesArray(secondChannelIndex)};
-        uint channels = outBuffer.getChannels();
-
-        const float mainGain = looperMainGain * gain;
-        const float finalLeftGain = mainGain * leftGain;
-        const float finalRightGain = mainGain * rightGain;
-        float gains[] = {finalLeftGain, finalRightGain};
-        for (uint c = 0; c < channels; ++c) {
-            for (uint s = 0; s < samplesToMix; ++s) {
-                const uint offset = s + intervalPosition;
-                bufferChannels[c][s] += internalChannels[c][offset] * gains[c];
-            }
-        }
-    }
+    uint s = 0;
+
+#ifdef LOOPER_LAYER_USE_SSE
+    for (; s + 4 <= count; s += 4)
+        _mm_storeu_ps(destination + s, _mm_add_ps(_mm_loadu_ps(destination + s), _mm_loadu_ps(source + s)));
+#endif
+
+    for (; s < count; ++s)
+        destination[s] += source[s];
 }
 
 void LooperLayer::append(const SamplesBuffer &samples, uint samplesToAppend, uint startPosition)
 {
+    if (!ensureFloatStorage())
+        return;
+
     int toAppend = qMin(static_cast<uint>(leftChannel.capacity() - startPosition), samplesToAppend);
 
     if (!toAppend) {
@@ -202,62 +287,56 @@ void LooperLayer::append(const SamplesBuffer &samples, uint samplesToAppend, uin
 
     //Q_ASSERT(availableSamples <= leftChannel.capacity());
 
-    // build peaks cache
-    if (lastSamplesPerPeak) {
-        if (lastCacheComputationSample < startPosition - lastSamplesPerPeak)
-            lastCacheComputationSample = startPosition;
-
-        while ((startPosition + samplesToAppend) - lastCacheComputationSample >= lastSamplesPerPeak && lastCacheComputationSample  < leftChannel.size()) { // enough samples to cache a new max peak?
-            peaksCache.push_back(computeMaxPeak(lastCacheComputationSample, lastSamplesPerPeak));
-            lastCacheComputationSample += lastSamplesPerPeak;
-        }
-    }
+    peaks.update(&(leftChannel[0]), &(rightChannel[0]), availableSamples, startPosition, toAppend);
 }
 
 float LooperLayer::computeMaxPeak(uint from, uint samplesPerPeak) const
 {
-    float maxPeak = 0;
+    if (from >= availableSamples || from >= leftChannel.size())
+        return 0;
+
     uint limit = qMin(samplesPerPeak, availableSamples - from);
-    for (uint i = 0; i < limit; ++i) {
-        const uint offset = from + i;
-        if (offset < leftChannel.size()) {
-            float peak = qMax(qAbs(leftChannel[offset]), qAbs(rightChannel[offset]));
-            if (peak > maxPeak) {
-                maxPeak = peak;
-            }
-        }
-    }
+    limit = qMin(limit, static_cast<uint>(leftChannel.size()) - from);
 
-    return maxPeak;
+    return qMax(PeaksPyramid::computeMaxAbs(&(leftChannel[from]), limit), PeaksPyramid::computeMaxAbs(&(rightChannel[from]), limit));
 }
 
-std::vector<float> LooperLayer::getSamplesPeaks(uint samplesPerPeak)
+void LooperLayer::getSamplesPeaks(uint samplesPerPeak, std::vector<float> &peaks) const
 {
-    if (lastSamplesPerPeak == samplesPerPeak && !peaksCache.empty()) { // cache hit?
-        return peaksCache;
+    if (compactStorage) {
+        this->peaks.getMaxPeaks(nullptr, nullptr, availableSamples, samplesPerPeak, peaks); // only the pyramid levels are available
+        return;
     }
 
-    // compute all peaks
-    peaksCache.clear();
-    if (samplesPerPeak) {
-        for (uint i = 0; i < availableSamples; i += samplesPerPeak) {
-            float maxPeak = computeMaxPeak(i, samplesPerPeak);
-            peaksCache.push_back(maxPeak);
-        }
-        lastSamplesPerPeak = samplesPerPeak;
+    if (leftChannel.empty()) {
+        peaks.clear();
+        return;
     }
 
-    return peaksCache;
+    this->peaks.getMaxPeaks(&(leftChannel[0]), &(rightChannel[0]), availableSamples, samplesPerPeak, peaks); // O(peaks), the pyramid is updated when recording
 }
 
 void LooperLayer::resize(quint32 samplesPerCycle)
 {
+    samplesRevision.ref();
+
+    if (compactStorage) { // compacted samples are repeated when decoding, no copy is necessary
+        peaks.resize(samplesPerCycle);
+        if (availableSamples && samplesPerCycle > availableSamples) {
+            availableSamples = samplesPerCycle;
+            peaksOutdated.storeRelease(1); // decoding the whole layer is too slow for the audio thread
+        }
+        return;
+    }
+
     if (samplesPerCycle > leftChannel.capacity())
         leftChannel.resize(samplesPerCycle);
 
     if (samplesPerCycle > rightChannel.capacity())
         rightChannel.resize(samplesPerCycle);
 
+    peaks.resize(samplesPerCycle);
+
     if (availableSamples && samplesPerCycle > availableSamples) { // need copy samples?
         uint initialAvailableSamples = availableSamples;
         uint totalSamplesToCopy = samplesPerCycle - initialAvailableSamples;
@@ -272,13 +351,20 @@ void LooperLayer::resize(quint32 samplesPerCycle)
 
         Q_ASSERT(availableSamples == samplesPerCycle);
 
-        peaksCache.clear(); // invalidate peaks cache
+        peaks.update(&(leftChannel[0]), &(rightChannel[0]), availableSamples, initialAvailableSamples, samplesPerCycle - initialAvailableSamples); // peaks for the copied samples
     }
 }
 
 SamplesBuffer LooperLayer::getAllSamples() const
 {
     SamplesBuffer buffer(2, availableSamples);
+
+    QMutexLocker locker(&storageMutex);
+    if (compactStorage) {
+        compactStorage->decode(0, availableSamples, buffer.getSamplesArray(0), buffer.getSamplesArray(1));
+        return buffer;
+    }
+
     uint bytesToCopy = availableSamples * sizeof(float);
     std::memcpy(buffer.getSamplesArray(0), &(leftChannel[0]), bytesToCopy);
     std::memcpy(buffer.getSamplesArray(1), &(rightChannel[0]), bytesToCopy);
@@ -286,3 +372,158 @@ SamplesBuffer LooperLayer::getAllSamples() const
     return buffer;
 }
 
+
+void LooperLayer::setExpandedSamples(const SamplesBuffer &samples)
+{
+    const uint samplesToCopy = qMin(samples.getFrameLenght(), lastCycleLenght);
+
+    samplesRevision.ref();
+    eraseRequested.storeRelease(0); // the new samples replace the erased samples
+
+    pendingStorage.compactStorage.reset();
+    pendingStorage.leftChannel.assign(lastCycleLenght, 0.0f);
+    pendingStorage.rightChannel.assign(lastCycleLenght, 0.0f);
+
+    if (samplesToCopy) {
+        const uint bytesToCopy = samplesToCopy * sizeof(float);
+        std::memcpy(&(pendingStorage.leftChannel[0]), samples.getSamplesArray(0), bytesToCopy);
+        std::memcpy(&(pendingStorage.rightChannel[0]), samples.getSamplesArray(samples.isMono() ? 0 : 1), bytesToCopy);
+    }
+
+    availableSamples = samplesToCopy;
+
+    peaks.clear();
+    if (availableSamples)
+        peaks.update(&(pendingStorage.leftChannel[0]), &(pendingStorage.rightChannel[0]), availableSamples, 0, availableSamples);
+
+    hasPendingStorage.storeRelease(1);
+}
+
+void LooperLayer::prepareCompactStorage()
+{
+    // the lock is held while compressing, so the float samples are not replaced in the main thread. The audio
+    // thread is only trying the lock and the locked layers are not recorded
+    QMutexLocker locker(&storageMutex);
+
+    if (!locked || compactStorage || hasPendingStorage.load() || eraseRequested.load() || !availableSamples || leftChannel.size() < availableSamples)
+        return;
+
+    const uint frames = availableSamples;
+    const int revision = samplesRevision.load();
+
+    std::unique_ptr<CompactLayerStorage> storage(new CompactLayerStorage());
+    storage->compress(&(leftChannel[0]), &(rightChannel[0]), frames);
+
+    if (samplesRevision.load() != revision)
+        return; // the layer was resized in the audio thread while compressing
+
+    if (decodedLeft.size() < MAX_MIX_FRAMES) { // not used by the audio thread while the layer is not compacted
+        decodedLeft.resize(MAX_MIX_FRAMES);
+        decodedRight.resize(MAX_MIX_FRAMES);
+    }
+
+    pendingStorage.compactStorage = std::move(storage);
+    std::vector<float>().swap(pendingStorage.leftChannel);
+    std::vector<float>().swap(pendingStorage.rightChannel);
+    hasPendingStorage.storeRelease(1);
+}
+
+void LooperLayer::prepareExpandedStorage(bool decodeSamples)
+{
+    QMutexLocker locker(&storageMutex);
+
+    pendingStorage.compactStorage.reset(); // discard a compaction not committed yet
+    std::vector<float>().swap(pendingStorage.leftChannel);
+    std::vector<float>().swap(pendingStorage.rightChannel);
+    hasPendingStorage.storeRelease(0);
+
+    if (!compactStorage)
+        return;
+
+    const uint frames = qMax(lastCycleLenght, availableSamples);
+    pendingStorage.leftChannel.assign(frames, 0.0f);
+    pendingStorage.rightChannel.assign(frames, 0.0f);
+    if (decodeSamples && availableSamples)
+        compactStorage->decode(0, availableSamples, &(pendingStorage.leftChannel[0]), &(pendingStorage.rightChannel[0]));
+
+    hasPendingStorage.storeRelease(1);
+}
+
+bool LooperLayer::commitPendingStorage()
+{
+    if (!hasPendingStorage.loadAcquire() && !eraseRequested.loadAcquire())
+        return true;
+
+    if (!storageMutex.tryLock()) // main thread is preparing the storage, trying again in the next callback
+        return false;
+
+    if (hasPendingStorage.load()) {
+        // the replaced storage is moved to 'pendingStorage' and released in the main thread, nothing is deallocated here
+        compactStorage.swap(pendingStorage.compactStorage);
+        leftChannel.swap(pendingStorage.leftChannel);
+        rightChannel.swap(pendingStorage.rightChannel);
+
+        hasPendingStorage.storeRelease(0);
+    }
+
+    if (eraseRequested.load() && !compactStorage)
+        eraseFloatSamples(); // a compacted layer keeps the request until the expanded storage is committed
+
+    storageMutex.unlock();
+
+    return true;
+}
+
+void LooperLayer::releaseRetiredStorage()
+{
+    if (hasPendingStorage.loadAcquire())
+        return; // not committed yet
+
+    if (!storageMutex.tryLock())
+        return; // a layer is compressed in a worker thread, trying again in the next call
+
+    if (!hasPendingStorage.load()) {
+        pendingStorage.compactStorage.reset();
+        std::vector<float>().swap(pendingStorage.leftChannel);
+        std::vector<float>().swap(pendingStorage.rightChannel);
+    }
+
+    storageMutex.unlock();
+}
+
+void LooperLayer::refreshPeaks()
+{
+    if (!peaksOutdated.loadAcquire() || !storageMutex.tryLock())
+        return;
+
+    peaksOutdated.storeRelease(0);
+
+    const uint frames = availableSamples;
+    if (compactStorage && frames) { // float layers are updating the peaks when resized
+        std::vector<float> left(frames);
+        std::vector<float> right(frames);
+        compactStorage->decode(0, frames, &(left[0]), &(right[0]));
+
+        peaks.update(&(left[0]), &(right[0]), frames, 0, frames);
+    }
+
+    storageMutex.unlock();
+}
+
+bool LooperLayer::ensureFloatStorage()
+{
+    commitPendingStorage(); // the layer was unlocked or erased in this callback
+
+    return !compactStorage && !eraseRequested.load(); // otherwise the samples are not changed until the expanded storage is committed
+}
+
+size_t LooperLayer::getMemoryUsage() const
+{
+    size_t floats = leftChannel.capacity() + rightChannel.capacity() + decodedLeft.capacity() + decodedRight.capacity();
+    size_t bytes = floats * sizeof(float);
+
+    if (compactStorage)
+        bytes += compactStorage->getMemoryUsage();
+
+    return bytes;
+}
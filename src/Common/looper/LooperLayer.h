@@ -2,7 +2,13 @@
 #define _AUDIO_LOOPER_LAYER_
 
 #include <vector>
+#include <memory>
 #include <QtGlobal>
+#include <QMutex>
+#include <QAtomicInt>
+
+#include "audio/core/PeaksPyramid.h"
+#include "CompactLayerStorage.h"
 
 namespace audio {
 
@@ -37,11 +43,26 @@ public:
 
     float computeMaxPeak(uint from, uint samplesPerPeak) const;
 
-    std::vector<float> getSamplesPeaks(uint samplesPerPeak);
+    void getSamplesPeaks(uint samplesPerPeak, std::vector<float> &peaks) const;
 
     SamplesBuffer getAllSamples() const;
 
-    void mixTo(SamplesBuffer &outBuffer, uint samplesToMix, uint intervalPosition, float looperMainGain);
+    // a layer ready to be mixed, the gains are already combined (looper main gain * layer gain * pan gain)
+    struct MixSource
+    {
+        const float *left;
+        const float *right;
+        uint frames; // frames available to mix, can be less than the requested frames in the end of the layer
+        float leftGain;
+        float rightGain;
+    };
+
+    bool getMixSource(uint intervalPosition, uint samplesToMix, float looperMainGain, MixSource &source); // false if the layer is muted or empty
+
+    // fused kernel: mix all sources in a single pass over the output. 'outRight' can be null (mono output)
+    static void mixLayers(const MixSource *sources, uint sourcesCount, float *outLeft, float *outRight, uint frames);
+
+    static void addSamples(float *destination, const float *source, uint count); // SIMD destination += source
 
     void setLocked(bool locked);
     bool isLocked() const;
@@ -61,14 +82,46 @@ public:
 
     uint getAvailableSamples() const;
 
+    // locked layers can be stored in a compact format, the storage is prepared outside the audio thread and swapped in the audio thread
+    void prepareCompactStorage(); // slow, called from a worker thread
+    void prepareExpandedStorage(bool decodeSamples = true); // pass false to erase the compacted samples
+    bool commitPendingStorage(); // called from the audio thread, return false when the storage is still pending
+    void releaseRetiredStorage(); // called from the main thread, release the storage replaced in the audio thread
+    void refreshPeaks(); // called from the main thread, rebuild the peaks of a compacted layer resized in the audio thread
+    bool isCompacted() const;
+
+    static const uint MAX_MIX_FRAMES = 4096; // max frames in getMixSource when the layer is compacted, the decoded samples are preallocated
+
+    size_t getMemoryUsage() const; // in bytes
+
 private:
-    std::vector<float> leftChannel;
+    std::vector<float> leftChannel; // empty when the layer is compacted
     std::vector<float> rightChannel;
 
-    std::vector<float> peaksCache;
-    uint lastSamplesPerPeak;
+    std::unique_ptr<CompactLayerStorage> compactStorage;
+    std::vector<float> decodedLeft; // compacted samples decoded just ahead of the playhead
+    std::vector<float> decodedRight;
+
+    struct PendingStorage
+    {
+        std::unique_ptr<CompactLayerStorage> compactStorage;
+        std::vector<float> leftChannel;
+        std::vector<float> rightChannel;
+    };
+
+    PendingStorage pendingStorage; // storage waiting the audio thread commit, or the replaced storage waiting to be released
+    QAtomicInt hasPendingStorage;
+    QAtomicInt eraseRequested; // zero() was called while the storage can't be touched, the float samples are erased after the next commit
+    QAtomicInt samplesRevision; // incremented when the samples are changed, a compression started before the change is discarded
+    QAtomicInt peaksOutdated; // a compacted layer was resized, the peaks of the repeated samples are rebuilt in the main thread
+    mutable QMutex storageMutex; // protect the storage swap, the audio thread never waits when committing
+
+    bool ensureFloatStorage(); // audio thread, return false while the layer is compacted or waiting to be erased
+    void eraseFloatSamples(); // 'storageMutex' must be locked
+    void setExpandedSamples(const SamplesBuffer &samples); // replace a compacted layer samples, 'storageMutex' must be locked
+
+    PeaksPyramid peaks; // multi resolution peaks, updated when samples are recorded or overdubbed
     uint availableSamples;
-    uint lastCacheComputationSample;
     uint lastCycleLenght;
     bool locked;
 
@@ -129,6 +182,11 @@ inline bool LooperLayer::isValid() const
     return availableSamples > 0;
 }
 
+inline bool LooperLayer::isCompacted() const
+{
+    return compactStorage != nullptr;
+}
+
 inline bool LooperLayer::isLocked() const
 {
     return locked;
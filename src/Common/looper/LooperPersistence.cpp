@@ -1,136 +1,45 @@
 #include "LooperPersistence.h"
+#include "LoopInfoIndex.h"
 #include "Looper.h"
 #include "file/WaveFileWriter.h"
 #include "audio/vorbis/VorbisEncoder.h"
-#include "file/FileReaderFactory.h"
-#include "audio/SamplesBufferResampler.h"
+#include "persistence/SoundCache.h"
 #include "Utils.h"
 
 #include <QtConcurrent/QtConcurrent>
-#include <QJsonDocument>
 #include <QFileInfo>
+#include <QDir>
 
 using audio::LoopInfo;
 using audio::LoopSaver;
 using audio::LoopLoader;
+using audio::LoopInfoIndex;
 using audio::Looper;
 using audio::SamplesBuffer;
 
-LoopInfo::LoopInfo(quint32 bpm, quint16 bpi, const QString &name, bool audioIsEncoded, quint8 mode) :
-    bpm(bpm),
-    bpi(bpi),
-    name(name),
-    usingEncodedAudio(audioIsEncoded),
-    looperMode(mode)
+LoopInfo LoopSaver::createLoopInfo(const Looper *looper, const QString &loopFileName, uint bpm, uint bpi, bool encodeInOggVorbis)
 {
-    //
-}
-
-LoopInfo::LoopInfo()
-    : LoopInfo(0, 0, QString(), false, 0) // calling overloaded constructor
-{
-    //
-}
-
-bool LoopInfo::isValid() const
-{
-    return !name.isEmpty() && bpm > 0 && bpi > 0 && layers.size() > 0;
-}
-
-QString LoopInfo::toString(bool showBpm) const
-{
-    QString text = name;
-    text += " (";
-
-    if (showBpm)
-        text += QString::number(bpm) + " BPM, ";
-
-    text += QString::number(bpi) + " BPI, ";
-    text += QString::number(layers.size()) + " layers";
-
-    text += ")";
-
-    return text;
-}
-
-void LoopInfo::addLayer(bool isLocked, float gain, float pan)
-{
-    LoopLayerInfo layerInfo;
-    layerInfo.locked = isLocked;
-    layerInfo.gain = gain;
-    layerInfo.pan = pan;
-    layers.append(layerInfo);
-}
-
-// -------------------------------------------------------------------
+    LoopInfo loopInfo(bpm, bpi, loopFileName, encodeInOggVorbis, static_cast<quint8>(looper->getMode()));
+    for (quint8 l = 0; l < looper->getLayers(); ++l)
+        loopInfo.addLayer(looper->layerIsLocked(l), Utils::poweredGainToLinear(looper->getLayerGain(l)), looper->getLayerPan(l));
 
-LoopSaver::LoopSaver(const QString &savePath, Looper *looper) :
-    savePath(savePath),
-    looper(looper)
-{
-
-}
-
-QList<quint8> LoopSaver::getLockedLayers(Looper *looper)
-{
-    QList<quint8> lockedLayers;
-    for (int l = 0; l < looper->getLayers(); ++l) {
-        if (looper->layerIsLocked(l))
-            lockedLayers << l;
-    }
-    return lockedLayers;
+    return loopInfo;
 }
 
-void LoopSaver::save(const QString &loopFileName, uint bpm, uint bpi, bool encodeInOggVorbis, float vorbisQuality, uint sampleRate, quint8 bitDepth)
+bool LoopSaver::createLoopDir(const QString &savePath, const QString &loopFileName)
 {
     QDir loopDir(QDir(savePath).absoluteFilePath(loopFileName));
     if (!loopDir.exists()) {
         if (!loopDir.mkpath(".")) {
             qCritical() << "Error creating loop dir" << loopDir;
+            return false;
         }
     }
 
-    QList<SamplesBuffer> layersSamples = looper->getLayersSamples();
-    for (int layer = 0; layer < layersSamples.size(); ++layer) {
-        LoopSaver::saveSamplesToDisk(savePath,
-                                     loopFileName,
-                                     layersSamples.at(layer),
-                                     layer,
-                                     encodeInOggVorbis,
-                                     vorbisQuality,
-                                     sampleRate,
-                                     bitDepth);
-    }
-
-    QFile jsonFile(QDir(savePath).absoluteFilePath(loopFileName) + ".json");
-    if (jsonFile.open(QIODevice::WriteOnly)) {
-        QJsonObject root;
-        root["bpm"] = static_cast<int>(bpm);
-        root["bpi"] = static_cast<int>(bpi);
-        root["loopLenght"] = static_cast<int>(looper->getIntervalLenght());
-        root["audioFormat"] = encodeInOggVorbis ? "ogg" : "wave";
-        root["looperMode"] = static_cast<int>(looper->getMode());
-
-        QJsonArray layers;
-        for (quint8 l = 0; l < looper->getLayers(); ++l) {
-            QJsonObject layer;
-            layer["locked"] = looper->layerIsLocked(l);
-            layer["gain"] = Utils::poweredGainToLinear(looper->getLayerGain(l));
-            layer["pan"] = looper->getLayerPan(l);
-            layers.append(layer);
-        }
-        root["layers"] = layers;
-
-        QJsonDocument doc(root);
-        jsonFile.write(doc.toJson());
-    } else {
-        qCritical() << jsonFile.errorString();
-    }
-
-    looper->setChanged(false);
+    return true;
 }
 
-void LoopSaver::saveSamplesToDisk(const QString &savePath, const QString &loopFileName, const SamplesBuffer &buffer, quint8 layerIndex, bool encodeInOggVorbis, float vorbisQuality, uint sampleRate, quint8 bitDepth)
+bool LoopSaver::saveSamplesToDisk(const QString &savePath, const QString &loopFileName, const SamplesBuffer &buffer, quint8 layerIndex, bool encodeInOggVorbis, float vorbisQuality, uint sampleRate, quint8 bitDepth)
 {
     Q_ASSERT(!loopFileName.isEmpty() && !loopFileName.isNull());
     Q_ASSERT(layerIndex < MAX_LOOP_LAYERS);
@@ -140,36 +49,66 @@ void LoopSaver::saveSamplesToDisk(const QString &savePath, const QString &loopFi
         WaveFileWriter waveFileWriter;
         QString filePath = QDir(savePath).absoluteFilePath(loopFileName +"/layer_" + QString::number(layerIndex) + ".wav");
         waveFileWriter.write(filePath, buffer, sampleRate, bitDepth);
+        return true;
     }
-    else {
-        vorbis::Encoder encoder(2, sampleRate, vorbisQuality);
-        QByteArray encodedData = encoder.encode(buffer);
-        encodedData.append(encoder.finishIntervalEncoding());
-        QString filePath = QDir(savePath).absoluteFilePath(loopFileName +"/layer_" + QString::number(layerIndex) + ".ogg");
-        QFile oggFile(filePath);
-        if (oggFile.open(QFile::WriteOnly)) {
-            oggFile.write(encodedData);
-        }
-        else {
-            qCritical() << "Can't write in the file " << filePath;
-        }
+
+    QString filePath = QDir(savePath).absoluteFilePath(loopFileName +"/layer_" + QString::number(layerIndex) + ".ogg");
+    QFile oggFile(filePath);
+    if (!oggFile.open(QFile::WriteOnly)) {
+        qCritical() << "Can't write in the file " << filePath;
+        return false;
     }
-}
 
+    // encoding and writing in small chunks, the whole encoded layer is never buffered in memory
+    static const uint CHUNK_SIZE = 8192;
+    vorbis::Encoder encoder(2, sampleRate, vorbisQuality);
+    SamplesBuffer chunk(2, CHUNK_SIZE);
+    const uint totalFrames = buffer.getFrameLenght();
+    for (uint offset = 0; offset < totalFrames; offset += CHUNK_SIZE) {
+        const uint frames = qMin(CHUNK_SIZE, totalFrames - offset);
+        chunk.setFrameLenght(frames);
+        chunk.set(buffer, offset, frames, 0);
+        oggFile.write(encoder.encode(chunk));
+    }
+    oggFile.write(encoder.finishIntervalEncoding());
+
+    return true;
+}
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-LoopLoader::LoopLoader(const QString &loadPath) :
-    loadPath(loadPath)
+LoopLoader::LoadedLayer::LoadedLayer(quint8 index, quint32 samplesPerInterval) :
+    index(index),
+    loaded(false),
+    samples(2, samplesPerInterval)
 {
 
 }
 
-void LoopLoader::load(LoopInfo loopInfo, Looper *looper, uint currentSampleRate, quint32 samplesPerInterval)
+QList<LoopLoader::LoadedLayer> LoopLoader::loadLayers(const QString &loadPath, const LoopInfo &loopInfo, uint currentSampleRate, quint32 samplesPerInterval,
+                                                      const std::function<bool ()> &isCanceled, const std::function<void ()> &layerFinished)
 {
-    if (!loopInfo.isValid())
-        return;
+    QList<LoadedLayer> layers;
+    for (quint8 layer = 0; layer < loopInfo.getLayersCount(); ++layer)
+        layers.append(LoadedLayer(layer, samplesPerInterval));
+
+    const QString loopName = loopInfo.getName();
+    const bool audioIsEncoded = loopInfo.audioIsEncoded();
+    QtConcurrent::blockingMap(layers, [&](LoadedLayer &layer) {
+        if (isCanceled && isCanceled())
+            return;
 
+        layer.loaded = LoopLoader::loadLoopLayerSamples(loadPath, loopName, layer.index, audioIsEncoded, currentSampleRate, layer.samples);
+
+        if (layerFinished)
+            layerFinished();
+    });
+
+    return layers;
+}
+
+void LoopLoader::setLooperLayers(const LoopInfo &loopInfo, const QList<LoadedLayer> &layers, Looper *looper)
+{
     looper->setChanged(false);
     looper->setLoading(true);
 
@@ -177,17 +116,14 @@ void LoopLoader::load(LoopInfo loopInfo, Looper *looper, uint currentSampleRate,
     looper->setMode(static_cast<Looper::Mode>(loopInfo.getLooperMode()));
     looper->setLayers(loopInfo.getLayersCount());
 
-    bool audioIsEncoded = loopInfo.audioIsEncoded();
     QList<LoopLayerInfo> layersInfo = loopInfo.getLayersInfo();
-    for (quint8 layer = 0; layer < layersInfo.size(); ++layer) {
-        SamplesBuffer samples(2, samplesPerInterval);
-        bool loadResult = LoopLoader::loadLoopLayerSamples(loadPath, loopInfo.getName(), layer, audioIsEncoded, currentSampleRate, samples);
-        if (loadResult) {
-            looper->setLayerSamples(layer, samples);
-            bool layerIsLocked = layersInfo.at(layer).locked;
-            looper->setLayerLockedState(layer, layerIsLocked);
-            looper->setLayerGain(layer, Utils::linearGainToPower(layersInfo.at(layer).gain));
-            looper->setLayerPan(layer, layersInfo.at(layer).pan);
+    for (const LoadedLayer &layer : layers) {
+        if (layer.loaded && layer.index < layersInfo.size()) {
+            const LoopLayerInfo &layerInfo = layersInfo.at(layer.index);
+            looper->setLayerSamples(layer.index, layer.samples);
+            looper->setLayerLockedState(layer.index, layerInfo.locked);
+            looper->setLayerGain(layer.index, Utils::linearGainToPower(layerInfo.gain));
+            looper->setLayerPan(layer.index, layerInfo.pan);
         }
     }
 
@@ -204,21 +140,7 @@ bool LoopLoader::loadAudioFile(const QString &filePath, uint currentSampleRate,
         return false;
     }
 
-    auto fileReader = FileReaderFactory::createFileReader(filePath);
-    quint32 audioFileSampleRate = 0;
-    if (!fileReader->read(filePath, out, audioFileSampleRate))
-        return false;
-
-    bool needResample = audioFileSampleRate > 0 && currentSampleRate != audioFileSampleRate;
-    if (needResample) {
-        SamplesBufferResampler resampler;
-        uint desiredLenght = currentSampleRate/static_cast<float>(audioFileSampleRate) * out.getFrameLenght();
-        const SamplesBuffer resampledBuffer = resampler.resample(out, desiredLenght);
-        out.setFrameLenght(desiredLenght);
-        out.set(resampledBuffer);
-    }
-
-    return true;
+    return persistence::SoundCache::getInstance()->load(filePath, currentSampleRate, out);
 }
 
 bool LoopLoader::loadLoopLayerSamples(const QString &loadPath, const QString &loopName, quint8 layerIndex, bool audioIsEncoded, uint currentSampleRate, SamplesBuffer &out)
@@ -240,61 +162,10 @@ QList<LoopInfo> LoopLoader::loadLoopsInfo(const QString &loadPath, quint32 bpmTo
 {
     QList<LoopInfo> allInfos;
 
-    QDir loadDir(loadPath);
-    QDir::Filters filters = QDir::NoDotAndDotDot | QDir::Files;
-    QFileInfoList fileInfoList = loadDir.entryInfoList(QStringList("*.json"), filters);
-    for (const QFileInfo &fileInfo : fileInfoList) {
-        QString loopFilePath = fileInfo.absoluteFilePath();
-        LoopInfo loopInfo = LoopLoader::loadLoopInfo(loopFilePath);
+    for (const LoopInfo &loopInfo : LoopInfoIndex::getLoopsInfo(loadPath)) { // only new or modified json files are parsed
         if (loopInfo.isValid() && loopInfo.getBpm() == bpmToMatch)
             allInfos.append(loopInfo);
     }
 
     return allInfos;
 }
-
-LoopInfo LoopLoader::loadLoopInfo(const QString &loopFilePath)
-{
-    QFile file(loopFilePath);
-    if (!file.open(QFile::ReadOnly)) {
-        qCritical() << "Error loading loop metada:" << file.errorString();
-        return LoopInfo();
-    }
-
-    if (QFileInfo(file).suffix() != "json") {
-        qCritical() << "Error loading loop metada, not a json file" << loopFilePath;
-        return LoopInfo();
-    }
-
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    QJsonObject root = doc.object();
-
-    quint32 bpm = (root.contains("bpm") ? (root["bpm"].toInt()) : 0);
-    quint16 bpi = (root.contains("bpi") ? (root["bpi"].toInt()) : 0);
-    bool audioIsEncoded = root.contains("audioFormat") && root["audioFormat"].toString() == "ogg";
-    QString loopName = QFileInfo(file).baseName();
-    quint8 looperMode = root.contains("looperMode") ? root["looperMode"].toInt() : 0;
-
-    LoopInfo loopInfo(bpm, bpi, loopName, audioIsEncoded, looperMode);
-
-    if (root.contains("layers")) {
-        if (root["layers"].isArray()) { // new loop file format
-            QJsonArray layers = root["layers"].toArray();
-            for (int i = 0; i < layers.size(); ++i) {
-                QJsonObject layer = layers.at(i).toObject();
-                bool isLocked = layer.contains("locked") ? layer["locked"].toBool() : false;
-                float gain = layer.contains("gain") ? layer["gain"].toDouble() : 1.0;
-                float pan = layer.contains("pan") ? layer["pan"].toDouble() : 0.0;
-                loopInfo.addLayer(isLocked, gain, pan);
-            }
-        }
-        else { // using old loop file format
-            int layers = root["layers"].toInt(0);
-            for (int l = 0; l < layers; ++l) {
-                loopInfo.addLayer(false, 1.0, 0.0);
-            }
-        }
-    }
-
-    return loopInfo;
-}
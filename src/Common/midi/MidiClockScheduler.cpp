@@ -0,0 +1,155 @@
+#include "MidiClockScheduler.h"
+#include "MidiDriver.h"
+
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+using midi::MidiClockScheduler;
+
+const quint32 MidiClockScheduler::QUEUE_SIZE = 1024; // more than 10 intervals with 16 bpi
+const qint64 MidiClockScheduler::SPIN_TIME = 1000000; // 1 ms
+const qint64 MidiClockScheduler::MAX_SLEEP_TIME = 5000000; // 5 ms
+const qint64 MidiClockScheduler::LATE_THRESHOLD = 1000000; // 1 ms
+
+MidiClockScheduler::MidiClockScheduler(MidiDriver *driver) :
+    driver(driver),
+    messages(QUEUE_SIZE),
+    running(0),
+    stopClockRequested(0),
+    sentMessages(0),
+    lateMessages(0),
+    droppedMessages(0),
+    maxJitter(0)
+{
+    threadPool.setMaxThreadCount(1);
+}
+
+MidiClockScheduler::~MidiClockScheduler()
+{
+    stop();
+}
+
+void MidiClockScheduler::start()
+{
+    if (isRunning())
+        return;
+
+    running.store(1);
+    future = QtConcurrent::run(&threadPool, this, &MidiClockScheduler::run);
+}
+
+void MidiClockScheduler::stop()
+{
+    running.store(0);
+    future.waitForFinished();
+
+    // the sending thread is stopped, the pending messages can be discarded here
+    ScheduledMessage message;
+    while (messages.read(&message, 1))
+        ;
+}
+
+bool MidiClockScheduler::schedule(ClockMessage message, quint64 samplePosition)
+{
+    if (!isRunning())
+        return false;
+
+    ScheduledMessage scheduledMessage;
+    scheduledMessage.time = driver->getSampleClockTime(samplePosition);
+    scheduledMessage.message = message;
+    if (!messages.write(&scheduledMessage, 1)) {
+        droppedMessages.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    return true;
+}
+
+void MidiClockScheduler::stopClock()
+{
+    if (!isRunning()) {
+        driver->sendClockStop();
+        return;
+    }
+
+    stopClockRequested.store(1); // the messages are discarded and the stop is sent in the sending thread, the midi outputs are used in just one thread
+}
+
+MidiClockScheduler::Statistics MidiClockScheduler::getStatistics() const
+{
+    Statistics statistics;
+    statistics.sentMessages = sentMessages.load();
+    statistics.lateMessages = lateMessages.load();
+    statistics.droppedMessages = droppedMessages.load();
+    statistics.maxJitter = maxJitter.load();
+    return statistics;
+}
+
+void MidiClockScheduler::waitUntil(qint64 time)
+{
+    qint64 remaining = time - driver->getClockTime();
+    while (remaining > 0 && running.load()) {
+        if (remaining > SPIN_TIME)
+            QThread::usleep(qMin(remaining - SPIN_TIME, MAX_SLEEP_TIME) / 1000); // sleeping is not precise, just sleep until the message is close
+        else
+            QThread::yieldCurrentThread();
+
+        remaining = time - driver->getClockTime();
+    }
+}
+
+void MidiClockScheduler::run()
+{
+    QThread *thread = QThread::currentThread();
+    thread->setPriority(QThread::TimeCriticalPriority);
+
+    ScheduledMessage message;
+    while (running.load()) {
+        if (stopClockRequested.testAndSetOrdered(1, 0)) {
+            while (messages.read(&message, 1))
+                ;
+
+            driver->sendClockStop();
+        }
+
+        if (!messages.read(&message, 1)) {
+            QThread::usleep(MAX_SLEEP_TIME / 1000 / 5); // nothing scheduled, the clock pulses are scheduled at least one audio buffer ahead
+            continue;
+        }
+
+        waitUntil(message.time);
+        if (!running.load() || stopClockRequested.load())
+            continue;
+
+        const qint64 jitter = qAbs(driver->getClockTime() - message.time);
+        send(message.message);
+
+        if (jitter > maxJitter.load())
+            maxJitter.store(jitter);
+
+        if (jitter > LATE_THRESHOLD)
+            lateMessages.fetchAndAddRelaxed(1);
+
+        sentMessages.fetchAndAddRelaxed(1);
+    }
+
+    thread->setPriority(QThread::NormalPriority); // the pool thread can be reused
+}
+
+void MidiClockScheduler::send(ClockMessage message)
+{
+    switch (message) {
+    case ClockPulse:
+        driver->sendClockPulse();
+        break;
+    case ClockStart:
+        driver->sendClockStart();
+        break;
+    case ClockContinue:
+        driver->sendClockContinue();
+        break;
+    case ClockStop:
+        driver->sendClockStop();
+        break;
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef MIDI_CLOCK_SCHEDULER_H
+#define MIDI_CLOCK_SCHEDULER_H
+
+#include "audio/core/RingBuffer.h"
+
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QFuture>
+
+namespace midi {
+
+class MidiDriver;
+
+/**
+    Send the MIDI clock messages at the precise time of their sample positions. The audio thread schedule
+    the messages using the sample clock (see MidiDriver::getSampleClockTime), and a high priority thread
+    send each message when the system clock reach the message time. So the clock jitter is not related
+    with the audio buffer size.
+ */
+
+class MidiClockScheduler
+{
+public:
+    enum ClockMessage : quint8
+    {
+        ClockPulse,
+        ClockStart,
+        ClockContinue,
+        ClockStop
+    };
+
+    struct Statistics
+    {
+        quint32 sentMessages;
+        quint32 lateMessages;    // sent after LATE_THRESHOLD
+        quint32 droppedMessages; // the queue was full
+        qint64 maxJitter;        // nanoseconds
+    };
+
+    explicit MidiClockScheduler(MidiDriver *driver);
+    ~MidiClockScheduler();
+
+    void start();
+    void stop();
+
+    bool schedule(ClockMessage message, quint64 samplePosition); // called in audio thread
+    void stopClock(); // discard the scheduled messages and send the stop message as soon as possible, called from any thread
+
+    Statistics getStatistics() const;
+
+    bool isRunning() const;
+
+private:
+    struct ScheduledMessage
+    {
+        qint64 time; // see MidiDriver::getClockTime()
+        ClockMessage message;
+    };
+
+    MidiDriver *driver;
+    audio::RingBuffer<ScheduledMessage> messages;
+
+    QThreadPool threadPool; // just one high priority thread
+    QFuture<void> future;
+
+    QAtomicInt running;
+    QAtomicInt stopClockRequested;
+
+    QAtomicInt sentMessages;
+    QAtomicInt lateMessages;
+    QAtomicInt droppedMessages;
+    QAtomicInteger<qint64> maxJitter;
+
+    void run();
+    void send(ClockMessage message);
+    void waitUntil(qint64 time);
+
+    static const quint32 QUEUE_SIZE;
+    static const qint64 SPIN_TIME;      // the thread sleeps until SPIN_TIME before the message time, and yields after this point
+    static const qint64 MAX_SLEEP_TIME; // the sleeping thread wakes up periodically to check the stop flag
+    static const qint64 LATE_THRESHOLD;
+};
+
+inline bool MidiClockScheduler::isRunning() const
+{
+    return running.load() != 0;
+}
+
+} // namespace
+
+#endif // MIDI_CLOCK_SCHEDULER_H
@@ -4,8 +4,62 @@
 
 using midi::MidiDriver;
 
-MidiDriver::MidiDriver()
+const qint64 MidiDriver::MAX_CLOCK_DRIFT = 20000000; // 20 ms
+
+MidiDriver::MidiDriver() :
+    sampleClockOrigin(0),
+    outputLatency(0),
+    sampleClockRate(0)
+{
+    clockTimer.start();
+}
+
+void MidiDriver::updateSampleClock(quint64 samplePosition, int sampleRate, double outputLatency)
+{
+    if (sampleRate <= 0)
+        return;
+
+    // the audio callbacks are not called in precise intervals, so the measured origin is smoothed. Only the slow drift
+    // between the audio clock and the system clock is followed. A single value is published, so the midi threads never
+    // read a position and a time from different callbacks.
+    const qint64 blockStart = static_cast<qint64>(samplePosition * 1000000000.0 / sampleRate);
+    const qint64 measuredOrigin = clockTimer.nsecsElapsed() - blockStart;
+    const qint64 currentOrigin = sampleClockOrigin.loadAcquire();
+    const qint64 error = measuredOrigin - currentOrigin;
+    if (sampleClockRate.loadAcquire() != sampleRate || qAbs(error) > MAX_CLOCK_DRIFT)
+        sampleClockOrigin.storeRelease(measuredOrigin); // starting or restarting the audio stream
+    else
+        sampleClockOrigin.storeRelease(currentOrigin + error / 16);
+
+    this->outputLatency.storeRelease(static_cast<qint64>(outputLatency * 1000000000.0));
+    sampleClockRate.storeRelease(sampleRate);
+}
+
+qint64 MidiDriver::getClockTime() const
 {
+    return clockTimer.nsecsElapsed();
+}
+
+qint64 MidiDriver::getSampleClockTime(quint64 samplePosition) const
+{
+    const int sampleRate = sampleClockRate.loadAcquire();
+    if (sampleRate <= 0)
+        return getClockTime(); // the audio driver is not running, just 'now'
+
+    return sampleClockOrigin.loadAcquire() + static_cast<qint64>(samplePosition * 1000000000.0 / sampleRate) + outputLatency.loadAcquire();
+}
+
+quint64 MidiDriver::getSampleClockPosition() const
+{
+    const int sampleRate = sampleClockRate.loadAcquire();
+    if (sampleRate <= 0)
+        return 0; // the audio driver is not running
+
+    const qint64 elapsed = clockTimer.nsecsElapsed() - sampleClockOrigin.loadAcquire();
+    if (elapsed <= 0)
+        return 0;
+
+    return static_cast<quint64>(elapsed / 1000000000.0 * sampleRate);
 }
 
 MidiDriver::~MidiDriver()
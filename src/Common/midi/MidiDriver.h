@@ -3,6 +3,8 @@
 
 #include <QtGlobal>
 #include <QMap>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
 
 #include "MidiMessage.h"
 
@@ -31,7 +33,12 @@ public:
     virtual QString getInputDeviceName(uint index) const = 0;
     virtual QString getOutputDeviceName(uint index) const = 0;
 
-    virtual std::vector<MidiMessage> getBuffer() = 0;
+    virtual void getBuffer(std::vector<MidiMessage> &buffer) = 0; // called in audio thread, the messages are appended in a preallocated buffer until its capacity
+
+    void updateSampleClock(quint64 samplePosition, int sampleRate, double outputLatency = 0.0); // called in audio thread in each audio callback, latency in seconds
+    quint64 getSampleClockPosition() const; // the current sample clock position, used to timestamp the incoming messages
+    qint64 getSampleClockTime(quint64 samplePosition) const; // the time (see getClockTime) when a sample will be heard, used to schedule the outgoing messages
+    qint64 getClockTime() const; // nanoseconds, monotonic
 
     virtual bool inputDeviceIsGloballyEnabled(int deviceIndex) const;
     virtual bool outputDeviceIsGloballyEnabled(int deviceIndex) const;
@@ -47,6 +54,14 @@ protected:
     QList<bool> inputDevicesEnabledStatuses; // store the globally enabled midi input devices
     QList<bool> outputDevicesEnabledStatuses; // store the globally enabled midi output devices
 
+private:
+    QElapsedTimer clockTimer;
+    QAtomicInteger<qint64> sampleClockOrigin; // the elapsed time (in nanoseconds) where the sample clock was zero
+    QAtomicInteger<qint64> outputLatency; // nanoseconds
+    QAtomicInt sampleClockRate;
+
+    static const qint64 MAX_CLOCK_DRIFT; // bigger errors are not smoothed, the clock is just restarted
+
 };
 
 class NullMidiDriver : public MidiDriver
@@ -97,9 +112,9 @@ class NullMidiDriver : public MidiDriver
         return "";
     }
 
-    inline std::vector<MidiMessage> getBuffer() override
+    inline void getBuffer(std::vector<MidiMessage> &buffer) override
     {
-        return std::vector<MidiMessage>();
+        Q_UNUSED(buffer)
     }
 
     void sendClockStart() const override
@@ -6,7 +6,9 @@ using midi::MidiMessage;
 
 MidiMessage::MidiMessage(qint32 data, int sourceID) :
     data(data),
-    sourceID(sourceID)
+    sourceID(sourceID),
+    timestamp(0),
+    sampleOffset(0)
 {
 
 }
@@ -17,7 +19,7 @@ MidiMessage::MidiMessage() :
 
 }
 
-MidiMessage MidiMessage::fromVector(std::vector<unsigned char> vector, qint32 deviceIndex)
+MidiMessage MidiMessage::fromVector(const std::vector<unsigned char> &vector, qint32 deviceIndex)
 {
     int msgData = 0;
     msgData |= vector.at(0);
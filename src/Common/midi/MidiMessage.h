@@ -13,7 +13,7 @@ public:
     MidiMessage(qint32 data, int sourceID);
     MidiMessage();
 
-    static MidiMessage fromVector(std::vector<unsigned char> vector, qint32 sourceID);
+    static MidiMessage fromVector(const std::vector<unsigned char> &vector, qint32 sourceID);
     static MidiMessage fromArray(const char array[4], qint32 sourceID=-1);
 
     int getChannel() const;
@@ -36,11 +36,39 @@ public:
 
     bool isControl() const;
 
+    quint64 getTimestamp() const;
+    void setTimestamp(quint64 timestamp);
+
+    quint32 getSampleOffset() const;
+    void setSampleOffset(quint32 offset);
+
 private:
     qint32 data;
     int sourceID; // the id of the midi device generating the message.
+    quint64 timestamp; // position in the audio driver sample clock when the message was received, zero for 'now'
+    quint32 sampleOffset; // position inside the current audio block, computed in the audio thread
 };
 
+inline quint64 MidiMessage::getTimestamp() const
+{
+    return timestamp;
+}
+
+inline void MidiMessage::setTimestamp(quint64 timestamp)
+{
+    this->timestamp = timestamp;
+}
+
+inline quint32 MidiMessage::getSampleOffset() const
+{
+    return sampleOffset;
+}
+
+inline void MidiMessage::setSampleOffset(quint32 offset)
+{
+    sampleOffset = offset;
+}
+
 inline int MidiMessage::getChannel() const
 {
     return data & 0x0000000F;
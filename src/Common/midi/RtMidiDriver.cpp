@@ -7,7 +7,20 @@
 using midi::RtMidiDriver;
 using midi::MidiMessage;
 
-RtMidiDriver::RtMidiDriver(const QList<bool> &inputDeviceStatuses, const QList<bool> &outputDeviceStatuses){
+const quint32 RtMidiDriver::INPUT_QUEUE_SIZE = 1024;
+
+RtMidiDriver::InputQueue::InputQueue(RtMidiDriver *driver, int deviceIndex) :
+    driver(driver),
+    deviceIndex(deviceIndex),
+    receiving(false),
+    messages(INPUT_QUEUE_SIZE)
+{
+
+}
+
+RtMidiDriver::RtMidiDriver(const QList<bool> &inputDeviceStatuses, const QList<bool> &outputDeviceStatuses) :
+    droppedMessages(0)
+{
 
     qCDebug(jtMidi) << "Initializing rtmidi...";
 
@@ -67,6 +80,7 @@ void RtMidiDriver::setDevicesStatus(const QList<bool> &inputStatuses, const QLis
 
     for (int s = 0; s < validInputStatuses.size(); ++s) {
         midiInStreams.append(new RtMidiIn());
+        inputQueues.append(new InputQueue(this, s));
     }
     for (int s = 0; s < validOutputStatuses.size(); ++s) {
         midiOutStreams.append(new RtMidiOut());
@@ -91,6 +105,11 @@ void RtMidiDriver::start(const QList<bool> &inputDeviceStatuses, const QList<boo
                     try {
                         qCInfo(jtMidi) << "Starting MIDI Input in " << QString::fromStdString(stream->getPortName(deviceIndex));
                         stream->ignoreTypes();// ignoring sysex, miditime and midi sense messages
+                        InputQueue *queue = inputQueues.at(deviceIndex);
+                        if (!queue->receiving) {
+                            stream->setCallback(&RtMidiDriver::handleIncommingMessage, queue);
+                            queue->receiving = true;
+                        }
                         stream->openPort(deviceIndex);
                     }
                     catch (RtMidiError &e) {
@@ -147,11 +166,14 @@ void RtMidiDriver::release(){
 
     qCDebug(jtMidi) << "Releasing RtMidiDriver";
 
-    foreach (RtMidiIn* stream, midiInStreams) {
+    for (int i = 0; i < midiInStreams.size(); ++i) {
+        RtMidiIn *stream = midiInStreams.at(i);
         if (stream) {
             if (stream->isPortOpen()) {
                 stream->closePort();
             }
+            if (inputQueues.at(i)->receiving)
+                stream->cancelCallback();
             delete stream;
         }
     }
@@ -165,6 +187,13 @@ void RtMidiDriver::release(){
     }
     midiInStreams.clear();
     midiOutStreams.clear();
+
+    qDeleteAll(inputQueues);
+    inputQueues.clear();
+
+    if (droppedMessages.load() > 0)
+        qCWarning(jtMidi) << droppedMessages.load() << " midi messages discarded, the input queues or the audio thread buffer are full!";
+    droppedMessages.store(0);
 }
 
 QString RtMidiDriver::getInputDeviceName(uint index) const{
@@ -197,22 +226,20 @@ void RtMidiDriver::sendClockPulse() const{
     sendMessageToOutputs({248});
 }
 
-void RtMidiDriver::consumeMessagesFromStream(RtMidiIn *stream, int deviceIndex, std::vector<midi::MidiMessage> &outBuffer)
+void RtMidiDriver::handleIncommingMessage(double deltaTime, std::vector<unsigned char> *message, void *userData)
 {
-    //qCDebug(jtMidi) << "consuming messages from stream - RtMidiDriver";
-    std::vector<unsigned char> messageBytes;
-    do {
-        messageBytes.clear();
-        stream->getMessage(&messageBytes);
-        if (messageBytes.size() == 3) { // Jamtaba is handling only the 3 bytes common midi messages. Uncommon midi messages will be ignored.
-            outBuffer.push_back(midi::MidiMessage::fromVector(messageBytes, deviceIndex));
-        }
-        else {
-            if (!messageBytes.empty())
-                qWarning() << "A midi message containing " << messageBytes.size() << " bytes was received!";
-        }
+    Q_UNUSED(deltaTime) // the sample clock is used instead the RtMidi time, so the messages are in the same time base of the audio
+
+    InputQueue *queue = static_cast<InputQueue *>(userData);
+    if (!queue || !message)
+        return;
+
+    if (message->size() == 3) { // Jamtaba is handling only the 3 bytes common midi messages. Uncommon midi messages will be ignored.
+        MidiMessage midiMessage = MidiMessage::fromVector(*message, queue->deviceIndex);
+        midiMessage.setTimestamp(queue->driver->getSampleClockPosition());
+        if (!queue->messages.write(&midiMessage, 1))
+            queue->driver->droppedMessages.fetchAndAddRelaxed(1);
     }
-    while (!messageBytes.empty());
 }
 
 void RtMidiDriver::sendMessageToOutputs(const std::vector<unsigned char> message) const {
@@ -227,15 +254,18 @@ void RtMidiDriver::sendMessageToOutputs(const std::vector<unsigned char> message
     }
 }
 
-std::vector<MidiMessage> RtMidiDriver::getBuffer()
+void RtMidiDriver::getBuffer(std::vector<MidiMessage> &buffer)
 {
-    std::vector<midi::MidiMessage> buffer;
-    int deviceIndex = 0;
-    for (auto stream : midiInStreams) {
-        consumeMessagesFromStream(stream, deviceIndex, buffer);
-        deviceIndex++;
+    // the buffer is not growing in the audio thread, the messages exceeding the preallocated capacity are discarded
+    MidiMessage message;
+    for (auto queue : inputQueues) {
+        while (queue->messages.read(&message, 1)) {
+            if (buffer.size() < buffer.capacity())
+                buffer.push_back(message);
+            else
+                droppedMessages.fetchAndAddRelaxed(1);
+        }
     }
-    return buffer;
 }
 
 bool RtMidiDriver::hasInputDevices() const{
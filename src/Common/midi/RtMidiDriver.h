@@ -3,6 +3,9 @@
 
 #include "MidiDriver.h"
 #include "RtMidi.h"
+#include "audio/core/RingBuffer.h"
+
+#include <QAtomicInt>
 
 namespace midi {
 
@@ -24,7 +27,7 @@ public:
     int getMaxOutputDevices() const override;
     QString getInputDeviceName(uint index) const override;
     QString getOutputDeviceName(uint index) const override;
-    std::vector<midi::MidiMessage> getBuffer() override;
+    void getBuffer(std::vector<midi::MidiMessage> &buffer) override;
 
     void sendClockStart() const override;
     void sendClockStop() const override;
@@ -32,10 +35,30 @@ public:
     void sendClockPulse() const override;
 
 private:
+
+    /**
+        Each input device has your own lock free queue, the messages are received (and timestamped) in
+        the RtMidi callback thread and consumed in the audio thread.
+     */
+    struct InputQueue
+    {
+        InputQueue(RtMidiDriver *driver, int deviceIndex);
+
+        RtMidiDriver *driver;
+        int deviceIndex;
+        bool receiving; // the RtMidi callback is installed
+        audio::RingBuffer<MidiMessage> messages;
+    };
+
     QList<RtMidiIn *> midiInStreams;
     QList<RtMidiOut *> midiOutStreams;
+    QList<InputQueue *> inputQueues;
+
+    QAtomicInt droppedMessages; // messages discarded because a queue or the audio thread buffer was full
+
+    static const quint32 INPUT_QUEUE_SIZE;
 
-    void consumeMessagesFromStream(RtMidiIn *stream, int deviceIndex, std::vector<MidiMessage> &outBuffer);
+    static void handleIncommingMessage(double deltaTime, std::vector<unsigned char> *message, void *userData); // called in RtMidi thread
     void sendMessageToOutputs(const std::vector<unsigned char> message) const;
 };
 }
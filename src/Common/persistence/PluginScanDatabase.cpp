@@ -0,0 +1,130 @@
+#include "PluginScanDatabase.h"
+#include "CacheHeader.h"
+#include "log/Logging.h"
+
+#include <QFile>
+#include <QDataStream>
+#include <QDateTime>
+
+using persistence::PluginScanDatabase;
+
+/**
+   - First version in revision 1
+*/
+const quint32 PluginScanDatabase::REVISION = 1;
+
+namespace persistence {
+
+QDataStream &operator<<(QDataStream &stream, const PluginScanDatabase::Entry &entry)
+{
+    return stream << entry.size << entry.lastModified << entry.result;
+}
+
+QDataStream &operator>>(QDataStream &stream, PluginScanDatabase::Entry &entry)
+{
+    return stream >> entry.size >> entry.lastModified >> entry.result;
+}
+
+} // namespace
+
+PluginScanDatabase::PluginScanDatabase(const QString &databaseFilePath) :
+    databaseFilePath(databaseFilePath),
+    modified(false)
+{
+    load();
+}
+
+PluginScanDatabase::~PluginScanDatabase()
+{
+    if (modified)
+        save();
+}
+
+PluginScanDatabase::ScanResult PluginScanDatabase::getScanResult(const QFileInfo &pluginFile) const
+{
+    auto it = entries.constFind(pluginFile.absoluteFilePath());
+    if (it == entries.constEnd())
+        return NotScanned;
+
+    if (it->size != pluginFile.size() || it->lastModified != pluginFile.lastModified().toMSecsSinceEpoch())
+        return NotScanned; // plugin updated
+
+    return static_cast<ScanResult>(it->result);
+}
+
+void PluginScanDatabase::setScanResult(const QFileInfo &pluginFile, ScanResult result)
+{
+    if (result == NotScanned) {
+        modified |= entries.remove(pluginFile.absoluteFilePath()) > 0;
+        return;
+    }
+
+    Entry entry;
+    entry.size = pluginFile.size();
+    entry.lastModified = pluginFile.lastModified().toMSecsSinceEpoch();
+    entry.result = result;
+
+    entries.insert(pluginFile.absoluteFilePath(), entry);
+    modified = true;
+}
+
+void PluginScanDatabase::removeInvalidPlugins()
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->result == InvalidPlugin) {
+            it = entries.erase(it);
+            modified = true;
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void PluginScanDatabase::clear()
+{
+    modified |= !entries.isEmpty();
+    entries.clear();
+}
+
+void PluginScanDatabase::load()
+{
+    QFile file(databaseFilePath);
+    if (!file.open(QFile::ReadOnly))
+        return; // first scan
+
+    QDataStream stream(&file);
+
+    CacheHeader cacheHeader;
+    stream >> cacheHeader;
+    if (!cacheHeader.isValid(REVISION)) {
+        qCritical() << "Invalid cache header when loading the plugins scan database.";
+        return;
+    }
+
+    stream >> entries;
+
+    if (stream.status() != QDataStream::Ok) {
+        qCritical() << "Error loading the plugins scan database" << databaseFilePath;
+        entries.clear();
+    }
+
+    qCDebug(jtStandalonePluginFinder) << "Plugins scan database loaded," << entries.size() << "entries";
+}
+
+bool PluginScanDatabase::save()
+{
+    QFile file(databaseFilePath);
+    if (!file.open(QFile::WriteOnly)) {
+        qCritical() << "Can't open the plugins scan database file in" << databaseFilePath << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << CacheHeader(REVISION);
+    stream << entries;
+
+    modified = false;
+
+    return stream.status() == QDataStream::Ok;
+}
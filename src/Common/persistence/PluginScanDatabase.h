@@ -0,0 +1,71 @@
+#ifndef PLUGIN_SCAN_DATABASE_H
+#define PLUGIN_SCAN_DATABASE_H
+
+#include <QString>
+#include <QHash>
+#include <QFileInfo>
+
+class QDataStream;
+
+/**
+
+  Remember the plugin scan results between JamTaba sessions. The results are keyed by the plugin
+  path, file size and modification time, so only new or modified plugin files are loaded by the
+  plugin scanner processes.
+
+ */
+
+namespace persistence {
+
+class PluginScanDatabase
+{
+
+public:
+    enum ScanResult
+    {
+        NotScanned, // new plugin, or the plugin file was modified after the last scan
+        ValidPlugin,
+        InvalidPlugin
+    };
+
+    explicit PluginScanDatabase(const QString &databaseFilePath);
+    ~PluginScanDatabase();
+
+    ScanResult getScanResult(const QFileInfo &pluginFile) const;
+    void setScanResult(const QFileInfo &pluginFile, ScanResult result);
+
+    void removeInvalidPlugins(); // invalid plugins are scanned again, maybe some dependency was installed after the last scan
+    void clear();
+
+    int getSize() const;
+
+    bool save(); // the database is saved in destructor too
+
+private:
+    struct Entry
+    {
+        qint64 size;
+        qint64 lastModified; // msecs since epoch
+        quint8 result;
+    };
+
+    friend QDataStream &operator<<(QDataStream &stream, const Entry &entry);
+    friend QDataStream &operator>>(QDataStream &stream, Entry &entry);
+
+    void load();
+
+    QHash<QString, Entry> entries; // plugin path as key
+    QString databaseFilePath;
+    bool modified;
+
+    static const quint32 REVISION;
+};
+
+inline int PluginScanDatabase::getSize() const
+{
+    return entries.size();
+}
+
+} // namespace
+
+#endif // PLUGIN_SCAN_DATABASE_H
@@ -98,7 +98,8 @@ LooperSettings::LooperSettings() :
     preferredMode(0),
     loopsFolder(""),
     encodingAudioWhenSaving(false),
-    waveFilesBitDepth(16) // 16 bits
+    waveFilesBitDepth(16), // 16 bits
+    compactLockedLayers(false)
 {
     qCDebug(jtSettings) << "LooperSettings ctor";
     setDefaultLooperFilesPath();
@@ -111,6 +112,7 @@ void LooperSettings::read(const QJsonObject &in)
     loopsFolder = getValueFromJson(in, "loopsFolder", QString());
     encodingAudioWhenSaving = getValueFromJson(in, "encodeAudio", false);
     waveFilesBitDepth = getValueFromJson(in, "bitDepth", quint8(16)); // 16 bit as default value
+    compactLockedLayers = getValueFromJson(in, "compactLockedLayers", false);
 
     if (!(waveFilesBitDepth == 16 || waveFilesBitDepth == 32)) {
         qWarning() << "Invalid bit depth " << waveFilesBitDepth << ", using 16 bits as default value";
@@ -143,7 +145,8 @@ void LooperSettings::read(const QJsonObject &in)
                     << "; loopsFolder " << loopsFolder
                     << " (useDefaultSavePath " << useDefaultSavePath << ")"
                     << "; encodingAudioWhenSaving " << encodingAudioWhenSaving
-                    << "; waveFilesBitDepth " << waveFilesBitDepth;
+                    << "; waveFilesBitDepth " << waveFilesBitDepth
+                    << "; compactLockedLayers " << compactLockedLayers;
 
 }
 
@@ -169,6 +172,7 @@ void LooperSettings::write(QJsonObject &out) const
     out["preferredMode"] = preferredMode;
     out["loopsFolder"] = loopsFolder;
     out["encodeAudio"] = encodingAudioWhenSaving;
+    out["compactLockedLayers"] = compactLockedLayers;
 
     if (!encodingAudioWhenSaving)
         out["bitDepth"] = waveFilesBitDepth;
@@ -571,7 +575,8 @@ void WindowSettings::write(QJsonObject &out) const
 // +++++++++++++++++++++++++++++++++++++++
 
 VstSettings::VstSettings() :
-    SettingsObject("VST")
+    SettingsObject("VST"),
+    bridgedPlugins(false)
 {
     qCDebug(jtSettings) << "VstSettings ctor";
 }
@@ -598,6 +603,7 @@ void VstSettings::write(QJsonObject &out) const
         BlackedArray.append(blackVst);
 
     out["BlackListPlugins"] = BlackedArray;
+    out["bridgedPlugins"] = bridgedPlugins;
 }
 
 void VstSettings::read(const QJsonObject &in)
@@ -625,6 +631,8 @@ void VstSettings::read(const QJsonObject &in)
             blackedPlugins.append(cacheArray.at(x).toString());
     }
 
+    bridgedPlugins = getValueFromJson(in, "bridgedPlugins", false);
+
     qCDebug(jtSettings) << "VstSettings: foldersToScan " << foldersToScan
                         << "; cachedPlugins " << cachedPlugins
                         << "; blackedPlugins " << blackedPlugins;
@@ -852,6 +860,8 @@ void LocalInputTrackSettings::read(const QJsonObject &in, bool allowSubchannels)
                             bool pathIsValid = !plugin.path.isEmpty();
                             if (plugin.category == audio::PluginDescriptor::VST_Plugin)
                                 pathIsValid = QFile(plugin.path).exists();
+                            else if (plugin.category == audio::PluginDescriptor::Native_Plugin)
+                                pathIsValid = true; // built-in plugins have no path
 
                             if (pathIsValid)
                                 plugins.append(plugin);
@@ -956,6 +966,16 @@ QStringList Settings::getBlackListedPlugins() const
     return vstSettings.blackedPlugins;
 }
 
+void Settings::setVstPluginsBridged(bool bridged)
+{
+    vstSettings.bridgedPlugins = bridged;
+}
+
+bool Settings::isVstPluginsBridged() const
+{
+    return vstSettings.bridgedPlugins;
+}
+
 // ++++++++++++++++++
 
 #ifdef Q_OS_MAC
@@ -1368,6 +1388,12 @@ void Settings::setRemoteUserRememberingSettings(bool boost, bool level, bool pan
     rememberSettings.rememberMute    = mute;
 }
 
+void Settings::setRemoteAutoGain(bool enabled)
+{
+    qCDebug(jtSettings) << "Settings setRemoteAutoGain: from " << rememberSettings.remoteAutoGain << " to " << enabled;
+    rememberSettings.remoteAutoGain = enabled;
+}
+
 void Settings::setCollapsileSectionsRememberingSettings(bool localChannels, bool bottomSection, bool chatSection)
 {
     qCDebug(jtSettings) << "Settings setCollapsileSectionsRememberingSettings: localChannels from " << rememberSettings.rememberLocalChannels << " to " << localChannels
@@ -1421,6 +1447,7 @@ RememberSettings::RememberSettings() :
     rememberPan(true),
     rememberMute(true),
     rememberLowCut(true),
+    remoteAutoGain(true),
     rememberLocalChannels(true),
     rememberBottomSection(true),
     rememberChatSection(true)
@@ -1436,6 +1463,7 @@ void RememberSettings::write(QJsonObject &out) const
     out["pan"] = rememberPan;
     out["mute"] = rememberMute;
     out["lowCut"] = rememberLowCut;
+    out["autoGain"] = remoteAutoGain;
 
     out["localChannels"] = rememberLocalChannels;
     out["bottomSection"] = rememberBottomSection;
@@ -1449,6 +1477,7 @@ void RememberSettings::read(const QJsonObject &in)
     rememberPan = getValueFromJson(in, "pan", true);
     rememberMute = getValueFromJson(in, "mute", true);
     rememberLowCut = getValueFromJson(in, "lowCut", true);
+    remoteAutoGain = getValueFromJson(in, "autoGain", true);
 
     rememberLocalChannels = getValueFromJson(in, "localChannels", true);
     rememberBottomSection = getValueFromJson(in, "bottomSection", false);
@@ -1458,6 +1487,7 @@ void RememberSettings::read(const QJsonObject &in)
                         << "; rememberLevel " << rememberLevel
                         << "; rememberPan " << rememberPan
                         << "; rememberMute " << rememberMute
+                        << "; remoteAutoGain " << remoteAutoGain
                         << "; rememberLocalChannels " << rememberLocalChannels
                         << "; rememberBottomSection " << rememberBottomSection
                         << "; rememberChatSection " << rememberChatSection;
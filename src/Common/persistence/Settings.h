@@ -156,6 +156,7 @@ public:
     QStringList cachedPlugins;
     QStringList foldersToScan;
     QStringList blackedPlugins; // vst in blackbox....
+    bool bridgedPlugins; // VST plugins running in PluginBridge processes, a crashing plugin will not crash Jamtaba
 };
 
 class AudioUnitSettings  : public SettingsObject
@@ -227,6 +228,7 @@ public:
     QString loopsFolder; // where looper audio files will be saved
     bool encodingAudioWhenSaving;
     quint8 waveFilesBitDepth;
+    bool compactLockedLayers; // locked layers are stored using less memory
 
 private:
     void setDefaultLooperFilesPath();
@@ -391,6 +393,7 @@ public:
     bool rememberLevel; // fader
     bool rememberMute;
     bool rememberLowCut;
+    bool remoteAutoGain; // remote users loudness normalization
 
     // collapsible section settings
     bool rememberLocalChannels; // local channels are collapsed?
@@ -521,6 +524,9 @@ public:
     void removeVstScanPath(const QString &path);
     QStringList getVstScanFolders() const;
 
+    void setVstPluginsBridged(bool bridged);
+    bool isVstPluginsBridged() const;
+
     QStringList getRecentEmojis() const;
     void setRecentEmojis(const QStringList &emojis);
 
@@ -591,12 +597,14 @@ public:
     bool getLooperAudioEncodingFlag() const;
     QString getLooperFolder() const;
     quint8 getLooperBitDepth() const;
+    bool getLooperCompactLockedLayersFlag() const;
 
     void setLooperPreferredLayersCount(quint8 layersCount);
     void setLooperPreferredMode(quint8 looperMode);
     void setLooperAudioEncodingFlag(bool encodeAudioWhenSaving);
     void setLooperFolder(const QString &folder);
     void setLooperBitDepth(quint8 bitDepth);
+    void setLooperCompactLockedLayersFlag(bool compact);
 
     // Remember settings
     void setRemoteUserRememberingSettings(bool boost, bool level, bool pan, bool mute, bool lowCut);
@@ -606,6 +614,8 @@ public:
     bool isRememberingPan() const;
     bool isRememberingMute() const;
     bool isRememberingLowCut() const;
+    void setRemoteAutoGain(bool enabled);
+    bool isRemoteAutoGainEnabled() const;
 
     // remembering collapsible sections
     bool isRememberingLocalChannels() const;
@@ -715,6 +725,11 @@ inline bool Settings::isRememberingLowCut() const
     return rememberSettings.rememberLowCut;
 }
 
+inline bool Settings::isRemoteAutoGainEnabled() const
+{
+    return rememberSettings.remoteAutoGain;
+}
+
 inline bool Settings::isRememberingBoost() const
 {
     return rememberSettings.rememberBoost;
@@ -742,6 +757,11 @@ inline quint8 Settings::getLooperBitDepth() const
     return looperSettings.waveFilesBitDepth;
 }
 
+inline void Settings::setLooperCompactLockedLayersFlag(bool compact)
+{
+    looperSettings.compactLockedLayers = compact;
+}
+
 inline QString Settings::getLooperFolder() const
 {
     return looperSettings.loopsFolder;
@@ -752,6 +772,11 @@ inline void Settings::setLooperFolder(const QString &folder)
     looperSettings.loopsFolder = folder;
 }
 
+inline bool Settings::getLooperCompactLockedLayersFlag() const
+{
+    return looperSettings.compactLockedLayers;
+}
+
 inline bool Settings::getLooperAudioEncodingFlag() const
 {
     return looperSettings.encodingAudioWhenSaving;
@@ -0,0 +1,318 @@
+#include "SoundCache.h"
+#include "CacheHeader.h"
+#include "log/Logging.h"
+#include "file/FileReaderFactory.h"
+#include "file/FileReader.h"
+#include "audio/Resampler.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QSysInfo>
+
+using persistence::SoundCache;
+using audio::SamplesBuffer;
+
+/**
+   - First version in revision 1
+*/
+const quint32 SoundCache::REVISION = 1;
+const quint8 SoundCache::RESAMPLER_QUALITY = 1; // SimpleResampler
+const int SoundCache::MEMORY_CACHE_SIZE = 64 * 1024; // 64 MB
+const int SoundCache::SMALL_SOUNDS_MEMORY_CACHE_SIZE = 8 * 1024; // 8 MB
+const qint64 SoundCache::DISK_CACHE_SIZE = 256 * 1024 * 1024; // 256 MB
+const qint64 SoundCache::SMALL_SOUNDS_DISK_CACHE_SIZE = 16 * 1024 * 1024; // 16 MB
+const qint64 SoundCache::SMALL_SOUND_SIZE = 1024 * 1024; // 1 MB, more than 2 seconds in 48 KHz stereo
+const QString SoundCache::FILE_SUFFIX(".snd");
+
+QScopedPointer<SoundCache> SoundCache::instance;
+
+SoundCache *SoundCache::getInstance()
+{
+    if (!instance)
+        instance.reset(new SoundCache());
+    return instance.data();
+}
+
+SoundCache::SoundCache() :
+    usingDiskCache(false)
+{
+    memoryCache.setMaxCost(MEMORY_CACHE_SIZE);
+    smallSoundsMemoryCache.setMaxCost(SMALL_SOUNDS_MEMORY_CACHE_SIZE);
+}
+
+void SoundCache::setCacheDir(const QDir &cacheDir)
+{
+    const bool dirCreated = cacheDir.mkpath(".");
+    if (!dirCreated)
+        qCritical() << "Can't create the sounds cache dir" << cacheDir.absolutePath();
+
+    {
+        QMutexLocker locker(&mutex);
+        this->cacheDir = cacheDir;
+        usingDiskCache = dirCreated;
+    }
+
+    if (dirCreated)
+        pruneDiskCache(cacheDir);
+}
+
+bool SoundCache::getDiskCacheDir(QDir &dir)
+{
+    QMutexLocker locker(&mutex);
+
+    dir = cacheDir;
+    return usingDiskCache;
+}
+
+void SoundCache::clearMemoryCache()
+{
+    QMutexLocker locker(&mutex);
+
+    memoryCache.clear();
+    smallSoundsMemoryCache.clear();
+    fileHashes.clear();
+}
+
+bool SoundCache::load(const QString &filePath, quint32 sampleRate, SamplesBuffer &out)
+{
+    const QByteArray fileHash = getFileHash(filePath);
+    if (fileHash.isEmpty()) {
+        out.setFrameLenght(0);
+        return false;
+    }
+
+    const QString key = buildKey(fileHash, sampleRate);
+
+    {
+        QMutexLocker locker(&mutex);
+        const SamplesBuffer *cachedBuffer = memoryCache.object(key);
+        if (!cachedBuffer)
+            cachedBuffer = smallSoundsMemoryCache.object(key);
+
+        if (cachedBuffer) {
+            copy(*cachedBuffer, out);
+            return true;
+        }
+    }
+
+    // the disk I/O is not blocking the other threads loading sounds
+    QDir diskCacheDir;
+    const bool diskCacheEnabled = getDiskCacheDir(diskCacheDir);
+
+    SamplesBuffer *buffer = new SamplesBuffer(2);
+    if (diskCacheEnabled && loadFromDisk(diskCacheDir, key, *buffer)) {
+        qCDebug(jtCache) << "Sound loaded from disk cache:" << filePath;
+        touch(diskCacheDir.absoluteFilePath(key + FILE_SUFFIX)); // the least recently used files are pruned
+    }
+    else {
+        if (!decode(filePath, sampleRate, *buffer)) {
+            delete buffer;
+            out.setFrameLenght(0);
+            return false;
+        }
+
+        if (diskCacheEnabled) {
+            saveToDisk(diskCacheDir, key, *buffer);
+            pruneDiskCache(diskCacheDir);
+        }
+    }
+
+    copy(*buffer, out);
+
+    const qint64 bytes = static_cast<qint64>(buffer->getChannels()) * buffer->getFrameLenght() * sizeof(float);
+    const int cost = static_cast<int>(bytes / 1024) + 1;
+
+    QMutexLocker locker(&mutex);
+    if (bytes <= SMALL_SOUND_SIZE)
+        smallSoundsMemoryCache.insert(key, buffer, cost); // QCache take the buffer ownership
+    else
+        memoryCache.insert(key, buffer, cost);
+
+    return true;
+}
+
+QByteArray SoundCache::getFileHash(const QString &filePath)
+{
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists()) {
+        qCritical() << "Can't load sound, file not found:" << filePath;
+        return QByteArray();
+    }
+
+    const QString absolutePath = fileInfo.absoluteFilePath();
+    const qint64 size = fileInfo.size();
+    const QDateTime lastModified = fileInfo.lastModified(); // invalid for files in resources, they never change
+
+    {
+        QMutexLocker locker(&mutex);
+        auto it = fileHashes.constFind(absolutePath);
+        if (it != fileHashes.constEnd() && it->size == size && it->lastModified == lastModified)
+            return it->hash;
+    }
+
+    QFile file(absolutePath);
+    if (!file.open(QFile::ReadOnly)) {
+        qCritical() << "Can't load sound, error opening" << filePath << file.errorString();
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return QByteArray();
+
+    FileHash fileHash;
+    fileHash.size = size;
+    fileHash.lastModified = lastModified;
+    fileHash.hash = hash.result();
+
+    QMutexLocker locker(&mutex);
+    fileHashes.insert(absolutePath, fileHash);
+
+    return fileHash.hash;
+}
+
+QString SoundCache::buildKey(const QByteArray &fileHash, quint32 sampleRate) const
+{
+    return QString("%1_%2_%3")
+            .arg(QString::fromLatin1(fileHash.toHex()))
+            .arg(sampleRate)
+            .arg(RESAMPLER_QUALITY);
+}
+
+bool SoundCache::decode(const QString &filePath, quint32 sampleRate, SamplesBuffer &out)
+{
+    std::unique_ptr<audio::FileReader> reader = audio::FileReaderFactory::createFileReader(filePath);
+    quint32 fileSampleRate = 0; // will be changed inside reader->read
+    SamplesBuffer fileBuffer(2);
+    if (!reader->read(filePath, fileBuffer, fileSampleRate) || fileBuffer.isEmpty())
+        return false;
+
+    const int channels = fileBuffer.getChannels();
+    if (channels > 1)
+        out.setToStereo();
+    else
+        out.setToMono();
+
+    if (fileSampleRate == 0 || fileSampleRate == sampleRate) {
+        out.setFrameLenght(fileBuffer.getFrameLenght());
+        out.set(fileBuffer);
+        return true;
+    }
+
+    const int finalSize = static_cast<double>(sampleRate)/fileSampleRate * fileBuffer.getFrameLenght();
+    out.setFrameLenght(finalSize);
+    for (int c = 0; c < channels; ++c) {
+        SimpleResampler resampler;
+        resampler.process(fileBuffer.getSamplesArray(c), fileBuffer.getFrameLenght(), out.getSamplesArray(c), finalSize);
+    }
+
+    return true;
+}
+
+bool SoundCache::loadFromDisk(const QDir &cacheDir, const QString &key, SamplesBuffer &out)
+{
+    QFile file(cacheDir.absoluteFilePath(key + FILE_SUFFIX));
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+
+    CacheHeader cacheHeader;
+    quint8 byteOrder;
+    quint8 channels;
+    quint32 frames;
+    stream >> cacheHeader >> byteOrder >> channels >> frames;
+
+    if (!cacheHeader.isValid(REVISION) || byteOrder != QSysInfo::ByteOrder || channels < 1 || channels > 2) {
+        qCWarning(jtCache) << "Invalid sound cache file" << file.fileName();
+        return false;
+    }
+
+    const int channelBytes = frames * sizeof(float);
+    if (file.bytesAvailable() != static_cast<qint64>(channelBytes) * channels) {
+        qCWarning(jtCache) << "Truncated sound cache file" << file.fileName();
+        return false;
+    }
+
+    if (channels > 1)
+        out.setToStereo();
+    else
+        out.setToMono();
+
+    out.setFrameLenght(frames);
+    for (int c = 0; c < channels; ++c) {
+        if (stream.readRawData(reinterpret_cast<char *>(out.getSamplesArray(c)), channelBytes) != channelBytes)
+            return false;
+    }
+
+    return true;
+}
+
+void SoundCache::saveToDisk(const QDir &cacheDir, const QString &key, const SamplesBuffer &buffer)
+{
+    QSaveFile file(cacheDir.absoluteFilePath(key + FILE_SUFFIX)); // written in a temp file and renamed, concurrent readers never see partial files
+    if (!file.open(QFile::WriteOnly)) {
+        qCritical() << "Can't open the sound cache file" << file.fileName() << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << CacheHeader(REVISION)
+           << static_cast<quint8>(QSysInfo::ByteOrder)
+           << static_cast<quint8>(buffer.getChannels())
+           << static_cast<quint32>(buffer.getFrameLenght());
+
+    const int channelBytes = buffer.getFrameLenght() * sizeof(float);
+    for (int c = 0; c < buffer.getChannels(); ++c)
+        stream.writeRawData(reinterpret_cast<const char *>(buffer.getSamplesArray(c)), channelBytes);
+
+    if (!file.commit())
+        qCritical() << "Error writing the sound cache file" << file.fileName() << file.errorString();
+}
+
+void SoundCache::pruneDiskCache(const QDir &cacheDir)
+{
+    // newest first, the files are touched when loaded, so the least recently used files are removed
+    const QFileInfoList files = cacheDir.entryInfoList(QStringList("*" + FILE_SUFFIX), QDir::Files, QDir::Time);
+
+    // the small sounds (metronome clicks) have their own budget, they are not removed to make room for the looper layers
+    qint64 soundsSize = 0;
+    qint64 smallSoundsSize = 0;
+    for (const QFileInfo &fileInfo : files) {
+        const bool smallSound = fileInfo.size() <= SMALL_SOUND_SIZE;
+        qint64 &totalSize = smallSound ? smallSoundsSize : soundsSize;
+        totalSize += fileInfo.size();
+        if (totalSize > (smallSound ? SMALL_SOUNDS_DISK_CACHE_SIZE : DISK_CACHE_SIZE)) {
+            qCDebug(jtCache) << "Removing old sound cache file" << fileInfo.fileName();
+            QFile::remove(fileInfo.absoluteFilePath());
+        }
+    }
+}
+
+void SoundCache::touch(const QString &filePath)
+{
+    // QFileDevice::setFileTime is not available in Qt 5.6, the first byte is written again to update the modification time
+    QFile file(filePath);
+    if (!file.open(QFile::ReadWrite))
+        return;
+
+    char firstByte;
+    if (file.read(&firstByte, 1) == 1 && file.seek(0))
+        file.write(&firstByte, 1);
+}
+
+void SoundCache::copy(const SamplesBuffer &source, SamplesBuffer &out)
+{
+    if (source.isMono())
+        out.setToMono();
+    else
+        out.setToStereo();
+
+    const uint maxFrames = out.getFrameLenght(); // zero = entire sound
+    out.setFrameLenght(maxFrames > 0 ? qMin(maxFrames, source.getFrameLenght()) : source.getFrameLenght());
+    out.set(source, 0, out.getFrameLenght(), 0);
+}
@@ -0,0 +1,86 @@
+#ifndef SOUNDCACHE_H
+#define SOUNDCACHE_H
+
+#include "audio/core/SamplesBuffer.h"
+
+#include <QString>
+#include <QDir>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QDateTime>
+#include <QScopedPointer>
+
+/**
+
+  Decoded and resampled sounds (metronome clicks, looper layers, custom sounds) ready to play.
+  Entries are content addressed, the key is (file content hash, target sample rate, resampler quality),
+  so renamed or copied files are reused and modified files are decoded again. The buffers are
+  stored in memory and in the cache dir, so sample rate switches and room joins don't decode and
+  resample the same files again, even after restarting JamTaba.
+
+ */
+
+namespace persistence {
+
+class SoundCache
+{
+
+public:
+    SoundCache();
+
+    static SoundCache *getInstance();
+
+    void setCacheDir(const QDir &cacheDir); // entries are stored only in memory until a cache dir is set
+
+    // decode and resample 'filePath' to 'sampleRate'. Only 'out.getFrameLenght()' frames are copied when 'out' is not empty.
+    bool load(const QString &filePath, quint32 sampleRate, audio::SamplesBuffer &out);
+
+    void clearMemoryCache();
+
+    static const quint8 RESAMPLER_QUALITY; // changed when the resampling code change, old entries are ignored
+
+private:
+    QByteArray getFileHash(const QString &filePath);
+    QString buildKey(const QByteArray &fileHash, quint32 sampleRate) const;
+
+    static bool decode(const QString &filePath, quint32 sampleRate, audio::SamplesBuffer &out);
+
+    // disk I/O, called without locking the mutex
+    static bool loadFromDisk(const QDir &cacheDir, const QString &key, audio::SamplesBuffer &out);
+    static void saveToDisk(const QDir &cacheDir, const QString &key, const audio::SamplesBuffer &buffer);
+    static void pruneDiskCache(const QDir &cacheDir);
+    static void touch(const QString &filePath);
+
+    bool getDiskCacheDir(QDir &dir);
+
+    static void copy(const audio::SamplesBuffer &source, audio::SamplesBuffer &out);
+
+    struct FileHash
+    {
+        qint64 size;
+        QDateTime lastModified;
+        QByteArray hash;
+    };
+
+    QHash<QString, FileHash> fileHashes; // avoid hashing unchanged files again
+    QCache<QString, audio::SamplesBuffer> memoryCache;
+    QCache<QString, audio::SamplesBuffer> smallSoundsMemoryCache; // metronome clicks are not discarded to make room for looper layers
+    QDir cacheDir;
+    bool usingDiskCache;
+    QMutex mutex;
+
+    static QScopedPointer<SoundCache> instance;
+
+    static const quint32 REVISION;
+    static const int MEMORY_CACHE_SIZE; // in KB
+    static const int SMALL_SOUNDS_MEMORY_CACHE_SIZE; // in KB
+    static const qint64 DISK_CACHE_SIZE; // in bytes
+    static const qint64 SMALL_SOUNDS_DISK_CACHE_SIZE; // in bytes
+    static const qint64 SMALL_SOUND_SIZE; // in bytes, sounds using the small sounds budget
+    static const QString FILE_SUFFIX;
+};
+
+} // namespace
+
+#endif // SOUNDCACHE_H
@@ -14,8 +14,9 @@ using persistence::UsersDataCacheHeader;
 /**
    - Added 3 low cut states (off, normal and drastic) in revision 3
    - Added instrument index in revision 4
+   - Added loudness in revision 5
 */
-const quint32 UsersDataCacheHeader::REVISION = 4;
+const quint32 UsersDataCacheHeader::REVISION = 5;
 
 const bool CacheEntry::DEFAULT_MUTED = false;
 const quint8 CacheEntry::DEFAULT_LOW_CUT_STATE = 0; // OFF state is default
@@ -25,6 +26,7 @@ const float CacheEntry::DEFAULT_BOOST = 1.0f;
 const float CacheEntry::PAN_MAX = 4.0f;
 const float CacheEntry::PAN_MIN = -4.0f;
 const qint8 CacheEntry::DEFAULT_INSTRUMENT_INDEX = -1;
+const float CacheEntry::UNKNOWN_LOUDNESS = -100.0f;
 
 // well formed address is an acceptable.
 // no need to validate the number within 8 bits.
@@ -42,10 +44,11 @@ QDataStream &operator<<(QDataStream &stream, const CacheEntry &entry)
            << entry.getPan()
            << entry.getBoost()
            << entry.getLowCutState()
-           << entry.getInstrumentIndex();
+           << entry.getInstrumentIndex()
+           << entry.getLoudness();
 }
 
-QDataStream &operator>>(QDataStream &stream, CacheEntry &entry)
+static QDataStream &readCacheEntry(QDataStream &stream, CacheEntry &entry, quint32 revision)
 {
     QString userIp, userName;
     quint8 channelID;
@@ -53,9 +56,13 @@ QDataStream &operator>>(QDataStream &stream, CacheEntry &entry)
     int lowCutState;
     float gain, pan, boost;
     int instrumentIndex;
+    float loudness = CacheEntry::UNKNOWN_LOUDNESS;
 
     stream >> userIp >> userName >> channelID >> muted >> gain >> pan >> boost >> lowCutState >> instrumentIndex;
 
+    if (revision >= 5)
+        stream >> loudness;
+
     entry.setUserIP(userIp);
     entry.setUserName(userName);
     entry.setChannelID(channelID);
@@ -65,10 +72,16 @@ QDataStream &operator>>(QDataStream &stream, CacheEntry &entry)
     entry.setBoost(boost);
     entry.setLowCutState(lowCutState);
     entry.setInstrumentIndex(instrumentIndex);
+    entry.setLoudness(loudness);
 
     return stream;
 }
 
+QDataStream &operator>>(QDataStream &stream, CacheEntry &entry)
+{
+    return readCacheEntry(stream, entry, UsersDataCacheHeader::REVISION);
+}
+
 // +++++++++++++++++++++++++++++++++++++++
 
 CacheEntry::CacheEntry(const QString &userIp, const QString &userName, quint8 channelID)
@@ -82,6 +95,17 @@ CacheEntry::CacheEntry(const QString &userIp, const QString &userName, quint8 ch
     setBoost(DEFAULT_BOOST);
     setLowCutState(DEFAULT_LOW_CUT_STATE);
     setInstrumentIndex(DEFAULT_INSTRUMENT_INDEX);
+    setLoudness(UNKNOWN_LOUDNESS);
+}
+
+void CacheEntry::setLoudness(float loudness)
+{
+    this->loudness = loudness;
+}
+
+bool CacheEntry::hasLoudness() const
+{
+    return loudness > UNKNOWN_LOUDNESS;
 }
 
 void CacheEntry::setInstrumentIndex(qint8 index)
@@ -174,6 +198,16 @@ CacheEntry UsersDataCache::getUserCacheEntry(const QString &userIp, const QStrin
     return CacheEntry(userIp, userName, channelID); // return a entry using default values for pan, gain, mute, etc.
 }
 
+CacheEntry UsersDataCache::getUserCacheEntry(const QString &userName, quint8 channelID) const
+{
+    for (const CacheEntry &entry : cacheEntries) {
+        if (entry.getUserName() == userName && entry.getChannelID() == channelID)
+            return entry;
+    }
+
+    return CacheEntry(QString(), userName, channelID);
+}
+
 void UsersDataCache::updateUserCacheEntry(CacheEntry entry)
 {
     QString userKey = getUserUniqueKey(entry.getUserIP(), entry.getUserName(), entry.getChannelID());
@@ -199,6 +233,8 @@ void UsersDataCache::loadCacheEntriesFromFile()
         quint32 expectedHeaderRevision = UsersDataCacheHeader::REVISION;
         if (cacheHeader.isValid(expectedHeaderRevision))
             stream >> cacheEntries;
+        else if (cacheHeader.isValid(4))
+            loadLegacyCacheEntries(stream, 4); // keeping the remembered levels, the loudness will be measured again
         else
             qCritical() << "Invalid cache header when loading users data cache.";
 
@@ -206,6 +242,21 @@ void UsersDataCache::loadCacheEntriesFromFile()
     }
 }
 
+void UsersDataCache::loadLegacyCacheEntries(QDataStream &stream, quint32 revision)
+{
+    // same layout used by QDataStream to serialize QMap
+    quint32 entries;
+    stream >> entries;
+    for (quint32 i = 0; i < entries && stream.status() == QDataStream::Ok; ++i) {
+        QString key;
+        CacheEntry entry;
+        stream >> key;
+        readCacheEntry(stream, entry, revision);
+        if (stream.status() == QDataStream::Ok)
+            cacheEntries.insert(key, entry);
+    }
+}
+
 void UsersDataCache::writeCacheEntriesToFile()
 {
     qCDebug(jtCache) << "Saving cache file";
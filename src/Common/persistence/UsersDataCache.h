@@ -6,6 +6,8 @@
 #include <QRegExp>
 #include <QDir>
 
+class QDataStream;
+
 /**
 
   This class is used to store/remember the users level, pan, mute and boost. When a user enter in the jam
@@ -73,6 +75,11 @@ public:
         return instrumentIndex;
     }
 
+    inline float getLoudness() const
+    {
+        return loudness;
+    }
+
     void setUserIP(const QString &userIp);
     void setUserName(const QString &userName);
     void setChannelID(quint8 channelID);
@@ -83,6 +90,8 @@ public:
     void setLowCutState(quint8 state);
     void setInstrumentIndex(qint8 index);
     bool hasValidInstrumentIndex() const;
+    void setLoudness(float loudness);
+    bool hasLoudness() const;
 
     static QRegExp ipPattern;
 
@@ -94,6 +103,7 @@ public:
     static const float PAN_MAX;
     static const float PAN_MIN;
     static const qint8 DEFAULT_INSTRUMENT_INDEX;
+    static const float UNKNOWN_LOUDNESS;
 private:
     QString userIp;
     QString userName;
@@ -104,6 +114,7 @@ private:
     float boost;
     quint8 lowCutState;
     qint8 instrumentIndex;
+    float loudness; // measured loudness (LUFS) used in remote users auto gain
 };
 
 // ++++++++++++++++++++++++++++++++
@@ -117,6 +128,9 @@ public:
     // return default values for pan, gain and mute if user is not cached yet
     CacheEntry getUserCacheEntry(const QString &userIp, const QString &userName, quint8 channelID);
 
+    // used when the user IP is unknown (recorded jams, for example). Return default values if user is not cached yet
+    CacheEntry getUserCacheEntry(const QString &userName, quint8 channelID) const;
+
     void updateUserCacheEntry(CacheEntry entry);
 private:
     QMap<QString, CacheEntry> cacheEntries;
@@ -127,6 +141,7 @@ private:
                                     quint8 channelID);
 
     void loadCacheEntriesFromFile();
+    void loadLegacyCacheEntries(QDataStream &stream, quint32 revision);
     void writeCacheEntriesToFile();
 
     const QString CACHE_FILE_NAME;
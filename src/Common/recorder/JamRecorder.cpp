@@ -114,7 +114,7 @@ void Jam::addAudioFile(const QString &userName, quint8 channelIndex, const QStri
         jamIntervals.insert(intervalIndex, QList<JamInterval>());
     }
 
-    jamIntervals[intervalIndex].insert(intervalIndex, JamInterval(intervalIndex, getBpm(), getBpi(), filePath, userName, channelIndex));
+    jamIntervals[intervalIndex].append(JamInterval(intervalIndex, getBpm(), getBpi(), filePath, userName, channelIndex));
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
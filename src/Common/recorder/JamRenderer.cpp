@@ -0,0 +1,384 @@
+#include "JamRenderer.h"
+
+#include "audio/core/SamplesBuffer.h"
+#include "audio/core/AudioNode.h"
+#include "audio/SamplesBufferResampler.h"
+#include "audio/vorbis/VorbisEncoder.h"
+#include "audio/vorbis/Vorbis.h"
+#include "file/FileReaderFactory.h"
+#include "file/FileReader.h"
+#include "file/WaveFileWriter.h"
+#include "persistence/UsersDataCache.h"
+#include "log/Logging.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QFile>
+#include <QDir>
+#include <QRegExp>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using recorder::JamRenderer;
+using recorder::Jam;
+using recorder::JamTrack;
+using recorder::JamAudioFile;
+using audio::SamplesBuffer;
+using audio::AudioNode;
+
+namespace {
+
+class RenderOutput
+{
+public:
+    virtual ~RenderOutput() {}
+    virtual bool open(const QString &filePath, quint32 sampleRate) = 0;
+    virtual void append(const SamplesBuffer &buffer) = 0;
+    virtual void close() = 0;
+};
+
+class WaveRenderOutput : public RenderOutput
+{
+public:
+    explicit WaveRenderOutput(quint8 bitDepth) :
+        bitDepth(bitDepth)
+    {
+    }
+
+    bool open(const QString &filePath, quint32 sampleRate) override
+    {
+        return writer.open(filePath, 2, sampleRate, bitDepth);
+    }
+
+    void append(const SamplesBuffer &buffer) override
+    {
+        writer.append(buffer);
+    }
+
+    void close() override
+    {
+        writer.close();
+    }
+
+private:
+    audio::WaveFileWriter writer;
+    quint8 bitDepth;
+};
+
+class VorbisRenderOutput : public RenderOutput
+{
+public:
+    explicit VorbisRenderOutput(float quality) :
+        quality(quality)
+    {
+    }
+
+    bool open(const QString &filePath, quint32 sampleRate) override
+    {
+        file.setFileName(filePath);
+        if (!file.open(QFile::WriteOnly)) {
+            qCritical() << "Failed to create OGG file ..." << filePath;
+            return false;
+        }
+        encoder.reset(new vorbis::Encoder(2, sampleRate, quality));
+        return true;
+    }
+
+    void append(const SamplesBuffer &buffer) override
+    {
+        if (encoder)
+            file.write(encoder->encode(buffer));
+    }
+
+    void close() override
+    {
+        if (encoder && file.isOpen()) {
+            file.write(encoder->finishIntervalEncoding());
+            file.close();
+        }
+        encoder.reset();
+    }
+
+private:
+    QFile file;
+    std::unique_ptr<vorbis::Encoder> encoder;
+    float quality;
+};
+
+std::unique_ptr<RenderOutput> createRenderOutput(const JamRenderer::Settings &settings)
+{
+    if (settings.format == JamRenderer::OggVorbisFormat)
+        return std::unique_ptr<RenderOutput>(new VorbisRenderOutput(settings.vorbisQuality));
+
+    return std::unique_ptr<RenderOutput>(new WaveRenderOutput(settings.bitDepth));
+}
+
+} // namespace
+
+JamRenderer::Settings::Settings() :
+    format(WaveFormat),
+    sampleRate(44100),
+    bitDepth(16),
+    vorbisQuality(vorbis::EncoderQualityHigh),
+    renderMix(true),
+    renderStems(false)
+{
+
+}
+
+JamRenderer::JamRenderer(const Jam &jam, QObject *parent) :
+    QObject(parent),
+    intervalLenght(jam.getIntervalsLenght()),
+    firstIntervalIndex(std::numeric_limits<int>::max()),
+    lastIntervalIndex(std::numeric_limits<int>::min()),
+    cancelled(0),
+    undecodedFiles(0)
+{
+    for (const JamTrack &jamTrack : jam.getJamTracks()) {
+        RenderTrack track;
+        track.userName = jamTrack.getUserName();
+        track.channelIndex = jamTrack.getChannelIndex();
+        track.name = buildTrackName(track.userName, track.channelIndex);
+        track.muted = false;
+        track.leftGain = track.rightGain = 1.0f;
+        for (const JamAudioFile &audioFile : jamTrack.getAudioFiles()) {
+            int intervalIndex = static_cast<int>(audioFile.getIntervalIndex());
+            track.audioFiles.insert(intervalIndex, audioFile.getPath());
+            firstIntervalIndex = std::min(firstIntervalIndex, intervalIndex);
+            lastIntervalIndex = std::max(lastIntervalIndex, intervalIndex);
+        }
+        tracks.append(track);
+        setTrackMix(track.userName, track.channelIndex, 1.0f, 0.0f); // default gain and center pan
+    }
+}
+
+void JamRenderer::setTrackMix(const QString &userName, quint8 channelIndex, float gain, float pan, float boost, bool muted)
+{
+    float leftGain;
+    float rightGain;
+    AudioNode::computePanGains(qBound(-1.0f, pan, 1.0f), leftGain, rightGain); // the tracks are panned like in the jam
+
+    const float commonGain = gain * boost;
+    leftGain *= commonGain;
+    rightGain *= commonGain;
+
+    for (RenderTrack &track : tracks) {
+        if (track.userName == userName && track.channelIndex == channelIndex) {
+            track.leftGain = leftGain;
+            track.rightGain = rightGain;
+            track.muted = muted;
+        }
+    }
+}
+
+void JamRenderer::loadTrackMixes(const persistence::UsersDataCache &cache)
+{
+    for (const RenderTrack &track : tracks) {
+        QString userName = track.userName.section(" from ", 0, 0); // remote users are recorded as 'userName from Country'
+        auto entry = cache.getUserCacheEntry(userName, track.channelIndex);
+        setTrackMix(track.userName, track.channelIndex, entry.getGain(), entry.getPan(), entry.getBoost(), entry.isMuted());
+    }
+}
+
+void JamRenderer::cancel()
+{
+    cancelled = 1;
+}
+
+QString JamRenderer::buildTrackName(const QString &userName, quint8 channelIndex)
+{
+    QString name = userName + " (Channel " + QString::number(channelIndex + 1) + ")";
+    return name.replace(QRegExp("[\\\\/:*?\"<>|]"), "_");
+}
+
+QString JamRenderer::getFileExtension(OutputFormat format)
+{
+    return format == OggVorbisFormat ? ".ogg" : ".wav";
+}
+
+QString JamRenderer::getMixFileName(OutputFormat format)
+{
+    return "Mix" + getFileExtension(format);
+}
+
+bool JamRenderer::fail(const QString &error)
+{
+    qCritical() << error;
+    errorString = error;
+    emit renderFinished(false);
+    return false;
+}
+
+bool JamRenderer::decode(const DecodeJob &job, quint32 targetSampleRate)
+{
+    SamplesBuffer buffer(2);
+    quint32 fileSampleRate = 0;
+    auto reader = audio::FileReaderFactory::createFileReader(job.filePath);
+    if (!reader->read(job.filePath, buffer, fileSampleRate) || buffer.isEmpty()) {
+        qCWarning(jtJamRecorder) << "Can't decode" << job.filePath;
+        return false;
+    }
+
+    const SamplesBuffer *decoded = &buffer;
+    SamplesBufferResampler resampler;
+    if (fileSampleRate != targetSampleRate && fileSampleRate > 0) {
+        int resampledLenght = qRound(static_cast<double>(buffer.getFrameLenght()) * targetSampleRate / fileSampleRate);
+        decoded = &resampler.resample(buffer, resampledLenght);
+    }
+
+    const bool mono = buffer.isMono();
+    const float *left = decoded->getSamplesArray(0);
+    const float *right = decoded->getSamplesArray(mono ? 0 : 1);
+    const float leftGain = job.track->leftGain;
+    const float rightGain = job.track->rightGain;
+
+    // each job owns a disjoint region of the track stem buffer, no locks are necessary
+    const uint frames = std::min(decoded->getFrameLenght(), job.frames);
+    for (uint s = 0; s < frames; ++s) {
+        job.left[s] = left[s] * leftGain;
+        job.right[s] = right[s] * rightGain;
+    }
+
+    return true;
+}
+
+bool JamRenderer::render(const Settings &settings)
+{
+    renderedFiles.clear();
+    errorString.clear();
+    cancelled = 0;
+    undecodedFiles = 0;
+
+    if (tracks.isEmpty() || intervalLenght <= 0 || (!settings.renderMix && !settings.renderStems))
+        return fail(tr("Nothing to render!"));
+
+    QDir outputDir(settings.outputPath);
+    if (!outputDir.exists() && !outputDir.mkpath("."))
+        return fail(tr("Can't create the folder %1").arg(settings.outputPath));
+
+    // open all output files
+    std::unique_ptr<RenderOutput> mixOutput;
+    if (settings.renderMix) {
+        QString filePath = outputDir.absoluteFilePath(getMixFileName(settings.format));
+        mixOutput = createRenderOutput(settings);
+        if (!mixOutput->open(filePath, settings.sampleRate))
+            return fail(tr("Can't create the file %1").arg(filePath));
+
+        renderedFiles << filePath;
+    }
+
+    std::vector<std::unique_ptr<RenderOutput>> stemOutputs(tracks.size());
+    if (settings.renderStems) {
+        for (int t = 0; t < tracks.size(); ++t) {
+            if (tracks.at(t).muted)
+                continue;
+
+            QString filePath = outputDir.absoluteFilePath(tracks.at(t).name + getFileExtension(settings.format));
+            stemOutputs[t] = createRenderOutput(settings);
+            if (!stemOutputs[t]->open(filePath, settings.sampleRate))
+                return fail(tr("Can't create the file %1").arg(filePath));
+
+            renderedFiles << filePath;
+        }
+    }
+
+    const uint intervalFrames = static_cast<uint>(std::round(intervalLenght * settings.sampleRate));
+    const int totalIntervals = lastIntervalIndex - firstIntervalIndex + 1;
+
+    // intervals rendered in each pass: enough decoding jobs to keep all cores busy, but no more than necessary to save memory
+    const int threads = std::max(1, QThread::idealThreadCount());
+    const int intervalsPerPass = qBound(1, (threads * 2 + tracks.size() - 1) / tracks.size(), totalIntervals);
+
+    QList<SamplesBuffer> stems;
+    for (int t = 0; t < tracks.size(); ++t)
+        stems.append(SamplesBuffer(2, intervalsPerPass * intervalFrames));
+
+    SamplesBuffer mix(2, intervalsPerPass * intervalFrames);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const quint32 sampleRate = settings.sampleRate;
+    int renderedIntervals = 0;
+    for (int passStart = firstIntervalIndex; passStart <= lastIntervalIndex && !cancelled.load(); passStart += intervalsPerPass) {
+        const int passIntervals = std::min(intervalsPerPass, lastIntervalIndex - passStart + 1);
+        const uint passFrames = passIntervals * intervalFrames;
+
+        QList<DecodeJob> jobs;
+        for (int t = 0; t < tracks.size(); ++t) {
+            SamplesBuffer &stem = stems[t];
+            stem.setFrameLenght(passFrames);
+            stem.zero();
+
+            const RenderTrack &track = tracks.at(t);
+            if (track.muted)
+                continue;
+
+            for (int i = 0; i < passIntervals; ++i) {
+                auto iterator = track.audioFiles.constFind(passStart + i);
+                if (iterator == track.audioFiles.constEnd())
+                    continue;
+
+                DecodeJob job;
+                job.track = &track;
+                job.filePath = iterator.value();
+                job.left = stem.getSamplesArray(0) + i * intervalFrames;
+                job.right = stem.getSamplesArray(1) + i * intervalFrames;
+                job.frames = intervalFrames;
+                jobs.append(job);
+            }
+        }
+
+        QtConcurrent::blockingMap(jobs, [this, sampleRate](const DecodeJob &job) {
+            if (!JamRenderer::decode(job, sampleRate))
+                undecodedFiles.fetchAndAddRelaxed(1); // the interval is rendered as silence
+        });
+
+        mix.setFrameLenght(passFrames);
+        mix.zero();
+        for (int t = 0; t < tracks.size(); ++t) {
+            if (tracks.at(t).muted)
+                continue;
+
+            if (stemOutputs[t])
+                stemOutputs[t]->append(stems.at(t));
+
+            if (mixOutput)
+                mix.add(stems.at(t));
+        }
+
+        if (mixOutput)
+            mixOutput->append(mix);
+
+        renderedIntervals += passIntervals;
+        emit progressChanged(renderedIntervals, totalIntervals);
+    }
+
+    if (mixOutput)
+        mixOutput->close();
+
+    for (auto &stemOutput : stemOutputs) {
+        if (stemOutput)
+            stemOutput->close();
+    }
+
+    if (cancelled.load()) {
+        for (const QString &filePath : renderedFiles)
+            QFile::remove(filePath);
+
+        renderedFiles.clear();
+        qCDebug(jtJamRecorder) << "Jam rendering cancelled";
+        emit renderFinished(false);
+        return false;
+    }
+
+    const double renderedSeconds = totalIntervals * intervalLenght;
+    const qint64 elapsed = std::max<qint64>(1, timer.elapsed());
+    qCDebug(jtJamRecorder) << "Jam rendered in" << elapsed << "ms," << (renderedSeconds * 1000.0 / elapsed) << "x realtime";
+
+    emit renderFinished(true);
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef _JAM_RENDERER_
+#define _JAM_RENDERER_
+
+#include "JamRecorder.h"
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QStringList>
+
+namespace persistence {
+class UsersDataCache;
+}
+
+namespace recorder {
+
+/**
+  Offline (faster than realtime) mixdown of a recorded jam. The ogg intervals are decoded and resampled in parallel
+  using the QtConcurrent global thread pool. The tracks are summed using the users gain/pan and the result is written
+  as a full mix and/or as one file per track (stems).
+*/
+
+class JamRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    enum OutputFormat
+    {
+        WaveFormat,
+        OggVorbisFormat
+    };
+
+    struct Settings
+    {
+        Settings();
+
+        QString outputPath;
+        OutputFormat format;
+        quint32 sampleRate;
+        quint8 bitDepth;     // used only in wave files
+        float vorbisQuality; // used only in ogg files
+        bool renderMix;
+        bool renderStems;
+    };
+
+    explicit JamRenderer(const Jam &jam, QObject *parent = nullptr);
+
+    void setTrackMix(const QString &userName, quint8 channelIndex, float gain, float pan, float boost = 1.0f, bool muted = false);
+    void loadTrackMixes(const persistence::UsersDataCache &cache);
+
+    bool render(const Settings &settings); // blocking, call this function from a worker thread to keep the GUI responsive
+    void cancel();
+
+    inline QStringList getRenderedFiles() const { return renderedFiles; }
+    inline QString getErrorString() const { return errorString; } // empty when the rendering was cancelled
+    inline int getUndecodedFiles() const { return undecodedFiles.load(); } // the intervals rendered as silence
+
+    static QString getMixFileName(OutputFormat format);
+
+signals:
+    void progressChanged(int renderedIntervals, int totalIntervals);
+    void renderFinished(bool success);
+
+private:
+
+    struct RenderTrack
+    {
+        QString name;
+        QString userName;
+        quint8 channelIndex;
+        float leftGain;
+        float rightGain;
+        bool muted;
+        QMap<int, QString> audioFiles; // intervalIndex is the key
+    };
+
+    struct DecodeJob
+    {
+        const RenderTrack *track;
+        QString filePath;
+        float *left;  // destination in the track stem buffer
+        float *right;
+        uint frames;
+    };
+
+    QList<RenderTrack> tracks;
+    double intervalLenght; // in seconds
+    int firstIntervalIndex;
+    int lastIntervalIndex;
+    QStringList renderedFiles;
+    QString errorString;
+    QAtomicInt cancelled;
+    QAtomicInt undecodedFiles;
+
+    bool fail(const QString &error);
+
+    static bool decode(const DecodeJob &job, quint32 targetSampleRate);
+    static QString buildTrackName(const QString &userName, quint8 channelIndex);
+    static QString getFileExtension(OutputFormat format);
+};
+
+} // namespace
+
+#endif
@@ -1,5 +1,8 @@
 #include "ReaperProjectGenerator.h"
 #include <QUuid>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
 #include "../log/Logging.h"
 
 using recorder::ReaperProjectGenerator;
@@ -97,6 +100,87 @@ QString ReaperProjectGenerator::getVideoAbsolutePath(const QString &videoFileNam
     return jamDir.absoluteFilePath("video/" + videoFileName);
 }
 
+std::unique_ptr<Jam> ReaperProjectGenerator::readJam(const QString &rppFilePath)
+{
+    QFile projectFile(rppFilePath);
+    if (!projectFile.open(QFile::ReadOnly)) {
+        qCritical() << "Can't read the reaper project file " << rppFilePath;
+        return nullptr;
+    }
+
+    struct ItemInfo
+    {
+        QString userName;
+        quint8 channelIndex;
+        double position;
+        QString filePath;
+    };
+
+    int sampleRate = 44100;
+    double bpm = 0;
+    double intervalLenght = 0;
+    QString userName;
+    quint8 channelIndex = 0;
+    double position = 0;
+    QList<ItemInfo> items;
+
+    static const QRegExp trackNameRegex("^NAME \"(.+) \\(Channel (\\d+)\\)\"$");
+
+    QDir projectDir = QFileInfo(rppFilePath).absoluteDir();
+    QTextStream stream(&projectFile);
+    while (!stream.atEnd()) {
+        QString line = stream.readLine().trimmed();
+        if (line.startsWith("SAMPLERATE ")) {
+            sampleRate = line.section(' ', 1, 1, QString::SectionSkipEmpty).toInt();
+        }
+        else if (line.startsWith("TEMPO ")) {
+            bpm = line.section(' ', 1, 1, QString::SectionSkipEmpty).toDouble();
+        }
+        else if (line.startsWith("<TRACK")) {
+            userName.clear();
+        }
+        else if (line.startsWith("NAME \"") && userName.isEmpty()) { // the first NAME after <TRACK is the track name, the others are item names
+            QRegExp regex(trackNameRegex);
+            if (regex.exactMatch(line)) {
+                userName = regex.cap(1);
+                channelIndex = static_cast<quint8>(regex.cap(2).toInt() - 1);
+            }
+        }
+        else if (line.startsWith("POSITION ")) {
+            position = line.section(' ', 1, 1).toDouble();
+        }
+        else if (line.startsWith("LENGTH ")) {
+            intervalLenght = line.section(' ', 1, 1).toDouble();
+        }
+        else if (line.startsWith("FILE \"") && !userName.isEmpty()) {
+            QString filePath = line.mid(6, line.length() - 7); // remove 'FILE "' and the last '"'
+            if (QFileInfo(filePath).isRelative())
+                filePath = projectDir.absoluteFilePath(filePath);
+
+            ItemInfo item;
+            item.userName = userName;
+            item.channelIndex = channelIndex;
+            item.position = position;
+            item.filePath = filePath;
+            items.append(item);
+        }
+    }
+
+    if (bpm <= 0 || intervalLenght <= 0 || items.isEmpty()) {
+        qCritical() << "Invalid reaper project file " << rppFilePath;
+        return nullptr;
+    }
+
+    int bpi = qRound(intervalLenght * bpm / 60.0);
+    std::unique_ptr<Jam> jam(new Jam(qRound(bpm), bpi, sampleRate));
+    for (const ItemInfo &item : items) {
+        int intervalIndex = qRound(item.position / intervalLenght) + 1; // the POSITION is computed using (intervalIndex - 1) in write()
+        jam->addAudioFile(item.userName, item.channelIndex, item.filePath, intervalIndex);
+    }
+
+    return jam;
+}
+
 QString ReaperProjectGenerator::buildTrackName(const QString &userName, quint8 channelIndex)
 {
     return userName + " (Channel " + QString::number(channelIndex+1) + ")";
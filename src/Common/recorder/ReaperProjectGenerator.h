@@ -4,6 +4,8 @@
 #include "JamRecorder.h"
 #include "QCoreApplication"
 
+#include <memory>
+
 namespace recorder {
 
 class ReaperProjectGenerator : public JamMetadataWriter
@@ -27,6 +29,9 @@ public:
     QString getAudioAbsolutePath(const QString &audioFileName) override;
     QString getVideoAbsolutePath(const QString &videoFileName) override;
 
+    // rebuild the Jam metadata from a RPP file previously written by this class. Return nullptr if the file is not valid.
+    static std::unique_ptr<Jam> readJam(const QString &rppFilePath);
+
 private:
     static QString buildTrackName(const QString &userName, quint8 channelIndex);
     QString rppPath;
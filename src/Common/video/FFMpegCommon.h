@@ -15,12 +15,6 @@ extern "C" {
 #define __STDC_CONSTANT_MACROS
 //#define snprintf(buf,len, format,...) _snprintf_s(buf, len,len, format, __VA_ARGS__)
 
-// a magic macro used to convert QImage to FFmpeg image format
-#define RGBtoYUV(r, g, b, y, u, v) \
-  y = (uint8_t)(((int)30*r + (int)59*g + (int)11*b)/100); \
-  u = (uint8_t)(((int)-17*r - (int)33*g + (int)50*b + 12800)/100); \
-  v = (uint8_t)(((int)50*r - (int)42*g - (int)8*b + 12800)/100);
-
 // FFMpeg is a C lib, we need use extern 'C' to include the FFMpeg headers
 extern "C" {
     #include <libavutil/opt.h>
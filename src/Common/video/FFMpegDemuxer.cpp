@@ -4,59 +4,300 @@
 #include <QImage>
 #include <QFile>
 #include <QFileInfo>
+#include <QtConcurrent/QtConcurrent>
 
-FFMpegDemuxer::FFMpegDemuxer(QObject *parent, const QByteArray &encodedData) :
+FFMpegDemuxer::FFMpegDemuxer(QObject *parent) :
     QObject(parent),
     formatContext(nullptr),
     avioContext(nullptr),
+    codecContext(nullptr),
     swsContext(nullptr),
     frame(nullptr),
-    frameRGB(nullptr),
-    rgbBuffer(nullptr),
-    buffer(nullptr),
-    encodedData(encodedData)
+    endOfStream(false),
+    framesInInterval(0),
+    nextPooledImage(0),
+    switchRequested(false),
+    intervalFinished(true),
+    playing(false),
+    decoding(false),
+    stopRequested(false),
+    frameRate(DEFAULT_FRAME_RATE),
+    statistics(Statistics())
 {
     av_register_all();
     avcodec_register_all();
 
-    qRegisterMetaType<QList<QImage>>();
+    threadPool.setMaxThreadCount(1);
 }
 
 FFMpegDemuxer::~FFMpegDemuxer()
 {
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+    }
+
+    threadPool.waitForDone();
+
     close();
+
+    if (swsContext)
+        sws_freeContext(swsContext);
+
+    if (frame)
+        av_frame_free(&frame);
 }
 
-void FFMpegDemuxer::close()
+void FFMpegDemuxer::addInterval(const QByteArray &encodedData)
 {
-    if (formatContext) {
-        avformat_close_input(&formatContext);
-        formatContext = nullptr;
-        avioContext = nullptr;
-        //codecContext = nullptr;
-        swsContext = nullptr;
+    QMutexLocker locker(&mutex);
+
+    pendingInterval = encodedData; // only the last received interval is played
+
+    if (!playing) {
+        locker.unlock();
+        startNextInterval(); // nothing is playing, starting immediately
+    }
+}
+
+bool FFMpegDemuxer::startNextInterval()
+{
+    QMutexLocker locker(&mutex);
+
+    if (!pendingInterval.isEmpty()) {
+        switchRequested = true;
+        intervalFinished = false;
+        playing = true;
+        readyFrames.clear();
+        playbackClock.restart();
+        scheduleDecoding();
+        return true;
+    }
+
+    return playing; // keep playing the current interval
+}
+
+void FFMpegDemuxer::setTargetSize(const QSize &size)
+{
+    QMutexLocker locker(&mutex);
+
+    targetSize = size;
+}
+
+QSize FFMpegDemuxer::getVideoSize() const
+{
+    QMutexLocker locker(&mutex);
+
+    return videoSize;
+}
+
+FFMpegDemuxer::Statistics FFMpegDemuxer::getStatistics() const
+{
+    QMutexLocker locker(&mutex);
+
+    return statistics;
+}
+
+QImage FFMpegDemuxer::getCurrentFrame()
+{
+    QMutexLocker locker(&mutex);
+
+    if (!playing)
+        return QImage();
+
+    const qint64 now = playbackClock.elapsed();
+
+    QImage image;
+    while (!readyFrames.isEmpty() && readyFrames.first().timestamp <= now)
+        image = readyFrames.takeFirst().image; // late frames are skipped, the newest due frame is showed
+
+    if (intervalFinished && readyFrames.isEmpty())
+        playing = false; // avoid show the last received frame forever
+    else
+        scheduleDecoding(); // decode ahead to refill the ring
+
+    return image;
+}
+
+void FFMpegDemuxer::scheduleDecoding()
+{
+    if (decoding || stopRequested)
+        return;
+
+    if (!switchRequested && (intervalFinished || readyFrames.size() >= MAX_READY_FRAMES))
+        return;
+
+    decoding = true;
+    QtConcurrent::run(&threadPool, this, &FFMpegDemuxer::decodeFrames);
+}
+
+void FFMpegDemuxer::decodeFrames()
+{
+    forever {
+        bool openNewInterval = false;
+        QByteArray newInterval;
+        QSize size;
+        uint fps;
+
+        {
+            QMutexLocker locker(&mutex);
+            if (switchRequested) {
+                switchRequested = false;
+                newInterval = pendingInterval;
+                pendingInterval.clear();
+                openNewInterval = true;
+            }
+            else if (stopRequested || intervalFinished || readyFrames.size() >= MAX_READY_FRAMES) {
+                decoding = false;
+                return;
+            }
+
+            size = targetSize;
+            fps = frameRate;
+        }
+
+        if (openNewInterval) {
+            close(); // releasing the last interval data
+
+            encodedData = newInterval;
+            bool opened = open();
+            QMutexLocker locker(&mutex);
+            if (!opened) {
+                qCritical() << "Can't open the video decoder!";
+                intervalFinished = true;
+            }
+            else {
+                frameRate = readFrameRate();
+            }
+            continue;
+        }
+
+        if (!decodeNextFrame()) {
+            close(); // release the decoder memory until the next interval
+            QMutexLocker locker(&mutex);
+            intervalFinished = true;
+            continue;
+        }
+
+        const qint64 timestamp = static_cast<qint64>(framesInInterval++ * 1000 / fps);
+
+        {
+            QMutexLocker locker(&mutex);
+            statistics.decodedFrames++;
+            videoSize = QSize(frame->width, frame->height);
+
+            if (playbackClock.elapsed() > timestamp + 1000 / fps) { // too late, just decode (next frames depend on it) but don't scale
+                statistics.skippedFrames++;
+                continue;
+            }
+        }
+
+        if (!size.isValid() || size.isEmpty())
+            size = QSize(frame->width, frame->height);
+
+        // convert and scale in just one step, the frame is painted without any other transformation
+        swsContext = sws_getCachedContext(swsContext, frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                          size.width(), size.height(), AV_PIX_FMT_RGB32, SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!swsContext) {
+            qCritical() << "Cannot initialize the conversion context!";
+            continue;
+        }
+
+        QImage &image = getPooledImage(size);
+        uint8_t *destination[4] = { image.bits(), nullptr, nullptr, nullptr };
+        int destinationStride[4] = { image.bytesPerLine(), 0, 0, 0 };
+        sws_scale(swsContext, frame->data, frame->linesize, 0, frame->height, destination, destinationStride);
+
+        QMutexLocker locker(&mutex);
+        if (!switchRequested) // discard frames decoded while a new interval is requested
+            readyFrames.append({ image, timestamp });
+    }
+}
+
+QImage &FFMpegDemuxer::getPooledImage(const QSize &size)
+{
+    for (QImage &image : imagesPool) {
+        if (image.isDetached() && image.size() == size)
+            return image;
     }
 
-    if (frame) {
-        av_free(frame);
-        frame = nullptr;
+    if (imagesPool.size() < MAX_POOLED_IMAGES) {
+        imagesPool.append(QImage(size, QImage::Format_RGB32));
+        return imagesPool.last();
     }
 
-    if (frameRGB) {
-        av_free(frameRGB);
-        frameRGB = nullptr;
+    // all images are in use (or the size changed), replacing one of them
+    QImage &image = imagesPool[nextPooledImage];
+    nextPooledImage = (nextPooledImage + 1) % MAX_POOLED_IMAGES;
+    image = QImage(size, QImage::Format_RGB32);
+
+    return image;
+}
+
+bool FFMpegDemuxer::decodeNextFrame()
+{
+    if (!codecContext || !frame)
+        return false;
+
+    forever {
+        int ret = avcodec_receive_frame(codecContext, frame);
+        if (ret == 0) { // got a frame?
+            if (!frame->width || !frame->height) // 0 size images are skipped
+                continue;
+
+            return true;
+        }
+
+        if (ret == AVERROR_EOF)
+            return false; // all frames decoded
+
+        if (ret != AVERROR(EAGAIN)) {
+            qCritical() << "error decoding video frame in avcodec_receive_frame" << av_error_to_qt_string(ret) << ret;
+            return false;
+        }
+
+        // decoder need more data
+        AVPacket packet;
+        av_init_packet(&packet);
+        packet.data = nullptr;
+        packet.size = 0;
+
+        if (!endOfStream && av_read_frame(formatContext, &packet) == 0) {
+            ret = avcodec_send_packet(codecContext, &packet);
+            av_packet_unref(&packet);
+        }
+        else if (!endOfStream) {
+            endOfStream = true;
+            ret = avcodec_send_packet(codecContext, nullptr); // flush the delayed frames
+        }
+        else {
+            return false;
+        }
+
+        if (ret != 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+            qCritical() << "error decoding video frame" << av_error_to_qt_string(ret) << ret;
+            return false;
+        }
     }
+}
 
-    if (rgbBuffer) {
-        delete [] rgbBuffer;
-        rgbBuffer = nullptr;
+void FFMpegDemuxer::close()
+{
+    if (formatContext) {
+        avformat_close_input(&formatContext); // stream codec context is released too
+        formatContext = nullptr;
+        codecContext = nullptr;
     }
 
-    if (buffer) {
-        //av_free(buffer);
-        buffer = nullptr;
+    if (avioContext) { // custom IO is not released by avformat_close_input
+        av_freep(&avioContext->buffer);
+        av_freep(&avioContext);
     }
 
+    if (encodedBuffer.isOpen())
+        encodedBuffer.close();
+
+    encodedData.clear();
 }
 
 int FFMpegDemuxer::readCallback(void *stream, uint8_t *buffer, int bufferSize)
@@ -74,13 +315,16 @@ int FFMpegDemuxer::readCallback(void *stream, uint8_t *buffer, int bufferSize)
 
 bool FFMpegDemuxer::open()
 {
+    endOfStream = false;
+    framesInInterval = 0;
+
     encodedBuffer.setBuffer(&(this->encodedData));
     if(!encodedBuffer.open(QIODevice::ReadOnly)) {
         qCritical() << "Error opening demuxer " << encodedBuffer.errorString();
         return false;
     }
 
-    buffer = (unsigned char*)av_malloc(FFMPEG_BUFFER_SIZE);
+    auto buffer = (unsigned char*)av_malloc(FFMPEG_BUFFER_SIZE);
 
     formatContext = avformat_alloc_context();
 
@@ -113,8 +357,6 @@ bool FFMpegDemuxer::open()
         return false;
     }
 
-    auto codecContext = stream->codec;
-
     /* find decoder for the stream */
     auto decoder = avcodec_find_decoder(stream->codecpar->codec_id);
     if (!decoder) {
@@ -122,131 +364,38 @@ bool FFMpegDemuxer::open()
         return false;
     }
 
-    if (!codecContext) {
+    if (!stream->codec) {
         qWarning() << "Error in FFMpegDemuxer::open, the codecContext is null";
         return false;
     }
 
-    ret = avcodec_open2(codecContext, decoder, nullptr);
+    ret = avcodec_open2(stream->codec, decoder, nullptr);
     if (ret < 0) {
         qCritical() << av_error_to_qt_string(ret);
         return false;
     }
 
-    frame = av_frame_alloc();
+    codecContext = stream->codec;
+
     if (!frame) {
-        qCritical() << "Could not allocate frame";
-        return false;
+        frame = av_frame_alloc();
+        if (!frame) {
+            qCritical() << "Could not allocate frame";
+            return false;
+        }
     }
 
     return true;
 }
 
-uint FFMpegDemuxer::getFrameRate() const
+uint FFMpegDemuxer::readFrameRate() const
 {
     if (formatContext && formatContext->nb_streams > 0) {
         auto firstStream = formatContext->streams[0];
-        if (firstStream && firstStream->codec) {
+        if (firstStream && firstStream->codec && firstStream->codec->framerate.num > 0) {
             return firstStream->codec->framerate.num;
         }
     }
 
-    return 0;
-}
-
-void FFMpegDemuxer::decode()
-{
-    QList<QImage> decodedImages;
-
-    if (!open()) {
-        qCritical() << "Can't open the video decoder!";
-        emit imagesDecoded(decodedImages, getFrameRate());
-        return;
-    }
-
-    if (!formatContext || formatContext->nb_streams <= 0)
-        return;
-
-    auto codecContext = formatContext->streams[0]->codec;
-
-    if (!codecContext)
-        return;
-
-    /* initialize packet, set data to NULL, let the demuxer fill it */
-    AVPacket packet;
-    packet.data = nullptr;
-    packet.size = 0;
-
-    int ret = 0;
-
-    /* read frames */
-    while ((ret = av_read_frame(formatContext, &packet)) == 0)
-    {
-
-        int framesDecoded = 0;
-
-        while (framesDecoded <= 0)
-        {
-            ret = avcodec_send_packet(codecContext, &packet);
-
-            if (ret != 0) { // error
-                if (ret != AVERROR(EAGAIN)) {
-                    qCritical() << "error decoding video frame" << av_error_to_qt_string(ret) << ret;
-                    emit imagesDecoded(decodedImages, getFrameRate());
-                }
-                return;
-            }
-
-            while((ret = avcodec_receive_frame(codecContext, frame)) == 0)  // got a frame?
-            {
-                int width = (codecContext->width > 0) ? codecContext->width : frame->width;
-                int height = (codecContext->height > 0) ? codecContext->height : frame->height;
-
-                if (!frameRGB) {
-                    frameRGB = av_frame_alloc();
-
-                    // Determine required buffer size and allocate buffer
-                    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, width, height, 1);
-                    rgbBuffer = new uint8_t[numBytes];
-
-                    // Assign appropriate parts of buffer to image planes in pFrameRGB
-                    av_image_fill_arrays(frameRGB->data, frameRGB->linesize, rgbBuffer, AV_PIX_FMT_RGB24, width, height, 1);
-                }
-
-                // Convert the image format (init the context the first time)
-                AVPixelFormat sourcePixelFormat = codecContext->pix_fmt;
-                AVPixelFormat destinationPixelFormat = AV_PIX_FMT_RGB24;
-
-                if (!frame->width || !frame->height) // 0 size images are skipped
-                    continue;
-
-                swsContext = sws_getCachedContext(swsContext, width, height, sourcePixelFormat, width, height, destinationPixelFormat, SWS_BICUBIC, nullptr, nullptr, nullptr);
-
-                if(!swsContext){
-                    qCritical() << "Cannot initialize the conversion context!";
-                    emit imagesDecoded(decodedImages, getFrameRate());
-                    return;
-                }
-                sws_scale(swsContext, frame->data, frame->linesize, 0, height, frameRGB->data, frameRGB->linesize);
-
-                // Convert the frame to QImage
-                QImage img(width, height, QImage::Format_RGB888);
-
-                for(int y=0; y < height; y++)
-                    memcpy(img.scanLine(y), frameRGB->data[0] + y * frameRGB->linesize[0], width * 3);
-
-                decodedImages << img;
-
-                framesDecoded++;
-            }
-
-            if (ret != 0 && ret != AVERROR(EAGAIN)) {
-                qCritical() << "error decoding video frame in avcodec_receive_frame" << av_error_to_qt_string(ret) << ret;
-                emit imagesDecoded(decodedImages, getFrameRate());
-                return;
-            }
-        }
-    }
-
-    emit imagesDecoded(decodedImages, getFrameRate());
+    return DEFAULT_FRAME_RATE;
 }
@@ -7,6 +7,19 @@
 #include <QDataStream>
 #include <QBuffer>
 #include <QImage>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+/**
+    Streaming decoder for the video intervals received from one ninjam user. The frames are decoded
+    on demand in a worker thread, just in time for their presentation timestamp, and stored in a
+    small ring already scaled to the target (widget) size. Only a few frames are in memory at once,
+    no matter the interval length.
+
+    The last received interval is played when the next interval starts (startNextInterval), or
+    immediately when nothing is playing.
+ */
 
 class FFMpegDemuxer : public QObject
 {
@@ -14,31 +27,76 @@ class FFMpegDemuxer : public QObject
     Q_OBJECT
 
 public:
-    FFMpegDemuxer(QObject *parent, const QByteArray &encodedData);
+    explicit FFMpegDemuxer(QObject *parent = nullptr);
     ~FFMpegDemuxer();
 
-    void decode();
+    void addInterval(const QByteArray &encodedData);
+    bool startNextInterval(); // return false when there is nothing to play in the new interval
+
+    QImage getCurrentFrame(); // return the frame to show now, or a null image when there is no new frame
+
+    void setTargetSize(const QSize &size); // decoded frames are scaled to this size, the video size is used when 'size' is not valid
+    QSize getVideoSize() const;
+
+    struct Statistics
+    {
+        quint64 decodedFrames;
+        quint64 skippedFrames; // late frames, decoded but not scaled and showed
+    };
+
+    Statistics getStatistics() const;
 
-signals:
-    void imagesDecoded(QList<QImage> images, uint frameRate);
 private:
+    struct DecodedFrame
+    {
+        QImage image;
+        qint64 timestamp; // ms since the interval start
+    };
+
+    // decoder state, used only in the decoder thread
     AVFormatContext *formatContext;
     AVIOContext *avioContext;
-    SwsContext *swsContext;
+    AVCodecContext *codecContext;
+    SwsContext *swsContext; // cached and reused in all intervals
     AVFrame *frame;
-    AVFrame *frameRGB;
-    uint8_t *rgbBuffer;
-
-    unsigned char *buffer; // avio buffer used in callback
-
     QByteArray encodedData;
     QBuffer encodedBuffer;
+    bool endOfStream;
+    quint64 framesInInterval;
+    QList<QImage> imagesPool;
+    int nextPooledImage;
+
+    // shared by the GUI and decoder threads
+    mutable QMutex mutex;
+    QByteArray pendingInterval;
+    bool switchRequested;
+    bool intervalFinished;
+    bool playing;
+    bool decoding;
+    bool stopRequested;
+    QList<DecodedFrame> readyFrames;
+    QSize targetSize;
+    QSize videoSize;
+    uint frameRate;
+    QElapsedTimer playbackClock;
+    Statistics statistics;
+
+    QThreadPool threadPool;
 
     static int readCallback(void *stream, uint8_t *buffer, int bufferSize);
 
+    void scheduleDecoding(); // must be called with the mutex locked
+    void decodeFrames(); // decoder thread loop, runs until the ring is full
+    bool decodeNextFrame();
+    QImage &getPooledImage(const QSize &size);
+
     void close();
     bool open();
-    uint getFrameRate() const;
+    uint readFrameRate() const;
+
+    static const int MAX_READY_FRAMES = 3;
+    static const int MAX_POOLED_IMAGES = MAX_READY_FRAMES + 2; // 2 images can be in use by the video widget
+    static const uint DEFAULT_FRAME_RATE = 10;
 };
 
 #endif // FFMPEGDEMUXER_H
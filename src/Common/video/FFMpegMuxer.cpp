@@ -1,6 +1,8 @@
 #include "FFMpegMuxer.h"
+#include "RgbToYuvConverter.h"
 
 #include <cstring>
+#include <vector>
 
 #include <QDebug>
 #include <QFile>
@@ -72,6 +74,66 @@ public:
     int samplesCount;
 };
 
+/**
+    Small pool of video frames. A frame is reused when the encoder is not holding a reference
+    to it, so in the common case no picture buffers are allocated while encoding.
+ */
+class FFMpegMuxer::VideoFramePool
+{
+public:
+    ~VideoFramePool()
+    {
+        clear();
+    }
+
+    AVFrame *getWritableFrame(AVPixelFormat pixelFormat, int width, int height)
+    {
+        if (!frames.empty()) {
+            const AVFrame *first = frames.front();
+            if (first->format != pixelFormat || first->width != width || first->height != height)
+                clear(); // resolution changed
+        }
+
+        for (AVFrame *frame : frames) {
+            if (av_frame_is_writable(frame))
+                return frame;
+        }
+
+        if (frames.size() < MAX_FRAMES) {
+            AVFrame *frame = FFMpegMuxer::allocPicture(pixelFormat, width, height);
+            if (frame)
+                frames.push_back(frame);
+
+            return frame;
+        }
+
+        // all frames are referenced by the encoder, the oldest frame get a new buffer
+        AVFrame *frame = frames[nextFrame];
+        nextFrame = (nextFrame + 1) % frames.size();
+        if (av_frame_make_writable(frame) < 0) {
+            qCritical() << "frame not writable";
+            return nullptr;
+        }
+
+        return frame;
+    }
+
+    void clear()
+    {
+        for (AVFrame *frame : frames)
+            av_frame_free(&frame);
+
+        frames.clear();
+        nextFrame = 0;
+    }
+
+private:
+    std::vector<AVFrame *> frames;
+    size_t nextFrame = 0;
+
+    static const size_t MAX_FRAMES = 4;
+};
+
 // +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 FFMpegMuxer::FFMpegMuxer(QObject *parent) :
@@ -86,17 +148,25 @@ FFMpegMuxer::FFMpegMuxer(QObject *parent) :
       frame(nullptr),
       tempFrame(nullptr),
       swsContext(nullptr),
+      framePool(new VideoFramePool()),
       videoResolution(QSize(320, 240)),
       videoFrameRate(25),
       videoBitRate(static_cast<uint>(FFMpegMuxer::VideoQualityMedium)),
       initialized(false),
-      startNewIntervalRequested(false)
+      startNewIntervalRequested(false),
+      pendingImageTimestamp(0),
+      encoderScheduled(false),
+      framesPerInterval(0),
+      statistics(Statistics()),
+      framesInCurrentInterval(0)
 {
     av_register_all();
 
     av_log_set_level(AV_LOG_QUIET); // disabling ffmpeg encoder messages
 
     threadPool.setMaxThreadCount(1);
+
+    clock.start();
 }
 
 void FFMpegMuxer::initialize()
@@ -108,6 +178,7 @@ void FFMpegMuxer::initialize()
 
     videoPts = 0;
     encodedFrames = 0;
+    framesInCurrentInterval = 0;
 }
 
 FFMpegMuxer::~FFMpegMuxer()
@@ -121,25 +192,89 @@ void FFMpegMuxer::finish()
 
 }
 
-void FFMpegMuxer::encodeImage(const QImage &image, bool async)
+void FFMpegMuxer::encodeImage(const QImage &image)
 {
+    if (image.isNull())
+        return;
+
+    QMutexLocker locker(&mailboxMutex);
+
+    statistics.capturedFrames++;
+
+    if (!pendingImage.isNull())
+        statistics.replacedFrames++; // encoder is late, the pending image is replaced by the newest one
+
+    pendingImage = image;
+    pendingImageTimestamp = clock.elapsed();
+
     // encoding in a separated thread
+    if (!encoderScheduled) {
+        encoderScheduled = true;
+        QtConcurrent::run(&threadPool, this, &FFMpegMuxer::encodePendingImages);
+    }
+}
+
+void FFMpegMuxer::encodePendingImages()
+{
+    forever {
+        QImage image;
+        qint64 captureTimestamp;
+        uint frameBudget;
+
+        {
+            QMutexLocker locker(&mailboxMutex);
+            if (pendingImage.isNull()) {
+                encoderScheduled = false;
+                return;
+            }
 
-    auto lambda = [=](){
+            image = pendingImage;
+            pendingImage = QImage();
+            captureTimestamp = pendingImageTimestamp;
+            frameBudget = framesPerInterval;
+        }
 
         if (startNewIntervalRequested) {
             if (prepareToEncodeNewInterval())
                 startNewIntervalRequested = false;
         }
 
-        if (encodeVideo && !image.isNull())
-            encodeVideo = !doEncodeVideoFrame(image);
-    };
+        if (!encodeVideo)
+            continue;
 
-    if (async)
-        QtConcurrent::run(&threadPool, lambda);
-    else
-        lambda();
+        if (frameBudget > 0 && framesInCurrentInterval >= frameBudget) {
+            QMutexLocker locker(&mailboxMutex);
+            statistics.overBudgetFrames++;
+            continue;
+        }
+
+        encodeVideo = !doEncodeVideoFrame(image);
+        framesInCurrentInterval++;
+
+        const float latency = static_cast<float>(clock.elapsed() - captureTimestamp);
+
+        QMutexLocker locker(&mailboxMutex);
+        statistics.encodedFrames++;
+        statistics.maxLatency = qMax(statistics.maxLatency, latency);
+        if (statistics.encodedFrames == 1)
+            statistics.averageLatency = latency;
+        else
+            statistics.averageLatency += (latency - statistics.averageLatency) * 0.1f; // smoothing
+    }
+}
+
+void FFMpegMuxer::setFramesPerInterval(uint frames)
+{
+    QMutexLocker locker(&mailboxMutex);
+
+    framesPerInterval = frames;
+}
+
+FFMpegMuxer::Statistics FFMpegMuxer::getStatistics() const
+{
+    QMutexLocker locker(&mailboxMutex);
+
+    return statistics;
 }
 
 void FFMpegMuxer::encodeAudioFrame()
@@ -212,10 +347,7 @@ void FFMpegMuxer::finishCurrentInterval()
     initialized = false;
     encodedFrames = 0;
 
-    if (frame) {
-        av_frame_free(&frame);
-        frame = nullptr;
-    }
+    frame = nullptr; // the frames are owned by the pool and reused in the next interval
 
     if (tempFrame) {
         av_frame_free(&tempFrame);
@@ -434,6 +566,7 @@ AVFrame *FFMpegMuxer::allocPicture(enum AVPixelFormat pixelFormat, int width, in
     int ret = av_frame_get_buffer(picture, 32);
     if (ret < 0) {
         qCritical() << "Could not allocate frame data.";
+        av_frame_free(&picture);
         return nullptr;
     }
 
@@ -453,8 +586,8 @@ bool FFMpegMuxer::openVideoCodec(AVCodec *codec, AVDictionary **opts)
         return false;
     }
 
-    /* allocate and init a re-usable frame */
-    frame = allocPicture(codecContext->pix_fmt, codecContext->width, codecContext->height);
+    /* get a re-usable frame from the pool */
+    frame = framePool->getWritableFrame(codecContext->pix_fmt, codecContext->width, codecContext->height);
 
     if (!frame) {
         qCritical() << "Could not allocate video frame";
@@ -476,7 +609,6 @@ bool FFMpegMuxer::openVideoCodec(AVCodec *codec, AVDictionary **opts)
 
 void FFMpegMuxer::imageToYuvPicture(const QImage &image, AVFrame *picture, int width, int height)
 {
-
     if (!picture)
         return;
 
@@ -484,99 +616,57 @@ void FFMpegMuxer::imageToYuvPicture(const QImage &image, AVFrame *picture, int w
     width = qMin(width, image.width());
     height = qMin(height, image.height());
 
-    // Preparing the buffer to get YUV420P data
-    auto size = av_image_get_buffer_size(AV_PIX_FMT_YUV420P, width, height, 1);
-    auto pic_dat = (uint8_t *) av_malloc(size);
+    // the converter is reading 32 bits pixels, other formats (RGB565, RGB555) are converted first
+    const QImage::Format format = image.format();
+    const bool is32Bits = format == QImage::Format_RGB32 || format == QImage::Format_ARGB32 || format == QImage::Format_ARGB32_Premultiplied;
+    const QImage rgbImage = is32Bits ? image : image.convertToFormat(QImage::Format_RGB32);
 
-    // Transforming data from RGB to YUV420P
-    RGBtoYUV420P(image.bits(), pic_dat, image.depth()/8, true, width, height);
+    // transforming data from RGB to YUV420P directly in the picture planes
+    RgbToYuvConverter::convert(rgbImage.constBits(), rgbImage.bytesPerLine(), width, height,
+                               picture->data[0], picture->linesize[0],
+                               picture->data[1], picture->linesize[1],
+                               picture->data[2], picture->linesize[2]);
 
     picture->quality = 0;
-
-    // Filling AVFrame with YUV420P data
-    av_image_fill_arrays(picture->data, picture->linesize, pic_dat, AV_PIX_FMT_YUV420P, width, height, 1);
-}
-
-void FFMpegMuxer::RGBtoYUV420P(const uint8_t *bufferRGB, uint8_t *bufferYUV, uint rgbIncrement, bool swapRGB, int width, int height)
-{
-    if (!bufferRGB || !bufferYUV)
-        return;
-
-    const unsigned iPlaneSize = width * height;
-    const unsigned iHalfWidth = width >> 1;
-
-    // get pointers to the data
-    uint8_t *yplane  = bufferYUV;
-    uint8_t *uplane  = bufferYUV + iPlaneSize;
-    uint8_t *vplane  = bufferYUV + iPlaneSize + (iPlaneSize >> 2);
-    const uint8_t *bufferRGBIndex = bufferRGB;
-
-    int iRGBIdx[3];
-    iRGBIdx[0] = 0;
-    iRGBIdx[1] = 1;
-    iRGBIdx[2] = 2;
-    if (swapRGB)  {
-        iRGBIdx[0] = 2;
-        iRGBIdx[2] = 0;
-    }
-
-    for (int y = 0; y < (int) height; y++) {
-         uint8_t *yline  = yplane + (y * width);
-         uint8_t *uline  = uplane + ((y >> 1) * iHalfWidth);
-         uint8_t *vline  = vplane + ((y >> 1) * iHalfWidth);
-
-         for (int x=0; x<width; x+=2) {
-              RGBtoYUV(bufferRGBIndex[iRGBIdx[0]], bufferRGBIndex[iRGBIdx[1]], bufferRGBIndex[iRGBIdx[2]], *yline, *uline, *vline);
-              bufferRGBIndex += rgbIncrement;
-              yline++;
-              RGBtoYUV(bufferRGBIndex[iRGBIdx[0]], bufferRGBIndex[iRGBIdx[1]], bufferRGBIndex[iRGBIdx[2]], *yline, *uline, *vline);
-              bufferRGBIndex += rgbIncrement;
-              yline++;
-              uline++;
-              vline++;
-         }
-    }
 }
 
-void FFMpegMuxer::fillFrameWithImageData(const QImage &image)
+bool FFMpegMuxer::fillFrameWithImageData(const QImage &image)
 {
-    /* when we pass a frame to the encoder, it may keep a reference to it internally; make sure we do not overwrite it here */
-    if (av_frame_make_writable(frame) < 0) {
-        qCritical() << "frame not writable";
-        return;
-    }
-
     if (!codecContext) {
         qCritical() << "Error in FFMpegMuxer::fillFrameWithImageData, codecContext is null";
-        return;
+        return false;
+    }
+
+    /* when we pass a frame to the encoder, it may keep a reference to it internally; the pool returns a frame we can overwrite */
+    frame = framePool->getWritableFrame(codecContext->pix_fmt, codecContext->width, codecContext->height);
+    if (!frame) {
+        qCritical() << "Error in FFMpegMuxer::fillFrameWithImageData, frame is null";
+        return false;
     }
 
     if (codecContext->pix_fmt != AV_PIX_FMT_YUV420P) { /* need image convertion? as we only generate a YUV420P picture, we must convert it to the codec pixel format if needed */
+        // the cached context is reused while the parameters are the same
+        swsContext = sws_getCachedContext(swsContext, codecContext->width, codecContext->height, AV_PIX_FMT_YUV420P, codecContext->width, codecContext->height, codecContext->pix_fmt, SWS_BICUBIC, NULL, NULL, NULL);
         if (!swsContext) {
-            swsContext = sws_getContext(image.width(), image.height(), AV_PIX_FMT_YUV420P, codecContext->width, codecContext->height, codecContext->pix_fmt, SWS_BICUBIC, NULL, NULL, NULL);
-            if (!swsContext) {
-                qCritical() << "Could not initialize the conversion context";
-                return;
-            }
+            qCritical() << "Could not initialize the conversion context";
+            return false;
         }
 
         if (!tempFrame) {
             qCritical() << "Error in FFMpegMuxer::fillFrameWithImageData, tempFrame is null";
-            return;
+            return false;
         }
 
         imageToYuvPicture(image, tempFrame, codecContext->width, codecContext->height);
         sws_scale(swsContext, (const uint8_t * const *)tempFrame->data, tempFrame->linesize, 0, codecContext->height, frame->data, frame->linesize);
     }
     else {
-        if (!frame) {
-            qCritical() << "Error in FFMpegMuxer::fillFrameWithImageData, frame is null";
-            return;
-        }
         imageToYuvPicture(image, frame, codecContext->width, codecContext->height);
     }
 
     frame->pts = videoPts++;
+
+    return true;
 }
 
 /*
@@ -599,16 +689,13 @@ bool FFMpegMuxer::doEncodeVideoFrame(const QImage &image)
         return false;
     }
 
-    if (!image.isNull())
-        fillFrameWithImageData(image);
+    if (!image.isNull() && !fillFrameWithImageData(image))
+        return false;
 
     // send the image to encoder, send nullpr if finishing
     int ret = avcodec_send_frame(codecContext, (!image.isNull()) ? frame : nullptr);
 
     if (!image.isNull()) {
-        // releasing the allocated memory - fix https://github.com/elieserdejesus/JamTaba/issues/951
-        av_freep(frame);
-
         if (ret != 0 && ret != AVERROR_EOF) {
             qCritical() << "Error encoding video frame: " << av_error_to_qt_string(ret) << ret;
             return false;
@@ -7,12 +7,21 @@
 #include <QFile>
 #include <QDebug>
 #include <QThreadPool>
+#include <QMutex>
+#include <QElapsedTimer>
 
 #include "FFMpegCommon.h"
 
 #include <memory>
 
-// adapted from FFMpeg muxing.c example
+/**
+    Adapted from FFMpeg muxing.c example.
+
+    The captured images are posted in a single slot mailbox and encoded in a worker thread. When the
+    encoder is late the image waiting in the mailbox is replaced by the new one (the latest frame wins),
+    so the memory used by pending frames is bounded and the intervals are closed on time. Each interval
+    has a frame budget, the images exceeding the budget are dropped too.
+ */
 
 class FFMpegMuxer : public QObject
 {
@@ -24,9 +33,23 @@ public:
 
     void finish();
 
-    void encodeImage(const QImage &image, bool async = true);
+    void encodeImage(const QImage &image); // thread safe, the image is encoded in the encoder thread
     void encodeAudioFrame();
 
+    void setFramesPerInterval(uint frames); // the frame budget for each interval, 0 is unlimited
+
+    struct Statistics
+    {
+        quint64 capturedFrames;
+        quint64 encodedFrames;
+        quint64 replacedFrames;   // dropped in the mailbox because the encoder was late
+        quint64 overBudgetFrames; // dropped because the interval frame budget was reached
+        float averageLatency;     // ms between the capture and the end of encoding
+        float maxLatency;
+    };
+
+    Statistics getStatistics() const;
+
     void setVideoResolution(const QSize &resolution);
     QSize getVideoResolution() const;
 
@@ -66,14 +89,15 @@ private:
     bool openVideoCodec(AVCodec *codec, AVDictionary **opts);
     void openAudioCodec(AVCodec *codec);
 
+    void encodePendingImages(); // encoder thread loop, runs while the mailbox has images
+
     bool doEncodeVideoFrame(const QImage &image);
     bool doEncodeAudioFrame(); // TODO add a SamplesBuffer parameter
 
     AVFrame *allocAudioFrame(enum AVSampleFormat sampleFormat, uint64_t channelLayout, int sampleRate, int nbSamples);
-    AVFrame *allocPicture(enum AVPixelFormat pixelFormat, int width, int height);
+    static AVFrame *allocPicture(enum AVPixelFormat pixelFormat, int width, int height);
     void imageToYuvPicture(const QImage &image, AVFrame *picture, int width, int height);
-    void fillFrameWithImageData(const QImage &image);
-    void RGBtoYUV420P(const uint8_t *bufferRGB, uint8_t *bufferYUV, uint rgbIncrement, bool swapRGB, int width, int height);
+    bool fillFrameWithImageData(const QImage &image);
 
     void initialize();
 
@@ -86,6 +110,7 @@ private:
     // internal streams
     class VideoOutputStream;
     class AudioOutputStream;
+    class VideoFramePool;
 
     //std::unique_ptr<VideoOutputStream> videoStream;
     std::unique_ptr<AudioOutputStream> audioStream;
@@ -96,6 +121,8 @@ private:
     AVFrame *tempFrame;
     SwsContext *swsContext;
 
+    std::unique_ptr<VideoFramePool> framePool; // the frames are reused in all intervals while the resolution is not changed
+
     QSize videoResolution;
     qreal videoFrameRate;
     uint videoBitRate;
@@ -103,6 +130,17 @@ private:
     bool initialized;
     bool startNewIntervalRequested;
 
+    // mailbox, shared by the capture and encoder threads
+    mutable QMutex mailboxMutex;
+    QImage pendingImage;
+    qint64 pendingImageTimestamp;
+    bool encoderScheduled;
+    uint framesPerInterval;
+    Statistics statistics;
+    QElapsedTimer clock;
+
+    uint framesInCurrentInterval; // used only in encoder thread
+
     QThreadPool threadPool;
 };
 
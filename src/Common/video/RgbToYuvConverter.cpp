@@ -0,0 +1,183 @@
+#include "RgbToYuvConverter.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RGB_TO_YUV_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
+/*
+    Fixed point coefficients (scaled by 256), the same weights used by the old RGBtoYUV macro:
+    Y = 0.30R + 0.59G + 0.11B
+    U = 0.50B - 0.33G - 0.17R + 128
+    V = 0.50R - 0.42G - 0.08B + 128
+
+    The U and V coefficients sum to zero and the Y coefficients sum to 256, so the
+    results are always in [0, 255] and no clamping is necessary.
+ */
+
+namespace {
+
+const int Y_B = 29;
+const int Y_G = 150;
+const int Y_R = 77;
+
+const int U_B = 127;
+const int U_G = -84;
+const int U_R = -43;
+
+const int V_B = -21;
+const int V_G = -106;
+const int V_R = 127;
+
+const int CHROMA_OFFSET = (128 << 10) + 512; // the chroma sums are computed from 4 pixels, so the results are scaled by 1024
+
+void convertLumaRow(const uint8_t *bgra, int from, int width, uint8_t *y)
+{
+    for (int x = from; x < width; ++x) {
+        const uint8_t *pixel = bgra + x * 4;
+        y[x] = static_cast<uint8_t>((Y_B * pixel[0] + Y_G * pixel[1] + Y_R * pixel[2] + 128) >> 8);
+    }
+}
+
+void convertChromaRow(const uint8_t *row0, const uint8_t *row1, int from, int width, uint8_t *u, uint8_t *v)
+{
+    const int chromaWidth = (width + 1) / 2;
+    for (int c = from; c < chromaWidth; ++c) {
+        const int x0 = c * 2 * 4;
+        const int x1 = (c * 2 + 1 < width) ? x0 + 4 : x0; // odd widths are using the last pixel twice
+
+        const int b = row0[x0]     + row0[x1]     + row1[x0]     + row1[x1];
+        const int g = row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1];
+        const int r = row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2];
+
+        u[c] = static_cast<uint8_t>((U_B * b + U_G * g + U_R * r + CHROMA_OFFSET) >> 10);
+        v[c] = static_cast<uint8_t>((V_B * b + V_G * g + V_R * r + CHROMA_OFFSET) >> 10);
+    }
+}
+
+#ifdef RGB_TO_YUV_USE_SSE2
+
+// sum the adjacent 32 bits lanes produced by _mm_madd_epi16 (one pixel per lanes pair) and pick the even lanes of 'a' and 'b'
+inline __m128i sumLanePairs(__m128i a, __m128i b)
+{
+    a = _mm_add_epi32(a, _mm_srli_epi64(a, 32));
+    b = _mm_add_epi32(b, _mm_srli_epi64(b, 32));
+    return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+// Y values (32 bits) of 4 BGRA pixels
+inline __m128i luma4(const uint8_t *bgra, __m128i coefficients)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bgra));
+    const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coefficients);
+    const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coefficients);
+    return _mm_srli_epi32(_mm_add_epi32(sumLanePairs(lo, hi), _mm_set1_epi32(128)), 8);
+}
+
+// BGRA sums (16 bits) of two 2x2 pixel blocks, 4 pixels in each row
+inline __m128i blockSums2(const uint8_t *row0, const uint8_t *row1)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1));
+
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)); // pixels 0 and 1, vertical sums
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)); // pixels 2 and 3
+
+    lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8)); // horizontal sums in the low 64 bits
+    hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+    return _mm_unpacklo_epi64(lo, hi);
+}
+
+inline void storeChroma4(__m128i values, uint8_t *dest)
+{
+    values = _mm_srai_epi32(_mm_add_epi32(values, _mm_set1_epi32(CHROMA_OFFSET)), 10);
+    values = _mm_packs_epi32(values, values);
+    values = _mm_packus_epi16(values, values);
+
+    const int bytes = _mm_cvtsi128_si32(values);
+    std::memcpy(dest, &bytes, 4);
+}
+
+int convertLumaRowSSE2(const uint8_t *bgra, int width, uint8_t *y)
+{
+    const __m128i coefficients = _mm_setr_epi16(Y_B, Y_G, Y_R, 0, Y_B, Y_G, Y_R, 0);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8_t *pixels = bgra + x * 4;
+        const __m128i first = _mm_packs_epi32(luma4(pixels, coefficients), luma4(pixels + 16, coefficients));
+        const __m128i second = _mm_packs_epi32(luma4(pixels + 32, coefficients), luma4(pixels + 48, coefficients));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(y + x), _mm_packus_epi16(first, second));
+    }
+
+    return x;
+}
+
+int convertChromaRowSSE2(const uint8_t *row0, const uint8_t *row1, int width, uint8_t *u, uint8_t *v)
+{
+    const __m128i uCoefficients = _mm_setr_epi16(U_B, U_G, U_R, 0, U_B, U_G, U_R, 0);
+    const __m128i vCoefficients = _mm_setr_epi16(V_B, V_G, V_R, 0, V_B, V_G, V_R, 0);
+
+    int c = 0;
+    for (; c * 2 + 8 <= width; c += 4) {
+        const int offset = c * 2 * 4;
+        const __m128i first = blockSums2(row0 + offset, row1 + offset);
+        const __m128i second = blockSums2(row0 + offset + 16, row1 + offset + 16);
+
+        storeChroma4(sumLanePairs(_mm_madd_epi16(first, uCoefficients), _mm_madd_epi16(second, uCoefficients)), u + c);
+        storeChroma4(sumLanePairs(_mm_madd_epi16(first, vCoefficients), _mm_madd_epi16(second, vCoefficients)), v + c);
+    }
+
+    return c;
+}
+
+#endif
+
+} // namespace
+
+void RgbToYuvConverter::convert(const uint8_t *bgra, int bgraStride, int width, int height,
+                                uint8_t *y, int yStride, uint8_t *u, int uStride, uint8_t *v, int vStride)
+{
+#ifdef RGB_TO_YUV_USE_SSE2
+    if (!bgra || !y || !u || !v || width <= 0 || height <= 0)
+        return;
+
+    for (int row = 0; row < height; ++row) {
+        const uint8_t *line = bgra + row * bgraStride;
+        uint8_t *yLine = y + row * yStride;
+        convertLumaRow(line, convertLumaRowSSE2(line, width, yLine), width, yLine);
+
+        if (row % 2 == 0) {
+            const uint8_t *nextLine = (row + 1 < height) ? line + bgraStride : line; // odd heights are using the last row twice
+            uint8_t *uLine = u + (row / 2) * uStride;
+            uint8_t *vLine = v + (row / 2) * vStride;
+            const int from = convertChromaRowSSE2(line, nextLine, width, uLine, vLine);
+            convertChromaRow(line, nextLine, from, width, uLine, vLine);
+        }
+    }
+#else
+    convertScalar(bgra, bgraStride, width, height, y, yStride, u, uStride, v, vStride);
+#endif
+}
+
+void RgbToYuvConverter::convertScalar(const uint8_t *bgra, int bgraStride, int width, int height,
+                                      uint8_t *y, int yStride, uint8_t *u, int uStride, uint8_t *v, int vStride)
+{
+    if (!bgra || !y || !u || !v || width <= 0 || height <= 0)
+        return;
+
+    for (int row = 0; row < height; ++row) {
+        const uint8_t *line = bgra + row * bgraStride;
+        convertLumaRow(line, 0, width, y + row * yStride);
+
+        if (row % 2 == 0) {
+            const uint8_t *nextLine = (row + 1 < height) ? line + bgraStride : line;
+            convertChromaRow(line, nextLine, 0, width, u + (row / 2) * uStride, v + (row / 2) * vStride);
+        }
+    }
+}
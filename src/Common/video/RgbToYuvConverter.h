@@ -0,0 +1,24 @@
+#ifndef _RGB_TO_YUV_CONVERTER_
+#define _RGB_TO_YUV_CONVERTER_
+
+#include <cstdint>
+
+/**
+    Converts 32 bits images (QImage::Format_RGB32 and ARGB32, stored as B, G, R, A bytes in little endian
+    machines) to planar YUV 4:2:0. Each U and V sample is computed from the average of a 2x2 pixels block.
+    The strides (bytes per line) of the source image and the destination planes are honoured, so the
+    conversion can write directly in the AVFrame planes. The SSE2 path produces the same output of the
+    scalar path, the scalar code is used in the tails and when SSE2 is not available.
+ */
+
+class RgbToYuvConverter
+{
+public:
+    static void convert(const uint8_t *bgra, int bgraStride, int width, int height,
+                        uint8_t *y, int yStride, uint8_t *u, int uStride, uint8_t *v, int vStride);
+
+    static void convertScalar(const uint8_t *bgra, int bgraStride, int width, int height,
+                              uint8_t *y, int yStride, uint8_t *u, int uStride, uint8_t *v, int vStride);
+};
+
+#endif
@@ -3,12 +3,35 @@
 #include <QPainter>
 #include <QDateTime>
 
+#include <cstring>
+
 CameraFrameGrabber::CameraFrameGrabber(QObject * parent) :
-    QAbstractVideoSurface(parent)
+    QAbstractVideoSurface(parent),
+    nextPooledImage(0)
 {
 
 }
 
+QImage &CameraFrameGrabber::getPooledImage(const QSize &size, QImage::Format format)
+{
+    for (QImage &image : imagesPool) {
+        if (image.isDetached() && image.size() == size && image.format() == format)
+            return image;
+    }
+
+    if (imagesPool.size() < MAX_POOLED_IMAGES) {
+        imagesPool.append(QImage(size, format));
+        return imagesPool.last();
+    }
+
+    // all images are in use (or the resolution changed), replacing one of them
+    QImage &image = imagesPool[nextPooledImage];
+    nextPooledImage = (nextPooledImage + 1) % MAX_POOLED_IMAGES;
+    image = QImage(size, format);
+
+    return image;
+}
+
 bool CameraFrameGrabber::present(const QVideoFrame& frame)
 {
     if (frame.isValid()) {
@@ -19,12 +42,22 @@ bool CameraFrameGrabber::present(const QVideoFrame& frame)
 
             QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(cloneFrame.pixelFormat());
             if (imageFormat != QImage::Format_Invalid) {
-                lastImage = QImage(cloneFrame.bits(), cloneFrame.width(), cloneFrame.height(), imageFormat)
-                        .copy(); // necessary
 
+                // copying the mapped frame to a recycled image, the frame bits are valid only until unmap()
+                QImage &image = getPooledImage(cloneFrame.size(), imageFormat);
+
+                const int height = image.height();
+                const int bytesPerLine = qMin(image.bytesPerLine(), cloneFrame.bytesPerLine());
+                for (int line = 0; line < height; ++line) {
 #ifdef Q_OS_WIN
-                lastImage = lastImage.mirrored(false, true);
+                    const int sourceLine = height - 1 - line; // mirrored
+#else
+                    const int sourceLine = line;
 #endif
+                    std::memcpy(image.scanLine(line), cloneFrame.bits() + sourceLine * cloneFrame.bytesPerLine(), bytesPerLine);
+                }
+
+                lastImage = image;
 
                 emit frameAvailable(lastImage);
             }
@@ -57,8 +57,15 @@ signals:
 
 
 private:
+    QImage &getPooledImage(const QSize &size, QImage::Format format);
+
     QImage lastImage;
 
+    QList<QImage> imagesPool; // images not shared anymore (encoded and painted) are reused to copy the next frames
+    int nextPooledImage;
+
+    static const int MAX_POOLED_IMAGES = 4;
+
 };
 
 #endif
@@ -46,26 +46,40 @@ void VideoWidget::setCurrentFrame(const QImage &image)
         update();
 }
 
-void VideoWidget::updateScaledImage()
+QRect VideoWidget::computeTargetRect(const QSize &imageSize) const
 {
-    QRect sourceRect = currentImage.rect();
+    if (imageSize.isEmpty())
+        return QRect();
 
     qreal ratio = 1.0;
 
     bool small = height() < width();
     if (small)
-        ratio =  static_cast<float>(height())/sourceRect.height();
+        ratio =  static_cast<float>(height())/imageSize.height();
     else
-        ratio =  static_cast<float>(width())/sourceRect.width();
+        ratio =  static_cast<float>(width())/imageSize.width();
 
-    qreal targetHeight = small ? height() : currentImage.height() * ratio;
-    qreal targetWidth = small ? currentImage.width() * ratio : width();
+    qreal targetHeight = small ? height() : imageSize.height() * ratio;
+    qreal targetWidth = small ? imageSize.width() * ratio : width();
     qreal targetX = (width() - targetWidth) / 2.0;
     qreal targetY = (height() - targetHeight) / 2.0;
 
-    targetRect = QRect(targetX, targetY, targetWidth, targetHeight);
+    return QRect(targetX, targetY, targetWidth, targetHeight);
+}
+
+QSize VideoWidget::getTargetSize(const QSize &imageSize) const
+{
+    return computeTargetRect(imageSize).size();
+}
 
-    scaledImage = currentImage.scaled(targetRect.size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+void VideoWidget::updateScaledImage()
+{
+    targetRect = computeTargetRect(currentImage.size());
+
+    if (currentImage.size() == targetRect.size())
+        scaledImage = currentImage; // already scaled by the decoder
+    else
+        scaledImage = currentImage.scaled(targetRect.size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
 }
 
 void VideoWidget::resizeEvent(QResizeEvent *ev)
@@ -16,6 +16,8 @@ public:
 
     void setCurrentFrame(const QImage &image);
 
+    QSize getTargetSize(const QSize &imageSize) const; // the size used to paint images, frames with this size are painted without rescaling
+
     void activate(bool status);
 
     inline bool isActivated() const
@@ -46,6 +48,7 @@ private:
     qreal imageRatio;
 
     void updateScaledImage();
+    QRect computeTargetRect(const QSize &imageSize) const;
 
     bool activated;
 
@@ -10,6 +10,7 @@
 namespace vst {
 
 class VstPlugin;
+class BridgedVstPlugin;
 class VstLoader;
 
 class VstHost : public QObject, public Host
@@ -18,6 +19,7 @@ class VstHost : public QObject, public Host
     Q_OBJECT
 
     friend class VstPlugin;
+    friend class BridgedVstPlugin; // forwarding the time line to the bridged plugins
     friend class VstLoader;
 
 public:
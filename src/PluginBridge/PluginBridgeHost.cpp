@@ -0,0 +1,240 @@
+#include "PluginBridgeHost.h"
+#include "VstPlugin.h"
+#include "vst/VstHost.h"
+#include "audio/core/SamplesBuffer.h"
+#include "midi/MidiMessage.h"
+#include "log/Logging.h"
+
+#include <QApplication>
+#include <QDialog>
+#include <QPoint>
+#include <iostream>
+#include <string>
+
+using audio::SamplesBuffer;
+
+namespace {
+const int REQUEST_TIMEOUT = 100000; // microseconds, the audio loop is checking the 'running' flag after timeouts
+}
+
+class PluginBridgeHost::AudioThread : public QThread
+{
+public:
+    explicit AudioThread(PluginBridgeHost *bridgeHost) :
+        bridgeHost(bridgeHost)
+    {
+        //
+    }
+
+protected:
+    void run() override
+    {
+        bridgeHost->processAudio();
+    }
+
+private:
+    PluginBridgeHost *bridgeHost;
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+class PluginBridgeHost::CommandReader : public QThread // blocking reads in standard input, not possible with QSocketNotifier in Windows
+{
+    Q_OBJECT
+
+public:
+    CommandReader()
+    {
+        //
+    }
+
+signals:
+    void commandReceived(const QString &command);
+
+protected:
+    void run() override
+    {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            const QString command = QString::fromStdString(line).trimmed();
+            if (!command.isEmpty())
+                emit commandReceived(command);
+        }
+
+        emit commandReceived("quit"); // JamTaba closed the pipe
+    }
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+PluginBridgeHost::PluginBridgeHost(const QString &transportKey, const QString &pluginPath, int sampleRate, int blockSize) :
+    transport(transportKey),
+    pluginPath(pluginPath),
+    sampleRate(sampleRate),
+    blockSize(blockSize),
+    host(vst::VstHost::getInstance()),
+    running(0)
+{
+
+}
+
+PluginBridgeHost::~PluginBridgeHost()
+{
+    stop();
+}
+
+bool PluginBridgeHost::start()
+{
+    if (!transport.attach()) {
+        writeToProcessOutput("JT-Bridge-Error: can't attach the shared memory");
+        return false;
+    }
+
+    host->setSampleRate(sampleRate);
+    host->setBlockSize(blockSize);
+
+    connect(host, &vst::VstHost::pluginRequestingWindowResize, this, &PluginBridgeHost::resizeEditor);
+
+    plugin.reset(new vst::VstPlugin(host, pluginPath));
+    if (!plugin->load(pluginPath)) {
+        writeToProcessOutput("JT-Bridge-Error: can't load " + pluginPath);
+        plugin.reset();
+        return false;
+    }
+
+    plugin->start();
+
+    running.storeRelease(1);
+
+    audioThread.reset(new AudioThread(this));
+    audioThread->start(QThread::TimeCriticalPriority);
+
+    commandReader.reset(new CommandReader());
+    connect(commandReader.data(), &CommandReader::commandReceived, this, &PluginBridgeHost::executeCommand, Qt::QueuedConnection);
+    commandReader->start();
+
+    connect(&editorTimer, &QTimer::timeout, this, [=]() { plugin->updateGui(); });
+    editorTimer.start(30);
+
+    const QString isVirtualInstrument = plugin->isVirtualInstrument() ? "1" : "0";
+    const QString canGenerateMidiMessages = plugin->canGenerateMidiMessages() ? "1" : "0";
+    writeToProcessOutput("JT-Bridge-Ready: " + plugin->getName() + ";" + isVirtualInstrument + ";" + canGenerateMidiMessages);
+
+    qCDebug(jtVstPlugin) << plugin->getName() << "bridged in process" << QCoreApplication::applicationPid();
+
+    return true;
+}
+
+void PluginBridgeHost::stop()
+{
+    running.storeRelease(0);
+
+    editorTimer.stop();
+
+    if (audioThread) {
+        audioThread->wait();
+        audioThread.reset();
+    }
+
+    if (plugin) {
+        plugin->closeEditor();
+        plugin.reset();
+    }
+
+    transport.close();
+
+    // the command reader is blocked in standard input, the thread is discarded when the process finish
+    if (commandReader)
+        commandReader.take()->disconnect(this);
+}
+
+void PluginBridgeHost::processAudio()
+{
+    SamplesBuffer in(2, bridge::BridgeTransport::MAX_FRAMES);
+    SamplesBuffer out(2, bridge::BridgeTransport::MAX_FRAMES);
+    std::vector<midi::MidiMessage> midiMessages;
+    midiMessages.reserve(bridge::BridgeTransport::MAX_MIDI_MESSAGES);
+
+    bridge::BridgeTransport::TimeInfo timeInfo;
+    bool playing = false;
+
+    while (running.loadAcquire()) {
+        if (!transport.waitRequest(in, midiMessages, timeInfo, REQUEST_TIMEOUT))
+            continue;
+
+        if (static_cast<int>(timeInfo.sampleRate) != host->getSampleRate()) {
+            host->setSampleRate(timeInfo.sampleRate);
+            plugin->setSampleRate(timeInfo.sampleRate);
+        }
+
+        if (timeInfo.playing != playing) {
+            playing = timeInfo.playing;
+            host->setPlayingFlag(playing);
+        }
+
+        if (playing) {
+            host->setTempo(timeInfo.bpm);
+            host->setPositionInSamples(timeInfo.positionInSamples);
+        }
+
+        // the output starts with the input samples, VSTis are adding their samples, VSTs are replacing
+        out.setFrameLenght(in.getFrameLenght());
+        if (in.getChannels() > 1)
+            out.setToStereo();
+        else
+            out.setToMono();
+
+        out.set(in);
+
+        plugin->process(in, out, midiMessages);
+
+        // the midi messages generated by the plugin are received in the host callback, in this thread
+        transport.sendResponse(out, host->pullReceivedMidiMessages(), static_cast<quint32>(plugin->getLatency()));
+    }
+}
+
+void PluginBridgeHost::executeCommand(const QString &command)
+{
+    const QString name = command.section(' ', 0, 0);
+    const QString argument = command.section(' ', 1);
+
+    if (name == "open-editor") {
+        const QPoint centerOfScreen(argument.section(' ', 0, 0).toInt(), argument.section(' ', 1, 1).toInt());
+        plugin->openEditor(centerOfScreen);
+    }
+    else if (name == "close-editor") {
+        plugin->closeEditor();
+    }
+    else if (name == "get-state") {
+        writeToProcessOutput("JT-Bridge-State: " + QString::fromLatin1(plugin->getSerializedData().toBase64()));
+    }
+    else if (name == "set-state") {
+        plugin->restoreFromSerializedData(QByteArray::fromBase64(argument.toLatin1()));
+    }
+    else if (name == "bypass") {
+        plugin->setBypass(argument == "1");
+    }
+    else if (name == "quit") {
+        stop();
+        QApplication::quit();
+    }
+    else {
+        qCritical() << "Unknown plugin bridge command" << command;
+    }
+}
+
+void PluginBridgeHost::resizeEditor(const QString &pluginName, int newWidth, int newHeight)
+{
+    auto editorWindow = vst::VstPlugin::getPluginEditorWindow(pluginName);
+    if (editorWindow)
+        editorWindow->setFixedSize(newWidth, newHeight);
+}
+
+void PluginBridgeHost::writeToProcessOutput(const QString &string)
+{
+    // using '\n' here because std::endl don't work well when reading the output from QProcess
+    std::cout << '\n' << string.toStdString() << '\n';
+    std::flush(std::cout);
+}
+
+#include "PluginBridgeHost.moc"
@@ -0,0 +1,68 @@
+#ifndef PLUGIN_BRIDGE_HOST_H
+#define PLUGIN_BRIDGE_HOST_H
+
+#include "bridge/BridgeTransport.h"
+
+#include <QObject>
+#include <QThread>
+#include <QAtomicInt>
+#include <QScopedPointer>
+#include <QTimer>
+
+namespace vst {
+class VstHost;
+class VstPlugin;
+}
+
+/**
+    Host a single VST plugin in a separated process. Audio and MIDI are exchanged with JamTaba using
+    the shared memory BridgeTransport, the control commands (editor, state, bypass) are received from
+    the standard input and the answers are written in the standard output:
+
+        JT-Bridge-Ready: name;isVirtualInstrument
+        JT-Bridge-State: base64 serialized plugin data
+        JT-Bridge-Error: message
+
+    The process is finished when the 'quit' command is received or when the standard input is closed
+    (JamTaba was closed or crashed).
+ */
+
+class PluginBridgeHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    PluginBridgeHost(const QString &transportKey, const QString &pluginPath, int sampleRate, int blockSize);
+    ~PluginBridgeHost();
+
+    bool start();
+
+private slots:
+    void executeCommand(const QString &command);
+    void resizeEditor(const QString &pluginName, int newWidth, int newHeight);
+
+private:
+    class AudioThread;
+    class CommandReader;
+
+    void processAudio(); // the loop running in the audio thread
+    void stop();
+
+    static void writeToProcessOutput(const QString &string);
+
+    bridge::BridgeTransport transport;
+    QString pluginPath;
+    int sampleRate;
+    int blockSize;
+
+    vst::VstHost *host;
+    QScopedPointer<vst::VstPlugin> plugin;
+
+    QScopedPointer<AudioThread> audioThread;
+    QScopedPointer<CommandReader> commandReader;
+    QAtomicInt running;
+
+    QTimer editorTimer; // the editor idle messages (effEditIdle)
+};
+
+#endif // PLUGIN_BRIDGE_HOST_H
@@ -0,0 +1,21 @@
+#include "PluginBridgeHost.h"
+
+#include <QApplication>
+
+// usage: PluginBridge <shared memory key> <plugin path> <sample rate> <block size>
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    app.setQuitOnLastWindowClosed(false); // closing the plugin editor will not finish the process
+
+    const QStringList args = app.arguments();
+    if (args.size() < 5)
+        return 1;
+
+    PluginBridgeHost bridgeHost(args.at(1), args.at(2), args.at(3).toInt(), args.at(4).toInt());
+    if (!bridgeHost.start())
+        return 1;
+
+    return app.exec();
+}
@@ -70,15 +70,17 @@ public:
         return std::vector<midi::MidiMessage>(); // empty buffer
     }
 
-    void startMidiClock() const override {};
+    void startMidiClock(quint64) const override {};
     void stopMidiClock() const override {};
-    void continueMidiClock() const override {};
-    void sendMidiClockPulse() const override {};
+    void continueMidiClock(quint64) const override {};
+    void sendMidiClockPulse(quint64) const override {};
 
 protected:
-    inline std::vector<midi::MidiMessage> pullMidiMessagesFromDevices() override
+    inline void pullMidiMessagesFromDevices(std::vector<midi::MidiMessage> &buffer, quint64 sampleClock, int sampleRate) override
     {
-        return std::vector<midi::MidiMessage>(); // empty buffer
+        Q_UNUSED(buffer) // no midi devices in plugin version
+        Q_UNUSED(sampleClock)
+        Q_UNUSED(sampleRate)
     }
 
     JamTabaPlugin *plugin;
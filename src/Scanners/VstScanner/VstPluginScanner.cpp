@@ -9,6 +9,7 @@
 #include <QDataStream>
 #include <QDirIterator>
 #include <QLibrary>
+#include <QSet>
 
 VstPluginScanner::VstPluginScanner()
     : BaseScanner()
@@ -43,6 +44,14 @@ audio::PluginDescriptor VstPluginScanner::getPluginDescriptor(const QFileInfo &p
 
 void VstPluginScanner::scan()
 {
+    if (!pluginsToScan.isEmpty()) {
+        writeToProcessOutput("JT-Scanner-Starting");
+        for (const QString &pluginPath : pluginsToScan)
+            scanPlugin(QFileInfo(pluginPath));
+        writeToProcessOutput("JT-Scanner-Finished");
+        return;
+    }
+
     if (foldersToScan.isEmpty()) {
         qCInfo(jtStandalonePluginFinder) << "Folders to scan is empty!";
         return;
@@ -50,6 +59,8 @@ void VstPluginScanner::scan()
         qCDebug(jtStandalonePluginFinder) << "Folders to scan: " << foldersToScan;
     }
 
+    const QSet<QString> skipSet = skipList.toSet();
+
     writeToProcessOutput("JT-Scanner-Starting");
     for (const QString &scanFolder : foldersToScan)
     {
@@ -59,20 +70,20 @@ void VstPluginScanner::scan()
             folderIterator.next(); // point to next file inside current folder
             QFileInfo pluginFileInfo(folderIterator.filePath());
 
-            if (!skipList.contains(pluginFileInfo.absoluteFilePath()))
-            {
-                if (canScan(pluginFileInfo)) {
-                    writeToProcessOutput("JT-Scanner-Scanning: "+ pluginFileInfo.absoluteFilePath());
-                    auto descriptor = getPluginDescriptor(pluginFileInfo);
-                    if (descriptor.isValid())
-                        writeToProcessOutput("JT-Scanner-Scan-Finished: " + descriptor.getPath());
-                }
-            }
+            if (!skipSet.contains(pluginFileInfo.absoluteFilePath()) && canScan(pluginFileInfo))
+                scanPlugin(pluginFileInfo);
         }
     }
     writeToProcessOutput("JT-Scanner-Finished");
 }
 
+void VstPluginScanner::scanPlugin(const QFileInfo &pluginFileInfo)
+{
+    writeToProcessOutput("JT-Scanner-Scanning: "+ pluginFileInfo.absoluteFilePath());
+    auto descriptor = getPluginDescriptor(pluginFileInfo);
+    if (descriptor.isValid())
+        writeToProcessOutput("JT-Scanner-Scan-Finished: " + descriptor.getPath());
+}
 
 bool VstPluginScanner::canScan(const QFileInfo &pluginFileInfo) const
 {
@@ -95,6 +106,12 @@ void VstPluginScanner::initialize(int argc, char *argv[])
     if (argc < 2)
         return;
 
+    if (QString::fromUtf8(argv[1]) == "--files") { // scanning just some plugin files, the folders are walked by JamTaba
+        if (argc > 2)
+            this->pluginsToScan = QString::fromUtf8(argv[2]).split(";", QString::SkipEmptyParts);
+        return;
+    }
+
     QString foldersString = QString::fromUtf8(argv[1]);
 
     if (!foldersString.isEmpty())
@@ -14,6 +14,9 @@ private:
 
     QStringList foldersToScan;
     QStringList skipList; // contain blackListed and cached plugins
+    QStringList pluginsToScan; // used when JamTaba is scanning in parallel, each scanner process receive some plugin files
+
+    void scanPlugin(const QFileInfo &pluginFileInfo);
 
     void initialize(int argc, char *argv[]) override;
 
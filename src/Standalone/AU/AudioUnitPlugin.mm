@@ -429,8 +429,8 @@ void AudioUnitPlugin::process(const audio::SamplesBuffer &inBuffer, audio::Sampl
     }
 
     if (wantsMidiMessages && !midiBuffer.empty()) {
-        UInt32 midiEventPosition = 0; // in jamtaba all MIDI messages are real time
         for (const midi::MidiMessage &message : midiBuffer) {
+            UInt32 midiEventPosition = message.getSampleOffset(); // sample accurate position inside the audio block
             MusicDeviceMIDIEvent(audioUnit, message.getStatus(), message.getData1(),
                                                             message.getData2(), midiEventPosition);
         }
@@ -1,13 +1,17 @@
 #include "MainControllerStandalone.h"
 
 #include "midi/RtMidiDriver.h"
+#include "midi/MidiClockScheduler.h"
 #include "midi/MidiMessage.h"
 #include "audio/PortAudioDriver.h"
 #include "audio/core/LocalInputNode.h"
 #include "vst/VstPlugin.h"
+#include "vst/BridgedVstPlugin.h"
 #include "vst/VstHost.h"
 #include "vst/VstPluginFinder.h"
+#include "PluginLoader.h"
 #include "audio/core/PluginDescriptor.h"
+#include "audio/BuiltInPlugins.h"
 #include "NinjamController.h"
 #include "vst/VstPluginChecker.h"
 #include "gui/MainWindowStandalone.h"
@@ -88,6 +92,15 @@ QMap<QString, QList<audio::PluginDescriptor> > MainControllerStandalone::getPlug
 {
     QMap<QString, QList<audio::PluginDescriptor> > descriptors;
 
+    if (category == audio::PluginDescriptor::Native_Plugin)
+    {
+        // built-in plugins are always available, they are not scanned
+        descriptors.insert("JamTaba", QList<audio::PluginDescriptor>()
+                           << audio::PluginDescriptor("Delay", category, "JamTaba")
+                           << audio::PluginDescriptor("Equalizer", category, "JamTaba"));
+        return descriptors;
+    }
+
     for (const auto &descriptor : pluginsDescriptors)
     {
         if (descriptor.getCategory() == category)
@@ -114,12 +127,22 @@ audio::Plugin *MainControllerStandalone::addPlugin(quint32 inputTrackIndex, quin
     if (plugin)
     {
         plugin->start();
-        QMutexLocker locker(&mutex);
-        getInputTrack(inputTrackIndex)->addProcessor(plugin, pluginSlotIndex);
+        insertPlugin(inputTrackIndex, pluginSlotIndex, plugin);
     }
     return plugin;
 }
 
+bool MainControllerStandalone::insertPlugin(quint32 inputTrackIndex, quint32 pluginSlotIndex, audio::Plugin *plugin)
+{
+    QMutexLocker locker(&mutex);
+    auto inputTrack = getInputTrack(inputTrackIndex);
+    if (!inputTrack)
+        return false;
+
+    inputTrack->addProcessor(plugin, pluginSlotIndex);
+    return true;
+}
+
 void MainControllerStandalone::removePlugin(int inputTrackIndex, audio::Plugin *plugin)
 {
     QMutexLocker locker(&mutex);
@@ -149,6 +172,7 @@ void MainControllerStandalone::removePluginsScanPath(const QString &path)
 void MainControllerStandalone::clearPluginsList()
 {
     pluginsDescriptors.clear();
+    vstPluginsPaths.clear();
 }
 
 void MainControllerStandalone::clearPluginsCache()
@@ -171,6 +195,11 @@ void MainControllerStandalone::removeBlackVstFromSettings(const QString &pluginP
     settings.removeVstFromBlackList(pluginPath);
 }
 
+void MainControllerStandalone::setVstPluginsBridged(bool bridged)
+{
+    settings.setVstPluginsBridged(bridged); // the loaded plugins are not reloaded, used for the next plugins
+}
+
 bool MainControllerStandalone::inputIndexIsValid(int inputIndex)
 {
     return inputIndex >= 0 && inputIndex <= audioDriver->getInputsCount();
@@ -264,6 +293,9 @@ void MainControllerStandalone::updateBpm(int newBpm)
 
     for (Host *host : hosts)
         host->setTempo(newBpm);
+
+    for (auto inputNode : inputTracks)
+        inputNode->setProcessorsTempo(newBpm);
 }
 
 void MainControllerStandalone::connectInNinjamServer(const ServerInfo &server)
@@ -272,6 +304,9 @@ void MainControllerStandalone::connectInNinjamServer(const ServerInfo &server)
 
     for (auto host : hosts)
         host->setTempo(server.getBpm());
+
+    for (auto inputNode : inputTracks)
+        inputNode->setProcessorsTempo(server.getBpm());
 }
 
 void MainControllerStandalone::setSampleRate(int newSampleRate)
@@ -332,22 +367,13 @@ void MainControllerStandalone::on_ninjamStartProcessing(int intervalPosition)
 
 void MainControllerStandalone::addFoundedVstPlugin(const QString &name, const QString &path)
 {
-    bool containThePlugin = false;
-    for (const auto descriptor : pluginsDescriptors)
-    {
-        if (descriptor.isVST() && descriptor.getPath() == path)
-        {
-            containThePlugin = true;
-            break;
-        }
-    }
-
-    if (!containThePlugin)
+    if (!vstPluginsPaths.contains(path))
     {
         settings.addVstPlugin(path);
         auto category = audio::PluginDescriptor::VST_Plugin;
         QString manufacturer = "";
         pluginsDescriptors.append(audio::PluginDescriptor(name, category, manufacturer, path));
+        vstPluginsPaths.insert(path);
     }
 }
 
@@ -412,8 +438,12 @@ MainControllerStandalone::MainControllerStandalone(persistence::Settings setting
                                                    QApplication *application) :
     MainController(settings),
     application(application),
-    audioDriver(nullptr)
+    audioDriver(nullptr),
+    timeToFirstAudio(0),
+    startupTimesLogged(false)
 {
+    startupTimer.start();
+
     application->setQuitOnLastWindowClosed(true);
 
     hosts.append(vst::VstHost::getInstance());
@@ -423,6 +453,18 @@ MainControllerStandalone::MainControllerStandalone(persistence::Settings setting
 
     connect(vst::VstHost::getInstance(), &vst::VstHost::pluginRequestingWindowResize,
             this, &MainControllerStandalone::setVstPluginWindowSize);
+
+    pluginLoader.reset(new audio::PluginLoader(this));
+    connect(pluginLoader.data(), &audio::PluginLoader::loadingFinished, this, &MainControllerStandalone::logStartupTimes);
+}
+
+void MainControllerStandalone::logStartupTimes()
+{
+    if (startupTimesLogged)
+        return;
+
+    startupTimesLogged = true;
+    qCInfo(jtCore) << "Time to first audio:" << timeToFirstAudio << "ms, session plugins loaded in" << startupTimer.elapsed() << "ms";
 }
 
 void MainControllerStandalone::setVstPluginWindowSize(QString pluginName, int newWidht,
@@ -436,6 +478,14 @@ void MainControllerStandalone::setVstPluginWindowSize(QString pluginName, int ne
     }
 }
 
+void MainControllerStandalone::handleBridgedPluginCrash(const QString &pluginName)
+{
+    qCritical() << pluginName << "crashed in the plugin bridge process!";
+
+    // the crashed plugin is kept in the chain passing through the audio, the user can remove or reload the plugin
+    QMessageBox::warning(window, tr("Plugin crash"), tr("The plugin %1 crashed and was disabled. JamTaba is still running, remove the plugin or load it again.").arg(pluginName));
+}
+
 void MainControllerStandalone::start()
 {
     // creating audio and midi driver before call start() in base class (MainController::start())
@@ -481,13 +531,23 @@ void MainControllerStandalone::start()
         if (!audioDriver->canBeStarted())
             useNullAudioDriver();
         audioDriver->start();
+
+        if (!timeToFirstAudio)
+            timeToFirstAudio = startupTimer.elapsed();
     }
 
-    if (midiDriver)
+    if (midiDriver) {
         midiDriver->start(settings.getMidiInputDevicesStatus(), settings.getSyncOutputDevicesStatus());
 
+        if (!midiClockScheduler)
+            midiClockScheduler.reset(new midi::MidiClockScheduler(midiDriver.data()));
+
+        midiClockScheduler->start();
+    }
+
     qCInfo(jtCore) << "Creating plugin finder...";
-    vstPluginFinder.reset(new audio::VSTPluginFinder());
+    QString scanDatabaseFile = Configurator::getInstance()->getBaseDir().absoluteFilePath("vst_scan.bin"); // next to config file
+    vstPluginFinder.reset(new audio::VSTPluginFinder(scanDatabaseFile));
 
 #ifdef Q_OS_MAC
 
@@ -541,11 +601,32 @@ audio::Plugin *MainControllerStandalone::createPluginInstance(
     if (descriptor.isNative())
     {
         if (descriptor.getName() == "Delay")
-            return new audio::JamtabaDelay(audioDriver->getSampleRate());
+        {
+            auto delay = new audio::JamtabaDelay(audioDriver->getSampleRate());
+            if (isPlayingInNinjamRoom() && ninjamController)
+                delay->setTempo(ninjamController->getCurrentBpm());
+            return delay;
+        }
+
+        if (descriptor.getName() == "Equalizer")
+            return new audio::JamtabaEqualizer(audioDriver->getSampleRate());
     }
     else if (descriptor.isVST())
     {
         auto host = vst::VstHost::getInstance();
+        if (settings.isVstPluginsBridged())
+        {
+            auto bridgedPlugin = new vst::BridgedVstPlugin(host, descriptor);
+            if (bridgedPlugin->load())
+            {
+                connect(bridgedPlugin, &vst::BridgedVstPlugin::crashed, this, &MainControllerStandalone::handleBridgedPluginCrash);
+                return bridgedPlugin;
+            }
+
+            delete bridgedPlugin;
+            return nullptr;
+        }
+
         auto vstPlugin = new vst::VstPlugin(host, descriptor.getPath());
         if (vstPlugin->load(descriptor.getPath()))
             return vstPlugin;
@@ -639,8 +720,8 @@ bool MainControllerStandalone::vstScanIsNeeded() const
     // checking for new vst plugins in scan folders
     QStringList foldersToScan = settings.getVstScanFolders();
 
-    QStringList skipList(settings.getBlackListedPlugins());
-    skipList.append(settings.getVstPluginsPaths());
+    QSet<QString> skipList(settings.getBlackListedPlugins().toSet()); // hash set, thousands of plugins are checked
+    skipList.unite(settings.getVstPluginsPaths().toSet());
 
     bool newVstFounded = false;
     for (const QString &scanFolder : foldersToScan)
@@ -686,6 +767,7 @@ void MainControllerStandalone::initializeVstPluginsList(const QStringList &paths
             QString manufacturer = "";
             pluginsDescriptors.append(audio::PluginDescriptor(pluginName, category, manufacturer,
                                                               path));
+            vstPluginsPaths.insert(path);
         }
     }
 }
@@ -694,6 +776,10 @@ void MainControllerStandalone::scanAllVstPlugins()
 {
     saveLastUserSettings(settings.getInputsSettings()); // save the config file before start scanning
     clearPluginsCache();
+
+    if (vstPluginFinder)
+        vstPluginFinder->forgetInvalidPlugins(); // valid and unchanged plugins are not loaded again
+
     scanVstPlugins(false);
 }
 
@@ -708,7 +794,10 @@ void MainControllerStandalone::scanVstPlugins(bool scanOnlyNewPlugins)
     if (vstPluginFinder)
     {
         if (!scanOnlyNewPlugins)
+        {
             pluginsDescriptors.clear();
+            vstPluginsPaths.clear();
+        }
 
         // The skipList contains the paths for black listed plugins by default.
         // If the parameter 'scanOnlyNewPlugins' is 'true' the cached plugins are added in the skipList too.
@@ -766,32 +855,40 @@ std::vector<midi::MidiMessage> MainControllerStandalone::pullMidiMessagesFromPlu
     return receivedMidiMessages;
 }
 
-void MainControllerStandalone::startMidiClock() const
+void MainControllerStandalone::startMidiClock(quint64 samplePosition) const
 {
-    midiDriver->sendClockStart();
+    if (midiClockScheduler)
+        midiClockScheduler->schedule(midi::MidiClockScheduler::ClockStart, samplePosition);
 }
 
 void MainControllerStandalone::stopMidiClock() const
 {
-    midiDriver->sendClockStop();
+    if (midiClockScheduler)
+        midiClockScheduler->stopClock();
 }
 
-void MainControllerStandalone::continueMidiClock() const
+void MainControllerStandalone::continueMidiClock(quint64 samplePosition) const
 {
-    midiDriver->sendClockContinue();
+    if (midiClockScheduler)
+        midiClockScheduler->schedule(midi::MidiClockScheduler::ClockContinue, samplePosition);
 }
 
-void MainControllerStandalone::sendMidiClockPulse() const
+void MainControllerStandalone::sendMidiClockPulse(quint64 samplePosition) const
 {
-    midiDriver->sendClockPulse();
+    if (midiClockScheduler)
+        midiClockScheduler->schedule(midi::MidiClockScheduler::ClockPulse, samplePosition);
 }
 
-std::vector<midi::MidiMessage> MainControllerStandalone::pullMidiMessagesFromDevices()
+void MainControllerStandalone::pullMidiMessagesFromDevices(std::vector<midi::MidiMessage> &buffer, quint64 sampleClock, int sampleRate)
 {
     if (!midiDriver)
-        return std::vector<midi::MidiMessage>();
+        return;
+
+    midiDriver->getBuffer(buffer);
 
-    return midiDriver->getBuffer();
+    // the messages received after this point are stamped using the current block position
+    const double outputLatency = audioDriver ? audioDriver->getOutputLatency() : 0.0;
+    midiDriver->updateSampleClock(sampleClock, sampleRate, outputLatency);
 }
 
 bool MainControllerStandalone::isUsingNullAudioDriver() const
@@ -806,6 +903,9 @@ void MainControllerStandalone::stop()
     if (audioDriver)
         this->audioDriver->release();
 
+    if (midiClockScheduler)
+        midiClockScheduler->stop();
+
     if (midiDriver)
         this->midiDriver->release();
 
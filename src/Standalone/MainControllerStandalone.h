@@ -3,6 +3,8 @@
 
 #include "MainController.h"
 #include <QApplication>
+#include <QSet>
+#include <QElapsedTimer>
 
 #ifdef Q_OS_MAC
     #include "AU/AudioUnitPluginFinder.h"
@@ -16,6 +18,7 @@ class Host;
 namespace midi
 {
     class MidiDriver;
+    class MidiClockScheduler;
 }
 
 namespace ninjam
@@ -32,6 +35,7 @@ namespace audio
     class Plugin;
     class AudioDriver;
     class PluginDescriptor;
+    class PluginLoader;
 }
 
 using audio::VSTPluginFinder;
@@ -112,13 +116,23 @@ namespace controller
             PluginDescriptor::Category category);
         Plugin *addPlugin(quint32 inputTrackIndex, quint32 pluginSlotIndex,
                           const PluginDescriptor &descriptor);
+        bool insertPlugin(quint32 inputTrackIndex, quint32 pluginSlotIndex, Plugin *plugin); // insert a started plugin in the audio chain
+
+        Plugin *createPluginInstance(const PluginDescriptor &descriptor); // VST plugins can be created in worker threads
+
+        inline audio::PluginLoader *getPluginLoader() const
+        {
+            return pluginLoader.data();
+        }
+
+        void logStartupTimes(); // called when the session plugins are loaded
 
         std::vector<midi::MidiMessage> pullMidiMessagesFromPlugins() override;
 
-        void startMidiClock() const override;
+        void startMidiClock(quint64 samplePosition) const override;
         void stopMidiClock() const override;
-        void continueMidiClock() const override;
-        void sendMidiClockPulse() const override;
+        void continueMidiClock(quint64 samplePosition) const override;
+        void sendMidiClockPulse(quint64 samplePosition) const override;
 
 
     public slots:
@@ -131,6 +145,8 @@ namespace controller
         void addBlackVstToSettings(const QString &path);
         void removeBlackVstFromSettings(const QString &pluginPath);
 
+        void setVstPluginsBridged(bool bridged);
+
         void scanAllVstPlugins();
         void scanOnlyNewVstPlugins();
 
@@ -150,7 +166,7 @@ namespace controller
 
         void setupNinjamControllerSignals() override;
 
-        std::vector<midi::MidiMessage> pullMidiMessagesFromDevices() override;
+        void pullMidiMessagesFromDevices(std::vector<midi::MidiMessage> &buffer, quint64 sampleClock, int sampleRate) override;
 
     protected slots:
         void updateBpm(int newBpm) override;
@@ -169,6 +185,7 @@ namespace controller
 
     private slots:
         void setVstPluginWindowSize(QString pluginName, int newWidht, int newHeight);
+        void handleBridgedPluginCrash(const QString &pluginName);
 
     private:
         // VST and AU hosts
@@ -177,14 +194,21 @@ namespace controller
 
         QScopedPointer<AudioDriver> audioDriver;
         QScopedPointer<midi::MidiDriver> midiDriver;
+        QScopedPointer<midi::MidiClockScheduler> midiClockScheduler; // send the sync messages in precise time
 
         QList<PluginDescriptor> pluginsDescriptors;
+        QSet<QString> vstPluginsPaths; // fast lookup for the VST plugins in 'pluginsDescriptors'
 
         MainWindowStandalone *window;
 
         bool inputIndexIsValid(int inputIndex);
 
         QScopedPointer<VSTPluginFinder> vstPluginFinder;
+        QScopedPointer<audio::PluginLoader> pluginLoader;
+
+        QElapsedTimer startupTimer;
+        qint64 timeToFirstAudio; // in milliseconds, measured when the audio driver is started
+        bool startupTimesLogged;
 #ifdef Q_OS_MAC
         QScopedPointer<audio::AudioUnitPluginFinder> auPluginFinder;
  #endif
@@ -193,8 +217,6 @@ namespace controller
         static bool pluginDescriptorLessThan(const PluginDescriptor &d1,
                                              const PluginDescriptor &d2);
 
-        Plugin *createPluginInstance(const PluginDescriptor &descriptor);
-
         void scanVstPlugins(bool scanOnlyNewVstPlugins);
     };
 } // namespace
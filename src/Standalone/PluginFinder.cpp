@@ -2,92 +2,242 @@
 #include "audio/core/PluginDescriptor.h"
 #include "log/Logging.h"
 
+#include <QThread>
+#include <QTextStream>
+
 using audio::PluginFinder;
 using audio::PluginDescriptor;
 
-void PluginFinder::finishScan()
-{
-    QProcess::ExitStatus exitStatus = scanProcess.exitStatus();
-    if (exitStatus!= QProcess::ExitStatus::CrashExit) // do not try to close an already crashed exit process
-        scanProcess.close();
-    bool exitingWithoutError = exitStatus == QProcess::NormalExit;
+const int PluginFinder::BATCH_SIZE = 8;
 
-    qCDebug(jtStandalonePluginFinder) << "Closing scan process! exited without error:" << exitingWithoutError;
+PluginFinder::PluginFinder() :
+    crashDetected(false),
+    canceled(false)
+{
 
-    emit scanFinished(exitingWithoutError);
-    QString lastScanned(lastScannedPlugin);
-    lastScannedPlugin.clear();
+}
 
-    if (!exitingWithoutError)
-        handleProcessError(lastScanned);
+PluginFinder::~PluginFinder()
+{
+    for (auto worker : workers) {
+        if (worker->process) {
+            worker->process->disconnect(this);
+            worker->process->kill();
+            worker->process->waitForFinished(1000);
+        }
+        delete worker;
+    }
 }
 
-void PluginFinder::handleScanError(QProcess::ProcessError error)
+int PluginFinder::getMaxWorkers()
 {
-    qCritical() << error << scanProcess.errorString();
-    finishScan();
+    return qBound(1, QThread::idealThreadCount(), 8);
 }
 
-void PluginFinder::handleProcessError(const QString &lastScannedPlugin)
+bool PluginFinder::canScanInParallel() const
 {
-    if (!lastScannedPlugin.isEmpty())
-        emit badPluginDetected(lastScannedPlugin);
+    return false;
 }
 
-void PluginFinder::consumeOutputFromScanProcess()
+QStringList PluginFinder::getPluginsToScan(const QStringList &foldersToScan, const QSet<QString> &skipList)
 {
-    QByteArray readedData = scanProcess.readAll();
-    QTextStream stream(readedData, QIODevice::ReadOnly);
-    while (!stream.atEnd()) {
-        QString readedLine = stream.readLine();
-        if (!readedLine.isNull() && !readedLine.isEmpty()) {
-            bool startScanning = readedLine.startsWith("JT-Scanner-Scanning:");
-            bool finishedScanning = readedLine.startsWith("JT-Scanner-Scan-Finished");
-            if (startScanning)
-                handleScanningStart(readedLine);
-            else if(finishedScanning)
-                handleScanningFinished(readedLine);
-        }
-    }
+    Q_UNUSED(foldersToScan)
+    Q_UNUSED(skipList)
+
+    return QStringList();
 }
 
+void PluginFinder::handlePluginScanned(const QString &pluginPath, bool isValidPlugin)
+{
+    Q_UNUSED(pluginPath)
+    Q_UNUSED(isValidPlugin)
+}
 
 void PluginFinder::scan(const QStringList &scanFolders, const QStringList &skipList)
 {
-    if (scanProcess.isOpen()) {
+    if (isScanning()) {
         qCritical() << "scan process is already open!";
         return;
     }
 
-    QString scannerExePath = getScannerExecutablePath();
-    if (scannerExePath.isEmpty())
+    scannerExecutablePath = getScannerExecutablePath();
+    if (scannerExecutablePath.isEmpty())
         return; // scanner executable not found!
 
+    crashDetected = false;
+    canceled = false;
+
     emit scanStarted();
-    // execute the scanner in another process to avoid crash Jamtaba process
+
+    if (!canScanInParallel()) {
+        // just one scanner process walking the folders
+        QStringList parameters;
+        parameters.append(buildCommaSeparatedString(scanFolders));
+        parameters.append(buildCommaSeparatedString(skipList));
+
+        auto worker = new ScanWorker();
+        workers.append(worker);
+        startWorker(worker, parameters);
+        return;
+    }
+
+    const QStringList plugins = getPluginsToScan(scanFolders, skipList.toSet());
+    for (int i = 0; i < plugins.size(); i += BATCH_SIZE)
+        pendingBatches.append(plugins.mid(i, BATCH_SIZE));
+
+    qCDebug(jtStandalonePluginFinder) << plugins.size() << "plugins to scan in" << pendingBatches.size() << "batches";
+
+    if (pendingBatches.isEmpty()) { // all plugins are cached or black listed
+        emit scanFinished(true);
+        return;
+    }
+
+    const int workersCount = qMin(getMaxWorkers(), pendingBatches.size());
+    for (int i = 0; i < workersCount; ++i) {
+        auto worker = new ScanWorker();
+        workers.append(worker);
+        startNextBatch(worker);
+    }
+}
+
+void PluginFinder::startNextBatch(ScanWorker *worker)
+{
+    if (worker->pendingPlugins.isEmpty())
+        worker->pendingPlugins = pendingBatches.takeFirst();
+
     QStringList parameters;
-    parameters.append(buildCommaSeparatedString(scanFolders));
-    parameters.append(buildCommaSeparatedString(skipList));
-    QObject::connect(&scanProcess, SIGNAL(readyReadStandardOutput()), this,
-                     SLOT(consumeOutputFromScanProcess()));
-    QObject::connect(&scanProcess, SIGNAL(finished(int)), this, SLOT(finishScan()));
-    QObject::connect(&scanProcess, SIGNAL(error(QProcess::ProcessError)), this,
-                     SLOT(handleScanError(QProcess::ProcessError)));
+    parameters.append("--files");
+    parameters.append(buildCommaSeparatedString(worker->pendingPlugins));
+
+    startWorker(worker, parameters);
+}
+
+void PluginFinder::startWorker(ScanWorker *worker, const QStringList &parameters)
+{
+    worker->scanningPlugin.clear();
+    worker->scanningPluginFinished = false;
+
+    // execute the scanner in another process to avoid crash Jamtaba process
+    worker->process = new QProcess(this);
+
+    connect(worker->process, &QProcess::readyReadStandardOutput, this, [=]() {
+        consumeOutputFromWorker(worker);
+    });
+
+    connect(worker->process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus exitStatus) {
+        finishWorker(worker, exitStatus == QProcess::CrashExit || exitCode != 0);
+    });
+
+    connect(worker->process, static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error), this, [=](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) { // 'finished' is not emitted
+            qCritical() << error << worker->process->errorString();
+            crashDetected = true;
+            pendingBatches.clear();
+            worker->pendingPlugins.clear();
+            finishWorker(worker, false);
+        }
+    });
 
-    scanProcess.start(scannerExePath, parameters);
+    worker->process->start(scannerExecutablePath, parameters);
 
     qCDebug(jtStandalonePluginFinder)
             << "Scan process started with "
-            << scannerExePath
-            << " (PID: " << scanProcess.processId() << ")";
+            << scannerExecutablePath
+            << " (PID: " << worker->process->processId() << ")";
+}
+
+void PluginFinder::consumeOutputFromWorker(ScanWorker *worker)
+{
+    QByteArray readedData = worker->process->readAllStandardOutput();
+    QTextStream stream(readedData, QIODevice::ReadOnly);
+    while (!stream.atEnd()) {
+        QString readedLine = stream.readLine();
+        if (readedLine.isEmpty())
+            continue;
+
+        if (readedLine.startsWith("JT-Scanner-Scanning:")) {
+            if (!worker->scanningPlugin.isEmpty() && !worker->scanningPluginFinished)
+                handlePluginScanned(worker->scanningPlugin, false); // previous plugin was not loaded
+
+            worker->scanningPlugin = readedLine.section(": ", 1);
+            worker->scanningPluginFinished = false;
+
+            // the batch is scanned in order, the scanning plugin and the previous plugins are not pending anymore
+            const int index = worker->pendingPlugins.indexOf(worker->scanningPlugin);
+            worker->pendingPlugins.erase(worker->pendingPlugins.begin(), worker->pendingPlugins.begin() + qMin(index + 1, worker->pendingPlugins.size()));
+
+            handleScanningStart(readedLine);
+        }
+        else if (readedLine.startsWith("JT-Scanner-Scan-Finished")) {
+            worker->scanningPluginFinished = true;
+            handlePluginScanned(worker->scanningPlugin, true);
+
+            handleScanningFinished(readedLine);
+        }
+    }
+}
+
+void PluginFinder::finishWorker(ScanWorker *worker, bool crashed)
+{
+    consumeOutputFromWorker(worker); // the last lines
+
+    qCDebug(jtStandalonePluginFinder) << "Closing scan process! crashed:" << crashed;
+
+    worker->process->disconnect(this);
+    worker->process->deleteLater();
+    worker->process = nullptr;
+
+    const bool pluginWasScanning = !worker->scanningPlugin.isEmpty() && !worker->scanningPluginFinished;
+
+    if (canceled) {
+        removeWorker(worker);
+        return;
+    }
+
+    if (crashed) {
+        crashDetected = true;
+        if (pluginWasScanning) {
+            emit badPluginDetected(worker->scanningPlugin);
+        }
+        else {
+            qCritical() << "Scanner process crashed before scanning any plugin, skipping" << worker->pendingPlugins;
+            worker->pendingPlugins.clear(); // avoid restarting the same crashing batch forever
+        }
+    }
+    else if (pluginWasScanning) {
+        handlePluginScanned(worker->scanningPlugin, false);
+    }
+
+    if (!worker->pendingPlugins.isEmpty() || !pendingBatches.isEmpty())
+        startNextBatch(worker); // the remaining plugins in a crashed batch are scanned in a new process
+    else
+        removeWorker(worker);
+}
+
+void PluginFinder::removeWorker(ScanWorker *worker)
+{
+    workers.removeOne(worker);
+    delete worker;
+
+    if (workers.isEmpty()) {
+        pendingBatches.clear();
+        emit scanFinished(!crashDetected && !canceled);
+    }
 }
 
 void PluginFinder::cancel()
 {
-    if (!scanProcess.atEnd()) {
-        qCDebug(jtStandalonePluginFinder) << "Terminating scan process!";
-        scanProcess.terminate();
-        qDebug() << "process closed";
+    if (!isScanning())
+        return;
+
+    qCDebug(jtStandalonePluginFinder) << "Terminating scan processes!";
+
+    canceled = true;
+    pendingBatches.clear();
+
+    for (auto worker : workers) {
+        if (worker->process)
+            worker->process->terminate();
     }
 }
 
@@ -101,4 +251,3 @@ QString PluginFinder::buildCommaSeparatedString(const QStringList &list) const
     }
     return folderString;
 }
-
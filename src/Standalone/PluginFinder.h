@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QProcess>
 #include <QFileInfo>
+#include <QSet>
 
 namespace audio {
 class PluginDescriptor;
@@ -11,31 +12,63 @@ class PluginDescriptor;
 
 namespace audio {
 
+/**
+    Plugins are scanned in external scanner processes to avoid crash Jamtaba process. When the finder
+    can collect the plugin files (canScanInParallel() returns true) the files are splitted in small
+    batches and scanned by a pool of scanner processes. If a plugin crash a scanner process only this
+    plugin is lost, the remaining batch files are scanned in a new process.
+ */
+
 class PluginFinder : public QObject
 {
     Q_OBJECT
 
 public:
+    PluginFinder();
+    ~PluginFinder();
+
     void scan(const QStringList &foldersToScan = QStringList(), const QStringList &skipList = QStringList());
     void cancel();
 
-protected:
-    QProcess scanProcess;
-    QString lastScannedPlugin;
+    bool isScanning() const;
 
+protected:
     virtual QString getScannerExecutablePath() const = 0;
 
-    void handleProcessError(const QString &lastScannedPlugin);
-
     virtual void handleScanningStart(const QString &scannedLine) = 0;
     virtual void handleScanningFinished(const QString &scannedLine) = 0;
 
-     QString buildCommaSeparatedString(const QStringList &list) const;
+    // parallel scan support, the default implementation is using just one scanner process walking the scan folders
+    virtual bool canScanInParallel() const;
+    virtual QStringList getPluginsToScan(const QStringList &foldersToScan, const QSet<QString> &skipList);
+    virtual void handlePluginScanned(const QString &pluginPath, bool isValidPlugin); // called when the plugin scan is finished without crash
+
+    QString buildCommaSeparatedString(const QStringList &list) const;
+
+    static const int BATCH_SIZE; // plugin files scanned by each scanner process
 
-protected slots:
-    void consumeOutputFromScanProcess();
-    void finishScan();
-    void handleScanError(QProcess::ProcessError);
+private:
+    struct ScanWorker
+    {
+        QProcess *process;
+        QStringList pendingPlugins; // plugins in the worker batch not scanned yet
+        QString scanningPlugin;
+        bool scanningPluginFinished;
+    };
+
+    void startWorker(ScanWorker *worker, const QStringList &parameters);
+    void startNextBatch(ScanWorker *worker);
+    void consumeOutputFromWorker(ScanWorker *worker);
+    void finishWorker(ScanWorker *worker, bool crashed);
+    void removeWorker(ScanWorker *worker);
+
+    static int getMaxWorkers();
+
+    QList<ScanWorker *> workers;
+    QList<QStringList> pendingBatches;
+    QString scannerExecutablePath;
+    bool crashDetected;
+    bool canceled;
 
 signals:
     void scanStarted();
@@ -46,6 +79,11 @@ signals:
 
 };
 
+inline bool PluginFinder::isScanning() const
+{
+    return !workers.isEmpty();
+}
+
 } // namespace
 
 #endif
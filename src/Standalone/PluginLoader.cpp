@@ -0,0 +1,248 @@
+#include "PluginLoader.h"
+#include "MainControllerStandalone.h"
+#include "audio/core/Plugins.h"
+#include "log/Logging.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <QElapsedTimer>
+
+using audio::PluginLoader;
+using audio::Plugin;
+
+PluginLoader::LoaderThread::LoaderThread() :
+    plugin(nullptr),
+    busy(false)
+{
+    context.moveToThread(&thread);
+}
+
+PluginLoader::PluginLoader(controller::MainControllerStandalone *controller) :
+    controller(controller),
+    loadingInMainThread(false),
+    generation(0),
+    totalPlugins(0),
+    loadedPlugins(0)
+{
+    for (int t = 0; t < getMaxThreads(); ++t) {
+        auto loaderThread = new LoaderThread();
+        loaderThread->thread.start(); // the default QThread::run() is executing the event loop
+        loaderThreads.append(loaderThread);
+    }
+}
+
+PluginLoader::~PluginLoader()
+{
+    cancel();
+
+    for (auto loaderThread : loaderThreads) {
+        loaderThread->thread.quit(); // the plugin in loading is finished before quit
+        loaderThread->thread.wait();
+    }
+
+    for (auto loaderThread : loaderThreads) {
+        if (loaderThread->busy)
+            delete loaderThread->plugin; // the 'handleJobFinished' calls will never be delivered
+
+        delete loaderThread;
+    }
+}
+
+int PluginLoader::getMaxThreads()
+{
+    return qBound(1, QThread::idealThreadCount(), 4); // plugin loading is reading a lot from disk, more threads will not help
+}
+
+bool PluginLoader::canLoadInWorkerThread(const PluginDescriptor &descriptor)
+{
+#ifdef Q_OS_MAC
+    Q_UNUSED(descriptor)
+    return false; // Audio Units and Mac VSTs are touching Cocoa/Carbon in initialization
+#else
+    return descriptor.isVST();
+#endif
+}
+
+void PluginLoader::load(const PluginDescriptor &descriptor, quint32 inputTrackIndex, quint32 slotIndex,
+                        const QByteArray &serializedData, bool bypassed)
+{
+    Job job;
+    job.descriptor = descriptor;
+    job.inputTrackIndex = inputTrackIndex;
+    job.slotIndex = slotIndex;
+    job.serializedData = serializedData;
+    job.bypassed = bypassed;
+    job.generation = generation;
+
+    totalPlugins++;
+    emit progressChanged(loadedPlugins, totalPlugins);
+
+    if (!canLoadInWorkerThread(descriptor)) {
+        mainThreadJobs.append(job);
+        if (!loadingInMainThread) {
+            loadingInMainThread = true;
+            QTimer::singleShot(0, this, [=]() { startNextMainThreadJob(); }); // the caller is not blocked
+        }
+        return;
+    }
+
+    const QString pluginFile = descriptor.getPath();
+    if (waitingJobs.contains(pluginFile)) { // another instance of this plugin file is loading
+        waitingJobs[pluginFile].append(job);
+        return;
+    }
+
+    waitingJobs.insert(pluginFile, QList<Job>());
+    startJob(job);
+}
+
+void PluginLoader::startJob(const Job &job)
+{
+    for (int t = 0; t < loaderThreads.size(); ++t) {
+        if (!loaderThreads.at(t)->busy) {
+            runJob(t, job);
+            return;
+        }
+    }
+
+    readyJobs.append(job); // all loader threads are busy
+}
+
+void PluginLoader::runJob(int loaderThreadIndex, const Job &job)
+{
+    qCDebug(jtStandaloneVstPlugin) << "Loading" << job.descriptor.getName() << "in a loader thread";
+
+    LoaderThread *loaderThread = loaderThreads.at(loaderThreadIndex);
+    loaderThread->job = job;
+    loaderThread->plugin = nullptr;
+    loaderThread->busy = true;
+
+    QThread *guiThread = thread();
+    QTimer::singleShot(0, &loaderThread->context, [=]() { // executed in the loader thread event loop
+        Plugin *plugin = createPlugin(job);
+        if (plugin)
+            plugin->moveToThread(guiThread); // plugins are QObjects created in a loader thread
+
+        loaderThread->plugin = plugin;
+        QMetaObject::invokeMethod(this, "handleJobFinished", Qt::QueuedConnection, Q_ARG(int, loaderThreadIndex));
+    });
+}
+
+void PluginLoader::handleJobFinished(int loaderThreadIndex)
+{
+    LoaderThread *loaderThread = loaderThreads.at(loaderThreadIndex);
+    const Job job = loaderThread->job;
+    Plugin *plugin = loaderThread->plugin;
+    loaderThread->plugin = nullptr;
+    loaderThread->busy = false;
+
+    const QString pluginFile = job.descriptor.getPath();
+    QList<Job> &nextJobs = waitingJobs[pluginFile];
+    if (!nextJobs.isEmpty())
+        readyJobs.append(nextJobs.takeFirst());
+    else
+        waitingJobs.remove(pluginFile);
+
+    if (!readyJobs.isEmpty())
+        runJob(loaderThreadIndex, readyJobs.takeFirst());
+
+    finishJob(job, plugin);
+}
+
+void PluginLoader::startNextMainThreadJob()
+{
+    if (mainThreadJobs.isEmpty()) {
+        loadingInMainThread = false;
+        return;
+    }
+
+    const Job job = mainThreadJobs.takeFirst();
+    finishJob(job, createPlugin(job));
+
+    QTimer::singleShot(0, this, [=]() { startNextMainThreadJob(); }); // process GUI events between plugins
+}
+
+Plugin *PluginLoader::createPlugin(const Job &job) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto plugin = controller->createPluginInstance(job.descriptor);
+    if (!plugin)
+        return nullptr;
+
+    plugin->start();
+
+    try
+    {
+        plugin->restoreFromSerializedData(job.serializedData);
+    }
+    catch (...)
+    {
+        qWarning() << "Exception restoring " << plugin->getName();
+    }
+
+    plugin->setBypass(job.bypassed);
+
+    qCDebug(jtStandaloneVstPlugin) << plugin->getName() << "loaded in" << timer.elapsed() << "ms";
+
+    return plugin;
+}
+
+void PluginLoader::finishJob(const Job &job, Plugin *plugin)
+{
+    loadedPlugins++;
+
+    if (job.generation != generation) { // canceled
+        delete plugin;
+    }
+    else if (plugin) {
+        emit pluginLoaded(plugin, job.inputTrackIndex, job.slotIndex);
+    }
+    else {
+        qCritical() << "can´t create plugin instance! " << job.descriptor.getName();
+        emit pluginLoadingFailed(job.descriptor, job.inputTrackIndex, job.slotIndex);
+    }
+
+    emit progressChanged(loadedPlugins, totalPlugins);
+
+    if (!isLoading()) {
+        totalPlugins = loadedPlugins = 0;
+        emit loadingFinished();
+    }
+}
+
+void PluginLoader::cancel()
+{
+    if (!isLoading())
+        return;
+
+    generation++;
+
+    int discardedPlugins = mainThreadJobs.size();
+    mainThreadJobs.clear();
+
+    for (const Job &job : readyJobs) // these plugin files are not loading
+        waitingJobs.remove(job.descriptor.getPath());
+
+    discardedPlugins += readyJobs.size();
+    readyJobs.clear();
+
+    for (auto it = waitingJobs.begin(); it != waitingJobs.end(); ++it) { // the keys are kept, these plugin files are loading
+        discardedPlugins += it->size();
+        it->clear();
+    }
+
+    totalPlugins -= discardedPlugins;
+
+    if (!isLoading()) {
+        totalPlugins = loadedPlugins = 0;
+        emit loadingFinished();
+    }
+}
+
+void PluginLoader::waitForFinished()
+{
+    while (isLoading())
+        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::WaitForMoreEvents);
+}
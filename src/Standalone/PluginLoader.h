@@ -0,0 +1,109 @@
+#ifndef PLUGIN_LOADER_H
+#define PLUGIN_LOADER_H
+
+#include "audio/core/PluginDescriptor.h"
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QList>
+
+namespace controller {
+class MainControllerStandalone;
+}
+
+namespace audio {
+
+class Plugin;
+
+/**
+    Instantiate and restore the plugins used in sessions and presets without freezing the GUI. VST
+    plugins are loaded in loader threads running an event loop (bridged plugins are creating a QProcess,
+    and plugins can use timers in initialization), plugins living in different files are loaded in parallel and
+    instances of the same plugin file are loaded one after another (some plugins are using global
+    variables in initialization). Formats requiring the main thread (Audio Units and Mac VSTs) are
+    loaded in the GUI thread, one plugin per event loop iteration.
+
+    The loaded plugins are started and restored, but not inserted in the audio chain. The 'pluginLoaded'
+    receiver is responsible to insert (or delete) the plugin.
+ */
+
+class PluginLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PluginLoader(controller::MainControllerStandalone *controller);
+    ~PluginLoader();
+
+    void load(const PluginDescriptor &descriptor, quint32 inputTrackIndex, quint32 slotIndex,
+              const QByteArray &serializedData, bool bypassed);
+
+    void cancel(); // pending plugins are discarded, plugins in loading are deleted when finished
+
+    void waitForFinished(); // processing events until all plugins are delivered
+
+    bool isLoading() const;
+
+signals:
+    void pluginLoaded(audio::Plugin *plugin, quint32 inputTrackIndex, quint32 slotIndex);
+    void pluginLoadingFailed(const audio::PluginDescriptor &descriptor, quint32 inputTrackIndex, quint32 slotIndex);
+    void progressChanged(int loadedPlugins, int totalPlugins);
+    void loadingFinished();
+
+private slots:
+    void handleJobFinished(int loaderThreadIndex); // queued from the loader threads
+
+private:
+    struct Job
+    {
+        PluginDescriptor descriptor;
+        quint32 inputTrackIndex;
+        quint32 slotIndex;
+        QByteArray serializedData;
+        bool bypassed;
+        quint32 generation;
+    };
+
+    struct LoaderThread
+    {
+        LoaderThread();
+
+        QThread thread; // running an event loop
+        QObject context; // living in 'thread', the jobs are invoked in this object thread
+        Job job; // the job in loading, used only in GUI thread
+        Plugin *plugin; // written in 'thread' before the job finished notification
+        bool busy;
+    };
+
+    void startJob(const Job &job);
+    void runJob(int loaderThreadIndex, const Job &job);
+    void finishJob(const Job &job, Plugin *plugin);
+    void startNextMainThreadJob();
+
+    Plugin *createPlugin(const Job &job) const; // called in loader threads and in GUI thread
+
+    static bool canLoadInWorkerThread(const PluginDescriptor &descriptor);
+    static int getMaxThreads();
+
+    controller::MainControllerStandalone *controller;
+
+    QList<LoaderThread *> loaderThreads;
+    QList<Job> readyJobs; // waiting an idle loader thread
+    QHash<QString, QList<Job>> waitingJobs; // waiting a previous instance of the same plugin file
+    QList<Job> mainThreadJobs;
+    bool loadingInMainThread;
+
+    quint32 generation; // incremented when loading is canceled
+    int totalPlugins;
+    int loadedPlugins;
+};
+
+inline bool PluginLoader::isLoading() const
+{
+    return loadedPlugins < totalPlugins;
+}
+
+} // namespace
+
+#endif // PLUGIN_LOADER_H
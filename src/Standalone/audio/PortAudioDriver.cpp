@@ -22,6 +22,7 @@ namespace audio
 
 PortAudioDriver::PortAudioDriver(controller::MainController* mainController, QString audioInputDevice, QString audioOutputDevice, int firstInputIndex, int lastInputIndex, int firstOutputIndex, int lastOutputIndex, int sampleRate, int bufferSize ) :
     AudioDriver(mainController),
+    outputLatency(0),
     useSystemDefaultDevices(false)
 {
     qCDebug(jtAudio) << QString("initializing portaudio (%1)...").arg(Pa_GetVersionText());
@@ -189,16 +190,28 @@ void PortAudioDriver::ensureInputRangeIsValid()
     }
 }
 
+double PortAudioDriver::getOutputLatency() const
+{
+    if (outputLatency > 0)
+        return outputLatency;
+
+    return AudioDriver::getOutputLatency();
+}
+
 PortAudioDriver::~PortAudioDriver()
 {
     qCDebug(jtAudio) << "PortAudioDriver destructor";
 }
 
 // this method just convert portaudio void* inputBuffer to a float[][] buffer, and do the same for outputs
-void PortAudioDriver::translatePortAudioCallBack(const void *in, void *out, unsigned long framesPerBuffer)
+void PortAudioDriver::translatePortAudioCallBack(const void *in, void *out, unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo *timeInfo)
 {
     const uint bytesToProcess = framesPerBuffer * sizeof(float);
 
+    // some host APIs are not reporting the stream time
+    if (timeInfo && timeInfo->currentTime > 0 && timeInfo->outputBufferDacTime > timeInfo->currentTime)
+        outputLatency = timeInfo->outputBufferDacTime - timeInfo->currentTime;
+
     // prepare buffers and expose then to application process
     inputBuffer.setFrameLenght(framesPerBuffer);
     outputBuffer.setFrameLenght(framesPerBuffer);
@@ -231,12 +244,12 @@ void PortAudioDriver::translatePortAudioCallBack(const void *in, void *out, unsi
 
 // friend function, receive the pointer to PortAudioDriver instance in userData param
 int portaudioCallBack(const void *inputBuffer, void *outputBuffer,
-                      unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo* /*timeInfo*/,
+                      unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo* timeInfo,
                       PaStreamCallbackFlags /*statusFlags*/, void *userData)
 {
     //qDebug() << "portAudioCallBack  Thread ID: " << QThread::currentThreadId();
     PortAudioDriver* instance = static_cast<PortAudioDriver*>(userData);
-    instance->translatePortAudioCallBack(inputBuffer, outputBuffer, framesPerBuffer);
+    instance->translatePortAudioCallBack(inputBuffer, outputBuffer, framesPerBuffer, timeInfo);
     return paContinue;
 }
 
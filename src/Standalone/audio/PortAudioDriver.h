@@ -47,6 +47,8 @@ public:
     bool hasControlPanel() const override;
     void openControlPanel(void *mainWindowHandle) override;
 
+    double getOutputLatency() const override;
+
     // portaudio callback function
     friend int portaudioCallBack(const void *inputBuffer, void *outputBuffer,
                                  unsigned long framesPerBuffer,
@@ -59,7 +61,9 @@ protected:
 private:
     bool initPortAudio(int sampleRate, int bufferSize);
     PaStream *paStream;
-    void translatePortAudioCallBack(const void *in, void *out, unsigned long framesPerBuffer);
+    void translatePortAudioCallBack(const void *in, void *out, unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo *timeInfo);
+
+    double outputLatency; // measured in audio callback using the portaudio stream time, zero when not available
 
     void changeInputSelection(int firstInputChannelIndex, int inputChannelCount);
 
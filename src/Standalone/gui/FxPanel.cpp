@@ -2,12 +2,16 @@
 #include "FxPanelItem.h"
 #include "LocalTrackViewStandalone.h"
 #include "audio/core/Plugins.h"
+#include "MainControllerStandalone.h"
 
 #include <QVBoxLayout>
 #include <QPainter>
+#include <QLabel>
 
 FxPanel::FxPanel(LocalTrackViewStandalone *parent, MainControllerStandalone *mainController) :
     QWidget(parent),
+    latencyLabel(new QLabel(this)),
+    chainLatency(0),
     controller(mainController),
     localTrackView(parent)
 {
@@ -20,6 +24,29 @@ FxPanel::FxPanel(LocalTrackViewStandalone *parent, MainControllerStandalone *mai
         items.append(item);
         mainLayout->addWidget(item);
     }
+
+    latencyLabel->setObjectName("latencyLabel");
+    latencyLabel->setAlignment(Qt::AlignCenter);
+    latencyLabel->setVisible(false);
+    mainLayout->addWidget(latencyLabel);
+}
+
+void FxPanel::updateLatency()
+{
+    int latency = 0;
+    for (auto item : items)
+        latency += item->updateLatency();
+
+    if (latency == chainLatency)
+        return;
+
+    chainLatency = latency;
+    latencyLabel->setVisible(chainLatency > 0);
+    if (chainLatency > 0) {
+        const double latencyInMs = chainLatency * 1000.0 / controller->getSampleRate();
+        latencyLabel->setText(tr("latency %1 ms").arg(latencyInMs, 0, 'f', 1));
+        latencyLabel->setToolTip(tr("Plugins latency: %1 samples. The transmited audio is aligned with the slowest channel.").arg(chainLatency));
+    }
 }
 
 void FxPanel::removePlugins()
@@ -28,6 +55,8 @@ void FxPanel::removePlugins()
     for (auto item : items) {
         if (item->containPlugin())
             item->unsetPlugin();
+        else if (item->isLoadingPlugin())
+            item->unsetLoadingPlugin();
     }
 }
 
@@ -36,7 +65,7 @@ qint32 FxPanel::getPluginFreeSlotIndex() const
     auto items = findChildren<FxPanelItem *>();
     int slotIndex = 0;
     for (auto item : items) {
-        if (!item->containPlugin())
+        if (!item->containPlugin() && !item->isLoadingPlugin())
             return slotIndex;
         slotIndex++;
     }
@@ -55,6 +84,29 @@ void FxPanel::addPlugin(Plugin *plugin, quint32 pluginSlotIndex)
     }
 }
 
+void FxPanel::setLoadingPlugin(const QString &pluginName, quint32 pluginSlotIndex)
+{
+    auto items = findChildren<FxPanelItem *>();
+    if (pluginSlotIndex < (quint32)items.count())
+        items.at(pluginSlotIndex)->setLoadingPlugin(pluginName);
+}
+
+void FxPanel::unsetLoadingPlugin(quint32 pluginSlotIndex)
+{
+    auto items = findChildren<FxPanelItem *>();
+    if (pluginSlotIndex < (quint32)items.count())
+        items.at(pluginSlotIndex)->unsetLoadingPlugin();
+}
+
+bool FxPanel::isLoadingPlugin(quint32 pluginSlotIndex) const
+{
+    auto items = findChildren<FxPanelItem *>();
+    if (pluginSlotIndex < (quint32)items.count())
+        return items.at(pluginSlotIndex)->isLoadingPlugin();
+
+    return false;
+}
+
 FxPanel::~FxPanel()
 {
     // delete ui;
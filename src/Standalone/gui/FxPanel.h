@@ -6,6 +6,7 @@
 
 class FxPanelItem;
 class LocalTrackViewStandalone;
+class QLabel;
 
 namespace controller {
 class MainControllerStandalone;
@@ -29,10 +30,16 @@ public:
 
     void addPlugin(Plugin *plugin, quint32 pluginSlotIndex);
 
+    void setLoadingPlugin(const QString &pluginName, quint32 pluginSlotIndex);
+    void unsetLoadingPlugin(quint32 pluginSlotIndex);
+    bool isLoadingPlugin(quint32 pluginSlotIndex) const;
+
     qint32 getPluginFreeSlotIndex() const; // return -1 if no free slots are available
 
     void removePlugins();
 
+    void updateLatency(); // called periodically, plugins can change the latency at any time
+
     inline LocalTrackViewStandalone *getLocalTrackView() const
     {
         return localTrackView;
@@ -45,6 +52,8 @@ public:
 
 private:
     QList<FxPanelItem *> items;
+    QLabel *latencyLabel; // the plugins chain latency, visible only when the chain has latency
+    int chainLatency;
     controller::MainControllerStandalone *controller; // storing a 'casted' controller for convenience
     LocalTrackViewStandalone *localTrackView;
 };
@@ -22,6 +22,8 @@ using controller::MainControllerStandalone;
 FxPanelItem::FxPanelItem(LocalTrackViewStandalone *parent, MainControllerStandalone *mainController) :
     QFrame(parent),
     plugin(nullptr),
+    loadingPlugin(false),
+    latency(0),
     bypassButton(new QPushButton(this)),
     label(new QLabel()),
     mainController(mainController),
@@ -49,6 +51,23 @@ bool FxPanelItem::pluginIsBypassed()
     return containPlugin() && plugin->isBypassed();
 }
 
+int FxPanelItem::updateLatency()
+{
+    const int newLatency = (containPlugin() && !plugin->isBypassed()) ? plugin->getLatency() : 0;
+    if (newLatency != latency) {
+        latency = newLatency;
+        if (latency > 0) {
+            const double latencyInMs = latency * 1000.0 / mainController->getSampleRate();
+            setToolTip(tr("Latency: %1 samples (%2 ms)").arg(latency).arg(latencyInMs, 0, 'f', 1));
+        }
+        else {
+            setToolTip(QString());
+        }
+    }
+
+    return latency;
+}
+
 void FxPanelItem::on_buttonClicked()
 {
     if (plugin) {
@@ -68,8 +87,25 @@ void FxPanelItem::updateStyleSheet()
     update();
 }
 
+void FxPanelItem::setLoadingPlugin(const QString &pluginName)
+{
+    loadingPlugin = true;
+    label->setText(tr("loading %1 ...").arg(pluginName));
+    setCursor(Qt::BusyCursor);
+}
+
+void FxPanelItem::unsetLoadingPlugin()
+{
+    loadingPlugin = false;
+    label->setText("");
+    unsetCursor();
+}
+
 void FxPanelItem::setPlugin(audio::Plugin *plugin)
 {
+    if (loadingPlugin)
+        unsetLoadingPlugin();
+
     this->plugin = plugin;
     this->label->setText(plugin->getName());
     this->bypassButton->setVisible(true);
@@ -92,7 +128,7 @@ void FxPanelItem::unsetPlugin()
 
 void FxPanelItem::mousePressEvent(QMouseEvent *event)
 {
-    if (!isEnabled())
+    if (!isEnabled() || loadingPlugin)
         return;
 
     if (event->button() == Qt::LeftButton) {
@@ -107,7 +143,7 @@ void FxPanelItem::mousePressEvent(QMouseEvent *event)
 
 void FxPanelItem::enterEvent(QEvent *)
 {
-    if (!isEnabled())
+    if (!isEnabled() || loadingPlugin)
         return;
 
     if (!containPlugin())
@@ -116,7 +152,7 @@ void FxPanelItem::enterEvent(QEvent *)
 
 void FxPanelItem::leaveEvent(QEvent *)
 {
-    if (!isEnabled())
+    if (!isEnabled() || loadingPlugin)
         return;
 
     if (!containPlugin())
@@ -132,7 +168,7 @@ void FxPanelItem::showPluginsListMenu(const QPoint &p)
 #ifdef Q_OS_MAC
     categories << PluginDescriptor::AU_Plugin;
 #endif
-    //categories << PluginDescriptor::Native_Plugin; // native plugins are not implemented yet
+    categories << PluginDescriptor::Native_Plugin; // built-in plugins (delay, equalizer)
 
     for (PluginDescriptor::Category category : categories) { // category = VST, NATIVE, AU
 
@@ -166,6 +202,9 @@ void FxPanelItem::showPluginsListMenu(const QPoint &p)
 
 void FxPanelItem::on_contextMenu(QPoint p)
 {
+    if (loadingPlugin)
+        return;
+
     if (!containPlugin()) { // show plugins list
         showPluginsListMenu(p);
     }
@@ -31,6 +31,15 @@ public:
         return plugin;
     }
 
+    void setLoadingPlugin(const QString &pluginName); // the slot is reserved to a plugin loading in background
+    void unsetLoadingPlugin();
+    inline bool isLoadingPlugin() const
+    {
+        return loadingPlugin;
+    }
+
+    int updateLatency(); // show the plugin latency in tooltip, return the latency in samples (zero for empty slots and bypassed plugins)
+
     bool pluginIsBypassed();
     const audio::Plugin *getAudioPlugin() const
     {
@@ -53,6 +62,8 @@ private slots:
 
 private:
     audio::Plugin *plugin;
+    bool loadingPlugin;
+    int latency; // the last showed latency
     QPushButton *bypassButton;
     QLabel *label;
     controller::MainControllerStandalone *mainController; // used to ask about plugins
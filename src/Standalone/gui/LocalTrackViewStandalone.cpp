@@ -197,7 +197,10 @@ void LocalTrackViewStandalone::updateGuiElements()
     }
 
     if (midiPeakMeter->isVisible())
-        midiPeakMeter->update();
+        midiPeakMeter->refresh();
+
+    if (fxPanel)
+        fxPanel->updateLatency();
 }
 
 void LocalTrackViewStandalone::reset()
@@ -448,6 +451,23 @@ void LocalTrackViewStandalone::addPlugin(audio::Plugin *plugin, quint32 slotInde
     }
 }
 
+void LocalTrackViewStandalone::setLoadingPlugin(const QString &pluginName, quint32 slotIndex)
+{
+    if (fxPanel)
+        fxPanel->setLoadingPlugin(pluginName, slotIndex);
+}
+
+void LocalTrackViewStandalone::unsetLoadingPlugin(quint32 slotIndex)
+{
+    if (fxPanel)
+        fxPanel->unsetLoadingPlugin(slotIndex);
+}
+
+bool LocalTrackViewStandalone::isLoadingPlugin(quint32 slotIndex) const
+{
+    return fxPanel && fxPanel->isLoadingPlugin(slotIndex);
+}
+
 qint32 LocalTrackViewStandalone::getPluginFreeSlotIndex() const
 {
     return fxPanel->getPluginFreeSlotIndex();
@@ -38,6 +38,10 @@ public:
 
     void addPlugin(audio::Plugin *plugin, quint32 slotIndex, bool bypassed = false);
 
+    void setLoadingPlugin(const QString &pluginName, quint32 slotIndex);
+    void unsetLoadingPlugin(quint32 slotIndex);
+    bool isLoadingPlugin(quint32 slotIndex) const;
+
     QList<const audio::Plugin *> getInsertedPlugins() const;
 
     void refreshInputSelectionName();
@@ -8,12 +8,14 @@
 #include "audio/core/PluginDescriptor.h"
 #include "vst/VstPluginFinder.h"
 #include "vst/VstPlugin.h"
+#include "PluginLoader.h"
 
 #include <QTimer>
 #include <QDesktopWidget>
 #include <QSharedPointer>
 #include <QShortcut>
 #include <QSettings>
+#include <QProgressDialog>
 
 using persistence::SubChannel;
 using persistence::Channel;
@@ -24,6 +26,7 @@ MainWindowStandalone::MainWindowStandalone(MainControllerStandalone *mainControl
     controller(mainController),
     fullScreenViewMode(false),
     pluginScanDialog(nullptr),
+    pluginsLoadingDialog(nullptr),
     preferencesDialog(nullptr)
 {
     setupSignals();
@@ -84,6 +87,20 @@ void MainWindowStandalone::setupSignals()
     connect(ui.actionFullscreenMode, &QAction::triggered, this,
             &MainWindowStandalone::toggleFullScreen);
 
+    auto pluginLoader = controller->getPluginLoader();
+
+    connect(pluginLoader, &audio::PluginLoader::pluginLoaded, this,
+            &MainWindowStandalone::addLoadedPlugin);
+
+    connect(pluginLoader, &audio::PluginLoader::pluginLoadingFailed, this,
+            &MainWindowStandalone::handlePluginLoadingFailure);
+
+    connect(pluginLoader, &audio::PluginLoader::progressChanged, this,
+            &MainWindowStandalone::showPluginsLoadingProgress);
+
+    connect(pluginLoader, &audio::PluginLoader::loadingFinished, this,
+            &MainWindowStandalone::hidePluginsLoadingProgress);
+
     auto pluginFinder = controller->getVstPluginFinder();
     if (!pluginFinder)
         return;
@@ -108,6 +125,9 @@ void MainWindowStandalone::doWindowInitialization()
 {
     MainWindow::doWindowInitialization();
 
+    if (!controller->getPluginLoader()->isLoading()) // no plugins in the session
+        controller->logStartupTimes();
+
     auto settings = mainController->getSettings();
     if (settings.windowsWasFullScreenViewMode()) {
         setFullScreenStatus(true);
@@ -251,7 +271,8 @@ void MainWindowStandalone::sanitizeSubchannelInputSelections(LocalTrackView *sub
 void MainWindowStandalone::restoreLocalSubchannelPluginsList(
     LocalTrackViewStandalone *subChannelView, const SubChannel &subChannel)
 {
-    // create the plugins list
+    // the plugins are loaded in background, the slots are reserved until the plugins are ready
+    auto pluginLoader = controller->getPluginLoader();
     for (const auto &plugin : subChannel.getPlugins()) {
         auto category = static_cast<audio::PluginDescriptor::Category>(plugin.category);
 
@@ -259,26 +280,80 @@ void MainWindowStandalone::restoreLocalSubchannelPluginsList(
         quint32 inputTrackIndex = subChannelView->getInputIndex();
         qint32 pluginSlotIndex = subChannelView->getPluginFreeSlotIndex();
         if (pluginSlotIndex >= 0) {
-            auto pluginInstance
-                = controller->addPlugin(inputTrackIndex, pluginSlotIndex, descriptor);
-            if (pluginInstance) {
-                try
-                {
-                    pluginInstance->restoreFromSerializedData(plugin.data);
-                }
-                catch (...)
-                {
-                    qWarning() << "Exception restoring " << pluginInstance->getName();
-                }
-                subChannelView->addPlugin(pluginInstance, pluginSlotIndex, plugin.bypassed);
-            } else {
-                qCritical() << "can´t create plugin instance! " << plugin.name;
-            }
-            // QApplication::processEvents();
+            subChannelView->setLoadingPlugin(plugin.name, pluginSlotIndex);
+            pluginLoader->load(descriptor, inputTrackIndex, pluginSlotIndex, plugin.data, plugin.bypassed);
         }
     }
 }
 
+LocalTrackViewStandalone *MainWindowStandalone::getLocalTrackView(quint32 inputTrackIndex) const
+{
+    for (auto trackGroup : getLocalChannels<LocalTrackGroupViewStandalone *>()) {
+        for (auto trackView : trackGroup->getTracks<LocalTrackViewStandalone *>()) {
+            if (trackView->getInputIndex() == static_cast<int>(inputTrackIndex))
+                return trackView;
+        }
+    }
+
+    return nullptr;
+}
+
+void MainWindowStandalone::addLoadedPlugin(audio::Plugin *plugin, quint32 inputTrackIndex, quint32 slotIndex)
+{
+    auto trackView = getLocalTrackView(inputTrackIndex);
+    if (!trackView || !trackView->isLoadingPlugin(slotIndex)) { // track removed while the plugin was loading
+        delete plugin;
+        return;
+    }
+
+    if (!controller->insertPlugin(inputTrackIndex, slotIndex, plugin)) {
+        trackView->unsetLoadingPlugin(slotIndex);
+        delete plugin;
+        return;
+    }
+
+    trackView->addPlugin(plugin, slotIndex, plugin->isBypassed());
+}
+
+void MainWindowStandalone::handlePluginLoadingFailure(const audio::PluginDescriptor &descriptor, quint32 inputTrackIndex, quint32 slotIndex)
+{
+    Q_UNUSED(descriptor)
+
+    auto trackView = getLocalTrackView(inputTrackIndex);
+    if (trackView)
+        trackView->unsetLoadingPlugin(slotIndex);
+}
+
+void MainWindowStandalone::showPluginsLoadingProgress(int loadedPlugins, int totalPlugins)
+{
+    if (!pluginsLoadingDialog) {
+        pluginsLoadingDialog = new QProgressDialog(tr("Loading plugins ..."), QString(), 0, totalPlugins, this);
+        pluginsLoadingDialog->setWindowModality(Qt::NonModal); // the GUI is usable while plugins are loading
+        pluginsLoadingDialog->setMinimumDuration(1000); // fast loadings will not show the dialog
+        pluginsLoadingDialog->setAutoClose(false);
+        pluginsLoadingDialog->setAutoReset(false);
+    }
+
+    pluginsLoadingDialog->setMaximum(totalPlugins);
+    pluginsLoadingDialog->setValue(loadedPlugins);
+    pluginsLoadingDialog->setLabelText(tr("Loading plugins (%1 of %2) ...").arg(qMin(loadedPlugins + 1, totalPlugins)).arg(totalPlugins));
+}
+
+void MainWindowStandalone::hidePluginsLoadingProgress()
+{
+    if (pluginsLoadingDialog) {
+        pluginsLoadingDialog->deleteLater();
+        pluginsLoadingDialog = nullptr;
+    }
+}
+
+void MainWindowStandalone::removeAllInputLocalTracks()
+{
+    controller->getPluginLoader()->cancel(); // the plugins in loading are not used anymore
+
+    MainWindow::removeAllInputLocalTracks();
+}
+
 void MainWindowStandalone::initializeLocalSubChannel(LocalTrackView *subChannelView, const SubChannel &subChannel)
 {
     // load channels names, gain, pan, boost, mute
@@ -355,6 +430,8 @@ void MainWindowStandalone::closeEvent(QCloseEvent *e)
 {
     writeWindowSettings(); // save windows pos, size and state using qt high level API for the standalone
 
+    controller->getPluginLoader()->waitForFinished(); // the plugins in loading are saved in settings
+
     MainWindow::closeEvent(e);
     hide(); // hide before stop main controller and disconnect from login server
 
@@ -414,6 +491,8 @@ PreferencesDialog *MainWindowStandalone::createPreferencesDialog()
             &MainControllerStandalone::addBlackVstToSettings);
     connect(dialog, &PreferencesDialogStandalone::vstPluginRemovedFromBlackList, controller,
             &MainControllerStandalone::removeBlackVstFromSettings);
+    connect(dialog, &PreferencesDialogStandalone::vstPluginsBridgedChanged, controller,
+            &MainControllerStandalone::setVstPluginsBridged);
 
     connect(dialog, &PreferencesDialogStandalone::startingFullPluginsScan, controller,
             &MainControllerStandalone::scanAllVstPlugins);
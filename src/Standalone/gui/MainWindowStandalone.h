@@ -12,6 +12,13 @@ namespace controller
 class LocalTrackView;
 class LocalTrackViewStandalone;
 class PluginScanDialog;
+class QProgressDialog;
+
+namespace audio
+{
+    class Plugin;
+    class PluginDescriptor;
+}
 
 using controller::MainControllerStandalone;
 using controller::MainController;
@@ -49,6 +56,8 @@ protected:
 
     void restoreLocalSubchannelPluginsList(LocalTrackViewStandalone *subChannelView, const SubChannel &subChannel);
 
+    void removeAllInputLocalTracks() override;
+
     PreferencesDialog *createPreferencesDialog() override;
 
 protected slots: // TODO change to private slots?
@@ -64,6 +73,12 @@ protected slots: // TODO change to private slots?
     void setCurrentScanningPlugin(const QString &pluginPath);
     void addPluginToBlackList(const QString &pluginPath);
 
+    // plugin loader
+    void addLoadedPlugin(audio::Plugin *plugin, quint32 inputTrackIndex, quint32 slotIndex);
+    void handlePluginLoadingFailure(const audio::PluginDescriptor &descriptor, quint32 inputTrackIndex, quint32 slotIndex);
+    void showPluginsLoadingProgress(int loadedPlugins, int totalPlugins);
+    void hidePluginsLoadingProgress();
+
     void doWindowInitialization() override;
 
 private slots:
@@ -76,11 +91,14 @@ private slots:
 private:
     MainControllerStandalone *controller;
     PluginScanDialog *pluginScanDialog;
+    QProgressDialog *pluginsLoadingDialog;
 
     PreferencesDialog *preferencesDialog; // store the instance to check if dialog is visible e decide show or not the Vst Plugin Scan Dialog
 
     LocalTrackGroupViewStandalone *geTrackGroupViewByName(const QString &trackGroupName) const;
 
+    LocalTrackViewStandalone *getLocalTrackView(quint32 inputTrackIndex) const;
+
     bool midiDeviceIsValid(int deviceIndex) const;
 
     void sanitizeSubchannelInputSelections(LocalTrackView *subChannelView, const persistence::SubChannel &subChannel);
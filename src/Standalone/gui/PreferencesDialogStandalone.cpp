@@ -94,6 +94,9 @@ void PreferencesDialogStandalone::setupSignals()
 
     connect(ui->buttonRemoveVstFromBlackList, SIGNAL(clicked(bool)), this,
             SLOT(removeBlackListedPlugins()));
+
+    connect(ui->checkBoxBridgedPlugins, &QCheckBox::toggled, this,
+            &PreferencesDialogStandalone::vstPluginsBridgedChanged);
 }
 
 void PreferencesDialogStandalone::showDialogToAddVstScanFolder()
@@ -496,6 +499,9 @@ void PreferencesDialogStandalone::populateVstTab()
 
     // update black listed plugins
     updateBlackBox();
+
+    QSignalBlocker bridgedPluginsCheckBoxBlocker(ui->checkBoxBridgedPlugins);
+    ui->checkBoxBridgedPlugins->setChecked(settings->isVstPluginsBridged());
 }
 
 void PreferencesDialogStandalone::selectTab(int index)
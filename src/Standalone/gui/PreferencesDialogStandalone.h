@@ -44,6 +44,8 @@ signals:
     void vstPluginAddedInBlackList(const QString &pluginPath);
     void vstPluginRemovedFromBlackList(const QString &pluginPath);
 
+    void vstPluginsBridgedChanged(bool bridged);
+
     void startingFullPluginsScan();
     void startingOnlyNewPluginsScan();
     void openingExternalAudioControlPanel(); // asio control panel in windows
@@ -8,6 +8,74 @@
 #include "log/Logging.h"
 #include "SingleApplication/singleapplication.h"
 #include "Configurator.h"
+#include "recorder/JamRenderer.h"
+#include "recorder/ReaperProjectGenerator.h"
+#include "persistence/UsersDataCache.h"
+
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <cstring>
+#include <cstdio>
+
+/**
+    Headless mixdown of a recorded jam. Usage example:
+        Jamtaba2 --render-jam "path/to/Reaper project.rpp" --output "path/to/Mixdown" --stems --format wav --sample-rate 48000
+*/
+int renderJam(int argc, char *args[])
+{
+    QCoreApplication application(argc, args);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Jamtaba recorded jam renderer");
+    parser.addHelpOption();
+
+    QCommandLineOption jamOption("render-jam", "Reaper project (RPP) file written by Jamtaba recorder.", "rpp file");
+    QCommandLineOption outputOption("output", "Output folder.", "folder");
+    QCommandLineOption formatOption("format", "Output format: wav or ogg.", "format", "wav");
+    QCommandLineOption sampleRateOption("sample-rate", "Output sample rate.", "sample rate", "44100");
+    QCommandLineOption bitDepthOption("bit-depth", "Wave files bit depth: 16 or 32 (float).", "bits", "16");
+    QCommandLineOption stemsOption("stems", "Render one file per track.");
+    QCommandLineOption noMixOption("no-mix", "Don't render the full mix.");
+    parser.addOptions({ jamOption, outputOption, formatOption, sampleRateOption, bitDepthOption, stemsOption, noMixOption });
+
+    parser.process(application);
+
+    QString rppFile = parser.value(jamOption);
+    auto jam = recorder::ReaperProjectGenerator::readJam(rppFile);
+    if (!jam)
+        return 1;
+
+    recorder::JamRenderer::Settings settings;
+    settings.outputPath = parser.isSet(outputOption) ? parser.value(outputOption) : QFileInfo(rppFile).absoluteDir().absoluteFilePath("../Mixdown");
+    settings.format = parser.value(formatOption) == "ogg" ? recorder::JamRenderer::OggVorbisFormat : recorder::JamRenderer::WaveFormat;
+    settings.sampleRate = parser.value(sampleRateOption).toUInt();
+    settings.bitDepth = static_cast<quint8>(parser.value(bitDepthOption).toUInt());
+    settings.renderStems = parser.isSet(stemsOption);
+    settings.renderMix = !parser.isSet(noMixOption);
+
+    persistence::UsersDataCache usersDataCache(Configurator::getInstance()->getCacheDir());
+
+    recorder::JamRenderer renderer(*jam);
+    renderer.loadTrackMixes(usersDataCache);
+
+    QObject::connect(&renderer, &recorder::JamRenderer::progressChanged, [](int renderedIntervals, int totalIntervals){
+        std::printf("\rRendering interval %d/%d", renderedIntervals, totalIntervals);
+        std::fflush(stdout);
+    });
+
+    bool success = renderer.render(settings);
+    std::printf("\n");
+
+    if (!success)
+        std::fprintf(stderr, "%s\n", qPrintable(renderer.getErrorString()));
+    else if (renderer.getUndecodedFiles() > 0)
+        std::fprintf(stderr, "%d intervals can't be decoded and were rendered as silence\n", renderer.getUndecodedFiles());
+
+    for (const QString &file : renderer.getRenderedFiles())
+        std::printf("%s\n", qPrintable(file));
+
+    return success ? 0 : 1;
+}
 
 int main(int argc, char *args[])
 {
@@ -19,6 +87,11 @@ int main(int argc, char *args[])
     if (!configurator->setUp())
         qCritical() << "JTBConfig->setUp() FAILED !";
 
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(args[i], "--render-jam") == 0)
+            return renderJam(argc, args);
+    }
+
 // SingleApplication is not working in mac. Using a dirty ifdef until have time to solve the SingleApplication issue in Mac
 #ifdef Q_OS_WIN
     SingleApplication application(argc, args);
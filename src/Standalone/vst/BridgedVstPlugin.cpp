@@ -0,0 +1,220 @@
+#include "BridgedVstPlugin.h"
+#include "vst/VstHost.h"
+#include "audio/core/SamplesBuffer.h"
+#include "log/Logging.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+
+using vst::BridgedVstPlugin;
+using audio::SamplesBuffer;
+
+const int BridgedVstPlugin::LOAD_TIMEOUT = 30000;
+const int BridgedVstPlugin::COMMAND_TIMEOUT = 5000;
+
+BridgedVstPlugin::BridgedVstPlugin(VstHost *host, const audio::PluginDescriptor &descriptor) :
+    audio::Plugin(descriptor),
+    host(host),
+    bridgeProcess(new QProcess(this)),
+    transport(createTransportKey()),
+    virtualInstrument(false),
+    midiGenerator(false),
+    closing(false),
+    pendingSequence(0),
+    lastWetBlock(2, bridge::BridgeTransport::MAX_FRAMES),
+    crashedFlag(0),
+    lateBlocks(0),
+    blockFrames(0)
+{
+    bridgeProcess->setProcessChannelMode(QProcess::ForwardedErrorChannel); // the plugin logs are in JamTaba log
+
+    lastWetBlock.zero(); // silence in the first block, the pipeline is empty
+    responseMidiMessages.reserve(bridge::BridgeTransport::MAX_MIDI_MESSAGES); // no allocations in audio thread
+}
+
+BridgedVstPlugin::~BridgedVstPlugin()
+{
+    closing = true;
+
+    if (bridgeProcess->state() != QProcess::NotRunning) {
+        sendCommand("quit");
+        if (!bridgeProcess->waitForFinished(COMMAND_TIMEOUT)) {
+            qCritical() << getName() << "bridge process not finished, killing!";
+            bridgeProcess->kill();
+            bridgeProcess->waitForFinished(1000);
+        }
+    }
+
+    transport.close();
+}
+
+QString BridgedVstPlugin::createTransportKey()
+{
+    static QAtomicInt instances;
+    return QString("JamTaba-Bridge-%1-%2").arg(QCoreApplication::applicationPid()).arg(instances.fetchAndAddOrdered(1));
+}
+
+QString BridgedVstPlugin::getBridgeExecutablePath()
+{
+    QString bridgeExePath = QApplication::applicationDirPath() + "/PluginBridge"; // PluginBridge and Jamtaba2 executables are in the same folder, like the VstScanner
+#ifdef Q_OS_WIN
+    bridgeExePath += ".exe";
+#endif
+    if (QFile(bridgeExePath).exists())
+        return bridgeExePath;
+
+    qCritical() << "PluginBridge executable not founded in" << bridgeExePath;
+    return QString();
+}
+
+bool BridgedVstPlugin::load()
+{
+    const QString bridgeExePath = getBridgeExecutablePath();
+    if (bridgeExePath.isEmpty())
+        return false;
+
+    if (!transport.create())
+        return false;
+
+    QStringList parameters;
+    parameters.append(transport.getKey());
+    parameters.append(descriptor.getPath());
+    parameters.append(QString::number(host->getSampleRate()));
+    parameters.append(QString::number(host->getBufferSize()));
+
+    bridgeProcess->start(bridgeExePath, parameters);
+    if (!bridgeProcess->waitForStarted(COMMAND_TIMEOUT)) {
+        qCritical() << "Can't start the plugin bridge" << bridgeProcess->errorString();
+        return false;
+    }
+
+    const QString readyLine = waitOutput("JT-Bridge-Ready: ", LOAD_TIMEOUT);
+    if (readyLine.isEmpty()) {
+        qCritical() << "Plugin bridge can't load" << descriptor.getPath();
+        bridgeProcess->kill();
+        bridgeProcess->waitForFinished(1000);
+        return false;
+    }
+
+    virtualInstrument = readyLine.section(';', 1, 1) == "1";
+    midiGenerator = readyLine.section(';', 2, 2) == "1";
+
+    connect(bridgeProcess, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus exitStatus) {
+        if (closing)
+            return;
+
+        crashedFlag.storeRelease(1); // the audio thread will pass through the input samples
+        qCritical() << getName() << "bridge process finished! Exit code:" << exitCode << exitStatus;
+        emit crashed(getName());
+    });
+
+    qCDebug(jtVstPlugin) << getName() << "loaded in bridge process" << bridgeProcess->processId();
+
+    return true;
+}
+
+void BridgedVstPlugin::sendCommand(const QString &command) const
+{
+    if (isCrashed() || bridgeProcess->state() != QProcess::Running)
+        return;
+
+    bridgeProcess->write(command.toUtf8() + '\n');
+}
+
+QString BridgedVstPlugin::waitOutput(const QString &prefix, int timeout) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    do {
+        while (bridgeProcess->canReadLine()) {
+            const QString line = QString::fromUtf8(bridgeProcess->readLine()).trimmed();
+            if (line.startsWith(prefix))
+                return line.mid(prefix.size());
+
+            if (line.startsWith("JT-Bridge-Error: ")) {
+                qCritical() << line;
+                return QString();
+            }
+        }
+    }
+    while (bridgeProcess->state() == QProcess::Running && bridgeProcess->waitForReadyRead(qMax(1, timeout - static_cast<int>(timer.elapsed()))));
+
+    return QString();
+}
+
+void BridgedVstPlugin::process(const SamplesBuffer &in, SamplesBuffer &out, std::vector<midi::MidiMessage> &midiBuffer)
+{
+    if (isBypassed() || isCrashed() || !transport.isOpen()) {
+        pendingSequence = 0; // a stale response will be discarded when the processing is resumed
+        return; // the output samples are the dry signal
+    }
+
+    const VstTimeInfo &vstTimeInfo = host->vstTimeInfo;
+
+    bridge::BridgeTransport::TimeInfo timeInfo;
+    timeInfo.sampleRate = static_cast<quint32>(vstTimeInfo.sampleRate);
+    timeInfo.bpm = static_cast<quint32>(vstTimeInfo.tempo);
+    timeInfo.positionInSamples = static_cast<qint32>(vstTimeInfo.samplePos);
+    timeInfo.playing = vstTimeInfo.flags & kVstTransportPlaying;
+
+    blockFrames.storeRelease(out.getFrameLenght());
+
+    // the current block is processed in the bridge process while we are using the response for the previous block
+    const quint32 sequence = transport.sendRequest(in, midiBuffer, timeInfo);
+    if (!sequence) // bridge process is not consuming the requests
+        lateBlocks.fetchAndAddRelaxed(1);
+
+    bool responseReceived = false;
+    if (pendingSequence) {
+        // the bridge process had the previous block duration to process, waiting at most half of the block duration
+        const int timeout = timeInfo.sampleRate ? static_cast<int>(out.getFrameLenght() * 500000.0 / timeInfo.sampleRate) : 0;
+        responseReceived = transport.waitResponse(pendingSequence, out, responseMidiMessages, timeout);
+        if (!responseReceived)
+            lateBlocks.fetchAndAddRelaxed(1);
+    }
+
+    pendingSequence = sequence;
+
+    if (responseReceived) {
+        lastWetBlock.set(out);
+
+        // forwarding the midi messages generated by the plugin to the next plugins in the chain
+        host->receivedMidiMessages.insert(host->receivedMidiMessages.end(), responseMidiMessages.begin(), responseMidiMessages.end());
+    }
+    else {
+        out.set(lastWetBlock); // repeating the last processed block instead of switching to the dry signal
+    }
+}
+
+void BridgedVstPlugin::openEditor(const QPoint &centerOfScreen)
+{
+    sendCommand(QString("open-editor %1 %2").arg(centerOfScreen.x()).arg(centerOfScreen.y()));
+}
+
+void BridgedVstPlugin::closeEditor()
+{
+    sendCommand("close-editor");
+}
+
+QByteArray BridgedVstPlugin::getSerializedData() const
+{
+    if (isCrashed())
+        return QByteArray();
+
+    sendCommand("get-state");
+    return QByteArray::fromBase64(waitOutput("JT-Bridge-State: ", COMMAND_TIMEOUT).toLatin1());
+}
+
+void BridgedVstPlugin::restoreFromSerializedData(const QByteArray &dataToRestore)
+{
+    if (!dataToRestore.isEmpty())
+        sendCommand("set-state " + QString::fromLatin1(dataToRestore.toBase64()));
+}
+
+void BridgedVstPlugin::setBypass(bool state)
+{
+    Plugin::setBypass(state);
+    sendCommand(state ? "bypass 1" : "bypass 0");
+}
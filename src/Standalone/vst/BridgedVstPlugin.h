@@ -0,0 +1,146 @@
+#ifndef BRIDGED_VST_PLUGIN_H
+#define BRIDGED_VST_PLUGIN_H
+
+#include "audio/core/Plugins.h"
+#include "audio/core/SamplesBuffer.h"
+#include "bridge/BridgeTransport.h"
+#include "midi/MidiMessage.h"
+
+#include <QProcess>
+#include <QAtomicInt>
+#include <QAtomicInteger>
+
+namespace vst {
+
+class VstHost;
+
+/**
+    A VST plugin running in a PluginBridge process. Crashes and freezes in the plugin will not crash
+    JamTaba: the audio is exchanged using a shared memory transport with a timeout and, after a crash,
+    the input samples are just passed through. The editor is opened by the bridge process.
+
+    The processing is pipelined: each block is sent to the bridge process and the response for the
+    previous block is used. All bridge processes (tracks and plugin chains) are computing in parallel
+    while the audio callback is running, and the plugin latency is increased by one block.
+ */
+
+class BridgedVstPlugin : public audio::Plugin
+{
+    Q_OBJECT
+
+public:
+    BridgedVstPlugin(vst::VstHost *host, const audio::PluginDescriptor &descriptor);
+    ~BridgedVstPlugin();
+
+    bool load(); // start the bridge process, blocked until the plugin is loaded
+
+    void process(const audio::SamplesBuffer &in, audio::SamplesBuffer &out, std::vector<midi::MidiMessage> &midiBuffer) override;
+
+    void openEditor(const QPoint &centerOfScreen) override;
+    void closeEditor() override;
+
+    void start() override;
+    void updateGui() override;
+
+    QString getPath() const override;
+
+    QByteArray getSerializedData() const override;
+    void restoreFromSerializedData(const QByteArray &dataToRestore) override;
+
+    void setBypass(bool state) override;
+
+    bool isVirtualInstrument() const override;
+    bool canGenerateMidiMessages() const override;
+
+    int getLatency() const override;
+
+    bool isCrashed() const;
+    quint32 getLateBlocks() const; // blocks not processed in time, the last processed block was repeated
+
+signals:
+    void crashed(const QString &pluginName);
+
+protected:
+    void suspend() override;
+    void resume() override;
+
+private:
+    void sendCommand(const QString &command) const;
+    QString waitOutput(const QString &prefix, int timeout) const; // empty string when the prefix is not received
+
+    static QString getBridgeExecutablePath();
+    static QString createTransportKey();
+
+    vst::VstHost *host;
+    QProcess *bridgeProcess;
+    bridge::BridgeTransport transport;
+
+    bool virtualInstrument;
+    bool midiGenerator;
+    bool closing;
+
+    quint32 pendingSequence; // the request sent in the previous block, zero when there is no request
+    audio::SamplesBuffer lastWetBlock; // repeated when the bridge process is late
+    std::vector<midi::MidiMessage> responseMidiMessages;
+
+    QAtomicInt crashedFlag;
+    QAtomicInteger<quint32> lateBlocks;
+    QAtomicInteger<quint32> blockFrames; // the pipeline latency, written in audio thread
+
+    static const int LOAD_TIMEOUT;
+    static const int COMMAND_TIMEOUT;
+};
+
+inline bool BridgedVstPlugin::isVirtualInstrument() const
+{
+    return virtualInstrument;
+}
+
+inline bool BridgedVstPlugin::canGenerateMidiMessages() const
+{
+    return midiGenerator;
+}
+
+inline int BridgedVstPlugin::getLatency() const
+{
+    return isCrashed() ? 0 : static_cast<int>(transport.getResponseLatency() + blockFrames.loadAcquire());
+}
+
+inline bool BridgedVstPlugin::isCrashed() const
+{
+    return crashedFlag.loadAcquire();
+}
+
+inline quint32 BridgedVstPlugin::getLateBlocks() const
+{
+    return lateBlocks.loadAcquire();
+}
+
+inline QString BridgedVstPlugin::getPath() const
+{
+    return descriptor.getPath();
+}
+
+inline void BridgedVstPlugin::start()
+{
+    // the plugin is started in the bridge process
+}
+
+inline void BridgedVstPlugin::updateGui()
+{
+    // the editor is idle by the bridge process
+}
+
+inline void BridgedVstPlugin::suspend()
+{
+
+}
+
+inline void BridgedVstPlugin::resume()
+{
+
+}
+
+} // namespace
+
+#endif // BRIDGED_VST_PLUGIN_H
@@ -0,0 +1,112 @@
+#include "VstMidiEvents.h"
+
+using vst::VstMidiEvents;
+
+VstMidiEvents::Block::Block(int capacity) :
+    midiEvents(capacity),
+    vstEventsData(sizeof(VstEvents) + sizeof(VstEvent *) * qMax(0, capacity - 2)) // VstEvents is declared with 2 events
+{
+    auto vstEvents = getVstEvents();
+    vstEvents->numEvents = 0;
+    vstEvents->reserved = 0;
+    for (int i = 0; i < capacity; ++i)
+        vstEvents->events[i] = reinterpret_cast<VstEvent *>(&midiEvents[i]);
+}
+
+VstEvents *VstMidiEvents::Block::getVstEvents()
+{
+    return reinterpret_cast<VstEvents *>(vstEventsData.data());
+}
+
+int VstMidiEvents::Block::getCapacity() const
+{
+    return static_cast<int>(midiEvents.size());
+}
+
+VstMidiEvent &VstMidiEvents::Block::getEvent(int index)
+{
+    return midiEvents[index];
+}
+
+VstMidiEvents::VstMidiEvents(int initialCapacity, int maxCapacity) :
+    block(new Block(initialCapacity)),
+    pendingBlock(nullptr),
+    retiredBlock(nullptr),
+    preparedCapacity(initialCapacity),
+    maxCapacity(maxCapacity),
+    requiredEvents(0),
+    overflowedEvents(0)
+{
+
+}
+
+VstMidiEvents::~VstMidiEvents()
+{
+    delete pendingBlock.fetchAndStoreAcquire(nullptr);
+    delete retiredBlock.fetchAndStoreAcquire(nullptr);
+}
+
+void VstMidiEvents::updateBlock()
+{
+    if (!pendingBlock.load() || retiredBlock.load()) // the GUI thread is not deleted the last retired block yet
+        return;
+
+    auto newBlock = pendingBlock.fetchAndStoreAcquire(nullptr);
+    if (newBlock) {
+        retiredBlock.storeRelease(block.release()); // deleted in GUI thread
+        block.reset(newBlock);
+    }
+}
+
+bool VstMidiEvents::grow()
+{
+    delete retiredBlock.fetchAndStoreAcquire(nullptr);
+
+    const int required = requiredEvents.load();
+    if (required <= preparedCapacity || preparedCapacity >= maxCapacity)
+        return false;
+
+    if (pendingBlock.load()) // the audio thread is not using the last allocated block yet
+        return false;
+
+    int capacity = qMax(preparedCapacity, 1);
+    while (capacity < required)
+        capacity *= 2;
+
+    preparedCapacity = qMin(capacity, maxCapacity);
+
+    pendingBlock.storeRelease(new Block(preparedCapacity));
+
+    return true;
+}
+
+VstEvents *VstMidiEvents::fill(const std::vector<midi::MidiMessage> &midiBuffer)
+{
+    updateBlock();
+
+    const int messages = static_cast<int>(midiBuffer.size());
+    if (messages > requiredEvents.load())
+        requiredEvents.store(messages); // a bigger block will be allocated in GUI thread
+
+    const int capacity = block->getCapacity();
+    if (messages > capacity)
+        overflowedEvents.fetchAndAddRelaxed(messages - capacity);
+
+    const int midiMessages = qMin(messages, capacity);
+    block->getVstEvents()->numEvents = midiMessages;
+    for (int m = 0; m < midiMessages; ++m) {
+        const auto &message = midiBuffer[m];
+        VstMidiEvent &vstEvent = block->getEvent(m);
+        vstEvent.type = kVstMidiType;
+        vstEvent.byteSize = sizeof(VstMidiEvent);
+        vstEvent.deltaFrames = message.getSampleOffset(); // sample accurate position inside the audio block
+        vstEvent.reserved1 = vstEvent.reserved2 = 0;
+        vstEvent.midiData[0] = message.getStatus();
+        vstEvent.midiData[1] = message.getData1();
+        vstEvent.midiData[2] = message.getData2();
+        vstEvent.midiData[3] = 0;
+        vstEvent.flags = kVstMidiEventIsRealtime;
+    }
+
+    return block->getVstEvents();
+}
@@ -0,0 +1,74 @@
+#ifndef VST_MIDI_EVENTS_H
+#define VST_MIDI_EVENTS_H
+
+#include "aeffectx.h"
+#include "midi/MidiMessage.h"
+
+#include <QAtomicPointer>
+#include <QAtomicInteger>
+
+#include <memory>
+#include <vector>
+
+#define MAX_MIDI_EVENTS 64 // initial capacity, in my tests playing piano I can genenerate just 3 messages per block (256 samples) at maximum
+#define MAX_MIDI_EVENTS_CAPACITY 4096 // dense controller streams are growing the events block up to this limit
+
+namespace vst {
+
+/**
+    VstEvents passed to the plugins in each audio block. The events block is never allocated in the audio
+    thread: when a midi buffer is bigger than the block the exceeding messages are dropped and a bigger
+    block is allocated in the GUI thread, the audio thread uses the new block in the next audio callback.
+ */
+
+class VstMidiEvents
+{
+public:
+    explicit VstMidiEvents(int initialCapacity = MAX_MIDI_EVENTS, int maxCapacity = MAX_MIDI_EVENTS_CAPACITY);
+    ~VstMidiEvents();
+
+    VstEvents *fill(const std::vector<midi::MidiMessage> &midiBuffer); // audio thread, translate the midi messages in VstEvents
+    bool grow(); // GUI thread, return true when a bigger events block is allocated
+
+    int getCapacity() const; // audio thread, capacity of the events block in use
+    quint32 getOverflowedEvents() const; // midi messages dropped because the events block was full
+
+private:
+    class Block // VstEvents with a variable number of VstMidiEvents
+    {
+    public:
+        explicit Block(int capacity);
+        VstEvents *getVstEvents();
+        int getCapacity() const;
+        VstMidiEvent &getEvent(int index);
+
+    private:
+        std::vector<VstMidiEvent> midiEvents;
+        std::vector<char> vstEventsData; // VstEvents header followed by 'capacity' events pointers
+    };
+
+    void updateBlock(); // audio thread, using the bigger events block if available
+
+    std::unique_ptr<Block> block; // used in audio thread
+    QAtomicPointer<Block> pendingBlock; // allocated in GUI thread, waiting the audio thread
+    QAtomicPointer<Block> retiredBlock; // replaced in audio thread, deleted in GUI thread
+    int preparedCapacity; // GUI thread
+    const int maxCapacity;
+
+    QAtomicInteger<int> requiredEvents; // the bigger midi buffer received in audio thread
+    QAtomicInteger<quint32> overflowedEvents;
+};
+
+inline int VstMidiEvents::getCapacity() const
+{
+    return block->getCapacity();
+}
+
+inline quint32 VstMidiEvents::getOverflowedEvents() const
+{
+    return overflowedEvents.loadAcquire();
+}
+
+} // namespace
+
+#endif
@@ -43,12 +43,6 @@ VstPlugin::VstPlugin(VstHost* host, const QString &pluginPath) :
     turnedOn(false),
     wantMidi(false)
 {
-    vstMidiEvents.reserved = 0;
-    vstMidiEvents.numEvents = 0;
-    for (int i = 0; i < MAX_MIDI_EVENTS; ++i) {
-        vstMidiEvents.events[i] = (VstEvent*)(new VstMidiEvent);
-    }
-
     assert(host);
 
 }
@@ -85,6 +79,14 @@ bool VstPlugin::canGenerateMidiMessages() const
     return returnValue >= 0;
 }
 
+int VstPlugin::getLatency() const
+{
+    if (!effect) {
+        return 0;
+    }
+    return qMax(0, static_cast<int>(effect->initialDelay)); // plugins can change the delay after parameter changes (ioChanged)
+}
+
 bool VstPlugin::isVirtualInstrument() const
 {
     if (!effect) {
@@ -146,6 +148,9 @@ void VstPlugin::start()
     internalOutputBuffer.reset(new audio::SamplesBuffer(effect->numOutputs, hostBufferSize));
     internalInputBuffer.reset(new audio::SamplesBuffer(effect->numInputs, hostBufferSize));
 
+    vstInputArray.assign(effect->numInputs, nullptr);
+    vstOutputArray.assign(effect->numOutputs, nullptr);
+
     long ver = effect->dispatcher(effect, effGetVstVersion, 0, 0, NULL, 0);// EffGetVstVersion();
     qCDebug(jtVstPlugin) << "Starting " << getName() << " version " << ver;
 
@@ -187,11 +192,6 @@ VstPlugin::~VstPlugin()
         editorWindow->deleteLater();
         editorWindow = nullptr;
     }
-
-    for (int i = 0; i < MAX_MIDI_EVENTS; ++i) {
-        delete this->vstMidiEvents.events[i];
-    }
-
 }
 
 void VstPlugin::unload()
@@ -211,28 +211,30 @@ void VstPlugin::unload()
     }
 }
 
-void VstPlugin::fillVstEventsList(const std::vector<midi::MidiMessage> &midiBuffer)
+void VstPlugin::updateChannelsPointers(const audio::SamplesBuffer &in, int sampleFrames)
 {
-    int midiMessages = qMin((int)midiBuffer.size(), (int)MAX_MIDI_EVENTS);
-    this->vstMidiEvents.numEvents = midiMessages;
-    for (int m = 0; m < midiMessages; ++m) {
-        auto message = midiBuffer.at(m);
-        VstMidiEvent* vstEvent = (VstMidiEvent*)vstMidiEvents.events[m];
-        vstEvent->type = kVstMidiType;
-        vstEvent->byteSize = sizeof(vstEvent);
-        vstEvent->deltaFrames = vstEvent->reserved1 = vstEvent->reserved2 = 0;
-        vstEvent->midiData[0] = message.getStatus();
-        vstEvent->midiData[1] = message.getData1();
-        vstEvent->midiData[2] = message.getData2();
-        vstEvent->midiData[3] = 0;
-        vstEvent->flags = kVstMidiEventIsRealtime;
+    // processReplacing is not writing in the input arrays, the input samples are used without copy when the plugin inputs are available in 'in'
+    const bool canUseInputSamples = in.getChannels() >= static_cast<int>(vstInputArray.size())
+            && static_cast<int>(in.getFrameLenght()) >= sampleFrames;
+
+    if (canUseInputSamples) {
+        for (size_t c = 0; c < vstInputArray.size(); ++c)
+            vstInputArray[c] = in.getSamplesArray(c);
     }
+    else {
+        internalInputBuffer->setFrameLenght(sampleFrames);
+        internalInputBuffer->set(in);
+        for (size_t c = 0; c < vstInputArray.size(); ++c)
+            vstInputArray[c] = internalInputBuffer->getSamplesArray(c);
+    }
+
+    internalOutputBuffer->setFrameLenght(sampleFrames);
+    for (size_t c = 0; c < vstOutputArray.size(); ++c)
+        vstOutputArray[c] = internalOutputBuffer->getSamplesArray(c);
 }
 
 void VstPlugin::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &outBuffer, std::vector<midi::MidiMessage> &midiBuffer)
 {
-
-    Q_UNUSED(in)
     if (isBypassed() || !effect || !loaded || !started) {
         return;
     }
@@ -243,28 +245,14 @@ void VstPlugin::process(const audio::SamplesBuffer &in, audio::SamplesBuffer &ou
     }
 
     if (wantMidi) {
-        fillVstEventsList(midiBuffer); // translate midiBuffer messages in VstEvents
-        effect->dispatcher(effect, effProcessEvents, 0, 0, (void*)&vstMidiEvents, 0);
+        VstEvents *vstEvents = midiEvents.fill(midiBuffer); // translate midiBuffer messages in VstEvents
+        effect->dispatcher(effect, effProcessEvents, 0, 0, (void*)vstEvents, 0);
     }
 
-    internalOutputBuffer->setFrameLenght(outBuffer.getFrameLenght());
-    internalInputBuffer->setFrameLenght(outBuffer.getFrameLenght());
-
-    internalInputBuffer->set(in);
-
-    int inChannels = internalInputBuffer->getChannels();
-    int outChannels = internalOutputBuffer->getChannels();
-
-    std::vector<float *> vstOutputArray(outChannels);
-    std::vector<float *> vstInputArray(inChannels);
-
-    for (int c = 0; c < inChannels; ++c)
-        vstInputArray[c] = internalInputBuffer->getSamplesArray(c);
+    VstInt32 sampleFrames = outBuffer.getFrameLenght();
 
-    for (int c = 0; c < outChannels; ++c)
-        vstOutputArray[c] = internalOutputBuffer->getSamplesArray(c);
+    updateChannelsPointers(in, sampleFrames);
 
-    VstInt32 sampleFrames = outBuffer.getFrameLenght();
     if (effect->flags & effFlagsCanReplacing) {
         effect->processReplacing(effect, vstInputArray.data(), vstOutputArray.data(), sampleFrames);
     }
@@ -375,6 +363,9 @@ QDialog* VstPlugin::getPluginEditorWindow(const QString &pluginName)
 
 void VstPlugin::updateGui()
 {
+    if (midiEvents.grow()) // called periodically in GUI thread
+        qCWarning(jtVstPlugin) << getName() << "dropped" << midiEvents.getOverflowedEvents() << "midi events, growing the events block";
+
     if (isBypassed() || !effect || !loaded || !started) {
         return;
     }
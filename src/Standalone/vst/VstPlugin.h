@@ -3,16 +3,13 @@
 
 #include "audio/core/Plugins.h"
 #include "aeffectx.h"
+#include "VstMidiEvents.h"
 #include <QMap>
 #include <QLibrary>
 
 #include <memory>
 #include <vector>
 
-#define MAX_MIDI_EVENTS 64 // in my tests playing piano I can genenerate just 3 messages per block (256 samples) at maximum
-
-struct VstEvents;
-
 namespace vst {
 
 class VstHost;
@@ -55,6 +52,8 @@ public:
 
     bool canGenerateMidiMessages() const override;
 
+    int getLatency() const override;
+
     inline quint32 getPluginID() const { return effect->resvd1; }
 
 protected:
@@ -81,17 +80,13 @@ private:
 
     bool loaded;
 
-    void fillVstEventsList(const std::vector<midi::MidiMessage> &midiBuffer);
+    void updateChannelsPointers(const audio::SamplesBuffer &in, int sampleFrames);
 
-    template<int N>
-    struct VSTEventBlock
-    {
-        VstInt32 numEvents;
-        VstIntPtr reserved;
-        VstEvent *events[N];
-    };
+    VstMidiEvents midiEvents; // filled in audio thread, grown in GUI thread
 
-    VSTEventBlock<MAX_MIDI_EVENTS> vstMidiEvents;
+    // persistent channels pointers passed to 'processReplacing', no allocations in audio thread
+    std::vector<float *> vstInputArray;
+    std::vector<float *> vstOutputArray;
 
     static QMap<QString, QDialog *> editorsWindows;
 
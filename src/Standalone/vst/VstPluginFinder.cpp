@@ -2,14 +2,20 @@
 
 #include <QApplication>
 #include <QLibraryInfo>
+#include <QDirIterator>
+
+#include "VstPluginChecker.h"
 
 #include "log/Logging.h"
 
 using audio::VSTPluginFinder;
 
-VSTPluginFinder::VSTPluginFinder()
+VSTPluginFinder::VSTPluginFinder(const QString &scanDatabaseFile) :
+    scanDatabase(scanDatabaseFile)
 {
-    //
+    connect(this, &PluginFinder::scanFinished, [=]() {
+        scanDatabase.save();
+    });
 }
 
 VSTPluginFinder::~VSTPluginFinder()
@@ -17,11 +23,50 @@ VSTPluginFinder::~VSTPluginFinder()
     //
 }
 
-audio::PluginDescriptor VSTPluginFinder::getPluginDescriptor(const QFileInfo &f)
+void VSTPluginFinder::forgetInvalidPlugins()
+{
+    scanDatabase.removeInvalidPlugins();
+}
+
+bool VSTPluginFinder::canScanInParallel() const
+{
+    return true;
+}
+
+QStringList VSTPluginFinder::getPluginsToScan(const QStringList &foldersToScan, const QSet<QString> &skipList)
+{
+    QStringList pluginsToScan;
+    for (const QString &scanFolder : foldersToScan) {
+        QDirIterator folderIterator(scanFolder, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDirIterator::Subdirectories);
+        while (folderIterator.hasNext()) {
+            folderIterator.next(); // point to next file inside current folder
+            const QFileInfo pluginFile(folderIterator.fileInfo());
+            const QString pluginPath = pluginFile.absoluteFilePath();
+
+            if (skipList.contains(pluginPath))
+                continue;
+
+            switch (scanDatabase.getScanResult(pluginFile)) {
+            case persistence::PluginScanDatabase::ValidPlugin: // scanned before and not changed, no need to load the plugin again
+                emit pluginScanFinished(audio::PluginDescriptor::getVstPluginNameFromPath(pluginPath), pluginPath);
+                break;
+            case persistence::PluginScanDatabase::InvalidPlugin:
+                break;
+            case persistence::PluginScanDatabase::NotScanned:
+                if (Vst::PluginChecker::isValidPluginFile(pluginPath))
+                    pluginsToScan.append(pluginPath);
+                break;
+            }
+        }
+    }
+
+    return pluginsToScan;
+}
+
+void VSTPluginFinder::handlePluginScanned(const QString &pluginPath, bool isValidPlugin)
 {
-    QString name = audio::PluginDescriptor::getVstPluginNameFromPath(f.absoluteFilePath());
-    auto category = audio::PluginDescriptor::VST_Plugin;
-    return audio::PluginDescriptor(name, category, f.absoluteFilePath());
+    auto result = isValidPlugin ? persistence::PluginScanDatabase::ValidPlugin : persistence::PluginScanDatabase::InvalidPlugin;
+    scanDatabase.setScanResult(QFileInfo(pluginPath), result);
 }
 
 QString VSTPluginFinder::getScannerExecutablePath() const
@@ -47,7 +92,6 @@ void VSTPluginFinder::handleScanningStart(const QString &scannedLine)
     }
 
     QString pluginPath = parts.at(1);
-    lastScannedPlugin = pluginPath;// store the plugin path, if the scanner process crash we can add this bad plugin in the black list
     emit pluginScanStarted(pluginPath);
 }
 
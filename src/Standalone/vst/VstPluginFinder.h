@@ -3,6 +3,7 @@
 
 #include "PluginFinder.h"
 #include "audio/core/PluginDescriptor.h"
+#include "persistence/PluginScanDatabase.h"
 
 namespace audio {
 
@@ -10,21 +11,23 @@ class VSTPluginFinder : public PluginFinder
 {
 
 public:
-    VSTPluginFinder();
+    explicit VSTPluginFinder(const QString &scanDatabaseFile);
     virtual ~VSTPluginFinder();
 
+    void forgetInvalidPlugins(); // invalid plugins (not crashed) are loaded again in the next scan
+
 protected:
     QString getScannerExecutablePath() const override;
 
     void handleScanningStart(const QString &scannedLine) override;
     void handleScanningFinished(const QString &scannedLine) override;
 
-private:
-    QProcess scanProcess;
-    QString lastScannedPlugin; // used to recover the last plugin path when the scanner process crash
-
-    audio::PluginDescriptor getPluginDescriptor(const QFileInfo &f);
+    bool canScanInParallel() const override;
+    QStringList getPluginsToScan(const QStringList &foldersToScan, const QSet<QString> &skipList) override;
+    void handlePluginScanned(const QString &pluginPath, bool isValidPlugin) override;
 
+private:
+    persistence::PluginScanDatabase scanDatabase;
 };
 
 } // namespace
@@ -0,0 +1,88 @@
+#include "TestAudioBus.h"
+#include "audio/core/AudioBus.h"
+
+#include <QtTest/QtTest>
+
+using audio::AudioBus;
+using audio::SamplesBuffer;
+
+namespace {
+
+SamplesBuffer createBuffer(int channels, quint32 frames, float leftValue, float rightValue)
+{
+    SamplesBuffer buffer(channels, frames);
+    for (quint32 s = 0; s < frames; ++s) {
+        buffer.set(0, s, leftValue);
+        if (channels > 1)
+            buffer.set(1, s, rightValue);
+    }
+
+    return buffer;
+}
+
+} // namespace
+
+void TestAudioBus::mixStereoInStereoBus()
+{
+    AudioBus bus;
+    bus.prepare(2, 64);
+
+    bus.mix(createBuffer(2, 64, 0.1f, 0.2f));
+    bus.mix(createBuffer(2, 64, 0.3f, 0.4f), 0.0f, 0.0f); // gains are used only when downmixing
+
+    QCOMPARE(bus.getChannels(), 2);
+    QCOMPARE(bus.getBuffer().getFrameLenght(), 64u);
+    QCOMPARE(bus.getBuffer().get(0, 63), 0.1f + 0.3f);
+    QCOMPARE(bus.getBuffer().get(1, 0), 0.2f + 0.4f);
+}
+
+void TestAudioBus::mixMonoInStereoBus()
+{
+    AudioBus bus;
+    bus.prepare(2, 64);
+
+    bus.mix(createBuffer(1, 64, 0.5f, 0.0f));
+
+    QCOMPARE(bus.getBuffer().get(0, 10), 0.5f);
+    QCOMPARE(bus.getBuffer().get(1, 10), 0.5f);
+}
+
+void TestAudioBus::downmixStereoInMonoBus()
+{
+    AudioBus bus;
+    bus.prepare(1, 64);
+
+    bus.mix(createBuffer(2, 64, 0.5f, 0.25f), 1.0f, 0.5f);
+    bus.mix(createBuffer(1, 64, 0.1f, 0.0f));
+
+    QCOMPARE(bus.getChannels(), 1);
+    QCOMPARE(bus.getBuffer().get(0, 0), 0.5f + 0.25f * 0.5f + 0.1f);
+}
+
+void TestAudioBus::prepareClearsTheBus()
+{
+    AudioBus bus;
+    bus.prepare(2, 64);
+    bus.mix(createBuffer(2, 64, 1.0f, 1.0f));
+
+    bus.prepare(2, 32);
+
+    QCOMPARE(bus.getBuffer().getFrameLenght(), 32u);
+    QCOMPARE(bus.getBuffer().get(0, 31), 0.0f);
+    QCOMPARE(bus.getBuffer().get(1, 0), 0.0f);
+}
+
+void TestAudioBus::prepareDontReallocate()
+{
+    AudioBus bus(256);
+    bus.prepare(2, 256);
+    const float *left = bus.getBuffer().getSamplesArray(0);
+    const float *right = bus.getBuffer().getSamplesArray(1);
+
+    bus.prepare(1, 128);
+    bus.prepare(2, 64);
+    bus.prepare(2, 256);
+
+    QCOMPARE(bus.getBuffer().getSamplesArray(0), left);
+    QCOMPARE(bus.getBuffer().getSamplesArray(1), right);
+}
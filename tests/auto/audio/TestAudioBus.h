@@ -0,0 +1,18 @@
+#ifndef TESTAUDIOBUS_H
+#define TESTAUDIOBUS_H
+
+#include <QObject>
+
+class TestAudioBus: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mixStereoInStereoBus();
+    void mixMonoInStereoBus();
+    void downmixStereoInMonoBus();
+    void prepareClearsTheBus();
+    void prepareDontReallocate();
+};
+
+#endif // TESTAUDIOBUS_H
@@ -0,0 +1,74 @@
+#include "TestDelayLine.h"
+#include "audio/core/DelayLine.h"
+
+#include <QtTest/QtTest>
+
+using audio::DelayLine;
+using audio::SamplesBuffer;
+
+namespace {
+
+SamplesBuffer createRamp(int channels, quint32 frames, float firstValue)
+{
+    SamplesBuffer buffer(channels, frames);
+    for (int c = 0; c < channels; ++c) {
+        for (quint32 s = 0; s < frames; ++s)
+            buffer.set(c, s, firstValue + s);
+    }
+
+    return buffer;
+}
+
+} // namespace
+
+void TestDelayLine::zeroDelayIsCopying()
+{
+    DelayLine delayLine;
+    SamplesBuffer in = createRamp(2, 32, 1.0f);
+    SamplesBuffer out(2, 32);
+
+    delayLine.process(in, out);
+
+    for (quint32 s = 0; s < 32; ++s)
+        QCOMPARE(out.get(1, s), in.get(1, s));
+}
+
+void TestDelayLine::delayAcrossBlocks()
+{
+    DelayLine delayLine;
+    delayLine.setDelay(40); // bigger than the block size
+
+    SamplesBuffer out(2, 32);
+    for (int block = 0; block < 4; ++block) {
+        const float firstValue = 1.0f + block * 32;
+        delayLine.process(createRamp(2, 32, firstValue), out);
+
+        for (quint32 s = 0; s < 32; ++s) {
+            const int inputIndex = block * 32 + static_cast<int>(s) - 40;
+            const float expected = inputIndex < 0 ? 0.0f : 1.0f + inputIndex;
+            QCOMPARE(out.get(0, s), expected);
+        }
+    }
+}
+
+void TestDelayLine::delayIsClampedInMaxDelay()
+{
+    DelayLine delayLine(100);
+    QVERIFY(delayLine.getMaxDelay() >= 100);
+
+    delayLine.setDelay(1000000);
+    QCOMPARE(delayLine.getDelay(), delayLine.getMaxDelay());
+}
+
+void TestDelayLine::monoInputInStereoOutput()
+{
+    DelayLine delayLine;
+    delayLine.setDelay(1);
+
+    SamplesBuffer out(2, 4);
+    delayLine.process(createRamp(1, 4, 1.0f), out);
+
+    QCOMPARE(out.get(0, 0), 0.0f);
+    QCOMPARE(out.get(0, 1), 1.0f);
+    QCOMPARE(out.get(1, 3), 3.0f);
+}
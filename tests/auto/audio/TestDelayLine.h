@@ -0,0 +1,17 @@
+#ifndef TESTDELAYLINE_H
+#define TESTDELAYLINE_H
+
+#include <QObject>
+
+class TestDelayLine: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void zeroDelayIsCopying();
+    void delayAcrossBlocks();
+    void delayIsClampedInMaxDelay();
+    void monoInputInStereoOutput();
+};
+
+#endif // TESTDELAYLINE_H
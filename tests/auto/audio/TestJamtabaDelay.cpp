@@ -0,0 +1,181 @@
+#include "TestJamtabaDelay.h"
+#include "audio/BuiltInPlugins.h"
+#include "audio/core/SamplesBuffer.h"
+
+#include <QtTest/QtTest>
+#include <cmath>
+
+using audio::JamtabaDelay;
+using audio::SamplesBuffer;
+
+namespace {
+
+const int SAMPLE_RATE = 44100;
+const quint32 BLOCK_SIZE = 256;
+
+// processing the input in audio blocks, returning the left output channel
+std::vector<float> processBlocks(JamtabaDelay &delay, const std::vector<float> &input)
+{
+    std::vector<float> output;
+    std::vector<midi::MidiMessage> midiBuffer;
+    SamplesBuffer in(2, BLOCK_SIZE);
+    SamplesBuffer out(2, BLOCK_SIZE);
+
+    for (size_t offset = 0; offset + BLOCK_SIZE <= input.size(); offset += BLOCK_SIZE) {
+        for (quint32 s = 0; s < BLOCK_SIZE; ++s) {
+            in.set(0, s, input[offset + s]);
+            in.set(1, s, input[offset + s]);
+        }
+
+        out.zero();
+        delay.process(in, out, midiBuffer);
+
+        for (quint32 s = 0; s < BLOCK_SIZE; ++s)
+            output.push_back(out.get(0, s));
+    }
+
+    return output;
+}
+
+std::vector<float> createImpulse(quint32 blocks)
+{
+    std::vector<float> impulse(blocks * BLOCK_SIZE, 0.0f);
+    impulse[0] = 1.0f;
+    return impulse;
+}
+
+std::vector<float> createSine(quint32 blocks, double frequency, quint32 firstSample)
+{
+    std::vector<float> sine(blocks * BLOCK_SIZE);
+    for (size_t s = 0; s < sine.size(); ++s)
+        sine[s] = static_cast<float>(std::sin(2 * M_PI * frequency * (s + firstSample) / SAMPLE_RATE));
+
+    return sine;
+}
+
+QList<int> findPeaks(const std::vector<float> &samples)
+{
+    QList<int> peaks;
+    for (size_t s = 0; s < samples.size(); ++s) {
+        if (std::abs(samples[s]) > 0.000001f)
+            peaks.append(static_cast<int>(s));
+    }
+
+    return peaks;
+}
+
+} // namespace
+
+void TestJamtabaDelay::impulseAtDelayTime()
+{
+    JamtabaDelay delay(SAMPLE_RATE);
+    delay.setDelayTime(100);
+    delay.setFeedback(0);
+    delay.setLevel(1.0f);
+
+    const std::vector<float> output = processBlocks(delay, createImpulse(40));
+
+    const int delayInSamples = SAMPLE_RATE / 10;
+    QCOMPARE(findPeaks(output), QList<int>() << 0 << delayInSamples); // the dry impulse and just one echo
+    QCOMPARE(output[delayInSamples], 1.0f);
+}
+
+void TestJamtabaDelay::feedbackIsDecaying()
+{
+    JamtabaDelay delay(SAMPLE_RATE);
+    delay.setDelayTime(100);
+    delay.setFeedback(0.5f);
+    delay.setLevel(1.0f);
+
+    const std::vector<float> output = processBlocks(delay, createImpulse(100));
+
+    const int delayInSamples = SAMPLE_RATE / 10;
+    const QList<int> peaks = findPeaks(output);
+    QVERIFY(peaks.size() >= 5);
+
+    float expectedEcho = 1.0f;
+    for (int echo = 1; echo < peaks.size(); ++echo) {
+        QCOMPARE(peaks.at(echo), echo * delayInSamples);
+        QCOMPARE(output[peaks.at(echo)], expectedEcho);
+        expectedEcho *= 0.5f;
+    }
+}
+
+void TestJamtabaDelay::delayTimeChangeWithoutDiscontinuity()
+{
+    const double frequency = 50.0;
+    const quint32 blocks = 400;
+
+    JamtabaDelay delay(SAMPLE_RATE);
+    delay.setDelayTime(100);
+    delay.setFeedback(0);
+    delay.setLevel(1.0f);
+
+    std::vector<float> output = processBlocks(delay, createSine(blocks, frequency, 0));
+
+    // 100 and 250 ms are 5 and 12.5 sine cycles, changing the delay time without gliding the wet signal is inverted
+    delay.setDelayTime(250);
+    const std::vector<float> outputAfterChange = processBlocks(delay, createSine(blocks, frequency, blocks * BLOCK_SIZE));
+    output.insert(output.end(), outputAfterChange.begin(), outputAfterChange.end());
+
+    const size_t firstSample = SAMPLE_RATE / 10; // skipping the first echo
+    float maxStep = 0.0f;
+    for (size_t s = firstSample + 1; s < output.size(); ++s)
+        maxStep = qMax(maxStep, std::abs(output[s] - output[s - 1]));
+
+    QVERIFY(maxStep < 0.1f); // a click is a step near 2.0
+}
+
+void TestJamtabaDelay::tempoSync_data()
+{
+    QTest::addColumn<int>("bpm");
+    QTest::addColumn<int>("sync");
+    QTest::addColumn<int>("expectedDelay"); // in samples
+
+    QTest::newRow("120 BPM, quarter") << 120 << static_cast<int>(JamtabaDelay::Quarter) << SAMPLE_RATE / 2;
+    QTest::newRow("120 BPM, eighth") << 120 << static_cast<int>(JamtabaDelay::Eighth) << SAMPLE_RATE / 4;
+    QTest::newRow("90 BPM, dotted eighth") << 90 << static_cast<int>(JamtabaDelay::DottedEighth) << SAMPLE_RATE / 2;
+    QTest::newRow("100 BPM, sixteenth") << 100 << static_cast<int>(JamtabaDelay::Sixteenth) << SAMPLE_RATE * 3 / 20;
+}
+
+void TestJamtabaDelay::tempoSync()
+{
+    QFETCH(int, bpm);
+    QFETCH(int, sync);
+    QFETCH(int, expectedDelay);
+
+    JamtabaDelay delay(SAMPLE_RATE);
+    delay.setDelayTime(100); // ignored when synced
+    delay.setFeedback(0);
+    delay.setLevel(1.0f);
+    delay.setTempoSync(static_cast<JamtabaDelay::TempoSync>(sync));
+    delay.setTempo(bpm);
+
+    const std::vector<float> output = processBlocks(delay, createImpulse(expectedDelay / BLOCK_SIZE + 10));
+
+    QCOMPARE(findPeaks(output), QList<int>() << 0 << expectedDelay);
+}
+
+void TestJamtabaDelay::serializationRoundTrip()
+{
+    JamtabaDelay delay(SAMPLE_RATE);
+    delay.setDelayTime(750);
+    delay.setFeedback(0.6f);
+    delay.setLevel(0.8f);
+    delay.setTempoSync(JamtabaDelay::DottedEighth);
+
+    JamtabaDelay restoredDelay(SAMPLE_RATE);
+    restoredDelay.restoreFromSerializedData(delay.getSerializedData());
+
+    QCOMPARE(restoredDelay.getDelayTime(), 750.0f);
+    QCOMPARE(restoredDelay.getFeedback(), 0.6f);
+    QCOMPARE(restoredDelay.getLevel(), 0.8f);
+    QCOMPARE(restoredDelay.getTempoSync(), JamtabaDelay::DottedEighth);
+
+    // sessions saved before the delay was implemented and truncated data are keeping the defaults
+    JamtabaDelay defaultDelay(SAMPLE_RATE);
+    defaultDelay.restoreFromSerializedData(QByteArray());
+    defaultDelay.restoreFromSerializedData(delay.getSerializedData().left(6));
+    QCOMPARE(defaultDelay.getDelayTime(), 500.0f);
+    QCOMPARE(defaultDelay.getTempoSync(), JamtabaDelay::NoSync);
+}
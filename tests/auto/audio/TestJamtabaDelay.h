@@ -0,0 +1,19 @@
+#ifndef TESTJAMTABADELAY_H
+#define TESTJAMTABADELAY_H
+
+#include <QObject>
+
+class TestJamtabaDelay: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void impulseAtDelayTime();
+    void feedbackIsDecaying();
+    void delayTimeChangeWithoutDiscontinuity(); // the delay time is gliding, no clicks
+    void tempoSync();
+    void tempoSync_data();
+    void serializationRoundTrip();
+};
+
+#endif // TESTJAMTABADELAY_H
@@ -4,6 +4,7 @@
 #include "audio/core/SamplesBuffer.h"
 #include <QTest>
 #include <QtGlobal>
+#include <cmath>
 
 #include "looper/Looper.h"
 
@@ -687,6 +688,218 @@ void TestLooper::recording_data()
 
 }
 
+void TestLooper::layerPeaks()
+{
+    QFETCH(uint, samplesPerPeak);
+
+    const uint cycleLenght = 1000;
+
+    Looper looper;
+    looper.setLayers(1, true);
+
+    // recording in small chunks, the peaks are updated incrementally
+    looper.toggleRecording();
+    looper.startNewCycle(cycleLenght);
+    Q_ASSERT(looper.isRecording());
+
+    QStringList values;
+    for (uint s = 0; s < cycleLenght; ++s) {
+        float value = (s % 2 ? -1.0f : 1.0f) * ((s * 37) % 101) / 100.0f;
+        values << QString::number(value);
+        if (values.size() == 100) {
+            looper.addBuffer(createBuffer(values.join(',')));
+            values.clear();
+        }
+    }
+
+    looper.startNewCycle(cycleLenght); // stop recording
+
+    std::vector<float> peaks;
+    looper.getLayerPeaks(0, samplesPerPeak, peaks);
+
+    QCOMPARE(static_cast<uint>(peaks.size()), (cycleLenght + samplesPerPeak - 1) / samplesPerPeak);
+
+    for (uint p = 0; p < peaks.size(); ++p) {
+        float expected = 0;
+        for (uint s = p * samplesPerPeak; s < qMin(cycleLenght, (p + 1) * samplesPerPeak); ++s)
+            expected = qMax(expected, ((s * 37) % 101) / 100.0f);
+
+        QCOMPARE(peaks[p], expected); // the samples in the peaks edges are not read from the coarse levels
+    }
+}
+
+void TestLooper::layerPeaks_data()
+{
+    QTest::addColumn<uint>("samplesPerPeak");
+
+    QTest::newRow("1 sample per peak") << 1u;
+    QTest::newRow("10 samples per peak") << 10u;
+    QTest::newRow("64 samples per peak") << 64u;
+    QTest::newRow("100 samples per peak") << 100u;
+    QTest::newRow("300 samples per peak") << 300u;
+    QTest::newRow("1000 samples per peak") << 1000u;
+}
+
+void TestLooper::compactLockedLayer()
+{
+    const uint cycleLenght = 4096;
+
+    Looper looper;
+    looper.setLayers(1, true);
+    looper.setMode(Looper::AllLayers);
+    looper.setCompactLockedLayers(true);
+    looper.startNewCycle(cycleLenght);
+
+    SamplesBuffer layerSamples(2, cycleLenght);
+    for (uint s = 0; s < cycleLenght; ++s) {
+        const float value = s < 2048 ? std::sin(s * 0.05f) * 0.5f : 0.0f; // second half is silence
+        layerSamples.set(0, s, value);
+        layerSamples.set(1, s, -value);
+    }
+    looper.setLayerSamples(0, layerSamples);
+
+    const size_t floatMemory = looper.getMemoryUsage();
+
+    looper.play();
+    looper.setLayerLockedState(0, true);
+    looper.waitForCompaction();
+
+    SamplesBuffer out(2, cycleLenght);
+    looper.mixToBuffer(out); // the compacted storage is committed in the end of the audio callback
+    QVERIFY(looper.getMemoryUsage() < floatMemory);
+
+    out.zero();
+    looper.startNewCycle(cycleLenght);
+    looper.mixToBuffer(out);
+
+    const float panGain = 0.70710678f; // center pan
+    for (uint s = 0; s < cycleLenght; ++s) {
+        QVERIFY(qAbs(out.get(0, s) - layerSamples.get(0, s) * panGain) < 0.0001f);
+        QVERIFY(qAbs(out.get(1, s) - layerSamples.get(1, s) * panGain) < 0.0001f);
+    }
+
+    // unlocking, the float samples are restored
+    looper.setLayerLockedState(0, false);
+    looper.mixToBuffer(out);
+    QCOMPARE(looper.getLayersSamples().first().getFrameLenght(), cycleLenght);
+}
+
+void TestLooper::clearUnlockedCompactedLayer()
+{
+    const uint cycleLenght = 4096;
+
+    Looper looper;
+    looper.setLayers(1, true);
+    looper.setMode(Looper::AllLayers);
+    looper.setCompactLockedLayers(true);
+    looper.startNewCycle(cycleLenght);
+
+    SamplesBuffer layerSamples(2, cycleLenght);
+    for (uint s = 0; s < cycleLenght; ++s) {
+        layerSamples.set(0, s, 0.5f);
+        layerSamples.set(1, s, 0.5f);
+    }
+    looper.setLayerSamples(0, layerSamples);
+
+    looper.play();
+    looper.setLayerLockedState(0, true);
+    looper.waitForCompaction();
+
+    SamplesBuffer out(2, cycleLenght);
+    looper.mixToBuffer(out); // compacted storage committed
+
+    // unlocking and clearing before the audio thread commit the expanded storage
+    looper.setLayerLockedState(0, false);
+    looper.clearLayer(0);
+    QVERIFY(!looper.layerIsValid(0));
+
+    out.zero();
+    looper.startNewCycle(cycleLenght);
+    looper.mixToBuffer(out); // expanded storage committed and erased
+    looper.updateLayersStorage();
+
+    for (uint s = 0; s < cycleLenght; ++s) {
+        QCOMPARE(out.get(0, s), 0.0f);
+        QCOMPARE(out.get(1, s), 0.0f);
+    }
+}
+
+void TestLooper::compactedLayerPeaksAfterResize()
+{
+    const uint cycleLenght = 4096;
+
+    Looper looper;
+    looper.setLayers(1, true);
+    looper.setMode(Looper::AllLayers);
+    looper.setCompactLockedLayers(true);
+    looper.startNewCycle(cycleLenght);
+
+    SamplesBuffer layerSamples(2, cycleLenght);
+    for (uint s = 0; s < cycleLenght; ++s) {
+        layerSamples.set(0, s, 0.5f);
+        layerSamples.set(1, s, 0.5f);
+    }
+    looper.setLayerSamples(0, layerSamples);
+
+    looper.play();
+    looper.setLayerLockedState(0, true);
+    looper.waitForCompaction();
+
+    SamplesBuffer out(2, cycleLenght);
+    looper.mixToBuffer(out); // compacted storage committed
+
+    looper.startNewCycle(cycleLenght * 2); // the compacted samples are repeated in the longer cycle
+    looper.updateLayersStorage(); // peaks of the repeated samples are rebuilt in the main thread
+
+    std::vector<float> peaks;
+    looper.getLayerPeaks(0, cycleLenght, peaks);
+    QCOMPARE(peaks.size(), static_cast<size_t>(2));
+    QVERIFY(qAbs(peaks[0] - 0.5f) < 0.001f);
+    QVERIFY(qAbs(peaks[1] - 0.5f) < 0.001f);
+}
+
+void TestLooper::mixAllLayersBenchmark()
+{
+    QFETCH(uint, frames);
+
+    const quint8 layers = MAX_LOOP_LAYERS;
+    const uint cycleLenght = 44100 * 2;
+
+    Looper looper;
+    looper.setLayers(layers, true);
+    looper.setMode(Looper::AllLayers);
+    looper.startNewCycle(cycleLenght);
+
+    SamplesBuffer layerSamples(2, cycleLenght);
+    for (uint s = 0; s < cycleLenght; ++s) {
+        layerSamples.set(0, s, std::sin(s * 0.01f));
+        layerSamples.set(1, s, std::cos(s * 0.01f));
+    }
+
+    for (quint8 l = 0; l < layers; ++l) {
+        looper.setLayerSamples(l, layerSamples);
+        looper.setLayerGain(l, 1.0f / layers);
+        looper.setLayerPan(l, (l % 2) ? -0.5f : 0.5f);
+    }
+
+    looper.play();
+
+    SamplesBuffer out(2, frames);
+    QBENCHMARK {
+        out.zero();
+        looper.mixToBuffer(out); // one audio callback, the interval position is wrapping in the cycle end
+    }
+}
+
+void TestLooper::mixAllLayersBenchmark_data()
+{
+    QTest::addColumn<uint>("frames");
+
+    QTest::newRow("64 frames") << 64u;
+    QTest::newRow("128 frames") << 128u;
+    QTest::newRow("256 frames") << 256u;
+}
+
 void TestLooper::resizeLayersAndCopySamples()
 {
     QFETCH(QStringList, initialBuffer);
@@ -43,6 +43,16 @@ private slots:
     void playing();
     void playing_data();
 
+    void layerPeaks();
+    void layerPeaks_data();
+
+    void compactLockedLayer();
+    void clearUnlockedCompactedLayer();
+    void compactedLayerPeaksAfterResize();
+
+    void mixAllLayersBenchmark();
+    void mixAllLayersBenchmark_data();
+
     void hearLockedLayersOnlyAfterRecord(); // first problem in issue #823
     void monitoringWhenPlayLockedAndHearAllAreChecked(); // second problem in issue #823
 
@@ -0,0 +1,119 @@
+#include "TestLoudnessMeter.h"
+#include "audio/core/LoudnessMeter.h"
+#include "audio/core/SamplesBuffer.h"
+#include "audio/LoudnessAnalyzer.h"
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include <vector>
+
+using audio::LoudnessMeter;
+using audio::LoudnessAnalysis;
+using audio::SamplesBuffer;
+
+namespace {
+
+std::vector<float> createSine(int sampleRate, double frequency, float amplitude, double seconds)
+{
+    std::vector<float> samples(static_cast<size_t>(sampleRate * seconds));
+    for (size_t s = 0; s < samples.size(); ++s)
+        samples[s] = amplitude * std::sin(2.0 * M_PI * frequency * s / sampleRate);
+
+    return samples;
+}
+
+}
+
+void TestLoudnessMeter::sineLoudness_data()
+{
+    QTest::addColumn<int>("sampleRate");
+
+    QTest::newRow("44.1 KHz") << 44100;
+    QTest::newRow("48 KHz") << 48000;
+}
+
+void TestLoudnessMeter::sineLoudness()
+{
+    QFETCH(int, sampleRate);
+
+    // a 1 KHz stereo sine with -20 dBFS peaks has -20 LUFS (the K-weighting has ~0.7 dB gain in 1 KHz)
+    const std::vector<float> sine = createSine(sampleRate, 1000.0, 0.1f, 3.0);
+
+    LoudnessMeter meter(sampleRate);
+    meter.process(sine.data(), sine.data(), sine.size());
+
+    QVERIFY(std::abs(meter.getIntegratedLoudness() - (-20.0)) < 0.1);
+}
+
+void TestLoudnessMeter::silence()
+{
+    const std::vector<float> silence(44100 * 2, 0.0f);
+
+    LoudnessMeter meter;
+    meter.process(silence.data(), silence.data(), silence.size());
+
+    QCOMPARE(meter.getIntegratedLoudness(), LoudnessMeter::SILENCE);
+}
+
+void TestLoudnessMeter::monoIsMeasuredAsDualMono()
+{
+    const std::vector<float> sine = createSine(44100, 440.0, 0.25f, 2.0);
+
+    LoudnessMeter monoMeter;
+    monoMeter.process(sine.data(), nullptr, sine.size());
+
+    LoudnessMeter stereoMeter;
+    stereoMeter.process(sine.data(), sine.data(), sine.size());
+
+    QCOMPARE(monoMeter.getIntegratedLoudness(), stereoMeter.getIntegratedLoudness());
+}
+
+void TestLoudnessMeter::quietBlocksAreGated()
+{
+    const std::vector<float> loud = createSine(44100, 1000.0, 0.1f, 2.0);
+    const std::vector<float> quiet = createSine(44100, 1000.0, 0.001f, 2.0); // 40 dB below, removed by the relative gate
+
+    LoudnessMeter meter;
+    meter.process(loud.data(), loud.data(), loud.size());
+    meter.process(quiet.data(), quiet.data(), quiet.size());
+
+    QVERIFY(std::abs(meter.getIntegratedLoudness() - (-20.0)) < 0.5);
+}
+
+void TestLoudnessMeter::intervalAnalysis()
+{
+    const int sampleRate = 44100;
+    const std::vector<float> sine = createSine(sampleRate, 1000.0, 0.05f, 2.0); // -26 LUFS
+
+    LoudnessAnalysis analysis;
+    QCOMPARE(analysis.getLoudness(), LoudnessAnalysis::UNKNOWN_LOUDNESS);
+    QCOMPARE(analysis.getAutoGain(), 1.0f);
+
+    SamplesBuffer buffer(2, 1024);
+    for (size_t offset = 0; offset + 1024 <= sine.size(); offset += 1024) {
+        for (int c = 0; c < 2; ++c)
+            std::copy(sine.begin() + offset, sine.begin() + offset + 1024, buffer.getSamplesArray(c));
+
+        analysis.write(buffer, sampleRate);
+        analysis.analyze(); // the rings have only 1.5 seconds
+    }
+
+    analysis.startNewInterval();
+    analysis.analyze();
+
+    QVERIFY(std::abs(analysis.getLoudness() - (-26.0f)) < 0.2f);
+    QVERIFY(std::abs(analysis.getAutoGainInDb() - 6.0f) < 0.2f); // target is -20 LUFS
+
+    analysis.setAutoGainEnabled(false);
+    QCOMPARE(analysis.getAutoGain(), 1.0f);
+}
+
+void TestLoudnessMeter::autoGainIsLimited()
+{
+    LoudnessAnalysis analysis;
+    analysis.setInitialLoudness(-60.0f);
+    QCOMPARE(analysis.getAutoGainInDb(), LoudnessAnalysis::MAX_AUTO_GAIN);
+
+    analysis.setInitialLoudness(-10.0f); // ignored, the loudness is already known
+    QCOMPARE(analysis.getLoudness(), -60.0f);
+}
@@ -0,0 +1,20 @@
+#ifndef TESTLOUDNESSMETER_H
+#define TESTLOUDNESSMETER_H
+
+#include <QObject>
+
+class TestLoudnessMeter: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sineLoudness_data();
+    void sineLoudness();
+    void silence();
+    void monoIsMeasuredAsDualMono();
+    void quietBlocksAreGated();
+    void intervalAnalysis();
+    void autoGainIsLimited();
+};
+
+#endif // TESTLOUDNESSMETER_H
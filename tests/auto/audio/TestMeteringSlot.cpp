@@ -0,0 +1,113 @@
+#include "TestMeteringSlot.h"
+
+#include <QTest>
+#include <QThread>
+#include <QAtomicInt>
+
+#include "audio/core/MeteringSlot.h"
+
+using namespace audio;
+
+namespace {
+
+// publish the same value in all fields, a torn read will have different values
+class PeaksWriter : public QThread
+{
+public:
+    explicit PeaksWriter(MeteringSlot &slot) :
+        slot(slot),
+        running(1)
+    {
+
+    }
+
+    void stop()
+    {
+        running.store(0);
+        wait();
+    }
+
+protected:
+    void run() override
+    {
+        quint32 block = 0;
+        while (running.load()) {
+            const float value = static_cast<float>(++block % 1000) / 1000.0f;
+            slot.publish(AudioPeak(value, value, value, value));
+        }
+    }
+
+private:
+    MeteringSlot &slot;
+    QAtomicInt running;
+};
+
+} // namespace
+
+void TestMeteringSlot::publishAndRead()
+{
+    MeteringSlot slot;
+
+    QCOMPARE(slot.getLastPeak().getMaxPeak(), 0.0f);
+
+    slot.publish(AudioPeak(0.5f, 0.25f, 0.2f, 0.1f));
+
+    auto peak = slot.getLastPeak();
+    QCOMPARE(peak.getLeftPeak(), 0.5f);
+    QCOMPARE(peak.getRightPeak(), 0.25f);
+    QCOMPARE(peak.getLeftRMS(), 0.2f);
+    QCOMPARE(peak.getRightRMS(), 0.1f);
+}
+
+void TestMeteringSlot::resetIgnoresOldValues()
+{
+    MeteringSlot slot;
+
+    slot.publish(AudioPeak(0.5f, 0.5f, 0.3f, 0.3f));
+    slot.reset();
+
+    QCOMPARE(slot.getLastPeak().getMaxPeak(), 0.0f);
+
+    slot.publish(AudioPeak(0.1f, 0.2f, 0.05f, 0.05f)); // new values after the reset
+    QCOMPARE(slot.getLastPeak().getRightPeak(), 0.2f);
+}
+
+void TestMeteringSlot::countClips()
+{
+    MeteringSlot slot;
+
+    slot.publish(AudioPeak(0.5f, 0.5f, 0.3f, 0.3f));
+    slot.publish(AudioPeak(1.0f, 0.5f, 0.3f, 0.3f));
+    slot.publish(AudioPeak(0.5f, 1.5f, 0.3f, 0.3f));
+
+    QCOMPARE(slot.getSnapshot().clips, 2u);
+}
+
+void TestMeteringSlot::concurrentReadsAreNotTorn()
+{
+    MeteringSlot slot;
+    PeaksWriter writer(slot);
+    writer.start();
+
+    quint32 lastSequence = 0;
+    quint32 newBlocks = 0;
+    quint32 tornReads = 0;
+    for (int i = 0; i < 200000; ++i) {
+        auto snapshot = slot.getSnapshot();
+        const float value = snapshot.peak.getLeftPeak();
+        if (snapshot.peak.getRightPeak() != value || snapshot.peak.getLeftRMS() != value
+                || snapshot.peak.getRightRMS() != value || (snapshot.sequence & 1)) {
+            tornReads++;
+        }
+
+        if (snapshot.sequence != lastSequence) {
+            newBlocks++;
+            lastSequence = snapshot.sequence;
+        }
+    }
+
+    writer.stop(); // stopping before the checks, the writer can't outlive the slot
+
+    QCOMPARE(tornReads, 0u);
+    QVERIFY(newBlocks > 0);
+}
@@ -0,0 +1,17 @@
+#ifndef TESTMETERINGSLOT_H
+#define TESTMETERINGSLOT_H
+
+#include <QObject>
+
+class TestMeteringSlot: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void publishAndRead();
+    void resetIgnoresOldValues();
+    void countClips();
+    void concurrentReadsAreNotTorn();
+};
+
+#endif // TESTMETERINGSLOT_H
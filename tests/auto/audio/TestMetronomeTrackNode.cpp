@@ -0,0 +1,172 @@
+#include "TestMetronomeTrackNode.h"
+#include "audio/MetronomeTrackNode.h"
+#include "audio/core/SamplesBuffer.h"
+#include "MetronomeUtils.h"
+
+#include <QtTest/QtTest>
+
+using audio::MetronomeTrackNode;
+using audio::SamplesBuffer;
+
+// the click sounds are created in these tests, so the metronome files utilities (and the sound cache) are not linked
+QList<int> audio::metronomeUtils::getAccentBeats(int beatsPerAccent, int bpi)
+{
+    Q_UNUSED(beatsPerAccent)
+    Q_UNUSED(bpi)
+    return QList<int>();
+}
+
+namespace {
+
+const int SAMPLE_RATE = 44100;
+const quint32 BLOCK_SIZE = 128;
+
+const float FIRST_BEAT = 1.0f;
+const float OFF_BEAT = 0.5f;
+const float ACCENT_BEAT = 0.25f;
+
+SamplesBuffer createClick(quint32 frames, float value)
+{
+    SamplesBuffer click(1, frames);
+    for (quint32 s = 0; s < frames; ++s)
+        click.set(0, s, value);
+
+    return click;
+}
+
+// processing the interval samples from 'from' to 'to' in audio blocks, returning the left output channel
+std::vector<float> processInterval(MetronomeTrackNode &node, long from, long to)
+{
+    std::vector<float> output;
+    std::vector<midi::MidiMessage> midiBuffer;
+    SamplesBuffer in(2);
+
+    for (long position = from; position < to; position += BLOCK_SIZE) {
+        const quint32 frames = static_cast<quint32>(qMin(static_cast<long>(BLOCK_SIZE), to - position));
+        SamplesBuffer out(2, frames);
+        out.zero();
+
+        node.setIntervalPosition(position);
+        node.processReplacing(in, out, SAMPLE_RATE, midiBuffer);
+
+        for (quint32 s = 0; s < frames; ++s)
+            output.push_back(out.get(0, s));
+    }
+
+    return output;
+}
+
+QMap<long, float> findClicks(const std::vector<float> &samples)
+{
+    QMap<long, float> clicks;
+    for (size_t s = 0; s < samples.size(); ++s) {
+        if (samples[s] != 0.0f)
+            clicks.insert(static_cast<long>(s), samples[s]);
+    }
+
+    return clicks;
+}
+
+} // namespace
+
+void TestMetronomeTrackNode::clickOffsets_data()
+{
+    QTest::addColumn<int>("intervalLength");
+    QTest::addColumn<int>("bpi");
+
+    QTest::newRow("1000 samples, 3 beats") << 1000 << 3;
+    QTest::newRow("120 BPM, 16 beats") << SAMPLE_RATE * 8 << 16;
+    QTest::newRow("97 BPM, 7 beats") << static_cast<int>(SAMPLE_RATE * 60.0 / 97 * 7) << 7;
+    QTest::newRow("max beats") << SAMPLE_RATE * 10 << MetronomeTrackNode::MAX_BEATS;
+}
+
+void TestMetronomeTrackNode::clickOffsets()
+{
+    QFETCH(int, intervalLength);
+    QFETCH(int, bpi);
+
+    MetronomeTrackNode node(createClick(1, FIRST_BEAT), createClick(1, OFF_BEAT), createClick(1, ACCENT_BEAT));
+    node.setIntervalLength(intervalLength, bpi);
+
+    const QMap<long, float> clicks = findClicks(processInterval(node, 0, intervalLength));
+
+    QCOMPARE(clicks.size(), bpi);
+    for (int beat = 0; beat < bpi; ++beat) {
+        const long offset = static_cast<long>(static_cast<qint64>(intervalLength) * beat / bpi);
+        QVERIFY(clicks.contains(offset));
+        QCOMPARE(clicks[offset], beat == 0 ? FIRST_BEAT : OFF_BEAT);
+    }
+}
+
+void TestMetronomeTrackNode::tempoAndAccentsChangedInNextInterval()
+{
+    MetronomeTrackNode node(createClick(1, FIRST_BEAT), createClick(1, OFF_BEAT), createClick(1, ACCENT_BEAT));
+    node.setIntervalLength(1000, 4);
+
+    std::vector<float> firstInterval = processInterval(node, 0, 384);
+
+    // changed in the middle of the interval
+    node.setIntervalLength(1200, 3);
+    node.setAccentBeats(QList<int>() << 2);
+
+    const std::vector<float> firstIntervalEnd = processInterval(node, 384, 1000);
+    firstInterval.insert(firstInterval.end(), firstIntervalEnd.begin(), firstIntervalEnd.end());
+
+    QMap<long, float> expectedClicks;
+    expectedClicks.insert(0, FIRST_BEAT);
+    expectedClicks.insert(250, OFF_BEAT);
+    expectedClicks.insert(500, OFF_BEAT);
+    expectedClicks.insert(750, OFF_BEAT);
+    QCOMPARE(findClicks(firstInterval), expectedClicks);
+
+    expectedClicks.clear();
+    expectedClicks.insert(0, FIRST_BEAT);
+    expectedClicks.insert(400, OFF_BEAT);
+    expectedClicks.insert(800, ACCENT_BEAT);
+    QCOMPARE(findClicks(processInterval(node, 0, 1200)), expectedClicks);
+}
+
+void TestMetronomeTrackNode::clickTailInNextInterval()
+{
+    // long off beat click (a ramp), the last click of the interval is starting in 750 and ending in 1150
+    SamplesBuffer offBeat(1, 400);
+    for (quint32 s = 0; s < 400; ++s)
+        offBeat.set(0, s, (s + 1) / 1000.0f);
+
+    MetronomeTrackNode node(createClick(100, FIRST_BEAT), offBeat, createClick(1, ACCENT_BEAT));
+    node.setIntervalLength(1000, 4);
+
+    const std::vector<float> firstInterval = processInterval(node, 0, 1000);
+    QCOMPARE(firstInterval[999], 250 / 1000.0f);
+
+    const std::vector<float> secondInterval = processInterval(node, 0, 1000);
+    for (int s = 0; s < 150; ++s) {
+        const float tail = (251 + s) / 1000.0f;
+        const float expected = s < 100 ? FIRST_BEAT + tail : tail;
+        QCOMPARE(secondInterval[s], expected);
+    }
+
+    for (int s = 150; s < 250; ++s)
+        QCOMPARE(secondInterval[s], 0.0f); // the tail is played just once
+}
+
+void TestMetronomeTrackNode::clickSoundsReplacedInNextBlock()
+{
+    MetronomeTrackNode node(createClick(1, FIRST_BEAT), createClick(1, OFF_BEAT), createClick(1, ACCENT_BEAT));
+    node.setIntervalLength(1000, 4);
+
+    QCOMPARE(findClicks(processInterval(node, 0, 384)).value(250), OFF_BEAT);
+
+    // replaced in the middle of the interval, the schedule is not changed
+    node.setClickSounds(createClick(1, 0.8f), createClick(1, 0.4f), createClick(1, 0.2f));
+    QMap<long, float> clicks = findClicks(processInterval(node, 384, 1000));
+    QCOMPARE(clicks.size(), 2);
+    QCOMPARE(clicks.value(500 - 384), 0.4f);
+    QCOMPARE(clicks.value(750 - 384), 0.4f);
+
+    // replaced again, the last replaced sounds are deleted in the GUI thread
+    node.setClickSounds(createClick(1, 0.6f), createClick(1, 0.3f), createClick(1, 0.1f));
+    clicks = findClicks(processInterval(node, 0, 1000));
+    QCOMPARE(clicks.value(0), 0.6f);
+    QCOMPARE(clicks.value(250), 0.3f);
+}
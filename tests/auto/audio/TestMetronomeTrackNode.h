@@ -0,0 +1,18 @@
+#ifndef TESTMETRONOMETRACKNODE_H
+#define TESTMETRONOMETRACKNODE_H
+
+#include <QObject>
+
+class TestMetronomeTrackNode: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void clickOffsets(); // sample accurate, length * beat / bpi
+    void clickOffsets_data();
+    void tempoAndAccentsChangedInNextInterval();
+    void clickTailInNextInterval(); // the last click of the interval is not cut in the interval boundary
+    void clickSoundsReplacedInNextBlock();
+};
+
+#endif // TESTMETRONOMETRACKNODE_H
@@ -0,0 +1,213 @@
+#include "TestMultiChannelFilter.h"
+#include "audio/core/Filters.h"
+#include "audio/core/SamplesBuffer.h"
+
+#include <QtTest/QtTest>
+#include <cmath>
+#include <vector>
+
+using audio::Filter;
+using audio::MultiChannelFilter;
+using audio::SamplesBuffer;
+
+namespace {
+
+const double SAMPLE_RATE = 44100;
+const quint32 BLOCK_SIZE = 256;
+const int EQ_STAGES = 4; // 0 dB peaking bands, the repeatedly processed buffer is not growing
+
+// noise with a different seed in each channel, the block size is not multiple of 4 to cover the remaining samples
+SamplesBuffer createNoise(int channels, quint32 frames)
+{
+    SamplesBuffer buffer(channels, frames);
+    quint32 seed = 1;
+    for (int c = 0; c < channels; ++c) {
+        for (quint32 s = 0; s < frames; ++s) {
+            seed = seed * 1664525u + 1013904223u;
+            buffer.set(c, s, (seed >> 8) / static_cast<float>(1 << 24) * 2.0f - 1.0f);
+        }
+    }
+
+    return buffer;
+}
+
+double channelFrequency(int channel)
+{
+    return 100.0 + channel * 250.0;
+}
+
+std::vector<float *> getPointers(const SamplesBuffer &buffer)
+{
+    std::vector<float *> pointers;
+    for (int c = 0; c < buffer.getChannels(); ++c)
+        pointers.push_back(buffer.getSamplesArray(c));
+
+    return pointers;
+}
+
+void compare(const SamplesBuffer &buffer, const SamplesBuffer &expected)
+{
+    for (int c = 0; c < expected.getChannels(); ++c) {
+        for (quint32 s = 0; s < expected.getFrameLenght(); ++s) {
+            if (std::fabs(buffer.get(c, s) - expected.get(c, s)) > 1e-4f)
+                QFAIL(qPrintable(QString("channel %1 sample %2: %3 != %4").arg(c).arg(s).arg(buffer.get(c, s)).arg(expected.get(c, s))));
+        }
+    }
+}
+
+} // namespace
+
+void TestMultiChannelFilter::matchesPerChannelFilter_data()
+{
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<quint32>("frames");
+
+    QTest::newRow("stereo") << 2 << 301u;
+    QTest::newRow("4 channels") << 4 << 256u;
+    QTest::newRow("8 channels") << 8 << 63u;
+    QTest::newRow("5 channels") << 5 << 128u;
+}
+
+void TestMultiChannelFilter::matchesPerChannelFilter()
+{
+    QFETCH(int, channels);
+    QFETCH(quint32, frames);
+
+    SamplesBuffer expected = createNoise(channels, frames);
+    SamplesBuffer buffer = createNoise(channels, frames);
+
+    MultiChannelFilter multiChannelFilter(channels);
+    for (int c = 0; c < channels; ++c) {
+        multiChannelFilter.setStage(0, c, Filter::computeCoefficients(Filter::HighPass, SAMPLE_RATE, channelFrequency(c), 1.0, 1.0));
+
+        Filter filter(Filter::HighPass, SAMPLE_RATE, channelFrequency(c), 1.0, 1.0);
+        filter.process(expected.getSamplesArray(c), frames);
+    }
+
+    multiChannelFilter.process(buffer);
+
+    compare(buffer, expected);
+}
+
+void TestMultiChannelFilter::cascadeMatchesFiltersInSeries()
+{
+    SamplesBuffer expected = createNoise(2, BLOCK_SIZE);
+    SamplesBuffer buffer = createNoise(2, BLOCK_SIZE);
+
+    MultiChannelFilter multiChannelFilter(2, 2);
+    multiChannelFilter.setStage(0, Filter::computeCoefficients(Filter::LowShelf, SAMPLE_RATE, 120.0, 1.0, 6.0));
+    multiChannelFilter.setStage(1, Filter::computeCoefficients(Filter::Peaking, SAMPLE_RATE, 1000.0, 0.7, -4.0));
+
+    for (int c = 0; c < 2; ++c) {
+        Filter lowShelf(Filter::LowShelf, SAMPLE_RATE, 120.0, 1.0, 6.0);
+        Filter peaking(Filter::Peaking, SAMPLE_RATE, 1000.0, 0.7, -4.0);
+        lowShelf.process(expected.getSamplesArray(c), BLOCK_SIZE);
+        peaking.process(expected.getSamplesArray(c), BLOCK_SIZE);
+    }
+
+    // two blocks, the states are preserved between them
+    std::vector<float *> pointers = getPointers(buffer);
+    multiChannelFilter.process(pointers.data(), 100);
+    for (float *&pointer : pointers)
+        pointer += 100;
+    multiChannelFilter.process(pointers.data(), BLOCK_SIZE - 100);
+
+    compare(buffer, expected);
+}
+
+void TestMultiChannelFilter::bypassedStagesAreIdentity()
+{
+    const SamplesBuffer expected = createNoise(2, BLOCK_SIZE);
+    SamplesBuffer buffer = createNoise(2, BLOCK_SIZE);
+
+    MultiChannelFilter multiChannelFilter(2, 3);
+    multiChannelFilter.setStage(1, Filter::computeCoefficients(Filter::HighPass, SAMPLE_RATE, 200.0, 1.0, 1.0));
+    multiChannelFilter.bypassStage(1);
+
+    multiChannelFilter.process(buffer);
+
+    compare(buffer, expected);
+}
+
+void TestMultiChannelFilter::monoBufferProcessesOnlyFirstChannel()
+{
+    SamplesBuffer expected = createNoise(1, BLOCK_SIZE);
+    SamplesBuffer buffer = createNoise(1, BLOCK_SIZE);
+
+    MultiChannelFilter multiChannelFilter(2);
+    multiChannelFilter.setStage(0, Filter::computeCoefficients(Filter::HighPass, SAMPLE_RATE, 120.0, 1.0, 1.0));
+    multiChannelFilter.process(buffer);
+
+    Filter filter(Filter::HighPass, SAMPLE_RATE, 120.0, 1.0, 1.0);
+    filter.process(expected.getSamplesArray(0), BLOCK_SIZE);
+
+    compare(buffer, expected);
+}
+
+void TestMultiChannelFilter::silenceHasNoDenormals()
+{
+    MultiChannelFilter multiChannelFilter(2, 2);
+    multiChannelFilter.setStage(0, Filter::computeCoefficients(Filter::LowPass, SAMPLE_RATE, 500.0, 1.0, 1.0));
+    multiChannelFilter.setStage(1, Filter::computeCoefficients(Filter::HighPass, SAMPLE_RATE, 80.0, 1.0, 1.0));
+
+    SamplesBuffer buffer = createNoise(2, BLOCK_SIZE);
+    multiChannelFilter.process(buffer);
+
+    for (int block = 0; block < 2000; ++block) { // ~10 seconds of silence, the filter tails are decaying
+        buffer.zero();
+        multiChannelFilter.process(buffer);
+    }
+
+    for (int c = 0; c < 2; ++c) {
+        for (quint32 s = 0; s < BLOCK_SIZE; ++s) {
+            QVERIFY(std::fpclassify(buffer.get(c, s)) != FP_SUBNORMAL);
+            QVERIFY(std::fabs(buffer.get(c, s)) < 1e-6f);
+        }
+    }
+}
+
+void TestMultiChannelFilter::perChannelFilterBenchmark_data()
+{
+    QTest::addColumn<int>("channels");
+
+    QTest::newRow("stereo") << 2;
+    QTest::newRow("8 channels") << 8;
+}
+
+void TestMultiChannelFilter::perChannelFilterBenchmark()
+{
+    QFETCH(int, channels);
+
+    SamplesBuffer buffer = createNoise(channels, BLOCK_SIZE);
+
+    std::vector<Filter> filters; // one filter per channel and EQ band
+    for (int i = 0; i < channels * EQ_STAGES; ++i)
+        filters.push_back(Filter(Filter::Peaking, SAMPLE_RATE, 1000.0, 0.7, 0.0));
+
+    QBENCHMARK {
+        for (int c = 0; c < channels; ++c) {
+            for (int stage = 0; stage < EQ_STAGES; ++stage)
+                filters[c * EQ_STAGES + stage].process(buffer.getSamplesArray(c), BLOCK_SIZE);
+        }
+    }
+}
+
+void TestMultiChannelFilter::multiChannelFilterBenchmark_data()
+{
+    perChannelFilterBenchmark_data();
+}
+
+void TestMultiChannelFilter::multiChannelFilterBenchmark()
+{
+    QFETCH(int, channels);
+
+    SamplesBuffer buffer = createNoise(channels, BLOCK_SIZE);
+
+    MultiChannelFilter multiChannelFilter(channels, EQ_STAGES);
+    for (int stage = 0; stage < EQ_STAGES; ++stage)
+        multiChannelFilter.setStage(stage, Filter::computeCoefficients(Filter::Peaking, SAMPLE_RATE, 1000.0, 0.7, 0.0));
+
+    QBENCHMARK {
+        multiChannelFilter.process(buffer);
+    }
+}
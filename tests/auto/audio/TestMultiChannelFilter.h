@@ -0,0 +1,24 @@
+#ifndef TESTMULTICHANNELFILTER_H
+#define TESTMULTICHANNELFILTER_H
+
+#include <QObject>
+
+class TestMultiChannelFilter: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesPerChannelFilter_data();
+    void matchesPerChannelFilter();
+    void cascadeMatchesFiltersInSeries();
+    void bypassedStagesAreIdentity();
+    void monoBufferProcessesOnlyFirstChannel();
+    void silenceHasNoDenormals();
+
+    void perChannelFilterBenchmark_data();
+    void perChannelFilterBenchmark();
+    void multiChannelFilterBenchmark_data();
+    void multiChannelFilterBenchmark();
+};
+
+#endif // TESTMULTICHANNELFILTER_H
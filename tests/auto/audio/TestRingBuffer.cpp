@@ -0,0 +1,159 @@
+#include "TestRingBuffer.h"
+#include "audio/core/RingBuffer.h"
+
+#include <QtTest/QtTest>
+#include <QThread>
+#include <vector>
+
+using audio::RingBuffer;
+
+void TestRingBuffer::capacityIsPowerOfTwo()
+{
+    QCOMPARE(RingBuffer<float>(1000).getCapacity(), 1024u);
+    QCOMPARE(RingBuffer<float>(1024).getCapacity(), 1024u);
+    QCOMPARE(RingBuffer<char>(1).getCapacity(), 1u);
+
+    RingBuffer<float> ring(16);
+    QCOMPARE(ring.getAvailable(), 0u);
+    QCOMPARE(ring.getFree(), 16u);
+}
+
+void TestRingBuffer::writeAndRead()
+{
+    RingBuffer<int> ring(8);
+
+    const int items[] = {1, 2, 3, 4, 5};
+    QCOMPARE(ring.write(items, 5), 5u);
+    QCOMPARE(ring.getAvailable(), 5u);
+    QCOMPARE(ring.getFree(), 3u);
+
+    int out[5] = {0};
+    QCOMPARE(ring.read(out, 3), 3u);
+    QCOMPARE(out[0], 1);
+    QCOMPARE(out[2], 3);
+    QCOMPARE(ring.getAvailable(), 2u);
+
+    QCOMPARE(ring.read(out, 2), 2u);
+    QCOMPARE(out[0], 4);
+    QCOMPARE(out[1], 5);
+    QCOMPARE(ring.getAvailable(), 0u);
+}
+
+void TestRingBuffer::writeInFullRing()
+{
+    RingBuffer<int> ring(4);
+
+    const int items[] = {1, 2, 3, 4, 5, 6};
+    QCOMPARE(ring.write(items, 6), 4u); // only the free items are written
+    QCOMPARE(ring.getFree(), 0u);
+    QCOMPARE(ring.write(items, 1), 0u);
+
+    int out[4] = {0};
+    QCOMPARE(ring.read(out, 4), 4u);
+    QCOMPARE(out[3], 4); // the items not fitting in the ring are discarded, not overwriting the oldest
+}
+
+void TestRingBuffer::readInEmptyRing()
+{
+    RingBuffer<int> ring(4);
+
+    int out[4] = {-1, -1, -1, -1};
+    QCOMPARE(ring.read(out, 4), 0u);
+    QCOMPARE(out[0], -1);
+
+    const int item = 7;
+    ring.write(&item, 1);
+    QCOMPARE(ring.read(out, 4), 1u); // only the available items are read
+    QCOMPARE(out[0], 7);
+    QCOMPARE(out[1], -1);
+}
+
+void TestRingBuffer::wrapping()
+{
+    RingBuffer<int> ring(8);
+
+    // moving the positions close to the ring end, the next writes and reads are split in two copies
+    std::vector<int> items(6);
+    std::vector<int> out(8);
+    ring.write(items.data(), 6);
+    ring.read(out.data(), 6);
+
+    for (int i = 0; i < 6; ++i)
+        items[i] = i + 100;
+
+    QCOMPARE(ring.write(items.data(), 6), 6u);
+    QCOMPARE(ring.getAvailable(), 6u);
+    QCOMPARE(ring.read(out.data(), 6), 6u);
+
+    for (int i = 0; i < 6; ++i)
+        QCOMPARE(out[i], i + 100);
+}
+
+void TestRingBuffer::clear()
+{
+    RingBuffer<int> ring(8);
+
+    const int items[] = {1, 2, 3};
+    ring.write(items, 3);
+    ring.clear();
+
+    QCOMPARE(ring.getAvailable(), 0u);
+    QCOMPARE(ring.getFree(), 8u);
+}
+
+void TestRingBuffer::producerAndConsumerThreads()
+{
+    static const quint32 TOTAL_ITEMS = 1000000;
+    static const quint32 CHUNK_SIZE = 37; // not aligned with the ring capacity, all the wrapping cases are used
+
+    RingBuffer<quint32> ring(256);
+
+    class Producer : public QThread
+    {
+    public:
+        explicit Producer(RingBuffer<quint32> &ring) : ring(ring) {}
+
+    protected:
+        void run() override
+        {
+            quint32 chunk[CHUNK_SIZE];
+            quint32 next = 0;
+            while (next < TOTAL_ITEMS) {
+                const quint32 count = std::min(CHUNK_SIZE, TOTAL_ITEMS - next);
+                for (quint32 i = 0; i < count; ++i)
+                    chunk[i] = next + i;
+
+                next += ring.write(chunk, count); // the items not written are produced again
+                if (ring.getFree() == 0)
+                    QThread::yieldCurrentThread();
+            }
+        }
+
+    private:
+        RingBuffer<quint32> &ring;
+    };
+
+    Producer producer(ring);
+    producer.start();
+
+    quint32 expected = 0;
+    bool inOrder = true;
+    quint32 chunk[CHUNK_SIZE];
+    QElapsedTimer timer;
+    timer.start();
+    while (expected < TOTAL_ITEMS && timer.elapsed() < 30000) {
+        const quint32 count = ring.read(chunk, CHUNK_SIZE);
+        for (quint32 i = 0; i < count; ++i)
+            inOrder = inOrder && chunk[i] == expected + i;
+
+        expected += count;
+        if (!count)
+            QThread::yieldCurrentThread();
+    }
+
+    QVERIFY(producer.wait(30000));
+
+    QVERIFY(inOrder);
+    QCOMPARE(expected, TOTAL_ITEMS);
+    QCOMPARE(ring.getAvailable(), 0u);
+}
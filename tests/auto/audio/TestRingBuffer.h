@@ -0,0 +1,20 @@
+#ifndef TESTRINGBUFFER_H
+#define TESTRINGBUFFER_H
+
+#include <QObject>
+
+class TestRingBuffer: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void capacityIsPowerOfTwo();
+    void writeAndRead();
+    void writeInFullRing();
+    void readInEmptyRing();
+    void wrapping();
+    void clear();
+    void producerAndConsumerThreads();
+};
+
+#endif // TESTRINGBUFFER_H
@@ -1,5 +1,6 @@
 QT += testlib
-QT -= gui
+QT += widgets # the built-in plugins editors
+QT += concurrent # the looper locked layers are compressed in worker threads
 CONFIG += testcase
 CONFIG += c++11
 TEMPLATE = app
@@ -11,16 +12,64 @@ VPATH += ../../../src/Common
 
 HEADERS += TestSamplesBuffer.h
 HEADERS += TestLooper.h
+HEADERS += TestMeteringSlot.h
+HEADERS += TestAudioBus.h
+HEADERS += TestDelayLine.h
+HEADERS += TestMultiChannelFilter.h
+HEADERS += TestLoudnessMeter.h
+HEADERS += TestRingBuffer.h
+HEADERS += TestJamtabaDelay.h
+HEADERS += TestMetronomeTrackNode.h
 HEADERS += audio/core/SamplesBuffer.h
 HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/core/MeteringSlot.h
+HEADERS += audio/core/AudioBus.h
+HEADERS += audio/core/DelayLine.h
+HEADERS += audio/core/Filters.h
+HEADERS += audio/core/LoudnessMeter.h
+HEADERS += audio/core/RingBuffer.h
+HEADERS += audio/LoudnessAnalyzer.h
+HEADERS += log/Logging.h
+HEADERS += audio/core/PeaksPyramid.h
 HEADERS += looper/Looper.h
+HEADERS += audio/core/AudioNodeProcessor.h
+HEADERS += audio/core/Plugins.h
+HEADERS += audio/core/PluginDescriptor.h
+HEADERS += audio/BuiltInPlugins.h
+HEADERS += gui/plugins/Guis.h
+HEADERS += audio/core/AudioNode.h
+HEADERS += audio/MetronomeTrackNode.h
 
 SOURCES += TestSamplesBuffer.cpp
 SOURCES += TestLooper.cpp
+SOURCES += TestMeteringSlot.cpp
+SOURCES += TestAudioBus.cpp
+SOURCES += TestDelayLine.cpp
+SOURCES += TestMultiChannelFilter.cpp
+SOURCES += TestLoudnessMeter.cpp
+SOURCES += TestRingBuffer.cpp
+SOURCES += TestJamtabaDelay.cpp
+SOURCES += TestMetronomeTrackNode.cpp
 SOURCES += audio/core/SamplesBuffer.cpp
 SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/core/MeteringSlot.cpp
+SOURCES += audio/core/AudioBus.cpp
+SOURCES += audio/core/DelayLine.cpp
+SOURCES += audio/core/Filters.cpp
+SOURCES += audio/core/LoudnessMeter.cpp
+SOURCES += audio/LoudnessAnalyzer.cpp
+SOURCES += log/logging.cpp
+SOURCES += audio/core/PeaksPyramid.cpp
 SOURCES += looper/Looper.cpp
 SOURCES += looper/LooperStates.cpp
 SOURCES += looper/LooperLayer.cpp
+SOURCES += looper/CompactLayerStorage.cpp
+SOURCES += audio/core/AudioNodeProcessor.cpp
+SOURCES += audio/core/Plugins.cpp
+SOURCES += audio/core/PluginDescriptor.cpp
+SOURCES += audio/BuiltInPlugins.cpp
+SOURCES += gui/plugins/Guis.cpp
+SOURCES += audio/core/AudioNode.cpp
+SOURCES += audio/MetronomeTrackNode.cpp
 
 SOURCES += test_Audio.cpp
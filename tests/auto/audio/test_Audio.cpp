@@ -3,15 +3,47 @@
 #include <QtTest>
 #include "TestSamplesBuffer.h"
 #include "TestLooper.h"
+#include "TestMeteringSlot.h"
+#include "TestAudioBus.h"
+#include "TestDelayLine.h"
+#include "TestMultiChannelFilter.h"
+#include "TestLoudnessMeter.h"
+#include "TestRingBuffer.h"
+#include "TestJamtabaDelay.h"
+#include "TestMetronomeTrackNode.h"
 
 int main(int argc, char *argv[])
 {
     TestSamplesBuffer testSamplesBuffer;
     TestLooper testLooper;
+    TestMeteringSlot testMeteringSlot;
+    TestAudioBus testAudioBus;
+    TestDelayLine testDelayLine;
+    TestMultiChannelFilter testMultiChannelFilter;
+    TestLoudnessMeter testLoudnessMeter;
+    TestRingBuffer testRingBuffer;
+    TestJamtabaDelay testJamtabaDelay;
+    TestMetronomeTrackNode testMetronomeTrackNode;
 
     int result = QTest::qExec(&testSamplesBuffer, argc, argv);
 
     result |= QTest::qExec(&testLooper, argc, argv);
 
+    result |= QTest::qExec(&testMeteringSlot, argc, argv);
+
+    result |= QTest::qExec(&testAudioBus, argc, argv);
+
+    result |= QTest::qExec(&testDelayLine, argc, argv);
+
+    result |= QTest::qExec(&testMultiChannelFilter, argc, argv);
+
+    result |= QTest::qExec(&testLoudnessMeter, argc, argv);
+
+    result |= QTest::qExec(&testRingBuffer, argc, argv);
+
+    result |= QTest::qExec(&testJamtabaDelay, argc, argv);
+
+    result |= QTest::qExec(&testMetronomeTrackNode, argc, argv);
+
     return result;
 }
@@ -2,10 +2,15 @@ TEMPLATE = subdirs
 
 
 SUBDIRS += audio
+SUBDIRS += bridge
 SUBDIRS += chat
 SUBDIRS += chords
 SUBDIRS += file
 SUBDIRS += geo
+SUBDIRS += meters
 SUBDIRS += midi
 SUBDIRS += ninjam
 SUBDIRS += persistence
+SUBDIRS += recorder
+SUBDIRS += video
+SUBDIRS += vst
@@ -0,0 +1,22 @@
+QT += testlib
+QT -= gui
+CONFIG += testcase
+CONFIG += c++11
+TEMPLATE = app
+TARGET = bridge
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../src/Common
+VPATH += ../../../src/Common
+
+HEADERS += bridge/BridgeTransport.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += midi/MidiMessage.h
+
+SOURCES += bridge/BridgeTransport.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+SOURCES += midi/MidiMessage.cpp
+SOURCES += log/logging.cpp
+
+SOURCES += test_Bridge.cpp
@@ -0,0 +1,309 @@
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <vector>
+#include <algorithm>
+
+#include "bridge/BridgeTransport.h"
+#include "audio/core/SamplesBuffer.h"
+#include "midi/MidiMessage.h"
+
+using bridge::BridgeTransport;
+using audio::SamplesBuffer;
+using midi::MidiMessage;
+
+class TestBridge: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void attachWithoutCreate();
+    void roundTrip();
+    void midiMessagesAreTransferred();
+    void responseMidiMessagesAreTransferred();
+    void fullRequestsRing();
+    void lateResponsesAreDiscarded();
+    void responseTimeout();
+    void roundTripLatencyBenchmark();
+
+private:
+    static QString createKey();
+    static SamplesBuffer createBuffer(quint32 frames, float value);
+    static BridgeTransport::TimeInfo createTimeInfo();
+};
+
+// the bridge process side, multiplying the samples by 2 and sending back the midi messages
+class EchoThread : public QThread
+{
+public:
+    explicit EchoThread(const QString &key) :
+        transport(key),
+        running(1)
+    {
+        //
+    }
+
+    bool attach()
+    {
+        return transport.attach();
+    }
+
+    void stop()
+    {
+        running.storeRelease(0);
+        wait();
+    }
+
+protected:
+    void run() override
+    {
+        SamplesBuffer buffer(2, BridgeTransport::MAX_FRAMES);
+        std::vector<MidiMessage> midiMessages;
+        BridgeTransport::TimeInfo timeInfo;
+
+        while (running.loadAcquire()) {
+            if (!transport.waitRequest(buffer, midiMessages, timeInfo, 10000))
+                continue;
+
+            buffer.applyGain(2.0f, 1.0f);
+            transport.sendResponse(buffer, midiMessages);
+        }
+    }
+
+private:
+    BridgeTransport transport;
+    QAtomicInt running;
+};
+
+QString TestBridge::createKey()
+{
+    static int keys = 0;
+    return QString("JamTaba-Test-Bridge-%1-%2").arg(QCoreApplication::applicationPid()).arg(keys++);
+}
+
+SamplesBuffer TestBridge::createBuffer(quint32 frames, float value)
+{
+    SamplesBuffer buffer(2, frames);
+    for (quint32 f = 0; f < frames; ++f) {
+        buffer.set(0, f, value);
+        buffer.set(1, f, -value);
+    }
+    return buffer;
+}
+
+BridgeTransport::TimeInfo TestBridge::createTimeInfo()
+{
+    BridgeTransport::TimeInfo timeInfo;
+    timeInfo.sampleRate = 44100;
+    timeInfo.bpm = 120;
+    timeInfo.positionInSamples = 1024;
+    timeInfo.playing = true;
+    return timeInfo;
+}
+
+void TestBridge::attachWithoutCreate()
+{
+    BridgeTransport transport(createKey());
+    QVERIFY(!transport.attach());
+    QVERIFY(!transport.isOpen());
+}
+
+void TestBridge::roundTrip()
+{
+    const QString key = createKey();
+    BridgeTransport jamtaba(key);
+    QVERIFY(jamtaba.create());
+
+    EchoThread bridgeProcess(key);
+    QVERIFY(bridgeProcess.attach());
+    bridgeProcess.start();
+
+    const SamplesBuffer in = createBuffer(256, 0.25f);
+    SamplesBuffer out(2, 256);
+    std::vector<MidiMessage> responseMessages;
+
+    const quint32 sequence = jamtaba.sendRequest(in, std::vector<MidiMessage>(), createTimeInfo());
+    QVERIFY(sequence != 0);
+    QVERIFY(jamtaba.waitResponse(sequence, out, responseMessages, 1000000));
+
+    bridgeProcess.stop();
+
+    for (quint32 f = 0; f < 256; ++f) {
+        QCOMPARE(out.get(0, f), 0.5f);
+        QCOMPARE(out.get(1, f), -0.5f);
+    }
+}
+
+void TestBridge::midiMessagesAreTransferred()
+{
+    const QString key = createKey();
+    BridgeTransport jamtaba(key);
+    QVERIFY(jamtaba.create());
+
+    BridgeTransport bridgeProcess(key);
+    QVERIFY(bridgeProcess.attach());
+
+    std::vector<MidiMessage> midiMessages;
+    MidiMessage noteOn(0x90 | (60 << 8) | (100 << 16), 0);
+    noteOn.setSampleOffset(32);
+    midiMessages.push_back(noteOn);
+
+    QVERIFY(jamtaba.sendRequest(createBuffer(64, 0.1f), midiMessages, createTimeInfo()) != 0);
+
+    SamplesBuffer in(2, 64);
+    std::vector<MidiMessage> receivedMessages;
+    BridgeTransport::TimeInfo timeInfo;
+    QVERIFY(bridgeProcess.waitRequest(in, receivedMessages, timeInfo, 1000));
+
+    QCOMPARE(receivedMessages.size(), static_cast<size_t>(1));
+    QCOMPARE(receivedMessages[0].getStatus(), 0x90);
+    QCOMPARE(receivedMessages[0].getData1(), 60);
+    QCOMPARE(receivedMessages[0].getData2(), 100);
+    QCOMPARE(receivedMessages[0].getSampleOffset(), 32u);
+
+    QCOMPARE(timeInfo.bpm, 120u);
+    QCOMPARE(timeInfo.positionInSamples, 1024);
+    QVERIFY(timeInfo.playing);
+    QCOMPARE(in.getFrameLenght(), 64u);
+}
+
+void TestBridge::responseMidiMessagesAreTransferred()
+{
+    const QString key = createKey();
+    BridgeTransport jamtaba(key);
+    QVERIFY(jamtaba.create());
+
+    BridgeTransport bridgeProcess(key);
+    QVERIFY(bridgeProcess.attach());
+
+    SamplesBuffer buffer(2, 64);
+    std::vector<MidiMessage> midiMessages;
+    BridgeTransport::TimeInfo timeInfo;
+
+    const quint32 sequence = jamtaba.sendRequest(createBuffer(64, 0.1f), midiMessages, createTimeInfo());
+    QVERIFY(bridgeProcess.waitRequest(buffer, midiMessages, timeInfo, 1000));
+
+    std::vector<MidiMessage> generatedMessages; // a midi effect plugin generating a note
+    MidiMessage noteOn(0x91 | (64 << 8) | (90 << 16), -1);
+    noteOn.setSampleOffset(10);
+    generatedMessages.push_back(noteOn);
+    QVERIFY(bridgeProcess.sendResponse(buffer, generatedMessages));
+
+    SamplesBuffer out(2, 64);
+    std::vector<MidiMessage> responseMessages;
+    QVERIFY(jamtaba.waitResponse(sequence, out, responseMessages, 1000));
+
+    QCOMPARE(responseMessages.size(), static_cast<size_t>(1));
+    QCOMPARE(responseMessages[0].getStatus(), 0x91);
+    QCOMPARE(responseMessages[0].getData1(), 64);
+    QCOMPARE(responseMessages[0].getData2(), 90);
+    QCOMPARE(responseMessages[0].getSampleOffset(), 10u);
+}
+
+void TestBridge::fullRequestsRing()
+{
+    BridgeTransport jamtaba(createKey());
+    QVERIFY(jamtaba.create());
+
+    const SamplesBuffer in = createBuffer(64, 0.1f);
+
+    int sentRequests = 0;
+    while (jamtaba.sendRequest(in, std::vector<MidiMessage>(), createTimeInfo()) != 0) {
+        sentRequests++;
+        QVERIFY(sentRequests <= 16);
+    }
+
+    QVERIFY(sentRequests > 0); // no blocking when the bridge process is not consuming the requests
+}
+
+void TestBridge::lateResponsesAreDiscarded()
+{
+    const QString key = createKey();
+    BridgeTransport jamtaba(key);
+    QVERIFY(jamtaba.create());
+
+    BridgeTransport bridgeProcess(key);
+    QVERIFY(bridgeProcess.attach());
+
+    SamplesBuffer buffer(2, 64);
+    std::vector<MidiMessage> midiMessages;
+    BridgeTransport::TimeInfo timeInfo;
+
+    // first request is processed too late, the response arrives with the second response
+    jamtaba.sendRequest(createBuffer(64, 0.1f), midiMessages, createTimeInfo());
+    QVERIFY(bridgeProcess.waitRequest(buffer, midiMessages, timeInfo, 1000));
+    QVERIFY(bridgeProcess.sendResponse(buffer, midiMessages));
+
+    const quint32 secondSequence = jamtaba.sendRequest(createBuffer(64, 0.2f), midiMessages, createTimeInfo());
+    QVERIFY(bridgeProcess.waitRequest(buffer, midiMessages, timeInfo, 1000));
+    QVERIFY(bridgeProcess.sendResponse(buffer, midiMessages));
+
+    SamplesBuffer out(2, 64);
+    std::vector<MidiMessage> responseMessages;
+    QVERIFY(jamtaba.waitResponse(secondSequence, out, responseMessages, 1000));
+    QCOMPARE(out.get(0, 0), 0.2f);
+}
+
+void TestBridge::responseTimeout()
+{
+    BridgeTransport jamtaba(createKey());
+    QVERIFY(jamtaba.create());
+
+    const SamplesBuffer in = createBuffer(64, 0.1f);
+    SamplesBuffer out = createBuffer(64, 0.3f);
+
+    const quint32 sequence = jamtaba.sendRequest(in, std::vector<MidiMessage>(), createTimeInfo());
+    std::vector<MidiMessage> responseMessages;
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!jamtaba.waitResponse(sequence, out, responseMessages, 2000)); // the bridge process is frozen
+    QVERIFY(timer.elapsed() < 1000);
+
+    QCOMPARE(out.get(0, 0), 0.3f); // output untouched, the last wet block is used by the caller
+}
+
+void TestBridge::roundTripLatencyBenchmark()
+{
+    const QString key = createKey();
+    BridgeTransport jamtaba(key);
+    QVERIFY(jamtaba.create());
+
+    EchoThread bridgeProcess(key);
+    QVERIFY(bridgeProcess.attach());
+    bridgeProcess.start();
+
+    const SamplesBuffer in = createBuffer(128, 0.25f);
+    SamplesBuffer out(2, 128);
+    const std::vector<MidiMessage> midiMessages;
+    std::vector<MidiMessage> responseMessages;
+    const BridgeTransport::TimeInfo timeInfo = createTimeInfo();
+
+    std::vector<qint64> latencies;
+    QElapsedTimer timer;
+
+    QBENCHMARK {
+        timer.start();
+        const quint32 sequence = jamtaba.sendRequest(in, midiMessages, timeInfo);
+        jamtaba.waitResponse(sequence, out, responseMessages, 1000000);
+        latencies.push_back(timer.nsecsElapsed());
+    }
+
+    bridgeProcess.stop();
+
+    std::sort(latencies.begin(), latencies.end());
+    qInfo() << "Round trip latency (128 frames): median" << latencies[latencies.size() / 2] / 1000.0 << "us, worst" << latencies.back() / 1000.0 << "us";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    TestBridge test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_Bridge.moc"
@@ -9,6 +9,16 @@ INCLUDEPATH += ../../../src/Common
 VPATH += ../../../src/Common
 
 HEADERS += file/FileUtils.h
+HEADERS += file/FileReader.h
+HEADERS += file/WaveFileReader.h
+HEADERS += file/WaveFileWriter.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
 
 SOURCES += file/FileUtils.cpp
+SOURCES += file/FileReader.cpp
+SOURCES += file/WaveFileReader.cpp
+SOURCES += file/WaveFileWriter.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
 SOURCES += test_File.cpp
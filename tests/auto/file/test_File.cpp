@@ -1,7 +1,17 @@
 #include <QObject>
 #include <QString>
 #include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
 #include "file/FileUtils.h"
+#include "file/WaveFileReader.h"
+#include "file/WaveFileWriter.h"
+
+using audio::SamplesBuffer;
+using audio::WaveFileReader;
+using audio::WaveFileWriter;
 
 class TestFile: public QObject
 {
@@ -10,8 +20,33 @@ class TestFile: public QObject
 private slots:
     void sanitizeFileName();
     void sanitizeFileName_data();
+
+    void readWaveFile();
+    void readWaveFile_data();
+
+    void readWaveFileInChunks();
+
+    void read24BitsWaveFile();
+
+    void readWaveFileBenchmark();
+
+private:
+    static SamplesBuffer createSineBuffer(quint8 channels, quint32 frames);
+
+    QTemporaryDir tempDir;
 };
 
+SamplesBuffer TestFile::createSineBuffer(quint8 channels, quint32 frames)
+{
+    SamplesBuffer buffer(channels, frames);
+    for (quint32 s = 0; s < frames; ++s) {
+        for (quint8 c = 0; c < channels; ++c)
+            buffer.set(c, s, std::sin(s * 0.01 * (c + 1)) * 0.9);
+    }
+
+    return buffer;
+}
+
 void TestFile::sanitizeFileName()
 {
     QFETCH(QString, original);
@@ -38,6 +73,142 @@ void TestFile::sanitizeFileName_data()
 
 }
 
+void TestFile::readWaveFile()
+{
+    QFETCH(int, channels);
+    QFETCH(int, bitDepth);
+    QFETCH(int, frames);
+
+    const QString filePath = tempDir.filePath("test.wav");
+    const SamplesBuffer original = createSineBuffer(channels, frames);
+
+    WaveFileWriter writer;
+    writer.write(filePath, original, 44100, bitDepth);
+
+    WaveFileReader reader;
+    SamplesBuffer loaded(2);
+    quint32 sampleRate = 0;
+    QVERIFY(reader.read(filePath, loaded, sampleRate));
+
+    QCOMPARE(sampleRate, 44100u);
+    QCOMPARE(loaded.getChannels(), channels);
+    QCOMPARE(loaded.getFrameLenght(), static_cast<uint>(frames));
+
+    const float tolerance = bitDepth == 16 ? 1.0f/32767.0f : 0.0f;
+    for (int c = 0; c < channels; ++c) {
+        for (int s = 0; s < frames; ++s)
+            QVERIFY(qAbs(loaded.get(c, s) - original.get(c, s)) <= tolerance);
+    }
+}
+
+void TestFile::readWaveFile_data()
+{
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<int>("bitDepth");
+    QTest::addColumn<int>("frames");
+
+    QTest::newRow("Mono 16 bits") << 1 << 16 << 1001;
+    QTest::newRow("Stereo 16 bits") << 2 << 16 << 1001;
+    QTest::newRow("Mono 32 bits float") << 1 << 32 << 1001;
+    QTest::newRow("Stereo 32 bits float") << 2 << 32 << 1001;
+    QTest::newRow("Stereo 16 bits, less frames than SIMD block") << 2 << 16 << 3;
+}
+
+void TestFile::readWaveFileInChunks()
+{
+    const QString filePath = tempDir.filePath("chunks.wav");
+    const quint32 frames = 10000;
+    const SamplesBuffer original = createSineBuffer(2, frames);
+
+    WaveFileWriter writer;
+    writer.write(filePath, original, 48000, 32);
+
+    WaveFileReader reader;
+    QVERIFY(reader.open(filePath));
+    QCOMPARE(reader.getTotalFrames(), static_cast<quint64>(frames));
+    QCOMPARE(reader.getSampleRate(), 48000u);
+
+    SamplesBuffer chunk(2);
+    quint32 position = 0;
+    const quint32 chunkSize = 777;
+    while (quint32 framesRead = reader.readFrames(chunk, chunkSize)) {
+        QCOMPARE(chunk.getFrameLenght(), framesRead);
+        for (quint32 s = 0; s < framesRead; ++s) {
+            QCOMPARE(chunk.get(0, s), original.get(0, position + s));
+            QCOMPARE(chunk.get(1, s), original.get(1, position + s));
+        }
+        position += framesRead;
+    }
+    QCOMPARE(position, frames);
+
+    QVERIFY(reader.seek(5000));
+    QCOMPARE(reader.readFrames(chunk, 10), 10u);
+    QCOMPARE(chunk.get(1, 0), original.get(1, 5000));
+
+    QVERIFY(!reader.seek(frames + 1));
+
+    reader.close();
+    QCOMPARE(reader.readFrames(chunk, 10), 0u);
+}
+
+void TestFile::read24BitsWaveFile()
+{
+    const QString filePath = tempDir.filePath("24bits.wav");
+
+    const qint32 samples[] = { 0, 8388607, -8388608, 4194304, -1, 1 }; // 3 stereo frames
+
+    QByteArray content;
+    content.resize(44 + sizeof(samples)/sizeof(samples[0]) * 3);
+    uchar *data = reinterpret_cast<uchar *>(content.data());
+    std::memcpy(data, "RIFF", 4);
+    qToLittleEndian<quint32>(content.size() - 8, data + 4);
+    std::memcpy(data + 8, "WAVEfmt ", 8);
+    qToLittleEndian<quint32>(16, data + 16);
+    qToLittleEndian<quint16>(1, data + 20);         // PCM
+    qToLittleEndian<quint16>(2, data + 22);         // channels
+    qToLittleEndian<quint32>(22050, data + 24);     // sample rate
+    qToLittleEndian<quint32>(22050 * 6, data + 28); // bytes per second
+    qToLittleEndian<quint16>(6, data + 32);         // block align
+    qToLittleEndian<quint16>(24, data + 34);        // bits per sample
+    std::memcpy(data + 36, "data", 4);
+    qToLittleEndian<quint32>(content.size() - 44, data + 40);
+    for (int i = 0; i < 6; ++i) {
+        data[44 + i * 3] = samples[i] & 0xFF;
+        data[44 + i * 3 + 1] = (samples[i] >> 8) & 0xFF;
+        data[44 + i * 3 + 2] = (samples[i] >> 16) & 0xFF;
+    }
+
+    QFile file(filePath);
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write(content);
+    file.close();
+
+    WaveFileReader reader;
+    SamplesBuffer loaded(2);
+    quint32 sampleRate = 0;
+    QVERIFY(reader.read(filePath, loaded, sampleRate));
+
+    QCOMPARE(sampleRate, 22050u);
+    QCOMPARE(loaded.getFrameLenght(), 3u);
+    for (int i = 0; i < 6; ++i)
+        QCOMPARE(loaded.get(i % 2, i / 2), samples[i] * (1.0f / 8388607.0f));
+}
+
+void TestFile::readWaveFileBenchmark()
+{
+    const QString filePath = tempDir.filePath("benchmark.wav");
+    const quint32 frames = 44100 * 60; // one minute
+
+    WaveFileWriter writer;
+    writer.write(filePath, createSineBuffer(2, frames), 44100, 16);
+
+    QBENCHMARK {
+        WaveFileReader reader;
+        SamplesBuffer loaded(2);
+        quint32 sampleRate = 0;
+        reader.read(filePath, loaded, sampleRate);
+    }
+}
 
 int main(int argc, char *argv[])
 {
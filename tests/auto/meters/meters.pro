@@ -0,0 +1,18 @@
+QT += testlib widgets
+CONFIG += testcase
+CONFIG += c++11
+TEMPLATE = app
+TARGET = meters
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../src/Common
+VPATH += ../../../src/Common
+
+HEADERS += Utils.h
+HEADERS += gui/widgets/MeterStrip.h
+HEADERS += gui/widgets/Slider.h
+
+SOURCES += gui/widgets/MeterStrip.cpp
+SOURCES += gui/widgets/Slider.cpp
+
+SOURCES += test_Meters.cpp
@@ -0,0 +1,203 @@
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QApplication>
+#include <QGridLayout>
+#include <QPainter>
+#include <QImage>
+#include <QElapsedTimer>
+#include <QThread>
+#include <vector>
+#include <cmath>
+
+#include "gui/widgets/MeterStrip.h"
+#include "gui/widgets/Slider.h"
+
+class TestMeters: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void stripPaintsSameSegments();
+    void stripPaintsSameSegments_data();
+
+    void largeRoomBenchmark();
+
+private:
+    static std::vector<QColor> createColors(int segments);
+    static void paintSegments(QPainter &painter, const QRectF &rect, qreal peakPosition, const std::vector<QColor> &colors, Qt::Orientation orientation, bool drawSegments, quint8 segmentSize);
+};
+
+class PaintCounter : public QObject
+{
+public:
+    PaintCounter() : paints(0) {}
+
+    quint64 paints;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint)
+            paints++;
+
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+std::vector<QColor> TestMeters::createColors(int segments)
+{
+    std::vector<QColor> colors;
+    for (int i = 0; i < segments; ++i)
+        colors.push_back(QColor::fromHsv((i * 7) % 360, 255, 200, 100 + i % 155));
+
+    return colors;
+}
+
+// the segments painting used before the cached strips, one rectangle per segment
+void TestMeters::paintSegments(QPainter &painter, const QRectF &rect, qreal peakPosition, const std::vector<QColor> &colors, Qt::Orientation orientation, bool drawSegments, quint8 segmentSize)
+{
+    const quint32 segmentsToPaint = static_cast<quint32>(peakPosition)/segmentSize;
+    const bool isVertical = orientation == Qt::Vertical;
+    const qreal pad = drawSegments ? 1.0 : 0;
+
+    qreal x = rect.left();
+    qreal y = isVertical ? (rect.height() - segmentSize) : rect.top();
+    const qreal w = isVertical ? rect.width() - pad : segmentSize - pad;
+    const qreal h = isVertical ? (segmentSize - pad) : rect.height() - pad;
+
+    for (quint32 i = 0; i < segmentsToPaint; ++i) {
+        painter.fillRect(QRectF(x, y, w, h), (i < colors.size()) ? colors[i] : colors.back());
+        if (isVertical)
+            y -= segmentSize;
+        else
+            x += segmentSize;
+    }
+}
+
+void TestMeters::stripPaintsSameSegments()
+{
+    QFETCH(bool, vertical);
+    QFETCH(bool, drawSegments);
+    QFETCH(qreal, peakPosition);
+
+    const Qt::Orientation orientation = vertical ? Qt::Vertical : Qt::Horizontal;
+    const quint8 segmentSize = 6;
+    const QSize imageSize(60, 180);
+    const QRectF rect(12, 0, 9, 180); // one of the parallel meters
+    const auto colors = createColors(20); // less colors than segments, the last color is used in the big peaks
+
+    QImage expected(imageSize, QImage::Format_ARGB32_Premultiplied);
+    expected.fill(Qt::black);
+    {
+        QPainter painter(&expected);
+        paintSegments(painter, rect, peakPosition, colors, orientation, drawSegments, segmentSize);
+    }
+
+    MeterStrip strip;
+    for (int i = 0; i < 2; ++i) { // the second paint is using the cached pixmap
+        QImage painted(imageSize, QImage::Format_ARGB32_Premultiplied);
+        painted.fill(Qt::black);
+        {
+            QPainter painter(&painted);
+            strip.paint(painter, rect, peakPosition, colors, orientation, drawSegments, segmentSize);
+        }
+        QCOMPARE(painted, expected);
+    }
+}
+
+void TestMeters::stripPaintsSameSegments_data()
+{
+    QTest::addColumn<bool>("vertical");
+    QTest::addColumn<bool>("drawSegments");
+    QTest::addColumn<qreal>("peakPosition");
+
+    QTest::newRow("Vertical, silence") << true << true << 0.0;
+    QTest::newRow("Vertical, one segment") << true << true << 7.5;
+    QTest::newRow("Vertical, half") << true << true << 90.0;
+    QTest::newRow("Vertical, full") << true << true << 180.0;
+    QTest::newRow("Vertical, no segments style") << true << false << 100.0;
+    QTest::newRow("Horizontal, half") << false << true << 30.0;
+    QTest::newRow("Horizontal, full") << false << false << 60.0;
+}
+
+/**
+    64 track meters (a big ninjam room) updated at the GUI refresh rate during 10 seconds. Half of
+    the tracks are silent, the others are playing. The reported value is the GUI thread time spent in
+    each frame (peaks update + painting). The benchmark is running in real time, so it is skipped
+    unless the JAMTABA_RUN_BENCHMARKS environment variable is set.
+ */
+void TestMeters::largeRoomBenchmark()
+{
+    if (!qEnvironmentVariableIsSet("JAMTABA_RUN_BENCHMARKS"))
+        QSKIP("Real time benchmark, set JAMTABA_RUN_BENCHMARKS to run it");
+
+    const int meters = 64;
+    const int columns = 16;
+    const int framePeriod = 33; // ms, ~30 fps
+    const qint64 duration = 10000;
+
+    QWidget window;
+    auto layout = new QGridLayout(&window);
+    PaintCounter paintCounter;
+    QList<AudioSlider *> sliders;
+    for (int i = 0; i < meters; ++i) {
+        auto slider = new AudioSlider(&window);
+        slider->setOrientation(Qt::Vertical);
+        slider->setValue(100);
+        slider->installEventFilter(&paintCounter);
+        layout->addWidget(slider, i / columns, i % columns);
+        sliders.append(slider);
+    }
+
+    window.resize(columns * 40, 2 * 300);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QApplication::processEvents();
+
+    paintCounter.paints = 0;
+    qint64 busyTime = 0; // nanoseconds
+    quint64 frames = 0;
+
+    QElapsedTimer clock;
+    clock.start();
+    while (clock.elapsed() < duration) {
+        QElapsedTimer frameTimer;
+        frameTimer.start();
+
+        const double time = clock.elapsed() / 1000.0;
+        for (int i = 0; i < meters; ++i) {
+            float peak = 0;
+            if (i % 2) { // playing tracks
+                peak = 0.4 + 0.4 * std::sin(2 * M_PI * (0.5 + i * 0.05) * time + i);
+            }
+            sliders.at(i)->setPeak(peak, peak * 0.9f, peak * 0.7f, peak * 0.6f);
+        }
+
+        QApplication::sendPostedEvents();
+        QApplication::processEvents(); // paint
+
+        busyTime += frameTimer.nsecsElapsed();
+        frames++;
+
+        const qint64 remaining = framePeriod - frameTimer.elapsed();
+        if (remaining > 0)
+            QThread::msleep(remaining);
+    }
+
+    QVERIFY(frames > 0);
+
+    const qreal msPerFrame = busyTime / 1000000.0 / frames;
+    qInfo() << "GUI thread time per frame:" << msPerFrame << "ms," << (paintCounter.paints / static_cast<qreal>(frames)) << "meter repaints per frame," << frames << "frames";
+
+    QTest::setBenchmarkResult(msPerFrame, QTest::WalltimeMilliseconds);
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    TestMeters test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_Meters.moc"
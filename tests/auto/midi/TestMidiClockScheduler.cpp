@@ -0,0 +1,157 @@
+#include "TestMidiClockScheduler.h"
+#include "midi/MidiDriver.h"
+#include "midi/MidiClockScheduler.h"
+
+#include <QtTest/QtTest>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+
+using midi::MidiClockScheduler;
+
+namespace {
+
+/**
+    A loopback midi driver, the clock messages sent to the 'output' are received with
+    the arrival time, like a virtual midi port connected in a midi input.
+ */
+class LoopbackMidiDriver : public midi::MidiDriver
+{
+public:
+    LoopbackMidiDriver() :
+        stopMessages(0)
+    {
+    }
+
+    void start(const QList<bool> &, const QList<bool> &) override {}
+    void stop() override {}
+    void release() override {}
+    bool hasInputDevices() const override { return true; }
+    bool hasOutputDevices() const override { return true; }
+    int getMaxInputDevices() const override { return 1; }
+    int getMaxOutputDevices() const override { return 1; }
+    QString getInputDeviceName(uint) const override { return "loopback"; }
+    QString getOutputDeviceName(uint) const override { return "loopback"; }
+    void getBuffer(std::vector<midi::MidiMessage> &) override {}
+
+    void sendClockStart() const override {}
+    void sendClockContinue() const override {}
+
+    void sendClockStop() const override
+    {
+        QMutexLocker locker(&mutex);
+        stopMessages++;
+    }
+
+    void sendClockPulse() const override
+    {
+        QMutexLocker locker(&mutex);
+        pulsesArrivalTime.append(getClockTime());
+    }
+
+    QList<qint64> getPulsesArrivalTime() const
+    {
+        QMutexLocker locker(&mutex);
+        return pulsesArrivalTime;
+    }
+
+    int getStopMessages() const
+    {
+        QMutexLocker locker(&mutex);
+        return stopMessages;
+    }
+
+private:
+    mutable QMutex mutex;
+    mutable QList<qint64> pulsesArrivalTime;
+    mutable int stopMessages;
+};
+
+} // namespace
+
+void TestMidiClockScheduler::pulsesJitter_data()
+{
+    QTest::addColumn<int>("bufferSize");
+
+    QTest::newRow("256 samples") << 256;
+    QTest::newRow("1024 samples") << 1024;
+    QTest::newRow("2048 samples") << 2048;
+}
+
+void TestMidiClockScheduler::pulsesJitter()
+{
+    QFETCH(int, bufferSize);
+
+    const int sampleRate = 48000;
+    const double samplesPerPulse = sampleRate * 60.0 / 120.0 / 24.0; // 120 bpm, 24 pulses per beat
+    const int totalPulses = 48;
+    const double outputLatency = static_cast<double>(bufferSize) / sampleRate;
+
+    LoopbackMidiDriver driver;
+    MidiClockScheduler scheduler(&driver);
+    scheduler.start();
+
+    // simulating the audio callbacks, the pulses are scheduled in the exact sample position
+    quint64 sampleClock = 0;
+    int scheduledPulses = 0;
+    QList<qint64> scheduledTimes; // the time when each pulse should be received
+    QElapsedTimer timer;
+    timer.start();
+    while (scheduledPulses < totalPulses) {
+        driver.updateSampleClock(sampleClock, sampleRate, outputLatency);
+
+        const quint64 blockEnd = sampleClock + bufferSize;
+        while (scheduledPulses < totalPulses) {
+            const quint64 pulsePosition = static_cast<quint64>(std::ceil(scheduledPulses * samplesPerPulse));
+            if (pulsePosition >= blockEnd)
+                break;
+
+            QVERIFY(scheduler.schedule(MidiClockScheduler::ClockPulse, pulsePosition));
+            scheduledTimes.append(driver.getSampleClockTime(pulsePosition));
+            scheduledPulses++;
+        }
+
+        sampleClock = blockEnd;
+        const qint64 nextCallbackTime = static_cast<qint64>(sampleClock * 1000000000.0 / sampleRate);
+        while (timer.nsecsElapsed() < nextCallbackTime)
+            QThread::usleep(500);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(driver.getPulsesArrivalTime().size(), totalPulses, 2000);
+    scheduler.stop();
+
+    const QList<qint64> arrivalTimes = driver.getPulsesArrivalTime();
+    QList<double> errors;
+    for (int i = 0; i < arrivalTimes.size(); ++i)
+        errors.append(qAbs(arrivalTimes.at(i) - scheduledTimes.at(i)) / 1000000.0); // in ms
+    std::sort(errors.begin(), errors.end());
+
+    // sending in the audio callback the pulses arrive up to one buffer (5.3, 21.3 and 42.6 ms here) plus the output latency
+    // away from the scheduled time. The test is using real sleeps, a few pulses can be late in loaded machines, so the
+    // 95th percentile is checked instead of the max error
+    const double p95Error = errors.at(static_cast<int>(std::ceil(errors.size() * 0.95)) - 1);
+    QVERIFY2(p95Error < 2.0, qPrintable(QString("95th percentile pulse error: %1 ms").arg(p95Error)));
+}
+
+void TestMidiClockScheduler::stopClockDiscardScheduledPulses()
+{
+    const int sampleRate = 44100;
+
+    LoopbackMidiDriver driver;
+    MidiClockScheduler scheduler(&driver);
+    scheduler.start();
+
+    driver.updateSampleClock(0, sampleRate);
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(scheduler.schedule(MidiClockScheduler::ClockPulse, sampleRate + i * 100)); // one second in the future
+
+    scheduler.stopClock();
+
+    QTRY_COMPARE_WITH_TIMEOUT(driver.getStopMessages(), 1, 1000);
+    QTest::qWait(50);
+    QCOMPARE(driver.getPulsesArrivalTime().size(), 0);
+
+    scheduler.stop();
+}
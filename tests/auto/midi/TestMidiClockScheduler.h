@@ -0,0 +1,17 @@
+#ifndef TESTMIDICLOCKSCHEDULER_H
+#define TESTMIDICLOCKSCHEDULER_H
+
+#include <QObject>
+
+class TestMidiClockScheduler: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pulsesJitter(); // the pulses interval must be stable, even using big audio buffers
+    void pulsesJitter_data();
+
+    void stopClockDiscardScheduledPulses();
+};
+
+#endif // TESTMIDICLOCKSCHEDULER_H
@@ -1,6 +1,7 @@
-QT += testlib
+QT += testlib concurrent
 QT -= gui
 CONFIG += testcase
+CONFIG += c++11
 TEMPLATE = app
 TARGET = midi
 
@@ -8,7 +9,15 @@ INCLUDEPATH += .
 INCLUDEPATH += ../../../src/Common
 VPATH += ../../../src/Common
 
+HEADERS += TestMidiClockScheduler.h
 HEADERS += midi/MidiMessage.h
+HEADERS += midi/MidiDriver.h
+HEADERS += midi/MidiClockScheduler.h
+HEADERS += audio/core/RingBuffer.h
+
+SOURCES += TestMidiClockScheduler.cpp
 SOURCES += midi/MidiMessage.cpp
+SOURCES += midi/MidiDriver.cpp
+SOURCES += midi/MidiClockScheduler.cpp
 
 SOURCES += test_MidiMessage.cpp
@@ -2,6 +2,7 @@
 #include <QtTest/QtTest>
 #include <QString>
 #include "midi/MidiMessage.h"
+#include "TestMidiClockScheduler.h"
 
 using namespace midi;
 
@@ -44,7 +45,13 @@ void TestMidiMessage::transpose_data()
 int main(int argc, char *argv[])
 {
     TestMidiMessage test;
-    return QTest::qExec(&test, argc, argv);
+    TestMidiClockScheduler testMidiClockScheduler;
+
+    int result = QTest::qExec(&test, argc, argv);
+
+    result |= QTest::qExec(&testMidiClockScheduler, argc, argv);
+
+    return result;
 }
 
 #include "test_MidiMessage.moc"
@@ -0,0 +1,81 @@
+#include "TestLoopInfoIndex.h"
+#include "looper/LoopInfoIndex.h"
+
+#include <QtTest/QtTest>
+
+using audio::LoopInfo;
+using audio::LoopInfoIndex;
+using audio::LoopLayerInfo;
+
+void TestLoopInfoIndex::indexRoundTrip()
+{
+    LoopInfo loopInfo(120, 16, "loop", true, 2);
+    loopInfo.addLayer(true, 0.7f, -0.35f);
+    loopInfo.addLayer(false, 1.25f, 0.1f);
+
+    LoopInfoIndex::Entry entry;
+    entry.lastModified = 1500000000123;
+    entry.fileSize = 321;
+    entry.loopInfo = loopInfo;
+
+    LoopInfoIndex::Entries entries;
+    entries.insert("loop.json", entry);
+
+    const QString indexFilePath = tempDir.filePath("roundTrip.index");
+    LoopInfoIndex::writeIndexFile(indexFilePath, entries);
+
+    const LoopInfoIndex::Entries readEntries = LoopInfoIndex::readIndexFile(indexFilePath);
+    QCOMPARE(readEntries.size(), 1);
+    QVERIFY(readEntries.contains("loop.json"));
+
+    const LoopInfoIndex::Entry &readEntry = readEntries["loop.json"];
+    QCOMPARE(readEntry.lastModified, entry.lastModified);
+    QCOMPARE(readEntry.fileSize, entry.fileSize);
+
+    const LoopInfo &readInfo = readEntry.loopInfo;
+    QCOMPARE(readInfo.getName(), loopInfo.getName());
+    QCOMPARE(readInfo.getBpm(), loopInfo.getBpm());
+    QCOMPARE(readInfo.getBpi(), loopInfo.getBpi());
+    QCOMPARE(readInfo.audioIsEncoded(), loopInfo.audioIsEncoded());
+    QCOMPARE(readInfo.getLooperMode(), loopInfo.getLooperMode());
+    QCOMPARE(readInfo.getLayersCount(), loopInfo.getLayersCount());
+
+    const QList<LoopLayerInfo> layers = loopInfo.getLayersInfo();
+    const QList<LoopLayerInfo> readLayers = readInfo.getLayersInfo();
+    for (int l = 0; l < layers.size(); ++l) {
+        QCOMPARE(readLayers[l].locked, layers[l].locked);
+        QCOMPARE(readLayers[l].gain, layers[l].gain);
+        QCOMPARE(readLayers[l].pan, layers[l].pan);
+    }
+}
+
+void TestLoopInfoIndex::loopsInfoReadFromIndex()
+{
+    QDir loopsDir(tempDir.filePath("loops"));
+    QVERIFY(loopsDir.mkpath("."));
+
+    LoopInfo loopInfo(95, 32, "savedLoop", false, 1);
+    loopInfo.addLayer(false, 0.5f, 0.25f);
+    QVERIFY(loopInfo.saveToJsonFile(loopsDir.absolutePath(), 44100));
+
+    const QList<LoopInfo> parsedInfos = LoopInfoIndex::getLoopsInfo(loopsDir.absolutePath()); // json parsed, index written
+    QCOMPARE(parsedInfos.size(), 1);
+
+    const QString indexFilePath = loopsDir.absoluteFilePath(LoopInfoIndex::INDEX_FILE_NAME);
+    QVERIFY(QFile::exists(indexFilePath));
+
+    // the entries read from the index file must be considered updated, otherwise all json files are parsed again
+    const LoopInfoIndex::Entries entries = LoopInfoIndex::readIndexFile(indexFilePath);
+    QCOMPARE(entries.size(), 1);
+
+    const QFileInfo jsonFileInfo(loopsDir.absoluteFilePath("savedLoop.json"));
+    const LoopInfoIndex::Entry &entry = entries.constBegin().value();
+    QCOMPARE(entries.constBegin().key(), jsonFileInfo.fileName());
+    QCOMPARE(entry.lastModified, jsonFileInfo.lastModified().toMSecsSinceEpoch());
+    QCOMPARE(entry.fileSize, jsonFileInfo.size());
+
+    QCOMPARE(entry.loopInfo.getName(), parsedInfos.first().getName());
+    QCOMPARE(entry.loopInfo.getBpm(), 95u);
+    QCOMPARE(entry.loopInfo.getLayersInfo().first().gain, 0.5f);
+    QCOMPARE(entry.loopInfo.getLayersInfo().first().pan, 0.25f);
+}
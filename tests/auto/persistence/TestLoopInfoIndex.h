@@ -0,0 +1,19 @@
+#ifndef TEST_LOOP_INFO_INDEX_H
+#define TEST_LOOP_INFO_INDEX_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class TestLoopInfoIndex: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void indexRoundTrip();
+    void loopsInfoReadFromIndex();
+
+private:
+    QTemporaryDir tempDir;
+};
+
+#endif
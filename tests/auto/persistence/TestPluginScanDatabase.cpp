@@ -0,0 +1,91 @@
+#include "TestPluginScanDatabase.h"
+#include "persistence/PluginScanDatabase.h"
+
+#include <QtTest/QtTest>
+
+using persistence::PluginScanDatabase;
+
+QString TestPluginScanDatabase::createPluginFile(const QString &fileName, const QByteArray &content)
+{
+    const QString filePath = tempDir.filePath(fileName);
+    QFile file(filePath);
+    file.open(QFile::WriteOnly);
+    file.write(content);
+
+    return filePath;
+}
+
+QString TestPluginScanDatabase::getDatabaseFilePath() const
+{
+    return tempDir.filePath("vst_scan.bin");
+}
+
+void TestPluginScanDatabase::init()
+{
+    QFile::remove(getDatabaseFilePath());
+}
+
+void TestPluginScanDatabase::notScannedPlugin()
+{
+    PluginScanDatabase database(getDatabaseFilePath());
+    QCOMPARE(database.getSize(), 0);
+    QCOMPARE(database.getScanResult(QFileInfo(createPluginFile("new.dll"))), PluginScanDatabase::NotScanned);
+}
+
+void TestPluginScanDatabase::saveAndLoad()
+{
+    const QString validPlugin = createPluginFile("valid.dll");
+    const QString invalidPlugin = createPluginFile("invalid.dll");
+
+    {
+        PluginScanDatabase database(getDatabaseFilePath());
+        database.setScanResult(QFileInfo(validPlugin), PluginScanDatabase::ValidPlugin);
+        database.setScanResult(QFileInfo(invalidPlugin), PluginScanDatabase::InvalidPlugin);
+        QVERIFY(database.save());
+    }
+
+    PluginScanDatabase database(getDatabaseFilePath());
+    QCOMPARE(database.getSize(), 2);
+    QCOMPARE(database.getScanResult(QFileInfo(validPlugin)), PluginScanDatabase::ValidPlugin);
+    QCOMPARE(database.getScanResult(QFileInfo(invalidPlugin)), PluginScanDatabase::InvalidPlugin);
+}
+
+void TestPluginScanDatabase::modifiedPluginIsScannedAgain()
+{
+    const QString plugin = createPluginFile("plugin.dll");
+
+    PluginScanDatabase database(getDatabaseFilePath());
+    database.setScanResult(QFileInfo(plugin), PluginScanDatabase::ValidPlugin);
+    QCOMPARE(database.getScanResult(QFileInfo(plugin)), PluginScanDatabase::ValidPlugin);
+
+    createPluginFile("plugin.dll", QByteArray("updated plugin")); // file size changed
+
+    QCOMPARE(database.getScanResult(QFileInfo(plugin)), PluginScanDatabase::NotScanned);
+}
+
+void TestPluginScanDatabase::removeInvalidPlugins()
+{
+    const QString validPlugin = createPluginFile("valid.dll");
+    const QString invalidPlugin = createPluginFile("invalid.dll");
+
+    PluginScanDatabase database(getDatabaseFilePath());
+    database.setScanResult(QFileInfo(validPlugin), PluginScanDatabase::ValidPlugin);
+    database.setScanResult(QFileInfo(invalidPlugin), PluginScanDatabase::InvalidPlugin);
+
+    database.removeInvalidPlugins();
+
+    QCOMPARE(database.getSize(), 1);
+    QCOMPARE(database.getScanResult(QFileInfo(validPlugin)), PluginScanDatabase::ValidPlugin);
+    QCOMPARE(database.getScanResult(QFileInfo(invalidPlugin)), PluginScanDatabase::NotScanned);
+}
+
+void TestPluginScanDatabase::invalidDatabaseFile()
+{
+    QFile file(getDatabaseFilePath());
+    file.open(QFile::WriteOnly);
+    file.write("garbage");
+    file.close();
+
+    PluginScanDatabase database(getDatabaseFilePath());
+    QCOMPARE(database.getSize(), 0);
+}
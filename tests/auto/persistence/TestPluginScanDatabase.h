@@ -0,0 +1,27 @@
+#ifndef TEST_PLUGIN_SCAN_DATABASE_H
+#define TEST_PLUGIN_SCAN_DATABASE_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class TestPluginScanDatabase: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void notScannedPlugin();
+    void saveAndLoad();
+    void modifiedPluginIsScannedAgain();
+    void removeInvalidPlugins();
+    void invalidDatabaseFile();
+
+private:
+    QString createPluginFile(const QString &fileName, const QByteArray &content = QByteArray("plugin"));
+    QString getDatabaseFilePath() const;
+
+    QTemporaryDir tempDir;
+};
+
+#endif
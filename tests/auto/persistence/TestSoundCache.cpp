@@ -0,0 +1,194 @@
+#include "TestSoundCache.h"
+#include "persistence/SoundCache.h"
+#include "file/FileReaderFactory.h"
+#include "file/WaveFileReader.h"
+#include "file/WaveFileWriter.h"
+
+#include <QtTest/QtTest>
+#include <cmath>
+
+using persistence::SoundCache;
+using audio::SamplesBuffer;
+
+// only wave files are used in these tests, so the ogg and mp3 decoders are not linked
+std::unique_ptr<audio::FileReader> audio::FileReaderFactory::createFileReader(const QString &filePath)
+{
+    Q_UNUSED(filePath)
+    return std::unique_ptr<audio::FileReader>(new audio::WaveFileReader());
+}
+
+QString TestSoundCache::createWaveFile(const QString &fileName, quint32 frames, quint32 sampleRate, float amplitude)
+{
+    SamplesBuffer buffer(2, frames);
+    for (quint32 s = 0; s < frames; ++s) {
+        buffer.set(0, s, std::sin(s * 0.05) * amplitude);
+        buffer.set(1, s, std::cos(s * 0.05) * amplitude);
+    }
+
+    const QString filePath = tempDir.filePath(fileName);
+    audio::WaveFileWriter writer;
+    writer.write(filePath, buffer, sampleRate, 32);
+
+    return filePath;
+}
+
+void TestSoundCache::init()
+{
+    QDir(tempDir.filePath("cache")).removeRecursively();
+}
+
+void TestSoundCache::loadWithoutResampling()
+{
+    const QString filePath = createWaveFile("click.wav", 1000, 44100);
+
+    SoundCache cache;
+    SamplesBuffer out(2);
+    QVERIFY(cache.load(filePath, 44100, out));
+
+    QCOMPARE(out.getFrameLenght(), 1000u);
+    QCOMPARE(out.getChannels(), 2);
+    QCOMPARE(out.get(0, 10), static_cast<float>(std::sin(10 * 0.05) * 0.5f));
+}
+
+void TestSoundCache::loadResampled()
+{
+    const QString filePath = createWaveFile("click.wav", 1000, 44100);
+
+    SoundCache cache;
+    SamplesBuffer out(2);
+    QVERIFY(cache.load(filePath, 48000, out));
+
+    QCOMPARE(out.getFrameLenght(), static_cast<uint>(48000.0/44100 * 1000));
+
+    SamplesBuffer original(2);
+    QVERIFY(cache.load(filePath, 44100, original)); // different sample rates are different entries
+    QCOMPARE(original.getFrameLenght(), 1000u);
+}
+
+void TestSoundCache::loadFromMemoryAfterFileRename()
+{
+    const QString filePath = createWaveFile("click.wav", 1000, 44100);
+
+    SoundCache cache;
+    SamplesBuffer first(2);
+    QVERIFY(cache.load(filePath, 48000, first));
+
+    const QString copyPath = tempDir.filePath("copy.wav");
+    QFile::remove(copyPath);
+    QVERIFY(QFile::copy(filePath, copyPath));
+
+    SamplesBuffer second(2);
+    QVERIFY(cache.load(copyPath, 48000, second)); // same content, same cache entry
+
+    QCOMPARE(second.getFrameLenght(), first.getFrameLenght());
+    for (uint s = 0; s < first.getFrameLenght(); ++s)
+        QCOMPARE(second.get(1, s), first.get(1, s));
+}
+
+void TestSoundCache::loadFromDiskCache()
+{
+    const QString filePath = createWaveFile("click.wav", 1000, 44100);
+    const QDir cacheDir(tempDir.filePath("cache"));
+
+    SamplesBuffer first(2);
+    {
+        SoundCache cache;
+        cache.setCacheDir(cacheDir);
+        QVERIFY(cache.load(filePath, 48000, first));
+    }
+
+    QCOMPARE(cacheDir.entryList(QDir::Files).size(), 1);
+
+    SoundCache cache; // a new cache instance, like a new JamTaba session
+    cache.setCacheDir(cacheDir);
+    SamplesBuffer second(2);
+    QVERIFY(cache.load(filePath, 48000, second));
+
+    QCOMPARE(second.getFrameLenght(), first.getFrameLenght());
+    for (uint s = 0; s < first.getFrameLenght(); ++s)
+        QCOMPARE(second.get(0, s), first.get(0, s));
+}
+
+void TestSoundCache::diskCacheHitIsTouched()
+{
+    const QString filePath = createWaveFile("click.wav", 1000, 44100);
+    const QDir cacheDir(tempDir.filePath("cache"));
+
+    SamplesBuffer out(2);
+    {
+        SoundCache cache;
+        cache.setCacheDir(cacheDir);
+        QVERIFY(cache.load(filePath, 48000, out));
+    }
+
+    const QFileInfoList files = cacheDir.entryInfoList(QDir::Files);
+    QCOMPARE(files.size(), 1);
+    const QDateTime savedTime = files.first().lastModified();
+
+    QTest::qSleep(1100); // some file systems are using 1 second resolution
+
+    SoundCache cache;
+    cache.setCacheDir(cacheDir);
+    QVERIFY(cache.load(filePath, 48000, out));
+
+    QVERIFY(QFileInfo(files.first().absoluteFilePath()).lastModified() > savedTime);
+}
+
+void TestSoundCache::modifiedFileIsDecodedAgain()
+{
+    SoundCache cache;
+
+    const QString filePath = createWaveFile("modified.wav", 1000, 44100, 0.5f);
+    SamplesBuffer first(2);
+    QVERIFY(cache.load(filePath, 44100, first));
+
+    createWaveFile("modified.wav", 2000, 44100, 0.25f);
+    SamplesBuffer second(2);
+    QVERIFY(cache.load(filePath, 44100, second));
+
+    QCOMPARE(second.getFrameLenght(), 2000u);
+    QCOMPARE(second.get(0, 10), first.get(0, 10) * 0.5f);
+}
+
+void TestSoundCache::maxFramesInOutBuffer()
+{
+    const QString filePath = createWaveFile("click.wav", 1000, 44100);
+
+    SoundCache cache;
+    SamplesBuffer out(2, 100);
+    QVERIFY(cache.load(filePath, 44100, out));
+    QCOMPARE(out.getFrameLenght(), 100u);
+}
+
+void TestSoundCache::missingFile()
+{
+    SoundCache cache;
+    SamplesBuffer out(2, 100);
+    QVERIFY(!cache.load(tempDir.filePath("missing.wav"), 44100, out));
+    QCOMPARE(out.getFrameLenght(), 0u);
+}
+
+void TestSoundCache::cachedLoadBenchmark()
+{
+    const QString filePath = createWaveFile("long.wav", 44100 * 10, 44100);
+
+    SoundCache cache;
+    SamplesBuffer out(2);
+    cache.load(filePath, 48000, out);
+
+    QBENCHMARK {
+        out.setFrameLenght(0);
+        cache.load(filePath, 48000, out);
+    }
+}
+
+void TestSoundCache::uncachedLoadBenchmark()
+{
+    const QString filePath = createWaveFile("long.wav", 44100 * 10, 44100);
+
+    QBENCHMARK {
+        SoundCache cache;
+        SamplesBuffer out(2);
+        cache.load(filePath, 48000, out);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef TEST_SOUND_CACHE_H
+#define TEST_SOUND_CACHE_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class TestSoundCache: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void loadWithoutResampling();
+    void loadResampled();
+    void loadFromMemoryAfterFileRename();
+    void loadFromDiskCache();
+    void diskCacheHitIsTouched(); // the disk cache is pruned in LRU order
+    void modifiedFileIsDecodedAgain();
+    void maxFramesInOutBuffer();
+    void missingFile();
+
+    void cachedLoadBenchmark();
+    void uncachedLoadBenchmark();
+
+private:
+    QString createWaveFile(const QString &fileName, quint32 frames, quint32 sampleRate, float amplitude = 0.5f);
+
+    QTemporaryDir tempDir;
+};
+
+#endif
@@ -12,8 +12,34 @@ VPATH += ../../../src/Common
 HEADERS += log/logging.h
 HEADERS += persistence/UsersDataCache.h
 HEADERS += persistence/CacheHeader.h
+HEADERS += persistence/SoundCache.h
+HEADERS += persistence/PluginScanDatabase.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/Resampler.h
+HEADERS += file/FileReader.h
+HEADERS += file/WaveFileReader.h
+HEADERS += file/WaveFileWriter.h
+HEADERS += TestSoundCache.h
+HEADERS += TestPluginScanDatabase.h
+HEADERS += TestLoopInfoIndex.h
+HEADERS += looper/LoopInfo.h
+HEADERS += looper/LoopInfoIndex.h
 
 SOURCES += log/logging.cpp
 SOURCES += persistence/UsersDataCache.cpp
 SOURCES += persistence/CacheHeader.cpp
+SOURCES += persistence/SoundCache.cpp
+SOURCES += persistence/PluginScanDatabase.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/Resampler.cpp
+SOURCES += file/FileReader.cpp
+SOURCES += file/WaveFileReader.cpp
+SOURCES += file/WaveFileWriter.cpp
+SOURCES += TestSoundCache.cpp
+SOURCES += TestPluginScanDatabase.cpp
+SOURCES += TestLoopInfoIndex.cpp
+SOURCES += looper/LoopInfo.cpp
+SOURCES += looper/LoopInfoIndex.cpp
 SOURCES += tst_UsersDataCache.cpp
@@ -4,6 +4,9 @@
 #include <QtTest/QtTest>
 #include "persistence/UsersDataCache.h"
 #include "persistence/CacheHeader.h"
+#include "TestSoundCache.h"
+#include "TestPluginScanDatabase.h"
+#include "TestLoopInfoIndex.h"
 
 using namespace persistence;
 
@@ -157,6 +160,7 @@ void TestCacheEntry::defaultValues()
     QCOMPARE(entry.getGain(), 1.0f);
     QCOMPARE(entry.getPan(), 0.0f);
     QCOMPARE(entry.getBoost(), 1.0f);
+    QVERIFY(!entry.hasLoudness());
 }
 
 void TestCacheEntry::setPanGuard_data()
@@ -199,6 +203,21 @@ int main(int argc, char *argv[])
         status |= QTest::qExec(&test, argc, argv);
     }
 
+    {
+        TestSoundCache test;
+        status |= QTest::qExec(&test, argc, argv);
+    }
+
+    {
+        TestPluginScanDatabase test;
+        status |= QTest::qExec(&test, argc, argv);
+    }
+
+    {
+        TestLoopInfoIndex test;
+        status |= QTest::qExec(&test, argc, argv);
+    }
+
     return status;
 }
 
@@ -0,0 +1,89 @@
+QT += testlib
+QT -= gui
+QT += concurrent # the intervals are decoded in parallel
+CONFIG += testcase
+CONFIG += c++11
+TEMPLATE = app
+TARGET = recorder
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../src/Common
+INCLUDEPATH += ../../../libs/includes/ogg
+INCLUDEPATH += ../../../libs/includes/vorbis
+INCLUDEPATH += ../../../libs/includes/minimp3
+VPATH += ../../../src/Common
+
+HEADERS += recorder/JamRecorder.h
+HEADERS += recorder/ReaperProjectGenerator.h
+HEADERS += recorder/JamRenderer.h
+HEADERS += audio/core/AudioNode.h
+HEADERS += audio/core/AudioNodeProcessor.h
+HEADERS += audio/core/MeteringSlot.h
+HEADERS += audio/core/SamplesBuffer.h
+HEADERS += audio/core/AudioPeak.h
+HEADERS += audio/Resampler.h
+HEADERS += audio/SamplesBufferResampler.h
+HEADERS += audio/Mp3Decoder.h
+HEADERS += audio/vorbis/VorbisDecoder.h
+HEADERS += audio/vorbis/VorbisEncoder.h
+HEADERS += file/FileReader.h
+HEADERS += file/FileReaderFactory.h
+HEADERS += file/WaveFileReader.h
+HEADERS += file/WaveFileWriter.h
+HEADERS += file/OggFileReader.h
+HEADERS += file/Mp3FileReader.h
+HEADERS += persistence/UsersDataCache.h
+HEADERS += persistence/CacheHeader.h
+HEADERS += midi/MidiMessage.h
+HEADERS += log/Logging.h
+
+SOURCES += recorder/JamRecorder.cpp
+SOURCES += recorder/ReaperProjectGenerator.cpp
+SOURCES += recorder/JamRenderer.cpp
+SOURCES += audio/core/AudioNode.cpp
+SOURCES += audio/core/AudioNodeProcessor.cpp
+SOURCES += audio/core/MeteringSlot.cpp
+SOURCES += audio/core/SamplesBuffer.cpp
+SOURCES += audio/core/AudioPeak.cpp
+SOURCES += audio/Resampler.cpp
+SOURCES += audio/SamplesBufferResampler.cpp
+SOURCES += audio/Mp3Decoder.cpp
+SOURCES += audio/vorbis/VorbisDecoder.cpp
+SOURCES += audio/vorbis/VorbisEncoder.cpp
+SOURCES += file/FileReader.cpp
+SOURCES += file/FileReaderFactory.cpp
+SOURCES += file/WaveFileReader.cpp
+SOURCES += file/WaveFileWriter.cpp
+SOURCES += file/OggFileReader.cpp
+SOURCES += file/Mp3FileReader.cpp
+SOURCES += persistence/UsersDataCache.cpp
+SOURCES += persistence/CacheHeader.cpp
+SOURCES += midi/MidiMessage.cpp
+SOURCES += log/logging.cpp
+
+SOURCES += test_Recorder.cpp
+
+# same static ogg, vorbis and minimp3 libs used in Standalone
+win32 {
+    !contains(QMAKE_TARGET.arch, x86_64) {
+        LIBS_PATH = "static/win32-msvc"
+    } else {
+        LIBS_PATH = "static/win64-msvc"
+    }
+    LIBS += -L$$PWD/../../../libs/$$LIBS_PATH -lminimp3 -lvorbisfile -lvorbis -logg
+    QMAKE_LFLAGS += "/NODEFAULTLIB:libcmt"
+}
+
+macx {
+    LIBS_PATH = "static/mac64"
+    LIBS += -L$$PWD/../../../libs/$$LIBS_PATH -lminimp3 -lvorbisfile -lvorbisenc -lvorbis -logg
+}
+
+linux {
+    contains(QMAKE_HOST.arch, x86_64) {
+        LIBS_PATH = "static/linux64"
+    } else {
+        LIBS_PATH = "static/linux32"
+    }
+    LIBS += -L$$PWD/../../../libs/$$LIBS_PATH -lminimp3 -lvorbisfile -lvorbisenc -lvorbis -logg
+}
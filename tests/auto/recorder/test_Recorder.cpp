@@ -0,0 +1,286 @@
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+
+#include "recorder/JamRecorder.h"
+#include "recorder/ReaperProjectGenerator.h"
+#include "recorder/JamRenderer.h"
+#include "audio/core/AudioNode.h"
+#include "audio/core/SamplesBuffer.h"
+#include "file/WaveFileReader.h"
+#include "file/WaveFileWriter.h"
+
+using recorder::Jam;
+using recorder::JamTrack;
+using recorder::JamAudioFile;
+using recorder::JamRenderer;
+using recorder::ReaperProjectGenerator;
+using audio::AudioNode;
+using audio::SamplesBuffer;
+using audio::WaveFileReader;
+using audio::WaveFileWriter;
+
+class TestRecorder: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readJam();
+    void readJamWithInvalidFiles();
+    void readJamWithInvalidFiles_data();
+
+    void renderMix();
+    void renderPannedStems();
+    void renderMutedTrack();
+    void renderUndecodedInterval();
+    void renderErrors();
+
+private:
+    QString writeInterval(const QString &fileName, float value); // one interval of constant samples
+    JamRenderer::Settings createSettings(const QString &outputFolder) const;
+    static SamplesBuffer readWaveFile(const QString &filePath);
+
+    QTemporaryDir tempDir;
+
+    static const int BPM = 60; // one second per interval
+    static const int BPI = 1;
+    static const quint32 SAMPLE_RATE = 1000;
+};
+
+QString TestRecorder::writeInterval(const QString &fileName, float value)
+{
+    SamplesBuffer buffer(2, SAMPLE_RATE);
+    for (quint32 s = 0; s < SAMPLE_RATE; ++s) {
+        buffer.set(0, s, value);
+        buffer.set(1, s, value);
+    }
+
+    const QString filePath = tempDir.filePath(fileName);
+    WaveFileWriter writer;
+    writer.write(filePath, buffer, SAMPLE_RATE, 32); // float samples, no quantization errors
+
+    return filePath;
+}
+
+JamRenderer::Settings TestRecorder::createSettings(const QString &outputFolder) const
+{
+    JamRenderer::Settings settings;
+    settings.outputPath = QDir(tempDir.path()).absoluteFilePath(outputFolder);
+    settings.sampleRate = SAMPLE_RATE; // no resampling
+    settings.bitDepth = 32;
+
+    return settings;
+}
+
+SamplesBuffer TestRecorder::readWaveFile(const QString &filePath)
+{
+    WaveFileReader reader;
+    SamplesBuffer buffer(2);
+    quint32 sampleRate = 0;
+    reader.read(filePath, buffer, sampleRate);
+
+    return buffer;
+}
+
+void TestRecorder::readJam()
+{
+    Jam jam(BPM * 2, 16, 48000);
+    jam.addAudioFile("user (from Brazil)", 0, "audio/user-1.ogg", 1);
+    jam.addAudioFile("user (from Brazil)", 0, "audio/user-3.ogg", 3);
+    jam.addAudioFile("user (from Brazil)", 1, "audio/user-ch2-2.ogg", 2);
+    jam.addAudioFile("zeca", 0, QDir(tempDir.path()).absoluteFilePath("zeca-1.ogg"), 1);
+
+    ReaperProjectGenerator generator;
+    generator.setJamDir("readJam", tempDir.path());
+    generator.write(jam);
+
+    const QString rppFilePath = QDir(tempDir.path()).absoluteFilePath("readJam/Reaper/Reaper project.rpp");
+    auto readedJam = ReaperProjectGenerator::readJam(rppFilePath);
+    QVERIFY(readedJam);
+
+    QCOMPARE(readedJam->getBpm(), jam.getBpm());
+    QCOMPARE(readedJam->getBpi(), jam.getBpi());
+    QCOMPARE(readedJam->getSampleRate(), jam.getSampleRate());
+
+    const QList<JamTrack> tracks = readedJam->getJamTracks();
+    QCOMPARE(tracks.size(), 3);
+
+    QCOMPARE(tracks.at(0).getUserName(), QString("user (from Brazil)"));
+    QCOMPARE(tracks.at(0).getChannelIndex(), static_cast<quint8>(0));
+    QCOMPARE(tracks.at(1).getUserName(), QString("user (from Brazil)"));
+    QCOMPARE(tracks.at(1).getChannelIndex(), static_cast<quint8>(1));
+    QCOMPARE(tracks.at(2).getUserName(), QString("zeca"));
+
+    // the relative paths are resolved using the project folder
+    const QDir projectDir = QFileInfo(rppFilePath).absoluteDir();
+    const QList<JamAudioFile> audioFiles = tracks.at(0).getAudioFiles();
+    QCOMPARE(audioFiles.size(), 2);
+    QCOMPARE(audioFiles.at(0).getIntervalIndex(), 1u);
+    QCOMPARE(audioFiles.at(0).getPath(), projectDir.absoluteFilePath("audio/user-1.ogg"));
+    QCOMPARE(audioFiles.at(1).getIntervalIndex(), 3u);
+
+    QCOMPARE(tracks.at(1).getAudioFiles().first().getIntervalIndex(), 2u);
+    QCOMPARE(tracks.at(2).getAudioFiles().first().getPath(), QDir(tempDir.path()).absoluteFilePath("zeca-1.ogg"));
+
+    QVERIFY(!ReaperProjectGenerator::readJam(tempDir.filePath("missing.rpp")));
+}
+
+void TestRecorder::readJamWithInvalidFiles()
+{
+    QFETCH(QString, content);
+
+    const QString rppFilePath = tempDir.filePath("invalid.rpp");
+    QFile file(rppFilePath);
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write(content.toUtf8());
+    file.close();
+
+    QVERIFY(!ReaperProjectGenerator::readJam(rppFilePath));
+}
+
+void TestRecorder::readJamWithInvalidFiles_data()
+{
+    QTest::addColumn<QString>("content");
+
+    QTest::newRow("Empty file") << "";
+    QTest::newRow("Without tempo") << "<REAPER_PROJECT\n  SAMPLERATE 44100 0 0\n  <TRACK\n    NAME \"user (Channel 1)\"\n    <ITEM\n      POSITION 0\n      LENGTH 8\n      <SOURCE VORBIS\n        FILE \"a.ogg\"\n      >\n    >\n  >\n>";
+    QTest::newRow("Without items") << "<REAPER_PROJECT\n  SAMPLERATE 44100 0 0\n  TEMPO 120 4 4\n  <TRACK\n    NAME \"user (Channel 1)\"\n  >\n>";
+    QTest::newRow("Track not written by Jamtaba") << "<REAPER_PROJECT\n  TEMPO 120 4 4\n  <TRACK\n    NAME \"Guitar\"\n    <ITEM\n      POSITION 0\n      LENGTH 8\n      <SOURCE VORBIS\n        FILE \"a.ogg\"\n      >\n    >\n  >\n>";
+}
+
+void TestRecorder::renderMix()
+{
+    Jam jam(BPM, BPI, SAMPLE_RATE);
+    jam.addAudioFile("user1", 0, writeInterval("mix-user1-1.wav", 0.5f), 1);
+    jam.addAudioFile("user1", 0, writeInterval("mix-user1-2.wav", 0.5f), 2);
+    jam.addAudioFile("user2", 0, writeInterval("mix-user2-2.wav", 0.25f), 2);
+
+    JamRenderer renderer(jam);
+    renderer.setTrackMix("user2", 0, 0.5f, 0.0f); // half gain
+
+    QSignalSpy finishedSpy(&renderer, SIGNAL(renderFinished(bool)));
+    QVERIFY(renderer.render(createSettings("renderMix")));
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(renderer.getRenderedFiles().size(), 1);
+    QCOMPARE(renderer.getUndecodedFiles(), 0);
+
+    const SamplesBuffer mix = readWaveFile(renderer.getRenderedFiles().first());
+    QCOMPARE(mix.getFrameLenght(), SAMPLE_RATE * 2);
+
+    float centerLeftGain, centerRightGain;
+    AudioNode::computePanGains(0.0f, centerLeftGain, centerRightGain); // the same pan law used in the jam
+
+    QVERIFY(qFuzzyCompare(mix.get(0, 10), 0.5f * centerLeftGain)); // first interval, only user1
+    QVERIFY(qFuzzyCompare(mix.get(1, 10), 0.5f * centerRightGain));
+    QVERIFY(qFuzzyCompare(mix.get(0, SAMPLE_RATE + 10), (0.5f + 0.25f * 0.5f) * centerLeftGain)); // second interval, user1 + user2
+}
+
+void TestRecorder::renderPannedStems()
+{
+    Jam jam(BPM, BPI, SAMPLE_RATE);
+    jam.addAudioFile("left", 0, writeInterval("pan-left-1.wav", 0.5f), 1);
+    jam.addAudioFile("right", 1, writeInterval("pan-right-1.wav", 0.5f), 1);
+
+    JamRenderer renderer(jam);
+    renderer.setTrackMix("left", 0, 1.0f, -1.0f);
+    renderer.setTrackMix("right", 1, 1.0f, 1.0f, 2.0f); // boosted
+
+    auto settings = createSettings("renderPannedStems");
+    settings.renderMix = false;
+    settings.renderStems = true;
+    QVERIFY(renderer.render(settings));
+
+    const QDir outputDir(settings.outputPath);
+    QVERIFY(renderer.getRenderedFiles().contains(outputDir.absoluteFilePath("left (Channel 1).wav")));
+    QVERIFY(renderer.getRenderedFiles().contains(outputDir.absoluteFilePath("right (Channel 2).wav")));
+    QVERIFY(!QFile::exists(outputDir.absoluteFilePath(JamRenderer::getMixFileName(JamRenderer::WaveFormat))));
+
+    const SamplesBuffer left = readWaveFile(outputDir.absoluteFilePath("left (Channel 1).wav"));
+    QVERIFY(qFuzzyCompare(left.get(0, 10), 0.5f));
+    QVERIFY(qAbs(left.get(1, 10)) < 0.00001f);
+
+    const SamplesBuffer right = readWaveFile(outputDir.absoluteFilePath("right (Channel 2).wav"));
+    QVERIFY(qAbs(right.get(0, 10)) < 0.00001f);
+    QVERIFY(qFuzzyCompare(right.get(1, 10), 1.0f));
+}
+
+void TestRecorder::renderMutedTrack()
+{
+    Jam jam(BPM, BPI, SAMPLE_RATE);
+    jam.addAudioFile("user1", 0, writeInterval("muted-user1-1.wav", 0.5f), 1);
+    jam.addAudioFile("muted", 0, writeInterval("muted-muted-1.wav", 0.5f), 1);
+
+    JamRenderer renderer(jam);
+    renderer.setTrackMix("user1", 0, 1.0f, -1.0f);
+    renderer.setTrackMix("muted", 0, 1.0f, 0.0f, 1.0f, true);
+
+    auto settings = createSettings("renderMutedTrack");
+    settings.renderStems = true;
+    QVERIFY(renderer.render(settings));
+
+    QCOMPARE(renderer.getRenderedFiles().size(), 2); // the mix and 'user1' stem
+    QVERIFY(!QFile::exists(QDir(settings.outputPath).absoluteFilePath("muted (Channel 1).wav")));
+
+    const SamplesBuffer mix = readWaveFile(QDir(settings.outputPath).absoluteFilePath(JamRenderer::getMixFileName(JamRenderer::WaveFormat)));
+    QVERIFY(qFuzzyCompare(mix.get(0, 10), 0.5f));
+}
+
+void TestRecorder::renderUndecodedInterval()
+{
+    Jam jam(BPM, BPI, SAMPLE_RATE);
+    jam.addAudioFile("user1", 0, writeInterval("undecoded-user1-1.wav", 0.5f), 1);
+    jam.addAudioFile("user1", 0, tempDir.filePath("undecoded-missing.wav"), 2);
+
+    JamRenderer renderer(jam);
+    renderer.setTrackMix("user1", 0, 1.0f, -1.0f);
+    QVERIFY(renderer.render(createSettings("renderUndecodedInterval")));
+    QCOMPARE(renderer.getUndecodedFiles(), 1);
+
+    const SamplesBuffer mix = readWaveFile(renderer.getRenderedFiles().first());
+    QCOMPARE(mix.getFrameLenght(), SAMPLE_RATE * 2);
+    QVERIFY(qFuzzyCompare(mix.get(0, 10), 0.5f));
+    QCOMPARE(mix.get(0, SAMPLE_RATE + 10), 0.0f); // silence in the missing interval
+}
+
+void TestRecorder::renderErrors()
+{
+    Jam jam(BPM, BPI, SAMPLE_RATE);
+    jam.addAudioFile("user1", 0, writeInterval("errors-user1-1.wav", 0.5f), 1);
+
+    JamRenderer renderer(jam);
+    QSignalSpy finishedSpy(&renderer, SIGNAL(renderFinished(bool)));
+
+    // the output folder is an existing file
+    QFile file(tempDir.filePath("errors-file"));
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.close();
+
+    auto settings = createSettings("errors-file");
+    QVERIFY(!renderer.render(settings));
+    QVERIFY(!renderer.getErrorString().isEmpty());
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.first().first().toBool(), false);
+
+    // nothing to render
+    settings = createSettings("renderErrors");
+    settings.renderMix = false;
+    QVERIFY(!renderer.render(settings));
+    QVERIFY(!renderer.getErrorString().isEmpty());
+
+    // the error is cleared in the next rendering
+    QVERIFY(renderer.render(createSettings("renderErrors")));
+    QVERIFY(renderer.getErrorString().isEmpty());
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    TestRecorder test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_Recorder.moc"
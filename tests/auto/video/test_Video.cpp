@@ -0,0 +1,268 @@
+#include <QObject>
+#include <QGuiApplication>
+#include <QtTest/QtTest>
+#include <vector>
+#include <cstdlib>
+
+#include "video/RgbToYuvConverter.h"
+#include "video/FFMpegMuxer.h"
+#include "video/FFMpegDemuxer.h"
+
+class TestRgbToYuvConverter: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void uniformColors();
+    void uniformColors_data();
+
+    void simdAndScalarProduceSameOutput();
+    void simdAndScalarProduceSameOutput_data();
+
+    void convertBenchmark();
+    void convertBenchmark_data();
+
+    void scalarConvertBenchmark();
+    void scalarConvertBenchmark_data();
+
+private:
+    struct YuvPicture
+    {
+        YuvPicture(int width, int height) :
+            width(width),
+            height(height),
+            chromaWidth((width + 1) / 2),
+            chromaHeight((height + 1) / 2),
+            y(width * height),
+            u(chromaWidth * chromaHeight),
+            v(chromaWidth * chromaHeight)
+        {
+
+        }
+
+        int width;
+        int height;
+        int chromaWidth;
+        int chromaHeight;
+        std::vector<uint8_t> y;
+        std::vector<uint8_t> u;
+        std::vector<uint8_t> v;
+    };
+
+    static std::vector<uint8_t> createImage(int width, int height, int stride, bool random, quint32 color = 0);
+
+    void addResolutions();
+};
+
+std::vector<uint8_t> TestRgbToYuvConverter::createImage(int width, int height, int stride, bool random, quint32 color)
+{
+    std::vector<uint8_t> image(stride * height, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t *pixel = &image[y * stride + x * 4];
+            const quint32 value = random ? static_cast<quint32>(std::rand()) : color;
+            pixel[0] = value & 0xFF;          // B
+            pixel[1] = (value >> 8) & 0xFF;   // G
+            pixel[2] = (value >> 16) & 0xFF;  // R
+            pixel[3] = 0xFF;                  // A
+        }
+    }
+    return image;
+}
+
+void TestRgbToYuvConverter::uniformColors()
+{
+    QFETCH(quint32, color);
+    QFETCH(int, expectedY);
+    QFETCH(int, expectedU);
+    QFETCH(int, expectedV);
+
+    const int width = 32;
+    const int height = 4;
+    auto image = createImage(width, height, width * 4, false, color);
+
+    YuvPicture picture(width, height);
+    RgbToYuvConverter::convert(image.data(), width * 4, width, height,
+                               picture.y.data(), width, picture.u.data(), picture.chromaWidth, picture.v.data(), picture.chromaWidth);
+
+    for (uint8_t y : picture.y)
+        QCOMPARE(static_cast<int>(y), expectedY);
+
+    for (uint8_t u : picture.u)
+        QCOMPARE(static_cast<int>(u), expectedU);
+
+    for (uint8_t v : picture.v)
+        QCOMPARE(static_cast<int>(v), expectedV);
+}
+
+void TestRgbToYuvConverter::uniformColors_data()
+{
+    QTest::addColumn<quint32>("color");
+    QTest::addColumn<int>("expectedY");
+    QTest::addColumn<int>("expectedU");
+    QTest::addColumn<int>("expectedV");
+
+    QTest::newRow("White") << 0xFFFFFFu << 255 << 128 << 128;
+    QTest::newRow("Black") << 0x000000u << 0 << 128 << 128;
+    QTest::newRow("Red") << 0xFF0000u << 77 << 85 << 255;
+    QTest::newRow("Green") << 0x00FF00u << 149 << 44 << 22;
+    QTest::newRow("Blue") << 0x0000FFu << 29 << 255 << 107;
+}
+
+void TestRgbToYuvConverter::simdAndScalarProduceSameOutput()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    const int stride = width * 4 + 12; // padding in the end of each line
+    auto image = createImage(width, height, stride, true);
+
+    YuvPicture converted(width, height);
+    RgbToYuvConverter::convert(image.data(), stride, width, height,
+                               converted.y.data(), width, converted.u.data(), converted.chromaWidth, converted.v.data(), converted.chromaWidth);
+
+    YuvPicture expected(width, height);
+    RgbToYuvConverter::convertScalar(image.data(), stride, width, height,
+                                     expected.y.data(), width, expected.u.data(), expected.chromaWidth, expected.v.data(), expected.chromaWidth);
+
+    QVERIFY(converted.y == expected.y);
+    QVERIFY(converted.u == expected.u);
+    QVERIFY(converted.v == expected.v);
+}
+
+void TestRgbToYuvConverter::simdAndScalarProduceSameOutput_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    QTest::newRow("320 x 240") << 320 << 240;
+    QTest::newRow("640 x 480") << 640 << 480;
+    QTest::newRow("Odd resolution 33 x 7") << 33 << 7;
+    QTest::newRow("Smaller than SIMD block 5 x 3") << 5 << 3;
+    QTest::newRow("Single pixel") << 1 << 1;
+}
+
+void TestRgbToYuvConverter::addResolutions()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    QTest::newRow("320 x 240") << 320 << 240;
+    QTest::newRow("640 x 480") << 640 << 480;
+}
+
+void TestRgbToYuvConverter::convertBenchmark()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    auto image = createImage(width, height, width * 4, true);
+    YuvPicture picture(width, height);
+
+    QBENCHMARK { // one video frame per iteration
+        RgbToYuvConverter::convert(image.data(), width * 4, width, height,
+                                   picture.y.data(), width, picture.u.data(), picture.chromaWidth, picture.v.data(), picture.chromaWidth);
+    }
+}
+
+void TestRgbToYuvConverter::convertBenchmark_data()
+{
+    addResolutions();
+}
+
+void TestRgbToYuvConverter::scalarConvertBenchmark()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    auto image = createImage(width, height, width * 4, true);
+    YuvPicture picture(width, height);
+
+    QBENCHMARK {
+        RgbToYuvConverter::convertScalar(image.data(), width * 4, width, height,
+                                         picture.y.data(), width, picture.u.data(), picture.chromaWidth, picture.v.data(), picture.chromaWidth);
+    }
+}
+
+void TestRgbToYuvConverter::scalarConvertBenchmark_data()
+{
+    addResolutions();
+}
+
+class TestFFMpegDemuxer: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodeEncodedInterval();
+
+private:
+    static QByteArray encodeInterval(const QSize &resolution, int frames);
+};
+
+QByteArray TestFFMpegDemuxer::encodeInterval(const QSize &resolution, int frames)
+{
+    QByteArray encodedData;
+    QMutex encodedDataMutex;
+
+    FFMpegMuxer muxer;
+    muxer.setVideoResolution(resolution);
+
+    // the packets are emitted in the encoder thread
+    QObject::connect(&muxer, &FFMpegMuxer::dataEncoded, [&](const QByteArray &data, bool) {
+        QMutexLocker locker(&encodedDataMutex);
+        encodedData.append(data);
+    });
+
+    QSignalSpy finishedSpy(&muxer, SIGNAL(encodingFinished()));
+
+    muxer.startNewInterval();
+    for (int f = 0; f < frames; ++f) {
+        QImage image(resolution, QImage::Format_RGB32);
+        image.fill(QColor::fromHsv((f * 30) % 360, 255, 255));
+        muxer.encodeImage(image);
+        QTest::qWait(40); // the muxer mailbox keeps only the latest image
+    }
+
+    muxer.finish();
+    if (!finishedSpy.wait(5000))
+        return QByteArray();
+
+    QMutexLocker locker(&encodedDataMutex);
+    return encodedData;
+}
+
+void TestFFMpegDemuxer::decodeEncodedInterval()
+{
+    const QSize resolution(160, 120);
+
+    const QByteArray encodedData = encodeInterval(resolution, 15);
+    QVERIFY(!encodedData.isEmpty());
+
+    FFMpegDemuxer demuxer;
+    demuxer.addInterval(encodedData); // nothing is playing, the interval is played immediately
+
+    QImage frame;
+    QTRY_VERIFY_WITH_TIMEOUT(!(frame = demuxer.getCurrentFrame()).isNull(), 5000);
+
+    QCOMPARE(frame.size(), resolution); // the video size is used when the target size is not set
+    QCOMPARE(demuxer.getVideoSize(), resolution);
+    QVERIFY(demuxer.getStatistics().decodedFrames > 0);
+}
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv); // QSignalSpy::wait is running the event loop
+
+    int result = 0;
+
+    TestRgbToYuvConverter rgbToYuvConverterTest;
+    result |= QTest::qExec(&rgbToYuvConverterTest, argc, argv);
+
+    TestFFMpegDemuxer demuxerTest;
+    result |= QTest::qExec(&demuxerTest, argc, argv);
+
+    return result;
+}
+
+#include "test_Video.moc"
@@ -0,0 +1,51 @@
+QT += testlib
+QT += gui
+QT += concurrent
+CONFIG += testcase
+CONFIG += c++11
+TEMPLATE = app
+TARGET = video
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../src/Common
+INCLUDEPATH += ../../../libs/includes/ffmpeg
+VPATH += ../../../src/Common
+
+HEADERS += video/RgbToYuvConverter.h
+HEADERS += video/FFMpegCommon.h
+HEADERS += video/FFMpegMuxer.h
+HEADERS += video/FFMpegDemuxer.h
+
+SOURCES += video/RgbToYuvConverter.cpp
+SOURCES += video/FFMpegMuxer.cpp
+SOURCES += video/FFMpegDemuxer.cpp
+
+SOURCES += test_Video.cpp
+
+# same static ffmpeg libs used in Standalone
+win32 {
+    !contains(QMAKE_TARGET.arch, x86_64) {
+        LIBS_PATH = "static/win32-msvc"
+    } else {
+        LIBS_PATH = "static/win64-msvc"
+    }
+    LIBS += -L$$PWD/../../../libs/$$LIBS_PATH -lx264 -lavcodec -lavutil -lavformat -lswscale -lswresample
+    LIBS += -lole32 -lws2_32 -lAdvapi32 -lUser32 -lSecur32
+    QMAKE_LFLAGS += "/NODEFAULTLIB:libcmt"
+}
+
+macx {
+    LIBS_PATH = "static/mac64"
+    LIBS += -L$$PWD/../../../libs/$$LIBS_PATH -lx264 -lavcodec -lavutil -lavformat -lswscale -lswresample -liconv -lz
+    LIBS += -framework CoreServices
+}
+
+linux {
+    contains(QMAKE_HOST.arch, x86_64) {
+        LIBS_PATH = "static/linux64"
+    } else {
+        LIBS_PATH = "static/linux32"
+    }
+    LIBS += -L$$PWD/../../../libs/$$LIBS_PATH -lavformat -lavcodec -lswscale -lavutil -lswresample -lx264
+    LIBS += -ldl -lz
+}
@@ -0,0 +1,132 @@
+#include <QObject>
+#include <QtTest/QtTest>
+#include <vector>
+
+#include "vst/VstMidiEvents.h"
+#include "midi/MidiMessage.h"
+
+using vst::VstMidiEvents;
+using midi::MidiMessage;
+
+class TestVstMidiEvents: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void eventsAreTranslated();
+    void noGrowWithoutOverflow();
+    void overflowedEventsAreDropped();
+    void growAfterOverflow();
+    void growIsLimitedToMaxCapacity();
+    void retiredBlockIsDeletedBeforeGrowAgain();
+
+private:
+    static std::vector<MidiMessage> createMidiBuffer(int messages);
+};
+
+std::vector<MidiMessage> TestVstMidiEvents::createMidiBuffer(int messages)
+{
+    std::vector<MidiMessage> midiBuffer;
+    for (int m = 0; m < messages; ++m) {
+        MidiMessage message(0x7F0090 | ((m % 128) << 8), 0); // note on, channel 0, max velocity
+        message.setSampleOffset(m);
+        midiBuffer.push_back(message);
+    }
+    return midiBuffer;
+}
+
+void TestVstMidiEvents::eventsAreTranslated()
+{
+    VstMidiEvents midiEvents(4, 16);
+
+    VstEvents *vstEvents = midiEvents.fill(createMidiBuffer(3));
+    QCOMPARE(vstEvents->numEvents, 3);
+
+    for (int e = 0; e < vstEvents->numEvents; ++e) {
+        VstMidiEvent *midiEvent = reinterpret_cast<VstMidiEvent *>(vstEvents->events[e]);
+        QCOMPARE(midiEvent->type, static_cast<VstInt32>(kVstMidiType));
+        QCOMPARE(midiEvent->deltaFrames, e);
+        QCOMPARE(static_cast<quint8>(midiEvent->midiData[0]), quint8(0x90));
+        QCOMPARE(static_cast<int>(midiEvent->midiData[1]), e);
+        QCOMPARE(static_cast<int>(midiEvent->midiData[2]), 127);
+    }
+}
+
+void TestVstMidiEvents::noGrowWithoutOverflow()
+{
+    VstMidiEvents midiEvents(4, 16);
+
+    midiEvents.fill(createMidiBuffer(4));
+    QVERIFY(!midiEvents.grow());
+
+    midiEvents.fill(createMidiBuffer(2));
+    QCOMPARE(midiEvents.getCapacity(), 4);
+    QCOMPARE(midiEvents.getOverflowedEvents(), 0u);
+}
+
+void TestVstMidiEvents::overflowedEventsAreDropped()
+{
+    VstMidiEvents midiEvents(4, 16);
+
+    VstEvents *vstEvents = midiEvents.fill(createMidiBuffer(6));
+    QCOMPARE(vstEvents->numEvents, 4); // the first messages are kept
+    QCOMPARE(midiEvents.getOverflowedEvents(), 2u);
+
+    midiEvents.fill(createMidiBuffer(5)); // the block is not growing in the audio thread
+    QCOMPARE(midiEvents.getCapacity(), 4);
+    QCOMPARE(midiEvents.getOverflowedEvents(), 3u);
+}
+
+void TestVstMidiEvents::growAfterOverflow()
+{
+    VstMidiEvents midiEvents(4, 16);
+
+    midiEvents.fill(createMidiBuffer(6));
+    QVERIFY(midiEvents.grow()); // GUI thread
+    QVERIFY(!midiEvents.grow()); // the prepared block is already big enough
+
+    VstEvents *vstEvents = midiEvents.fill(createMidiBuffer(6)); // the bigger block is used in the next audio block
+    QCOMPARE(midiEvents.getCapacity(), 8);
+    QCOMPARE(vstEvents->numEvents, 6);
+    QCOMPARE(midiEvents.getOverflowedEvents(), 2u); // no new dropped messages
+}
+
+void TestVstMidiEvents::growIsLimitedToMaxCapacity()
+{
+    VstMidiEvents midiEvents(4, 16);
+
+    midiEvents.fill(createMidiBuffer(40));
+    QVERIFY(midiEvents.grow());
+
+    VstEvents *vstEvents = midiEvents.fill(createMidiBuffer(40));
+    QCOMPARE(midiEvents.getCapacity(), 16);
+    QCOMPARE(vstEvents->numEvents, 16);
+    QCOMPARE(midiEvents.getOverflowedEvents(), 36u + 24u);
+
+    QVERIFY(!midiEvents.grow()); // max capacity reached
+}
+
+void TestVstMidiEvents::retiredBlockIsDeletedBeforeGrowAgain()
+{
+    VstMidiEvents midiEvents(2, 64);
+
+    midiEvents.fill(createMidiBuffer(3));
+    QVERIFY(midiEvents.grow());
+
+    midiEvents.fill(createMidiBuffer(10)); // the 4 events block replaces the first block, which is retired
+    QCOMPARE(midiEvents.getCapacity(), 4);
+
+    QVERIFY(midiEvents.grow()); // deleting the retired block and allocating a bigger block
+
+    VstEvents *vstEvents = midiEvents.fill(createMidiBuffer(10));
+    QCOMPARE(midiEvents.getCapacity(), 16);
+    QCOMPARE(vstEvents->numEvents, 10);
+}
+
+int main(int argc, char *argv[])
+{
+    TestVstMidiEvents test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "test_VstMidiEvents.moc"
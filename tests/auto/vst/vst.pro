@@ -0,0 +1,27 @@
+QT += testlib
+QT -= gui
+CONFIG += testcase
+CONFIG += c++11
+TEMPLATE = app
+TARGET = vst
+
+DEFINES += VST_FORCE_DEPRECATED=0 #enable VST 2.3 features
+
+linux{
+    DEFINES += __cdecl="" #avoid tons of errors in VST_SDK in linux
+}
+
+INCLUDEPATH += .
+INCLUDEPATH += ../../../src/Common
+INCLUDEPATH += ../../../src/Standalone
+INCLUDEPATH += ../../../VST_SDK/VST2_SDK/pluginterfaces/vst2.x
+VPATH += ../../../src/Common
+VPATH += ../../../src/Standalone
+
+HEADERS += vst/VstMidiEvents.h
+HEADERS += midi/MidiMessage.h
+
+SOURCES += vst/VstMidiEvents.cpp
+SOURCES += midi/MidiMessage.cpp
+
+SOURCES += test_VstMidiEvents.cpp